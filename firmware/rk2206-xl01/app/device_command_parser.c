@@ -289,6 +289,8 @@ int ParseDeviceCommandV1(const char *json, DeviceCommandMessage *out)
     const char *payload_end = NULL;
     const char *time_sync = NULL;
     const char *time_sync_end = NULL;
+    const char *sensor_rates = NULL;
+    const char *sensor_rates_end = NULL;
 
     if (json == NULL || out == NULL) {
         return -1;
@@ -358,5 +360,31 @@ int ParseDeviceCommandV1(const char *json, DeviceCommandMessage *out)
         out->has_interval_seconds = 1;
     }
 
+    if (ExtractJsonStringFromObject(payload, payload_end, "sensor", out->history_sensor, sizeof(out->history_sensor)) == 0) {
+        out->has_history_sensor = 1;
+    }
+    if (ExtractJsonIntFromObject(payload, payload_end, "since_s", &out->since_s) == 0) {
+        out->has_since_s = 1;
+    }
+    if (ExtractJsonIntFromObject(payload, payload_end, "cursor", &out->log_cursor) == 0) {
+        out->has_log_cursor = 1;
+    }
+
+    sensor_rates = FindJsonValueStartInObject(payload, payload_end, "sensor_sampling_ms");
+    if (sensor_rates != NULL && *sensor_rates == '{') {
+        sensor_rates_end = FindJsonObjectEnd(sensor_rates);
+        if (sensor_rates_end != NULL && sensor_rates_end <= payload_end) {
+            if (ExtractJsonIntFromObject(sensor_rates, sensor_rates_end, "soil", &out->soil_sampling_ms) == 0) {
+                out->has_soil_sampling_ms = 1;
+            }
+            if (ExtractJsonIntFromObject(sensor_rates, sensor_rates_end, "tilt", &out->tilt_sampling_ms) == 0) {
+                out->has_tilt_sampling_ms = 1;
+            }
+            if (ExtractJsonIntFromObject(sensor_rates, sensor_rates_end, "rain", &out->rain_sampling_ms) == 0) {
+                out->has_rain_sampling_ms = 1;
+            }
+        }
+    }
+
     return 0;
 }
@@ -22,6 +22,22 @@ typedef struct {
     int report_interval_s;
     int has_interval_seconds;
     int interval_seconds;
+    /* set_config "sensor_sampling_ms": {"soil": ms, "tilt": ms, "rain": ms}; 0 follows sampling_s */
+    int has_soil_sampling_ms;
+    int soil_sampling_ms;
+    int has_tilt_sampling_ms;
+    int tilt_sampling_ms;
+    int has_rain_sampling_ms;
+    int rain_sampling_ms;
+    /* fetch_history: "sensor": "tilt" | "soil" | "all", "since_s": look-back window */
+    int has_history_sensor;
+    char history_sensor[16];
+    int has_since_s;
+    int since_s;
+    /* fetch_log: "cursor": first record seq wanted (next_cursor of the previous drain);
+     * get_runtime_stats: first task row wanted */
+    int has_log_cursor;
+    int log_cursor;
 } DeviceCommandMessage;
 
 int ParseDeviceCommandV1(const char *json, DeviceCommandMessage *out);
@@ -1,4 +1,5 @@
 #include "device_identity.h"
+#include <stddef.h>
 #include "../config/app_config.h"
 
 static const DeviceIdentity kDeviceIdentity = {
@@ -10,7 +11,29 @@ static const DeviceIdentity kDeviceIdentity = {
     .legacy_node_label = LEGACY_NODE_LABEL
 };
 
+#if DEVICE_IDENTITY_ENABLE_HOST_HOOKS
+static DeviceIdentity g_host_identity;
+static int g_host_identity_set = 0;
+
+void DeviceIdentity_SetHostOverride(const char *device_id, const char *install_label)
+{
+    g_host_identity = kDeviceIdentity;
+    if (device_id != NULL && device_id[0] != '\0') {
+        g_host_identity.device_id = device_id;
+    }
+    if (install_label != NULL && install_label[0] != '\0') {
+        g_host_identity.install_label = install_label;
+    }
+    g_host_identity_set = 1;
+}
+#endif
+
 const DeviceIdentity *DeviceIdentity_Get(void)
 {
+#if DEVICE_IDENTITY_ENABLE_HOST_HOOKS
+    if (g_host_identity_set) {
+        return &g_host_identity;
+    }
+#endif
     return &kDeviceIdentity;
 }
@@ -18,6 +18,16 @@ typedef struct {
 
 const DeviceIdentity *DeviceIdentity_Get(void);
 
+#if DEVICE_IDENTITY_ENABLE_HOST_HOOKS
+/**
+ * Replace the compiled-in device_id and install_label (NULL or empty keeps
+ * it) so several host instances can share one binary. Call before the
+ * firmware starts; the strings must outlive it. Host simulators only; firmware
+ * builds leave DEVICE_IDENTITY_ENABLE_HOST_HOOKS unset.
+ */
+void DeviceIdentity_SetHostOverride(const char *device_id, const char *install_label);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
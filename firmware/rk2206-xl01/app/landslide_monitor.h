@@ -18,6 +18,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "risk_engine.h"    // ProcessedData, RiskLevel, RiskAssessment and their getters
 
 #ifdef __cplusplus
 extern "C" {
@@ -80,18 +81,6 @@ typedef struct {
     bool data_valid;            // 数据有效标志
 } SensorData;
 
-// 处理后的数据结构
-typedef struct {
-    float accel_magnitude;      // 加速度幅值
-    float accel_change_rate;    // 加速度变化率
-    float angle_magnitude;      // 倾角幅值
-    float angle_change_rate;    // 倾角变化率
-    float humidity_trend;       // 湿度变化趋势
-    float light_change_rate;    // 光照变化率
-    float vibration_intensity;  // 振动强度
-    uint32_t timestamp;         // 时间戳
-} ProcessedData;
-
 // GPS定位数据
 typedef struct {
     double latitude;                // 纬度
@@ -103,31 +92,6 @@ typedef struct {
     uint32_t last_update_time;      // 最后更新时间
 } GPSData;
 
-// 风险等级枚举
-typedef enum {
-    RISK_LEVEL_SAFE = 0,        // 安全
-    RISK_LEVEL_LOW = 1,         // 低风险
-    RISK_LEVEL_MEDIUM = 2,      // 中风险
-    RISK_LEVEL_HIGH = 3,        // 高风险
-    RISK_LEVEL_CRITICAL = 4     // 危急
-} RiskLevel;
-
-// 风险评估结果
-typedef struct {
-    RiskLevel level;            // 风险等级
-    float confidence;           // 置信度 (0.0-1.0)
-    uint32_t duration_ms;       // 持续时间 (ms)
-    char description[64];       // 风险描述
-    uint32_t timestamp;         // 评估时间戳
-    
-    // 各项风险因子
-    float tilt_risk;            // 倾斜风险
-    float vibration_risk;       // 振动风险
-    float humidity_risk;        // 湿度风险
-    float light_risk;           // 光照风险
-    float gps_deform_risk;      // GPS形变风险
-} RiskAssessment;
-
 // 系统状态枚举
 typedef enum {
     SYSTEM_STATE_INIT = 0,      // 初始化状态
@@ -165,8 +129,6 @@ void LandslideMonitorShutdown(void);
 
 // 数据获取接口
 int GetLatestSensorData(SensorData *data);
-int GetLatestProcessedData(ProcessedData *data);
-int GetLatestRiskAssessment(RiskAssessment *assessment);
 int GetSystemStats(SystemStats *stats);
 
 // 系统状态管理
@@ -183,8 +145,6 @@ bool IsAlarmMuted(void);
 
 // 配置接口
 int SetSensorSampleRate(uint32_t rate_hz);
-int SetRiskThresholds(float tilt_threshold, float vibration_threshold, 
-                      float humidity_threshold, float light_threshold);
 
 // 错误处理
 const char* GetLastErrorMessage(void);
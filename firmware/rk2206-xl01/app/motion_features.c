@@ -0,0 +1,190 @@
+/*
+ * Motion Features Implementation
+ *
+ * |a| is taken per sample with an integer square root and kept in Q15 with
+ * 4 g full scale. A slow EW mean of |a| (2^-MOTION_MEAN_EW_SHIFT per sample)
+ * tracks gravity plus the sensor offset; the difference from it is the
+ * vibration signal. Its mean square is folded in per block with weight
+ * 2^-MOTION_VIBRATION_EW_SHIFT per sample, and its zero crossings are counted
+ * over MOTION_ZCR_WINDOW_MS. Tilt uses the CORDIC atan2 on raw counts, so no
+ * float transcendental runs per sample.
+ */
+
+#include "motion_features.h"
+#include <stddef.h>
+#include <string.h>
+#include "../utils/fixed_dsp.h"
+#include "../config/app_config.h"
+
+#ifndef MOTION_ACCEL_LSB_PER_G
+#define MOTION_ACCEL_LSB_PER_G 16384    // MPU6050 at +/-2 g
+#endif
+
+#ifndef MOTION_MEAN_EW_SHIFT
+#define MOTION_MEAN_EW_SHIFT 6U
+#endif
+
+#ifndef MOTION_VIBRATION_EW_SHIFT
+#define MOTION_VIBRATION_EW_SHIFT 3U
+#endif
+
+#ifndef MOTION_ZCR_HYSTERESIS_G
+#define MOTION_ZCR_HYSTERESIS_G 0.01f
+#endif
+
+#ifndef MOTION_ZCR_WINDOW_MS
+#define MOTION_ZCR_WINDOW_MS 10000U
+#endif
+
+// |a| is stored as raw-count magnitude >> 1: Q15 with 4 g full scale.
+#define MAG_G_PER_LSB (2.0f / (float)MOTION_ACCEL_LSB_PER_G)
+#define Q15_DEG_PER_LSB (180.0f / (float)FIXED_DSP_Q15_ONE)
+
+static int16_t g_last_magnitude = 0;
+static int32_t g_mean = 0;                  // EW mean of |a|, Q15 << 16
+static uint32_t g_mean_square = 0U;         // EW mean square of the AC signal, Q30
+static int8_t g_side = 0;
+static uint32_t g_window_crossings = 0U;
+static uint32_t g_window_start_ms = 0U;
+static float g_zero_crossing_hz = 0.0f;
+static uint32_t g_last_ms = 0U;
+static uint32_t g_samples = 0U;
+static uint8_t g_has = 0U;
+
+static uint32_t SumSquares(int32_t a, int32_t b)
+{
+    return (uint32_t)(a * a) + (uint32_t)(b * b);
+}
+
+void MotionFeatures_Init(void)
+{
+    g_last_magnitude = 0;
+    g_mean = 0;
+    g_mean_square = 0U;
+    g_side = 0;
+    g_window_crossings = 0U;
+    g_window_start_ms = 0U;
+    g_zero_crossing_hz = 0.0f;
+    g_last_ms = 0U;
+    g_samples = 0U;
+    g_has = 0U;
+}
+
+void MotionFeatures_TiltFromRaw(const int16_t accel[3], float *tilt_x_deg, float *tilt_y_deg)
+{
+    if (accel == NULL || tilt_x_deg == NULL || tilt_y_deg == NULL) {
+        return;
+    }
+
+    *tilt_x_deg = (float)FixedDsp_Atan2Q15(
+        accel[1],
+        (int32_t)FixedDsp_SqrtU32(SumSquares(accel[0], accel[2]))
+    ) * Q15_DEG_PER_LSB;
+    *tilt_y_deg = (float)FixedDsp_Atan2Q15(
+        -(int32_t)accel[0],
+        (int32_t)FixedDsp_SqrtU32(SumSquares(accel[1], accel[2]))
+    ) * Q15_DEG_PER_LSB;
+}
+
+static void PushChunk(const int16_t (*accel)[3], uint32_t count, uint32_t period_ms, MotionFeatures *out)
+{
+    int16_t magnitude[MOTION_FEATURES_BLOCK_SAMPLES];
+    int16_t work[MOTION_FEATURES_BLOCK_SAMPLES];
+    int16_t hysteresis = (int16_t)(MOTION_ZCR_HYSTERESIS_G / MAG_G_PER_LSB);
+    int32_t max_step = 0;
+    uint32_t block_square;
+    uint32_t i;
+
+    for (i = 0U; i < count; ++i) {
+        int32_t ax = accel[i][0];
+        int32_t ay = accel[i][1];
+        int32_t az = accel[i][2];
+
+        // Up to 3 * 2^30, still inside uint32
+        magnitude[i] = FixedDsp_SatQ15((int32_t)(FixedDsp_SqrtU32(SumSquares(ax, ay) + (uint32_t)(az * az)) >> 1));
+    }
+    if (!g_has) {
+        g_has = 1U;
+        g_last_magnitude = magnitude[0];
+        g_mean = (int32_t)magnitude[0] << 16;
+    }
+
+    // Largest step in this chunk, including the one from the previous chunk
+    FixedDsp_DiffQ15(magnitude, work, count, g_last_magnitude);
+    for (i = 0U; i < count; ++i) {
+        int32_t step = work[i] < 0 ? -(int32_t)work[i] : work[i];
+
+        if (step > max_step) {
+            max_step = step;
+        }
+    }
+    g_last_magnitude = magnitude[count - 1U];
+
+    // AC signal around the running mean; work is reused
+    for (i = 0U; i < count; ++i) {
+        g_mean += (((int32_t)magnitude[i] << 16) - g_mean) >> MOTION_MEAN_EW_SHIFT;
+        work[i] = FixedDsp_SatQ15((int32_t)magnitude[i] - (g_mean >> 16));
+    }
+
+    // A chunk of n samples moves the estimate n / 2^shift of the way, like n single steps
+    block_square = FixedDsp_MeanSquareQ15(work, count);
+    if (count >= (1U << MOTION_VIBRATION_EW_SHIFT) || g_samples == 0U) {
+        g_mean_square = block_square;
+    } else {
+        int64_t delta = (int64_t)block_square - (int64_t)g_mean_square;
+
+        g_mean_square = (uint32_t)((int64_t)g_mean_square + ((delta * (int64_t)count) >> MOTION_VIBRATION_EW_SHIFT));
+    }
+    g_samples += count;
+    g_window_crossings += FixedDsp_ZeroCrossingsQ15(work, count, hysteresis, &g_side);
+
+    if (period_ms > 0U && out->accel_change_rate < (float)max_step * MAG_G_PER_LSB * 1000.0f / (float)period_ms) {
+        out->accel_change_rate = (float)max_step * MAG_G_PER_LSB * 1000.0f / (float)period_ms;
+    }
+}
+
+int MotionFeatures_PushAccelRaw(const int16_t (*accel)[3], uint32_t count, uint32_t now_ms, MotionFeatures *out)
+{
+    uint32_t period_ms = 0U;
+    uint32_t done = 0U;
+    uint32_t window_ms;
+
+    if (accel == NULL || count == 0U || out == NULL) {
+        return -1;
+    }
+
+    memset(out, 0, sizeof(*out));
+    if (g_has) {
+        period_ms = (now_ms - g_last_ms) / count;
+    } else {
+        g_window_start_ms = now_ms;
+    }
+
+    while (done < count) {
+        uint32_t chunk = count - done;
+
+        if (chunk > MOTION_FEATURES_BLOCK_SAMPLES) {
+            chunk = MOTION_FEATURES_BLOCK_SAMPLES;
+        }
+        PushChunk(&accel[done], chunk, period_ms, out);
+        done += chunk;
+    }
+    g_last_ms = now_ms;
+
+    window_ms = now_ms - g_window_start_ms;
+    if (window_ms >= MOTION_ZCR_WINDOW_MS) {
+        g_zero_crossing_hz = (float)g_window_crossings * 1000.0f / (float)window_ms;
+        g_window_crossings = 0U;
+        g_window_start_ms = now_ms;
+    }
+
+    MotionFeatures_TiltFromRaw(accel[count - 1U], &out->tilt_x_deg, &out->tilt_y_deg);
+    out->accel_magnitude_g = (float)g_last_magnitude * MAG_G_PER_LSB;
+    out->vibration_rms_g = (float)FixedDsp_SqrtU32(g_mean_square) * MAG_G_PER_LSB;
+    out->zero_crossing_hz = g_zero_crossing_hz;
+    out->maturity = (float)g_samples / (float)(1U << MOTION_VIBRATION_EW_SHIFT);
+    if (out->maturity > 1.0f) {
+        out->maturity = 1.0f;
+    }
+    return 0;
+}
@@ -0,0 +1,54 @@
+/*
+ * Motion Features
+ * Fixed-point tilt, acceleration change rate and vibration features from raw
+ * MPU6050 accelerometer samples
+ */
+
+#ifndef APP_MOTION_FEATURES_H
+#define APP_MOTION_FEATURES_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef MOTION_FEATURES_BLOCK_SAMPLES
+#define MOTION_FEATURES_BLOCK_SAMPLES 32U   // Longer pushes are processed in chunks of this size
+#endif
+
+typedef struct {
+    float tilt_x_deg;           // atan2(ay, sqrt(ax^2 + az^2)) of the newest sample
+    float tilt_y_deg;           // atan2(-ax, sqrt(ay^2 + az^2)) of the newest sample
+    float accel_magnitude_g;    // |a| of the newest sample
+    float accel_change_rate;    // Largest |d|a|/dt| in this push (g/s), 0 without a previous sample
+    float vibration_rms_g;      // EW RMS of |a| around its slow EW mean (gravity and offset removed)
+    float zero_crossing_hz;     // Sign changes of that AC signal per second over the last window
+    float maturity;             // Samples seen / vibration EW length, for confidence weighting
+} MotionFeatures;
+
+/**
+ * Forget all history
+ */
+void MotionFeatures_Init(void);
+
+/**
+ * Fold count raw accelerometer samples (MPU6050 counts, x/y/z) into the
+ * features. now_ms is the time of the newest sample; earlier ones are taken
+ * as evenly spaced since the previous push. Integer arithmetic only, apart
+ * from converting the outputs. Call from a single task only.
+ * @return 0 on success, -1 on invalid arguments
+ */
+int MotionFeatures_PushAccelRaw(const int16_t (*accel)[3], uint32_t count, uint32_t now_ms, MotionFeatures *out);
+
+/**
+ * Tilt of one raw sample, same convention as MotionFeatures.tilt_*_deg.
+ * Stateless, so any task may call it.
+ */
+void MotionFeatures_TiltFromRaw(const int16_t accel[3], float *tilt_x_deg, float *tilt_y_deg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_MOTION_FEATURES_H
@@ -0,0 +1,558 @@
+/*
+ * Risk Engine Implementation
+ *
+ * Every factor keeps constant-size streaming state updated by its own sensor
+ * sample; the combined level is re-evaluated after each update:
+ * - tilt, soil moisture: latest value, ramping from half the alarm value
+ * - GPS rate: latest estimator rate against its alarm value
+ * - tilt rate, moisture trend: slope of an exponentially weighted least-squares
+ *   line (time constant RISK_*_TAU_S), shifted to the newest sample each step
+ * - rainfall: exponentially weighted mean of gauge increments per hour
+ * - vibration: RMS and change rate of |a| from the fixed-point motion features
+ * score = strongest factor + RISK_CORROBORATION * second strongest. A level is
+ * entered after RISK_RAISE_CONFIRM_SAMPLES consecutive evaluations above it
+ * and left only after the score has stayed RISK_HYSTERESIS below its entry
+ * point for RISK_CLEAR_HOLD_MS. Confidence is the weighted share of known
+ * factors with fresh, mature statistics.
+ */
+
+#include "risk_engine.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "los_mux.h"
+#include "../config/app_config.h"
+
+#ifndef RISK_TILT_ALARM_DEG
+#define RISK_TILT_ALARM_DEG 5.0f
+#endif
+
+#ifndef RISK_TILT_RATE_ALARM_DEG_PER_H
+#define RISK_TILT_RATE_ALARM_DEG_PER_H 0.5f
+#endif
+
+#ifndef RISK_MOISTURE_ALARM_PCT
+#define RISK_MOISTURE_ALARM_PCT 45.0f
+#endif
+
+#ifndef RISK_MOISTURE_TREND_ALARM_PCT_PER_H
+#define RISK_MOISTURE_TREND_ALARM_PCT_PER_H 3.0f
+#endif
+
+#ifndef RISK_RAIN_ALARM_MM_PER_H
+#define RISK_RAIN_ALARM_MM_PER_H 20.0f
+#endif
+
+#ifndef RISK_GPS_RATE_ALARM_MM_PER_DAY
+#define RISK_GPS_RATE_ALARM_MM_PER_DAY 10.0f
+#endif
+
+#ifndef RISK_VIBRATION_ALARM_G
+#define RISK_VIBRATION_ALARM_G 0.3f
+#endif
+
+#ifndef RISK_TILT_RATE_TAU_S
+#define RISK_TILT_RATE_TAU_S 3600.0f
+#endif
+
+#ifndef RISK_MOISTURE_TAU_S
+#define RISK_MOISTURE_TAU_S 21600.0f
+#endif
+
+#ifndef RISK_RAIN_TAU_S
+#define RISK_RAIN_TAU_S 3600.0f
+#endif
+
+#ifndef RISK_FACTOR_STALE_MS
+#define RISK_FACTOR_STALE_MS 600000U
+#endif
+
+#ifndef RISK_RAISE_CONFIRM_SAMPLES
+#define RISK_RAISE_CONFIRM_SAMPLES 2U
+#endif
+
+#ifndef RISK_CLEAR_HOLD_MS
+#define RISK_CLEAR_HOLD_MS 60000U
+#endif
+
+#define RISK_HYSTERESIS 0.1f
+#define RISK_CORROBORATION 0.25f
+#define RISK_SCORE_MAX 1.5f
+#define RISK_TREND_MIN_SPAN 0.1f        // Fraction of tau before a slope is scored
+#define RISK_LEVEL_ONSET 0.5f           // Level factors score from this fraction of their alarm value
+#define RISK_MS_PER_HOUR 3600000.0f
+
+typedef enum {
+    RISK_FACTOR_TILT = 0,
+    RISK_FACTOR_TILT_RATE,
+    RISK_FACTOR_MOISTURE,
+    RISK_FACTOR_MOISTURE_TREND,
+    RISK_FACTOR_RAIN,
+    RISK_FACTOR_GPS,
+    RISK_FACTOR_VIBRATION,
+    RISK_FACTOR_COUNT
+} RiskFactor;
+
+typedef struct {
+    float score;
+    float maturity;             // 0..1, how much history backs the score
+    uint32_t last_ms;
+    uint8_t seen;
+} RiskFactorState;
+
+// Weighted least squares with weights exp(-age / tau); t is in hours relative
+// to the newest sample, y relative to the first one for float precision.
+typedef struct {
+    float sw;
+    float st;
+    float sy;
+    float stt;
+    float sty;
+    float y0;
+    uint32_t first_ms;
+    uint32_t last_ms;
+    uint8_t has;
+} RiskTrend;
+
+typedef struct {
+    float last_total;
+    float rate_mm_h;
+    uint32_t first_ms;
+    uint32_t last_ms;
+    uint8_t has;
+} RiskRain;
+
+static const char *const g_factor_names[RISK_FACTOR_COUNT] = {
+    "tilt", "tilt_rate", "soil_moisture", "moisture_trend", "rain", "gps_deform", "vibration"
+};
+
+// Share of the confidence value; direct slope-movement evidence counts most.
+static const float g_factor_weights[RISK_FACTOR_COUNT] = {3.0f, 3.0f, 1.0f, 2.0f, 2.0f, 2.0f, 1.0f};
+
+static const float g_level_enter[RISK_LEVEL_CRITICAL + 1] = {0.0f, 0.35f, 0.6f, 0.85f, 1.2f};
+static const char *const g_level_names[RISK_LEVEL_CRITICAL + 1] = {"safe", "low", "medium", "high", "critical"};
+
+static RiskFactorState g_factors[RISK_FACTOR_COUNT];
+static RiskTrend g_tilt_x_trend;
+static RiskTrend g_tilt_y_trend;
+static RiskTrend g_moisture_trend;
+static RiskRain g_rain;
+static ProcessedData g_processed;
+static RiskAssessment g_assessment;
+static uint8_t g_has_assessment = 0;
+static uint32_t g_level_since_ms = 0;
+static uint32_t g_raise_count = 0;
+static uint32_t g_below_since_ms = 0;
+static uint8_t g_below_active = 0;
+
+static float g_tilt_alarm_deg = RISK_TILT_ALARM_DEG;
+static float g_vibration_alarm_g = RISK_VIBRATION_ALARM_G;
+static float g_moisture_alarm_pct = RISK_MOISTURE_ALARM_PCT;
+
+static uint32_t g_risk_mutex;
+static unsigned char g_risk_mutex_ready = 0;
+
+static void Lock(void)
+{
+    if (g_risk_mutex_ready) {
+        (void)LOS_MuxPend(g_risk_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+static void Unlock(void)
+{
+    if (g_risk_mutex_ready) {
+        (void)LOS_MuxPost(g_risk_mutex);
+    }
+}
+
+static float Clamp(float v, float lo, float hi)
+{
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static float Ratio(float value, float alarm)
+{
+    return alarm > 0.0f ? Clamp(value / alarm, 0.0f, RISK_SCORE_MAX) : 0.0f;
+}
+
+/* Level factors (tilt, moisture) have a normal non-zero operating point */
+static float Ramp(float value, float alarm)
+{
+    float onset = alarm * RISK_LEVEL_ONSET;
+
+    return alarm > onset ? Clamp((value - onset) / (alarm - onset), 0.0f, RISK_SCORE_MAX) : 0.0f;
+}
+
+static float HoursBetween(uint32_t from_ms, uint32_t to_ms)
+{
+    return (float)(uint32_t)(to_ms - from_ms) / RISK_MS_PER_HOUR;
+}
+
+static void SetFactor(RiskFactor factor, float score, float maturity, uint32_t now_ms)
+{
+    g_factors[factor].score = score;
+    g_factors[factor].maturity = Clamp(maturity, 0.0f, 1.0f);
+    g_factors[factor].last_ms = now_ms;
+    g_factors[factor].seen = 1;
+}
+
+static void Trend_Add(RiskTrend *trend, float y, uint32_t now_ms, float tau_s)
+{
+    const float tau_h = tau_s / 3600.0f;
+    float dt_h = 0.0f;
+    float decay;
+
+    if (trend->has) {
+        dt_h = HoursBetween(trend->last_ms, now_ms);
+        if (dt_h > 3.0f * tau_h) {
+            trend->has = 0;     // Gap longer than the memory: start over
+        }
+    }
+    if (!trend->has) {
+        memset(trend, 0, sizeof(*trend));
+        trend->y0 = y;
+        trend->first_ms = now_ms;
+        trend->has = 1;
+        dt_h = 0.0f;
+    }
+
+    // Move the time origin to now, then age every earlier point.
+    trend->stt += dt_h * dt_h * trend->sw - 2.0f * dt_h * trend->st;
+    trend->sty -= dt_h * trend->sy;
+    trend->st -= dt_h * trend->sw;
+    decay = expf(-dt_h / tau_h);
+    trend->sw *= decay;
+    trend->st *= decay;
+    trend->sy *= decay;
+    trend->stt *= decay;
+    trend->sty *= decay;
+
+    trend->sw += 1.0f;
+    trend->sy += y - trend->y0;
+    trend->last_ms = now_ms;
+}
+
+/* Slope per hour, 0 until two distinct times are in the window */
+static float Trend_Slope(const RiskTrend *trend)
+{
+    float denom = trend->sw * trend->stt - trend->st * trend->st;
+
+    if (!trend->has || denom <= 1e-9f) {
+        return 0.0f;
+    }
+    return (trend->sw * trend->sty - trend->st * trend->sy) / denom;
+}
+
+static float Trend_Span(const RiskTrend *trend, float tau_s)
+{
+    return trend->has ? HoursBetween(trend->first_ms, trend->last_ms) * 3600.0f / tau_s : 0.0f;
+}
+
+static RiskLevel LevelFor(float score)
+{
+    int level;
+
+    for (level = RISK_LEVEL_CRITICAL; level > RISK_LEVEL_SAFE; --level) {
+        if (score >= g_level_enter[level]) {
+            return (RiskLevel)level;
+        }
+    }
+    return RISK_LEVEL_SAFE;
+}
+
+static float FreshScore(RiskFactor factor, uint32_t now_ms)
+{
+    const RiskFactorState *state = &g_factors[factor];
+
+    if (!state->seen || (uint32_t)(now_ms - state->last_ms) > RISK_FACTOR_STALE_MS) {
+        return 0.0f;
+    }
+    return state->score;
+}
+
+static void Evaluate(uint32_t now_ms)
+{
+    float first = 0.0f;
+    float second = 0.0f;
+    float conf_num = 0.0f;
+    float conf_den = 0.0f;
+    float score;
+    int dominant = -1;
+    int i;
+    RiskLevel candidate;
+    RiskLevel level;
+
+    for (i = 0; i < RISK_FACTOR_COUNT; ++i) {
+        float s = FreshScore((RiskFactor)i, now_ms);
+
+        if (!g_factors[i].seen) {
+            continue;   // Sensor not fitted: neither evidence nor missing data
+        }
+        conf_den += g_factor_weights[i];
+        if ((uint32_t)(now_ms - g_factors[i].last_ms) <= RISK_FACTOR_STALE_MS) {
+            conf_num += g_factor_weights[i] * g_factors[i].maturity;
+        }
+        if (s > first) {
+            second = first;
+            first = s;
+            dominant = i;
+        } else if (s > second) {
+            second = s;
+        }
+    }
+    score = Clamp(first + RISK_CORROBORATION * second, 0.0f, RISK_SCORE_MAX);
+
+    if (!g_has_assessment) {
+        g_assessment.level = RISK_LEVEL_SAFE;
+        g_level_since_ms = now_ms;
+        g_has_assessment = 1;
+    }
+    level = g_assessment.level;
+    candidate = LevelFor(score);
+
+    if (candidate > level) {
+        g_below_active = 0;
+        if (++g_raise_count >= RISK_RAISE_CONFIRM_SAMPLES) {
+            level = candidate;
+            g_level_since_ms = now_ms;
+            g_raise_count = 0;
+        }
+    } else {
+        g_raise_count = 0;
+        if (level > RISK_LEVEL_SAFE && score < g_level_enter[level] - RISK_HYSTERESIS) {
+            if (!g_below_active) {
+                g_below_active = 1;
+                g_below_since_ms = now_ms;
+            } else if ((uint32_t)(now_ms - g_below_since_ms) >= RISK_CLEAR_HOLD_MS) {
+                level = LevelFor(score + RISK_HYSTERESIS);
+                g_level_since_ms = now_ms;
+                g_below_active = 0;
+            }
+        } else {
+            g_below_active = 0;
+        }
+    }
+
+    g_assessment.level = level;
+    g_assessment.score = score;
+    g_assessment.confidence = conf_den > 0.0f ? conf_num / conf_den : 0.0f;
+    g_assessment.duration_ms = now_ms - g_level_since_ms;
+    g_assessment.timestamp = now_ms;
+    g_assessment.tilt_risk = FreshScore(RISK_FACTOR_TILT, now_ms);
+    g_assessment.tilt_rate_risk = FreshScore(RISK_FACTOR_TILT_RATE, now_ms);
+    g_assessment.humidity_risk = FreshScore(RISK_FACTOR_MOISTURE, now_ms);
+    g_assessment.moisture_trend_risk = FreshScore(RISK_FACTOR_MOISTURE_TREND, now_ms);
+    g_assessment.rain_risk = FreshScore(RISK_FACTOR_RAIN, now_ms);
+    g_assessment.gps_deform_risk = FreshScore(RISK_FACTOR_GPS, now_ms);
+    g_assessment.vibration_risk = FreshScore(RISK_FACTOR_VIBRATION, now_ms);
+    g_assessment.light_risk = 0.0f;
+    snprintf(
+        g_assessment.description,
+        sizeof(g_assessment.description),
+        "%s%s%s",
+        g_level_names[level],
+        dominant >= 0 && level > RISK_LEVEL_SAFE ? ":" : "",
+        dominant >= 0 && level > RISK_LEVEL_SAFE ? g_factor_names[dominant] : ""
+    );
+    g_processed.timestamp = now_ms;
+}
+
+void RiskEngine_Init(void)
+{
+    if (!g_risk_mutex_ready) {
+        g_risk_mutex_ready = LOS_MuxCreate(&g_risk_mutex) == LOS_OK ? 1U : 0U;
+    }
+
+    Lock();
+    memset(g_factors, 0, sizeof(g_factors));
+    memset(&g_tilt_x_trend, 0, sizeof(g_tilt_x_trend));
+    memset(&g_tilt_y_trend, 0, sizeof(g_tilt_y_trend));
+    memset(&g_moisture_trend, 0, sizeof(g_moisture_trend));
+    memset(&g_rain, 0, sizeof(g_rain));
+    memset(&g_processed, 0, sizeof(g_processed));
+    memset(&g_assessment, 0, sizeof(g_assessment));
+    g_has_assessment = 0;
+    g_raise_count = 0;
+    g_below_active = 0;
+    g_tilt_alarm_deg = RISK_TILT_ALARM_DEG;
+    g_vibration_alarm_g = RISK_VIBRATION_ALARM_G;
+    g_moisture_alarm_pct = RISK_MOISTURE_ALARM_PCT;
+    Unlock();
+}
+
+void RiskEngine_ObserveTilt(float x_deg, float y_deg, uint32_t now_ms)
+{
+    float peak = fabsf(x_deg) > fabsf(y_deg) ? fabsf(x_deg) : fabsf(y_deg);
+    float sx;
+    float sy;
+    float rate;
+    float span;
+
+    Lock();
+    Trend_Add(&g_tilt_x_trend, x_deg, now_ms, RISK_TILT_RATE_TAU_S);
+    Trend_Add(&g_tilt_y_trend, y_deg, now_ms, RISK_TILT_RATE_TAU_S);
+    sx = Trend_Slope(&g_tilt_x_trend);
+    sy = Trend_Slope(&g_tilt_y_trend);
+    rate = sqrtf(sx * sx + sy * sy);
+    span = Trend_Span(&g_tilt_x_trend, RISK_TILT_RATE_TAU_S);
+
+    g_processed.angle_magnitude = sqrtf(x_deg * x_deg + y_deg * y_deg);
+    g_processed.angle_change_rate = rate;
+    // Same per-axis peak as the legacy warning flag.
+    SetFactor(RISK_FACTOR_TILT, Ramp(peak, g_tilt_alarm_deg), 1.0f, now_ms);
+    SetFactor(
+        RISK_FACTOR_TILT_RATE,
+        span >= RISK_TREND_MIN_SPAN ? Ratio(rate, RISK_TILT_RATE_ALARM_DEG_PER_H) : 0.0f,
+        span,
+        now_ms
+    );
+    Evaluate(now_ms);
+    Unlock();
+}
+
+void RiskEngine_ObserveMotion(const MotionFeatures *features, uint32_t now_ms)
+{
+    if (features == NULL) {
+        return;
+    }
+
+    Lock();
+    g_processed.accel_magnitude = features->accel_magnitude_g;
+    g_processed.accel_change_rate = features->accel_change_rate;
+    g_processed.vibration_intensity = features->vibration_rms_g;
+    g_processed.vibration_zcr_hz = features->zero_crossing_hz;
+    SetFactor(
+        RISK_FACTOR_VIBRATION,
+        Ratio(features->vibration_rms_g, g_vibration_alarm_g),
+        features->maturity,
+        now_ms
+    );
+    Evaluate(now_ms);
+    Unlock();
+}
+
+void RiskEngine_ObserveSoilMoisture(float moisture_pct, uint32_t now_ms)
+{
+    float trend;
+    float span;
+
+    Lock();
+    Trend_Add(&g_moisture_trend, moisture_pct, now_ms, RISK_MOISTURE_TAU_S);
+    trend = Trend_Slope(&g_moisture_trend);
+    span = Trend_Span(&g_moisture_trend, RISK_MOISTURE_TAU_S);
+
+    g_processed.humidity_trend = trend;
+    SetFactor(RISK_FACTOR_MOISTURE, Ramp(moisture_pct, g_moisture_alarm_pct), 1.0f, now_ms);
+    // Only wetting counts; drying slopes are not a precursor.
+    SetFactor(
+        RISK_FACTOR_MOISTURE_TREND,
+        span >= RISK_TREND_MIN_SPAN ? Ratio(trend, RISK_MOISTURE_TREND_ALARM_PCT_PER_H) : 0.0f,
+        span,
+        now_ms
+    );
+    Evaluate(now_ms);
+    Unlock();
+}
+
+void RiskEngine_ObserveRainTotal(float total_mm, uint32_t now_ms)
+{
+    float dt_h;
+    float increment;
+    float decay;
+
+    Lock();
+    if (!g_rain.has) {
+        g_rain.has = 1;
+        g_rain.first_ms = now_ms;
+        g_rain.rate_mm_h = 0.0f;
+    } else {
+        dt_h = HoursBetween(g_rain.last_ms, now_ms);
+        // A smaller total means the gauge counter was reset, not negative rain.
+        increment = total_mm >= g_rain.last_total ? total_mm - g_rain.last_total : 0.0f;
+        if (dt_h > 0.0f) {
+            decay = expf(-dt_h * 3600.0f / RISK_RAIN_TAU_S);
+            g_rain.rate_mm_h = decay * g_rain.rate_mm_h + (1.0f - decay) * (increment / dt_h);
+        } else {
+            // Same-instant increment: spread it over one time constant.
+            g_rain.rate_mm_h += increment * 3600.0f / RISK_RAIN_TAU_S;
+        }
+    }
+    g_rain.last_total = total_mm;
+    g_rain.last_ms = now_ms;
+
+    g_processed.rain_intensity = g_rain.rate_mm_h;
+    SetFactor(
+        RISK_FACTOR_RAIN,
+        Ratio(g_rain.rate_mm_h, RISK_RAIN_ALARM_MM_PER_H),
+        HoursBetween(g_rain.first_ms, now_ms) * 3600.0f / RISK_RAIN_TAU_S,
+        now_ms
+    );
+    Evaluate(now_ms);
+    Unlock();
+}
+
+void RiskEngine_ObserveGpsRate(float mm_per_day, uint32_t now_ms)
+{
+    Lock();
+    g_processed.gps_rate = mm_per_day;
+    // The estimator only reports a rate once its regression is established.
+    SetFactor(RISK_FACTOR_GPS, Ratio(mm_per_day, RISK_GPS_RATE_ALARM_MM_PER_DAY), 1.0f, now_ms);
+    Evaluate(now_ms);
+    Unlock();
+}
+
+int GetLatestRiskAssessment(RiskAssessment *assessment)
+{
+    int ret = -1;
+
+    if (assessment == NULL) {
+        return -1;
+    }
+    Lock();
+    if (g_has_assessment) {
+        *assessment = g_assessment;
+        ret = 0;
+    }
+    Unlock();
+    return ret;
+}
+
+int GetLatestProcessedData(ProcessedData *data)
+{
+    int ret = -1;
+
+    if (data == NULL) {
+        return -1;
+    }
+    Lock();
+    if (g_has_assessment) {
+        *data = g_processed;
+        ret = 0;
+    }
+    Unlock();
+    return ret;
+}
+
+int SetRiskThresholds(float tilt_threshold, float vibration_threshold,
+                      float humidity_threshold, float light_threshold)
+{
+    int accepted = 0;
+
+    (void)light_threshold;
+    Lock();
+    if (tilt_threshold > 0.0f) {
+        g_tilt_alarm_deg = tilt_threshold;
+        accepted++;
+    }
+    if (vibration_threshold > 0.0f) {
+        g_vibration_alarm_g = vibration_threshold;
+        accepted++;
+    }
+    if (humidity_threshold > 0.0f) {
+        g_moisture_alarm_pct = humidity_threshold;
+        accepted++;
+    }
+    Unlock();
+    return accepted > 0 ? 0 : -1;
+}
@@ -0,0 +1,96 @@
+/*
+ * Risk Engine
+ * Incremental per-factor landslide risk scoring driven by the sample stream
+ */
+
+#ifndef APP_RISK_ENGINE_H
+#define APP_RISK_ENGINE_H
+
+#include <stdint.h>
+#include "motion_features.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 处理后的数据结构（由各传感器样本流增量更新）
+typedef struct {
+    float accel_magnitude;      // 加速度幅值 (g)
+    float accel_change_rate;    // 加速度变化率 (g/s)
+    float angle_magnitude;      // 倾角幅值 (度)
+    float angle_change_rate;    // 倾角变化率 (度/小时，指数加权回归斜率)
+    float humidity_trend;       // 土壤湿度变化趋势 (%/小时)
+    float light_change_rate;    // 光照变化率（本机无光照传感器，恒为 0）
+    float vibration_intensity;  // 振动强度 (g RMS，去除重力与零偏后的 |a|)
+    uint32_t timestamp;         // 时间戳 (ms)
+    float rain_intensity;       // 降雨强度 (mm/小时)
+    float gps_rate;             // GNSS 水平位移速率 (mm/天)
+    float vibration_zcr_hz;     // 振动过零率 (次/秒)
+} ProcessedData;
+
+// 风险等级枚举
+typedef enum {
+    RISK_LEVEL_SAFE = 0,        // 安全
+    RISK_LEVEL_LOW = 1,         // 低风险
+    RISK_LEVEL_MEDIUM = 2,      // 中风险
+    RISK_LEVEL_HIGH = 3,        // 高风险
+    RISK_LEVEL_CRITICAL = 4     // 危急
+} RiskLevel;
+
+// 风险评估结果；各因子 1.0 表示达到该因子的报警阈值，上限 1.5
+typedef struct {
+    RiskLevel level;            // 风险等级
+    float confidence;           // 置信度 (0.0-1.0)
+    uint32_t duration_ms;       // 持续时间 (ms)
+    char description[64];       // 风险描述
+    uint32_t timestamp;         // 评估时间戳
+
+    // 各项风险因子
+    float tilt_risk;            // 倾斜风险
+    float vibration_risk;       // 振动风险
+    float humidity_risk;        // 湿度风险（土壤湿度绝对值）
+    float light_risk;           // 光照风险（无传感器，恒为 0）
+    float gps_deform_risk;      // GPS形变风险
+    float tilt_rate_risk;       // 倾角变化率风险
+    float moisture_trend_risk;  // 土壤湿度上升趋势风险
+    float rain_risk;            // 降雨强度风险
+    float score;                // 综合得分
+} RiskAssessment;
+
+/**
+ * Reset all streaming statistics and thresholds to the app_config defaults
+ */
+void RiskEngine_Init(void);
+
+/**
+ * Feed one sample at the time it was read. Each call updates that factor's
+ * statistics and re-evaluates the level in O(1).
+ */
+void RiskEngine_ObserveTilt(float x_deg, float y_deg, uint32_t now_ms);
+void RiskEngine_ObserveMotion(const MotionFeatures *features, uint32_t now_ms);
+void RiskEngine_ObserveSoilMoisture(float moisture_pct, uint32_t now_ms);
+void RiskEngine_ObserveRainTotal(float total_mm, uint32_t now_ms);
+void RiskEngine_ObserveGpsRate(float mm_per_day, uint32_t now_ms);
+
+/**
+ * Latest evaluation / derived features
+ * @return 0 on success, -1 before the first sample
+ */
+int GetLatestRiskAssessment(RiskAssessment *assessment);
+int GetLatestProcessedData(ProcessedData *data);
+
+/**
+ * Override the alarm thresholds (score 1.0) of the level factors: tilt in
+ * degrees, vibration in g RMS, soil moisture in %. light_threshold is
+ * accepted for API compatibility and ignored. Non-positive values keep the
+ * current threshold.
+ * @return 0 on success, -1 if every argument was rejected
+ */
+int SetRiskThresholds(float tilt_threshold, float vibration_threshold,
+                      float humidity_threshold, float light_threshold);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_RISK_ENGINE_H
@@ -0,0 +1,377 @@
+#include "sample_history.h"
+#include <stdio.h>
+#include <string.h>
+#include "los_mux.h"
+
+typedef struct {
+    SampleHistoryBlock blocks[SAMPLE_HISTORY_BLOCKS_PER_CHANNEL];
+    uint32_t head_seq;      // Block currently being filled
+    uint8_t has_block;
+    uint8_t closed;         // Head block handed off; next sample starts a new one
+    int32_t last_value;
+    uint32_t last_ms;
+} SampleHistoryRing;
+
+typedef struct {
+    const char *name;
+    int scale;
+} SampleHistoryChannelInfo;
+
+// Resolution matches what the envelope reports for the same metric.
+static const SampleHistoryChannelInfo g_channel_info[SAMPLE_HISTORY_CHANNEL_COUNT] = {
+    {"tilt_x_deg", 100},
+    {"tilt_y_deg", 100},
+    {"tilt_z_deg", 100},
+    {"soil_moisture_pct", 10},
+    {"soil_temperature_c", 10},
+};
+
+static SampleHistoryRing g_rings[SAMPLE_HISTORY_CHANNEL_COUNT];
+static SampleHistoryBlockHandler g_closed_block_handler = NULL;
+static uint32_t g_history_mutex;
+static unsigned char g_history_mutex_ready = 0;
+
+static void Lock(void)
+{
+    if (g_history_mutex_ready) {
+        (void)LOS_MuxPend(g_history_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+static void Unlock(void)
+{
+    if (g_history_mutex_ready) {
+        (void)LOS_MuxPost(g_history_mutex);
+    }
+}
+
+static uint32_t OldestSeq(const SampleHistoryRing *ring)
+{
+    return ring->head_seq >= SAMPLE_HISTORY_BLOCKS_PER_CHANNEL - 1U
+        ? ring->head_seq - (SAMPLE_HISTORY_BLOCKS_PER_CHANNEL - 1U)
+        : 0U;
+}
+
+static const SampleHistoryBlock *BlockAt(const SampleHistoryRing *ring, uint32_t seq)
+{
+    return &ring->blocks[seq % SAMPLE_HISTORY_BLOCKS_PER_CHANNEL];
+}
+
+static uint32_t BlockEndMs(const SampleHistoryBlock *block)
+{
+    uint32_t t = block->t0_ms;
+    uint16_t i;
+
+    for (i = 1; i < block->count; ++i) {
+        t += block->deltas[i - 1U].dt_ms;
+    }
+    return t;
+}
+
+static int32_t ScaleValue(SampleHistoryChannel channel, float value)
+{
+    float scaled = value * (float)g_channel_info[channel].scale;
+
+    if (scaled > 2147483000.0f) {
+        return 2147483000;
+    }
+    if (scaled < -2147483000.0f) {
+        return -2147483000;
+    }
+    return (int32_t)(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+void SampleHistory_Init(void)
+{
+    memset(g_rings, 0, sizeof(g_rings));
+    if (!g_history_mutex_ready) {
+        g_history_mutex_ready = LOS_MuxCreate(&g_history_mutex) == LOS_OK ? 1U : 0U;
+    }
+}
+
+void SampleHistory_SetClosedBlockHandler(SampleHistoryBlockHandler handler)
+{
+    Lock();
+    g_closed_block_handler = handler;
+    Unlock();
+}
+
+static void CloseHead(SampleHistoryRing *ring)
+{
+    if (!ring->has_block || ring->closed) {
+        return;
+    }
+    ring->closed = 1;
+    if (g_closed_block_handler != NULL) {
+        g_closed_block_handler(BlockAt(ring, ring->head_seq));
+    }
+}
+
+void SampleHistory_CloseOpenBlocks(void)
+{
+    unsigned int ch;
+
+    Lock();
+    for (ch = 0; ch < SAMPLE_HISTORY_CHANNEL_COUNT; ++ch) {
+        CloseHead(&g_rings[ch]);
+    }
+    Unlock();
+}
+
+void SampleHistory_Append(SampleHistoryChannel channel, float value, uint32_t now_ms)
+{
+    SampleHistoryRing *ring;
+    SampleHistoryBlock *block;
+    int32_t scaled;
+    int32_t dv;
+    uint32_t dt;
+
+    if ((unsigned int)channel >= SAMPLE_HISTORY_CHANNEL_COUNT) {
+        return;
+    }
+
+    scaled = ScaleValue(channel, value);
+    ring = &g_rings[channel];
+
+    Lock();
+    block = &ring->blocks[ring->head_seq % SAMPLE_HISTORY_BLOCKS_PER_CHANNEL];
+    dv = scaled - ring->last_value;
+    dt = now_ms - ring->last_ms;
+    if (!ring->has_block ||
+        ring->closed ||
+        block->count >= SAMPLE_HISTORY_BLOCK_SAMPLES ||
+        dv > INT16_MAX || dv < INT16_MIN ||
+        dt > UINT16_MAX) {
+        if (ring->has_block) {
+            CloseHead(ring);
+            ring->head_seq++;
+        }
+        ring->has_block = 1;
+        ring->closed = 0;
+        block = &ring->blocks[ring->head_seq % SAMPLE_HISTORY_BLOCKS_PER_CHANNEL];
+        block->seq = ring->head_seq;
+        block->t0_ms = now_ms;
+        block->v0 = scaled;
+        block->channel = (uint8_t)channel;
+        block->reserved = 0;
+        block->count = 1;
+    } else {
+        block->deltas[block->count - 1U].dv = (int16_t)dv;
+        block->deltas[block->count - 1U].dt_ms = (uint16_t)dt;
+        block->count++;
+    }
+    ring->last_value = scaled;
+    ring->last_ms = now_ms;
+    Unlock();
+}
+
+const char *SampleHistory_ChannelName(SampleHistoryChannel channel)
+{
+    return (unsigned int)channel < SAMPLE_HISTORY_CHANNEL_COUNT ? g_channel_info[channel].name : "";
+}
+
+int SampleHistory_ChannelScale(SampleHistoryChannel channel)
+{
+    return (unsigned int)channel < SAMPLE_HISTORY_CHANNEL_COUNT ? g_channel_info[channel].scale : 1;
+}
+
+int SampleHistory_BeginFetch(
+    SampleHistoryCursor *cursor,
+    uint32_t channel_mask,
+    uint32_t since_ms,
+    uint32_t *out_blocks,
+    uint32_t *out_samples
+)
+{
+    uint32_t blocks = 0;
+    uint32_t samples = 0;
+    unsigned int ch;
+
+    if (cursor == NULL || (channel_mask & SAMPLE_HISTORY_MASK_ALL) == 0U) {
+        return -1;
+    }
+
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->channel_mask = channel_mask & SAMPLE_HISTORY_MASK_ALL;
+    cursor->since_ms = since_ms;
+    cursor->channel = SAMPLE_HISTORY_CHANNEL_COUNT;
+
+    Lock();
+    for (ch = 0; ch < SAMPLE_HISTORY_CHANNEL_COUNT; ++ch) {
+        const SampleHistoryRing *ring = &g_rings[ch];
+        uint32_t seq;
+
+        if ((cursor->channel_mask & (1U << ch)) == 0U || !ring->has_block) {
+            continue;
+        }
+        cursor->has_end[ch] = 1;
+        cursor->end_seq[ch] = ring->head_seq;
+        for (seq = OldestSeq(ring); seq <= ring->head_seq; ++seq) {
+            const SampleHistoryBlock *block = BlockAt(ring, seq);
+
+            if ((int32_t)(BlockEndMs(block) - since_ms) >= 0) {
+                blocks++;
+                samples += block->count;
+            }
+        }
+        if (cursor->channel == SAMPLE_HISTORY_CHANNEL_COUNT) {
+            cursor->channel = (uint8_t)ch;
+            cursor->next_seq = OldestSeq(ring);
+        }
+    }
+    Unlock();
+
+    cursor->done = (uint8_t)(cursor->channel == SAMPLE_HISTORY_CHANNEL_COUNT);
+    if (out_blocks != NULL) {
+        *out_blocks = blocks;
+    }
+    if (out_samples != NULL) {
+        *out_samples = samples;
+    }
+    return 0;
+}
+
+static void AdvanceChannel(SampleHistoryCursor *cursor)
+{
+    unsigned int ch;
+
+    for (ch = (unsigned int)cursor->channel + 1U; ch < SAMPLE_HISTORY_CHANNEL_COUNT; ++ch) {
+        if (cursor->has_end[ch]) {
+            cursor->channel = (uint8_t)ch;
+            cursor->next_seq = OldestSeq(&g_rings[ch]);
+            return;
+        }
+    }
+    cursor->done = 1;
+}
+
+static int Base64Encode(const uint8_t *data, int len, char *output, int output_size)
+{
+    static const char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int out = 0;
+    int i;
+
+    if (((len + 2) / 3) * 4 >= output_size) {
+        return -1;
+    }
+    for (i = 0; i < len; i += 3) {
+        uint32_t triple = (uint32_t)data[i] << 16;
+        int remain = len - i;
+
+        if (remain > 1) {
+            triple |= (uint32_t)data[i + 1] << 8;
+        }
+        if (remain > 2) {
+            triple |= data[i + 2];
+        }
+        output[out++] = alphabet[(triple >> 18) & 0x3FU];
+        output[out++] = alphabet[(triple >> 12) & 0x3FU];
+        output[out++] = remain > 1 ? alphabet[(triple >> 6) & 0x3FU] : '=';
+        output[out++] = remain > 2 ? alphabet[triple & 0x3FU] : '=';
+    }
+    output[out] = '\0';
+    return out;
+}
+
+// Serialize explicitly so the wire format does not depend on struct layout or endianness.
+int SampleHistory_FormatBlock(const SampleHistoryBlock *block, char *output, int output_size)
+{
+    uint8_t raw[(SAMPLE_HISTORY_BLOCK_SAMPLES - 1U) * 4U];
+    int raw_len = 0;
+    int head;
+    int body;
+    uint16_t i;
+
+    if (block == NULL || output == NULL || block->channel >= SAMPLE_HISTORY_CHANNEL_COUNT ||
+        block->count == 0U || block->count > SAMPLE_HISTORY_BLOCK_SAMPLES) {
+        return -1;
+    }
+
+    for (i = 1; i < block->count; ++i) {
+        const SampleHistoryDelta *d = &block->deltas[i - 1U];
+        uint16_t dv = (uint16_t)d->dv;
+
+        raw[raw_len++] = (uint8_t)(dv & 0xFFU);
+        raw[raw_len++] = (uint8_t)(dv >> 8);
+        raw[raw_len++] = (uint8_t)(d->dt_ms & 0xFFU);
+        raw[raw_len++] = (uint8_t)(d->dt_ms >> 8);
+    }
+
+    head = snprintf(
+        output,
+        (size_t)output_size,
+        "{\"ch\":\"%s\",\"seq\":%u,\"scale\":%d,\"t0_ms\":%u,\"v0\":%ld,\"n\":%u,\"d\":\"",
+        g_channel_info[block->channel].name,
+        (unsigned int)block->seq,
+        g_channel_info[block->channel].scale,
+        (unsigned int)block->t0_ms,
+        (long)block->v0,
+        (unsigned int)block->count
+    );
+    if (head < 0 || head >= output_size) {
+        return -1;
+    }
+    body = Base64Encode(raw, raw_len, output + head, output_size - head);
+    if (body < 0 || head + body + 2 >= output_size) {
+        return -1;
+    }
+    output[head + body] = '"';
+    output[head + body + 1] = '}';
+    output[head + body + 2] = '\0';
+    return head + body + 2;
+}
+
+int SampleHistory_EncodeNext(SampleHistoryCursor *cursor, char *output, int output_size)
+{
+    int len = 0;
+
+    if (cursor == NULL || output == NULL || output_size <= 0) {
+        return -1;
+    }
+    output[0] = '\0';
+
+    Lock();
+    while (!cursor->done) {
+        const SampleHistoryRing *ring = &g_rings[cursor->channel];
+        const SampleHistoryBlock *block;
+        int written;
+
+        if ((int32_t)(cursor->next_seq - cursor->end_seq[cursor->channel]) > 0) {
+            AdvanceChannel(cursor);
+            continue;
+        }
+        if ((int32_t)(cursor->next_seq - OldestSeq(ring)) < 0) {
+            // Overwritten while earlier frames were on the air.
+            cursor->lost_blocks += OldestSeq(ring) - cursor->next_seq;
+            cursor->next_seq = OldestSeq(ring);
+            continue;
+        }
+
+        block = BlockAt(ring, cursor->next_seq);
+        if ((int32_t)(BlockEndMs(block) - cursor->since_ms) < 0) {
+            cursor->next_seq++;
+            continue;
+        }
+
+        written = SampleHistory_FormatBlock(block, output + len + (len > 0 ? 1 : 0), output_size - len - (len > 0 ? 1 : 0));
+        if (written < 0) {
+            output[len] = '\0';
+            break;
+        }
+        if (len > 0) {
+            output[len] = ',';
+            len++;
+        }
+        len += written;
+        cursor->next_seq++;
+    }
+    Unlock();
+
+    if (len == 0 && !cursor->done) {
+        return -1;
+    }
+    if (len > 0) {
+        cursor->part++;
+    }
+    return len;
+}
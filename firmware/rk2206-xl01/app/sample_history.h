@@ -0,0 +1,128 @@
+/*
+ * Sample History
+ * Per-channel RAM rings of delta-encoded, scaled-int16 sample blocks
+ */
+
+#ifndef APP_SAMPLE_HISTORY_H
+#define APP_SAMPLE_HISTORY_H
+
+#include <stdint.h>
+#include "../config/app_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SAMPLE_HISTORY_BLOCK_SAMPLES
+#define SAMPLE_HISTORY_BLOCK_SAMPLES 64U
+#endif
+
+#ifndef SAMPLE_HISTORY_BLOCKS_PER_CHANNEL
+#define SAMPLE_HISTORY_BLOCKS_PER_CHANNEL 8U
+#endif
+
+typedef enum {
+    SAMPLE_HISTORY_TILT_X = 0,
+    SAMPLE_HISTORY_TILT_Y,
+    SAMPLE_HISTORY_TILT_Z,
+    SAMPLE_HISTORY_SOIL_MOISTURE,
+    SAMPLE_HISTORY_SOIL_TEMPERATURE,
+    SAMPLE_HISTORY_CHANNEL_COUNT
+} SampleHistoryChannel;
+
+#define SAMPLE_HISTORY_MASK_TILT ((1U << SAMPLE_HISTORY_TILT_X) | (1U << SAMPLE_HISTORY_TILT_Y) | (1U << SAMPLE_HISTORY_TILT_Z))
+#define SAMPLE_HISTORY_MASK_SOIL ((1U << SAMPLE_HISTORY_SOIL_MOISTURE) | (1U << SAMPLE_HISTORY_SOIL_TEMPERATURE))
+#define SAMPLE_HISTORY_MASK_ALL  ((1U << SAMPLE_HISTORY_CHANNEL_COUNT) - 1U)
+
+typedef struct {
+    int16_t dv;         // Change from the previous sample, channel units
+    uint16_t dt_ms;     // Time since the previous sample
+} SampleHistoryDelta;
+
+/*
+ * A block restarts from an absolute value, so evicting the oldest block never
+ * breaks decoding. A new block is also opened when a delta does not fit 16 bits.
+ */
+typedef struct {
+    uint32_t seq;       // Per-channel block number, increases without reuse
+    uint32_t t0_ms;     // Uptime ms of the first sample
+    int32_t v0;         // First sample, channel units
+    uint8_t channel;    // SampleHistoryChannel
+    uint8_t reserved;
+    uint16_t count;     // Samples including v0
+    SampleHistoryDelta deltas[SAMPLE_HISTORY_BLOCK_SAMPLES - 1U];
+} SampleHistoryBlock;
+
+typedef struct {
+    uint32_t channel_mask;
+    uint32_t since_ms;
+    uint32_t end_seq[SAMPLE_HISTORY_CHANNEL_COUNT];     // Last block at BeginFetch
+    uint32_t next_seq;
+    uint8_t has_end[SAMPLE_HISTORY_CHANNEL_COUNT];
+    uint8_t channel;
+    uint8_t done;
+    uint16_t part;
+    uint32_t lost_blocks;   // Overwritten before they could be sent
+} SampleHistoryCursor;
+
+/* Called with the history lock held; must not call back into SampleHistory. */
+typedef void (*SampleHistoryBlockHandler)(const SampleHistoryBlock *block);
+
+void SampleHistory_Init(void);
+
+/**
+ * Receive every block once it stops growing (NULL to detach)
+ */
+void SampleHistory_SetClosedBlockHandler(SampleHistoryBlockHandler handler);
+
+/**
+ * Close every partly filled block now, e.g. before a planned reboot, so the
+ * closed-block handler sees them. The next sample of each channel opens a
+ * new block.
+ */
+void SampleHistory_CloseOpenBlocks(void);
+
+/**
+ * Record one sample. Cheap enough for the sensor path: O(1), one lock.
+ */
+void SampleHistory_Append(SampleHistoryChannel channel, float value, uint32_t now_ms);
+
+/**
+ * Channel name (matches the telemetry metric key) and units per 1.0 of value
+ */
+const char *SampleHistory_ChannelName(SampleHistoryChannel channel);
+int SampleHistory_ChannelScale(SampleHistoryChannel channel);
+
+/**
+ * Snapshot which blocks a fetch will cover: every block of the masked
+ * channels whose last sample is at or after since_ms.
+ * @return 0 on success, -1 on bad arguments
+ */
+int SampleHistory_BeginFetch(
+    SampleHistoryCursor *cursor,
+    uint32_t channel_mask,
+    uint32_t since_ms,
+    uint32_t *out_blocks,
+    uint32_t *out_samples
+);
+
+/**
+ * Write as many whole blocks as fit as comma-separated JSON objects:
+ * {"ch":..,"seq":..,"scale":..,"t0_ms":..,"v0":..,"n":..,"d":"<base64>"}
+ * where d holds n-1 little-endian {int16 dv, uint16 dt_ms} records.
+ * @return length written (0 once the cursor is done), -1 if output cannot
+ *         hold even one block
+ */
+int SampleHistory_EncodeNext(SampleHistoryCursor *cursor, char *output, int output_size);
+
+/**
+ * Write one block as the JSON object used by SampleHistory_EncodeNext
+ * @return length written, -1 if output is too small
+ */
+int SampleHistory_FormatBlock(const SampleHistoryBlock *block, char *output, int output_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SAMPLE_HISTORY_H
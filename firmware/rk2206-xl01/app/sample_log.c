@@ -0,0 +1,384 @@
+#include "sample_log.h"
+#include <stdio.h>
+#include <string.h>
+#include "los_mux.h"
+#include "los_tick.h"
+#include "../utils/time_discipline.h"
+
+#define SAMPLE_LOG_RECORD_VERSION 1U
+
+typedef struct {
+    uint16_t size;
+    uint8_t data[SAMPLE_LOG_RECORD_MAX_BYTES];
+} SampleLogQueued;
+
+static FlashLog g_log;
+static unsigned char g_log_mounted = 0;
+static uint16_t g_boot = 1;
+
+// Two locks: the queue lock is taken under the history lock and is never held
+// across flash I/O; the flash lock serializes the writer and fetch readers.
+static uint32_t g_queue_mutex;
+static unsigned char g_queue_mutex_ready = 0;
+static uint32_t g_flash_mutex;
+static unsigned char g_flash_mutex_ready = 0;
+
+static SampleLogQueued g_queue[SAMPLE_LOG_QUEUE_BLOCKS];
+static uint32_t g_queue_head = 0;     // Next slot to write to flash
+static uint32_t g_queue_count = 0;
+static uint32_t g_dropped_blocks = 0;
+
+static void QueueLock(void)
+{
+    if (g_queue_mutex_ready) {
+        (void)LOS_MuxPend(g_queue_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+static void QueueUnlock(void)
+{
+    if (g_queue_mutex_ready) {
+        (void)LOS_MuxPost(g_queue_mutex);
+    }
+}
+
+static void FlashLock(void)
+{
+    if (g_flash_mutex_ready) {
+        (void)LOS_MuxPend(g_flash_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+static void FlashUnlock(void)
+{
+    if (g_flash_mutex_ready) {
+        (void)LOS_MuxPost(g_flash_mutex);
+    }
+}
+
+static void PutLe16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFFU);
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void PutLe32(uint8_t *p, uint32_t v)
+{
+    PutLe16(p, (uint16_t)(v & 0xFFFFU));
+    PutLe16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t GetLe16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t GetLe32(const uint8_t *p)
+{
+    return (uint32_t)GetLe16(p) | ((uint32_t)GetLe16(p + 2) << 16);
+}
+
+static uint32_t NowMs(void)
+{
+    return (uint32_t)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U));
+}
+
+static uint16_t SerializeBlock(const SampleHistoryBlock *block, uint8_t *out)
+{
+    int64_t utc_ms = 0;
+    uint16_t size = SAMPLE_LOG_RECORD_HEADER_BYTES;
+    uint16_t i;
+
+    if (TimeDiscipline_NowUtcMs(&utc_ms) == 0) {
+        utc_ms -= (int64_t)(uint32_t)(NowMs() - block->t0_ms);
+    } else {
+        utc_ms = 0;
+    }
+
+    out[0] = SAMPLE_LOG_RECORD_VERSION;
+    out[1] = block->channel;
+    PutLe16(out + 2, block->count);
+    PutLe16(out + 4, g_boot);
+    PutLe16(out + 6, 0);
+    PutLe32(out + 8, block->seq);
+    PutLe32(out + 12, block->t0_ms);
+    PutLe32(out + 16, (uint32_t)block->v0);
+    PutLe32(out + 20, (uint32_t)((uint64_t)utc_ms & 0xFFFFFFFFU));
+    PutLe32(out + 24, (uint32_t)((uint64_t)utc_ms >> 32));
+    for (i = 1; i < block->count; ++i) {
+        PutLe16(out + size, (uint16_t)block->deltas[i - 1U].dv);
+        PutLe16(out + size + 2, block->deltas[i - 1U].dt_ms);
+        size += 4U;
+    }
+    return size;
+}
+
+/* @return 0 on success, -1 if the record is not a version this build understands */
+static int DeserializeBlock(
+    const uint8_t *data,
+    uint16_t size,
+    SampleHistoryBlock *block,
+    uint16_t *out_boot,
+    int64_t *out_utc_ms
+)
+{
+    uint16_t i;
+
+    if (size < SAMPLE_LOG_RECORD_HEADER_BYTES || data[0] != SAMPLE_LOG_RECORD_VERSION) {
+        return -1;
+    }
+    block->channel = data[1];
+    block->reserved = 0;
+    block->count = GetLe16(data + 2);
+    if (block->channel >= SAMPLE_HISTORY_CHANNEL_COUNT ||
+        block->count == 0U || block->count > SAMPLE_HISTORY_BLOCK_SAMPLES ||
+        size != SAMPLE_LOG_RECORD_HEADER_BYTES + (block->count - 1U) * 4U) {
+        return -1;
+    }
+    *out_boot = GetLe16(data + 4);
+    block->seq = GetLe32(data + 8);
+    block->t0_ms = GetLe32(data + 12);
+    block->v0 = (int32_t)GetLe32(data + 16);
+    *out_utc_ms = (int64_t)((uint64_t)GetLe32(data + 20) | ((uint64_t)GetLe32(data + 24) << 32));
+    for (i = 1; i < block->count; ++i) {
+        const uint8_t *d = data + SAMPLE_LOG_RECORD_HEADER_BYTES + (i - 1U) * 4U;
+
+        block->deltas[i - 1U].dv = (int16_t)GetLe16(d);
+        block->deltas[i - 1U].dt_ms = GetLe16(d + 2);
+    }
+    return 0;
+}
+
+// Runs under the history lock: copy and return, never touch flash here.
+static void OnBlockClosed(const SampleHistoryBlock *block)
+{
+    QueueLock();
+    if (g_queue_count >= SAMPLE_LOG_QUEUE_BLOCKS) {
+        g_dropped_blocks++;
+    } else {
+        SampleLogQueued *slot = &g_queue[(g_queue_head + g_queue_count) % SAMPLE_LOG_QUEUE_BLOCKS];
+
+        slot->size = SerializeBlock(block, slot->data);
+        g_queue_count++;
+    }
+    QueueUnlock();
+}
+
+static uint16_t RecoverBoot(void)
+{
+    static uint8_t record[SAMPLE_LOG_RECORD_MAX_BYTES];
+    static SampleHistoryBlock block;
+    FlashLogIterator it;
+    uint16_t size = 0;
+    uint16_t boot = 0;
+    int64_t utc_ms = 0;
+
+    if (FlashLog_NextSeq(&g_log) == FlashLog_OldestSeq(&g_log)) {
+        return 1;
+    }
+    FlashLog_Seek(&g_log, &it, FlashLog_NextSeq(&g_log) - 1U);
+    if (FlashLog_Next(&g_log, &it, record, sizeof(record), &size, NULL) != 1 ||
+        DeserializeBlock(record, size, &block, &boot, &utc_ms) != 0) {
+        return 1;
+    }
+    return (uint16_t)(boot == UINT16_MAX ? 1U : boot + 1U);
+}
+
+int SampleLog_Init(const FlashLogPort *port)
+{
+    int ret;
+
+    if (!g_queue_mutex_ready) {
+        g_queue_mutex_ready = LOS_MuxCreate(&g_queue_mutex) == LOS_OK ? 1U : 0U;
+    }
+    if (!g_flash_mutex_ready) {
+        g_flash_mutex_ready = LOS_MuxCreate(&g_flash_mutex) == LOS_OK ? 1U : 0U;
+    }
+
+    FlashLock();
+    g_log_mounted = 0;
+    ret = port != NULL ? FlashLog_Mount(&g_log, port) : -1;
+    if (ret == 0) {
+        g_log_mounted = 1;
+        g_boot = RecoverBoot();
+    }
+    FlashUnlock();
+
+    if (ret != 0) {
+        printf("[SAMPLE LOG] mount failed ret=%d; history stays RAM-only\n", ret);
+        return ret;
+    }
+    printf(
+        "[SAMPLE LOG] mounted boot=%u records=%u..%u\n",
+        (unsigned int)g_boot,
+        (unsigned int)FlashLog_OldestSeq(&g_log),
+        (unsigned int)FlashLog_NextSeq(&g_log)
+    );
+    SampleHistory_SetClosedBlockHandler(OnBlockClosed);
+    return 0;
+}
+
+void SampleLog_Service(void)
+{
+    static SampleLogQueued pending;
+
+    while (g_log_mounted) {
+        int ret;
+
+        QueueLock();
+        if (g_queue_count == 0U) {
+            QueueUnlock();
+            return;
+        }
+        pending = g_queue[g_queue_head];
+        g_queue_head = (g_queue_head + 1U) % SAMPLE_LOG_QUEUE_BLOCKS;
+        g_queue_count--;
+        QueueUnlock();
+
+        FlashLock();
+        ret = FlashLog_Append(&g_log, pending.data, pending.size, NULL);
+        FlashUnlock();
+        if (ret != 0) {
+            printf("[SAMPLE LOG] append failed ret=%d\n", ret);
+        }
+    }
+}
+
+uint16_t SampleLog_Boot(void)
+{
+    return g_boot;
+}
+
+uint32_t SampleLog_DroppedBlocks(void)
+{
+    return g_dropped_blocks;
+}
+
+int SampleLog_BeginFetch(
+    SampleLogCursor *cursor,
+    uint32_t from_seq,
+    uint16_t max_parts,
+    uint32_t *out_oldest,
+    uint32_t *out_next
+)
+{
+    if (cursor == NULL || !g_log_mounted) {
+        return -1;
+    }
+
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->max_parts = max_parts;
+    FlashLock();
+    FlashLog_Seek(&g_log, &cursor->it, from_seq);
+    cursor->end_seq = FlashLog_NextSeq(&g_log);
+    if (out_oldest != NULL) {
+        *out_oldest = FlashLog_OldestSeq(&g_log);
+    }
+    FlashUnlock();
+
+    cursor->done = (uint8_t)((int32_t)(cursor->it.cursor - cursor->end_seq) >= 0);
+    if (out_next != NULL) {
+        *out_next = cursor->end_seq;
+    }
+    return 0;
+}
+
+static int EncodeRecord(uint32_t seq, const uint8_t *data, uint16_t size, char *output, int output_size)
+{
+    static SampleHistoryBlock block;
+    char t0_utc[TIME_DISCIPLINE_RFC3339_BYTES];
+    uint16_t boot = 0;
+    int64_t utc_ms = 0;
+    int head;
+    int body;
+
+    if (DeserializeBlock(data, size, &block, &boot, &utc_ms) != 0) {
+        return 0;
+    }
+    if (utc_ms <= 0 || TimeDiscipline_FormatRfc3339(utc_ms, t0_utc, sizeof(t0_utc)) < 0) {
+        t0_utc[0] = '\0';
+    }
+
+    head = snprintf(
+        output,
+        (size_t)output_size,
+        "{\"rec\":%u,\"boot\":%u,%s%s%s\"block\":",
+        (unsigned int)seq,
+        (unsigned int)boot,
+        t0_utc[0] != '\0' ? "\"t0_utc\":\"" : "",
+        t0_utc,
+        t0_utc[0] != '\0' ? "\"," : ""
+    );
+    if (head < 0 || head >= output_size) {
+        return -1;
+    }
+    body = SampleHistory_FormatBlock(&block, output + head, output_size - head);
+    if (body < 0 || head + body + 1 >= output_size) {
+        return -1;
+    }
+    output[head + body] = '}';
+    output[head + body + 1] = '\0';
+    return head + body + 1;
+}
+
+int SampleLog_EncodeNext(SampleLogCursor *cursor, char *output, int output_size)
+{
+    static uint8_t record[SAMPLE_LOG_RECORD_MAX_BYTES];
+    int len = 0;
+
+    if (cursor == NULL || output == NULL || output_size <= 0) {
+        return -1;
+    }
+    output[0] = '\0';
+
+    FlashLock();
+    while (!cursor->done) {
+        FlashLogIterator before = cursor->it;
+        uint16_t size = 0;
+        uint32_t seq = 0;
+        int sep = len > 0 ? 1 : 0;
+        int written;
+        int ret;
+
+        ret = FlashLog_Next(&g_log, &cursor->it, record, sizeof(record), &size, &seq);
+        if (ret == 0 || (ret == 1 && (int32_t)(seq - cursor->end_seq) >= 0)) {
+            cursor->it = before;
+            cursor->done = 1;
+            break;
+        }
+        if (ret < 0) {
+            // Unreadable or oversized record: end this drain where it stands.
+            printf("[SAMPLE LOG] read failed ret=%d at rec=%u\n", ret, (unsigned int)before.cursor);
+            cursor->it = before;
+            cursor->done = 1;
+            break;
+        }
+
+        written = EncodeRecord(seq, record, size, output + len + sep, output_size - len - sep);
+        if (written == 0) {
+            continue;
+        }
+        if (written < 0) {
+            cursor->it = before;
+            output[len] = '\0';
+            break;
+        }
+        if (sep) {
+            output[len] = ',';
+        }
+        len += sep + written;
+    }
+    FlashUnlock();
+
+    if (len == 0 && !cursor->done) {
+        return -1;
+    }
+    if (len > 0) {
+        cursor->part++;
+        if (!cursor->done && cursor->max_parts > 0U && cursor->part >= cursor->max_parts) {
+            cursor->done = 1;
+            cursor->more = 1;
+        }
+    }
+    return len;
+}
@@ -0,0 +1,89 @@
+/*
+ * Sample Log
+ * Closed history blocks persisted to the flash log, drained by record cursor
+ */
+
+#ifndef APP_SAMPLE_LOG_H
+#define APP_SAMPLE_LOG_H
+
+#include <stdint.h>
+#include "sample_history.h"
+#include "../utils/flash_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SAMPLE_LOG_QUEUE_BLOCKS
+#define SAMPLE_LOG_QUEUE_BLOCKS 8U      // Closing every channel at once must not drop any
+#endif
+
+/*
+ * Record layout (little-endian), version 1:
+ *   u8 version, u8 channel, u16 count, u16 boot, u16 reserved,
+ *   u32 block seq, u32 t0_ms (uptime of that boot), i32 v0,
+ *   i64 t0 UTC ms (0 = clock was not synchronized),
+ *   then count-1 {i16 dv, u16 dt_ms}
+ */
+#define SAMPLE_LOG_RECORD_HEADER_BYTES 28U
+#define SAMPLE_LOG_RECORD_MAX_BYTES (SAMPLE_LOG_RECORD_HEADER_BYTES + (SAMPLE_HISTORY_BLOCK_SAMPLES - 1U) * 4U)
+
+typedef struct {
+    FlashLogIterator it;        // it.cursor is the resume point, it.lost the records recycled before sending
+    uint32_t end_seq;           // Log head at BeginFetch; later records wait for the next fetch
+    uint16_t part;
+    uint16_t max_parts;
+    uint8_t done;
+    uint8_t more;               // Stopped at max_parts with records left before end_seq
+} SampleLogCursor;
+
+/**
+ * Mount the log on port, recover after the newest intact record and start
+ * receiving closed blocks from SampleHistory.
+ * @return 0 on success, negative if the log cannot be mounted
+ */
+int SampleLog_Init(const FlashLogPort *port);
+
+/**
+ * Write queued blocks to flash. Call from a low-priority task: a sector
+ * erase can take tens of milliseconds.
+ */
+void SampleLog_Service(void);
+
+/**
+ * Boot number stamped on records written since this boot (starts at 1)
+ */
+uint16_t SampleLog_Boot(void);
+
+/**
+ * Blocks dropped because the queue was full, since boot
+ */
+uint32_t SampleLog_DroppedBlocks(void);
+
+/**
+ * Prepare a drain of records with seq >= from_seq up to the current head,
+ * at most max_parts frames long.
+ * @return 0 on success, -1 if the log is not mounted
+ */
+int SampleLog_BeginFetch(
+    SampleLogCursor *cursor,
+    uint32_t from_seq,
+    uint16_t max_parts,
+    uint32_t *out_oldest,
+    uint32_t *out_next
+);
+
+/**
+ * Write as many whole records as fit as comma-separated JSON objects:
+ * {"rec":..,"boot":..,"t0_utc":"..","block":{<SampleHistory_FormatBlock>}}
+ * t0_utc is omitted when the clock was unsynchronized at write time.
+ * @return length written (0 once the cursor is done), -1 if output cannot
+ *         hold even one record
+ */
+int SampleLog_EncodeNext(SampleLogCursor *cursor, char *output, int output_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SAMPLE_LOG_H
@@ -8,6 +8,32 @@
 
 // ==================== Data Structures ====================
 
+// Metrics aggregated between uploads, in envelope emission order (most
+// important first: if the payload is short on space the tail is dropped).
+typedef enum {
+    SENSOR_WINDOW_TILT_X = 0,
+    SENSOR_WINDOW_TILT_Y,
+    SENSOR_WINDOW_TILT_Z,
+    SENSOR_WINDOW_SOIL_MOISTURE,
+    SENSOR_WINDOW_SOIL_TEMPERATURE,
+    SENSOR_WINDOW_SOIL_EC,
+    SENSOR_WINDOW_ACCEL_X,
+    SENSOR_WINDOW_ACCEL_Y,
+    SENSOR_WINDOW_ACCEL_Z,
+    SENSOR_WINDOW_TEMPERATURE,
+    SENSOR_WINDOW_HUMIDITY,
+    SENSOR_WINDOW_METRIC_COUNT
+} SensorWindowMetric;
+
+typedef struct {
+    unsigned int count;         // Valid samples since the last upload
+    float min;
+    float max;
+    float last;
+    float mean;                 // Welford running mean
+    float m2;                   // Sum of squared deviations (variance = m2 / count)
+} SensorWindowStat;
+
 typedef struct {
     // System info
     unsigned int seq;           // Packet sequence number
@@ -26,9 +52,22 @@ typedef struct {
     int soil_valid;              // 0=invalid, 1=valid
     
     // GPS
-    float latitude;             // Decimal degrees
-    float longitude;            // Decimal degrees
+    double latitude;            // Decimal degrees (float steps ~2 m at 30N/110E)
+    double longitude;           // Decimal degrees
     int gps_valid;              // 0=invalid, 1=valid
+    int gps_quality;            // GGA scale: 0 none, 1 GNSS, 2 DGNSS, 4 RTK fixed, 5 RTK float
+    int gps_sats;               // Satellites used, 0=not reported
+    float gps_hdop;             // 0=not reported
+    unsigned int gps_age_ms;    // Age of the fix when sampled
+    unsigned int gps_utc_date;  // YYYYMMDD of the fix, 0=unknown
+    unsigned int gps_utc_ms;    // UTC ms since 00:00 of the fix
+    int gps_utc_valid;          // 0=no UTC time from the receiver
+    int gps_est_valid;          // 1=averaged position below is populated
+    double gps_mean_latitude;   // HDOP-weighted mean, outliers rejected
+    double gps_mean_longitude;
+    float gps_std_m;            // Horizontal 1-sigma scatter of accepted fixes
+    int gps_rate_valid;         // 1=enough history for a displacement rate
+    float gps_rate_mm_per_day;  // Horizontal displacement speed
     
     // Accelerometer & Gyroscope (MPU6050)
     float accel_x, accel_y, accel_z;    // g
@@ -44,6 +83,12 @@ typedef struct {
     // Status
     int warning;                // Warning flag
     int battery_level;          // Battery level (%)
+    int risk_valid;             // 1=risk engine has evaluated at least one sample
+    int risk_level;             // RiskLevel, 0 safe .. 4 critical
+    float risk_confidence;      // 0..1 share of fresh, mature factor statistics
+
+    // Aggregates of every sample since the previous upload snapshot
+    SensorWindowStat window[SENSOR_WINDOW_METRIC_COUNT];
 } SensorData;
 
 typedef struct {
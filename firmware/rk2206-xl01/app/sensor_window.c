@@ -0,0 +1,114 @@
+#include "sensor_window.h"
+#include <stddef.h>
+#include <string.h>
+
+static void AddValue(SensorWindowStat *stat, float value)
+{
+    float delta;
+
+    stat->count++;
+    stat->last = value;
+    if (stat->count == 1U) {
+        stat->min = value;
+        stat->max = value;
+        stat->mean = value;
+        stat->m2 = 0.0f;
+        return;
+    }
+    if (value < stat->min) {
+        stat->min = value;
+    }
+    if (value > stat->max) {
+        stat->max = value;
+    }
+    // Welford: numerically stable in float even for long windows of similar values.
+    delta = value - stat->mean;
+    stat->mean += delta / (float)stat->count;
+    stat->m2 += delta * (value - stat->mean);
+}
+
+void SensorWindow_Reset(SensorWindowStat window[SENSOR_WINDOW_METRIC_COUNT])
+{
+    if (window == NULL) {
+        return;
+    }
+    memset(window, 0, sizeof(SensorWindowStat) * SENSOR_WINDOW_METRIC_COUNT);
+}
+
+void SensorWindow_AddSample(SensorWindowStat window[SENSOR_WINDOW_METRIC_COUNT], const SensorData *sample)
+{
+    if (window == NULL || sample == NULL) {
+        return;
+    }
+
+    if (sample->imu_valid || sample->tilt_valid) {
+        AddValue(&window[SENSOR_WINDOW_TILT_X], sample->angle_x);
+        AddValue(&window[SENSOR_WINDOW_TILT_Y], sample->angle_y);
+    }
+    if (sample->tilt_valid) {
+        // The MPU6050 path has no yaw; only RS485 tilt reports Z.
+        AddValue(&window[SENSOR_WINDOW_TILT_Z], sample->angle_z);
+    }
+    if (sample->soil_valid) {
+        AddValue(&window[SENSOR_WINDOW_SOIL_MOISTURE], sample->soil_moisture);
+        AddValue(&window[SENSOR_WINDOW_SOIL_TEMPERATURE], sample->soil_temperature);
+        if (sample->soil_ec_valid) {
+            AddValue(&window[SENSOR_WINDOW_SOIL_EC], sample->soil_ec);
+        }
+    }
+    if (sample->imu_valid) {
+        AddValue(&window[SENSOR_WINDOW_ACCEL_X], sample->accel_x);
+        AddValue(&window[SENSOR_WINDOW_ACCEL_Y], sample->accel_y);
+        AddValue(&window[SENSOR_WINDOW_ACCEL_Z], sample->accel_z);
+    }
+    // With RS485 soil, temperature/humidity only mirror the soil fields.
+    if (sample->temp_valid && !sample->soil_valid) {
+        AddValue(&window[SENSOR_WINDOW_TEMPERATURE], sample->temperature);
+        AddValue(&window[SENSOR_WINDOW_HUMIDITY], sample->humidity);
+    }
+}
+
+void SensorWindow_Merge(SensorWindowStat window[SENSOR_WINDOW_METRIC_COUNT],
+                        const SensorWindowStat earlier[SENSOR_WINDOW_METRIC_COUNT])
+{
+    unsigned int i;
+
+    if (window == NULL || earlier == NULL) {
+        return;
+    }
+
+    for (i = 0U; i < SENSOR_WINDOW_METRIC_COUNT; ++i) {
+        SensorWindowStat *stat = &window[i];
+        const SensorWindowStat *old = &earlier[i];
+        float count;
+        float delta;
+
+        if (old->count == 0U) {
+            continue;
+        }
+        if (stat->count == 0U) {
+            *stat = *old;
+            continue;
+        }
+        if (old->min < stat->min) {
+            stat->min = old->min;
+        }
+        if (old->max > stat->max) {
+            stat->max = old->max;
+        }
+        // Chan's pairwise update, the two-window form of Welford.
+        count = (float)(stat->count + old->count);
+        delta = stat->mean - old->mean;
+        stat->m2 += old->m2 + delta * delta * (float)old->count * (float)stat->count / count;
+        stat->mean = old->mean + delta * (float)stat->count / count;
+        stat->count += old->count;
+    }
+}
+
+float SensorWindow_Variance(const SensorWindowStat *stat)
+{
+    if (stat == NULL || stat->count < 2U) {
+        return 0.0f;
+    }
+    return stat->m2 / (float)stat->count;
+}
@@ -0,0 +1,36 @@
+#ifndef APP_SENSOR_WINDOW_H
+#define APP_SENSOR_WINDOW_H
+
+#include "sensor_data.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Clear all per-metric aggregates (start of a new upload window)
+ */
+void SensorWindow_Reset(SensorWindowStat window[SENSOR_WINDOW_METRIC_COUNT]);
+
+/**
+ * Fold the valid fields of one sample into the aggregates. O(metrics), no allocation.
+ */
+void SensorWindow_AddSample(SensorWindowStat window[SENSOR_WINDOW_METRIC_COUNT], const SensorData *sample);
+
+/**
+ * Fold an earlier window back in front of the current one (an upload that
+ * never went out). Min/max/mean/m2 combine exactly; last stays the newest.
+ */
+void SensorWindow_Merge(SensorWindowStat window[SENSOR_WINDOW_METRIC_COUNT],
+                        const SensorWindowStat earlier[SENSOR_WINDOW_METRIC_COUNT]);
+
+/**
+ * Population variance of the window, 0 with fewer than 2 samples
+ */
+float SensorWindow_Variance(const SensorWindowStat *stat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_SENSOR_WINDOW_H
@@ -42,6 +42,31 @@ static int AppendJsonChunk(char *output, int output_size, int *offset, const cha
     return written;
 }
 
+// Room kept for "meta" after the metrics object; window stats never eat into it.
+#ifndef TELEMETRY_WINDOW_META_RESERVE_BYTES
+#define TELEMETRY_WINDOW_META_RESERVE_BYTES 448
+#endif
+
+typedef struct {
+    const char *name;
+    int decimals;
+} WindowMetricFormat;
+
+// Indexed by SensorWindowMetric; names match the instantaneous metric keys.
+static const WindowMetricFormat g_window_metric_formats[SENSOR_WINDOW_METRIC_COUNT] = {
+    {"tilt_x_deg", RS485_TILT_DECIMALS},
+    {"tilt_y_deg", RS485_TILT_DECIMALS},
+    {"tilt_z_deg", RS485_TILT_DECIMALS},
+    {"soil_moisture_pct", RS485_SOIL_MOISTURE_DECIMALS},
+    {"soil_temperature_c", RS485_SOIL_TEMPERATURE_DECIMALS},
+    {"electrical_conductivity_us_cm", 0},
+    {"accel_x_g", 2},
+    {"accel_y_g", 2},
+    {"accel_z_g", 2},
+    {"temperature_c", 1},
+    {"humidity_pct", 1},
+};
+
 static int BeginJsonField(char *output, int output_size, int *offset, int *field_count)
 {
     if (output == NULL || offset == NULL || field_count == NULL) {
@@ -58,6 +83,78 @@ static int BeginJsonField(char *output, int output_size, int *offset, int *field
     return 0;
 }
 
+// Half of the last printed digit: a smaller spread would print min == max.
+static float HalfPrintedUnit(int decimals)
+{
+    float unit = 0.5f;
+
+    while (decimals-- > 0) {
+        unit /= 10.0f;
+    }
+    return unit;
+}
+
+/*
+ * On-node risk level and confidence. Derived values, so like the window
+ * stats they are dropped whole rather than crowding out raw readings.
+ */
+static void AppendRiskMetrics(const SensorData *data, char *output, int budget, int *len, int *metric_count)
+{
+    int saved_len = *len;
+    int saved_count = *metric_count;
+
+    if (!data->risk_valid) {
+        return;
+    }
+    if (BeginJsonField(output, budget, len, metric_count) < 0 ||
+        AppendJsonChunk(output, budget, len, "\"risk_level\":%d", data->risk_level) < 0 ||
+        BeginJsonField(output, budget, len, metric_count) < 0 ||
+        AppendJsonChunk(output, budget, len, "\"risk_confidence\":%.2f", data->risk_confidence) < 0) {
+        *len = saved_len;
+        *metric_count = saved_count;
+        output[saved_len] = '\0';
+    }
+}
+
+/*
+ * "<metric>_min/_max/_avg" for every metric that varied since the last
+ * upload. A flat window adds nothing to the instantaneous value, which keeps
+ * a fully populated frame inside FIELD_LINK_MAX_PAYLOAD_BYTES. Each metric is
+ * all-or-nothing within budget; once one does not fit, the rest (lower
+ * priority) are dropped.
+ */
+static void AppendWindowStats(const SensorData *data, char *output, int budget, int *len, int *metric_count)
+{
+    int i;
+
+    for (i = 0; i < SENSOR_WINDOW_METRIC_COUNT; ++i) {
+        const SensorWindowStat *stat = &data->window[i];
+        const WindowMetricFormat *format = &g_window_metric_formats[i];
+        int saved_len = *len;
+        int saved_count = *metric_count;
+
+        if (stat->count < 2U || stat->max - stat->min < HalfPrintedUnit(format->decimals)) {
+            continue;
+        }
+#if !RS485_SOIL_HAS_EC
+        if (i == SENSOR_WINDOW_SOIL_EC) {
+            continue;
+        }
+#endif
+        if (BeginJsonField(output, budget, len, metric_count) < 0 ||
+            AppendJsonChunk(output, budget, len, "\"%s_min\":%.*f", format->name, format->decimals, stat->min) < 0 ||
+            BeginJsonField(output, budget, len, metric_count) < 0 ||
+            AppendJsonChunk(output, budget, len, "\"%s_max\":%.*f", format->name, format->decimals, stat->max) < 0 ||
+            BeginJsonField(output, budget, len, metric_count) < 0 ||
+            AppendJsonChunk(output, budget, len, "\"%s_avg\":%.*f", format->name, format->decimals, stat->mean) < 0) {
+            *len = saved_len;
+            *metric_count = saved_count;
+            output[saved_len] = '\0';
+            return;
+        }
+    }
+}
+
 int BuildTelemetryEnvelopeV1(
     const SensorData *data,
     const char *last_command_type,
@@ -66,6 +163,7 @@ int BuildTelemetryEnvelopeV1(
     const char *upload_trigger,
     const char *event_ts,
     const char *time_source,
+    int time_jump_ms,
     char *output,
     int output_size
 )
@@ -185,12 +283,49 @@ int BuildTelemetryEnvelopeV1(
 
     if (data->gps_valid) {
         if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
-            AppendJsonChunk(output, output_size, &len, "\"gps_latitude\":%.6f", data->latitude) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"gps_latitude\":%.7f", data->latitude) < 0 ||
+            BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"gps_longitude\":%.7f", data->longitude) < 0 ||
+            BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"gps_fix_quality\":%d", data->gps_quality) < 0 ||
+            BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"gps_fix_age_ms\":%u", data->gps_age_ms) < 0) {
+            output[0] = '\0';
+            return -1;
+        }
+        if (data->gps_sats > 0) {
+            if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+                AppendJsonChunk(output, output_size, &len, "\"gps_satellites\":%d", data->gps_sats) < 0) {
+                output[0] = '\0';
+                return -1;
+            }
+        }
+        if (data->gps_hdop > 0.0f) {
+            if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+                AppendJsonChunk(output, output_size, &len, "\"gps_hdop\":%.2f", data->gps_hdop) < 0) {
+                output[0] = '\0';
+                return -1;
+            }
+        }
+    }
+
+    if (data->gps_est_valid) {
+        if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"gps_mean_latitude\":%.8f", data->gps_mean_latitude) < 0 ||
+            BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"gps_mean_longitude\":%.8f", data->gps_mean_longitude) < 0 ||
             BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
-            AppendJsonChunk(output, output_size, &len, "\"gps_longitude\":%.6f", data->longitude) < 0) {
+            AppendJsonChunk(output, output_size, &len, "\"gps_std_m\":%.3f", data->gps_std_m) < 0) {
             output[0] = '\0';
             return -1;
         }
+        if (data->gps_rate_valid) {
+            if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+                AppendJsonChunk(output, output_size, &len, "\"gps_rate_mm_per_day\":%.1f", data->gps_rate_mm_per_day) < 0) {
+                output[0] = '\0';
+                return -1;
+            }
+        }
     }
 
     if (data->battery_level >= 1 && data->battery_level <= 100) {
@@ -206,6 +341,9 @@ int BuildTelemetryEnvelopeV1(
         return TELEMETRY_ENVELOPE_ERR_EMPTY_METRICS;
     }
 
+    AppendRiskMetrics(data, output, output_size - TELEMETRY_WINDOW_META_RESERVE_BYTES, &len, &metric_count);
+    AppendWindowStats(data, output, output_size - TELEMETRY_WINDOW_META_RESERVE_BYTES, &len, &metric_count);
+
     if (AppendJsonChunk(output, output_size, &len, "},") < 0 ||
         AppendJsonChunk(output, output_size, &len, "\"meta\":{") < 0 ||
         AppendJsonChunk(output, output_size, &len, "\"install_label\":\"%s\",", identity->install_label) < 0 ||
@@ -216,6 +354,23 @@ int BuildTelemetryEnvelopeV1(
         AppendJsonChunk(output, output_size, &len, "\"last_command_uptime_s\":%u,", last_command_uptime_s) < 0 ||
         AppendJsonChunk(output, output_size, &len, "\"upload_trigger\":\"%s\",", upload_trigger) < 0 ||
         AppendJsonChunk(output, output_size, &len, "\"time_source\":\"%s\",", time_source) < 0 ||
+        (time_jump_ms != 0
+            ? AppendJsonChunk(output, output_size, &len, "\"time_jump_ms\":%d,", time_jump_ms)
+            : 0) < 0 ||
+        (data->gps_valid && data->gps_utc_valid && data->gps_utc_date != 0U
+            ? AppendJsonChunk(
+                output,
+                output_size,
+                &len,
+                "\"gps_fix_utc\":\"%04u-%02u-%02uT%02u:%02u:%02u.%03uZ\",",
+                data->gps_utc_date / 10000U,
+                (data->gps_utc_date / 100U) % 100U,
+                data->gps_utc_date % 100U,
+                data->gps_utc_ms / 3600000U,
+                (data->gps_utc_ms / 60000U) % 60U,
+                (data->gps_utc_ms / 1000U) % 60U,
+                data->gps_utc_ms % 1000U)
+            : 0) < 0 ||
         AppendJsonChunk(output, output_size, &len, "\"legacy_valid_flags\":{") < 0 ||
         AppendJsonChunk(output, output_size, &len, "\"temp_ok\":%d,", data->temp_valid) < 0 ||
         AppendJsonChunk(output, output_size, &len, "\"imu_ok\":%d,", data->imu_valid) < 0 ||
@@ -232,3 +387,93 @@ int BuildTelemetryEnvelopeV1(
 
     return len;
 }
+
+int BuildTelemetryAlertV1(
+    const SensorData *data,
+    const RiskAssessment *risk,
+    int previous_level,
+    const char *event_ts,
+    const char *time_source,
+    char *output,
+    int output_size
+)
+{
+    int len = 0;
+    int metric_count = 0;
+
+    if (data == NULL || risk == NULL || output == NULL || output_size <= 0) {
+        return -1;
+    }
+
+    const DeviceIdentity *identity = DeviceIdentity_Get();
+    if (identity == NULL || identity->device_id == NULL) {
+        return -1;
+    }
+
+    if (time_source == NULL) {
+        time_source = "";
+    }
+
+    output[0] = '\0';
+
+    if (AppendJsonChunk(output, output_size, &len, "{\"schema_version\":1,") < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"device_id\":\"%s\",", identity->device_id) < 0 ||
+        (event_ts != NULL && event_ts[0] != '\0'
+            ? AppendJsonChunk(output, output_size, &len, "\"event_ts\":\"%s\",", event_ts)
+            : AppendJsonChunk(output, output_size, &len, "\"event_ts\":null,")) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"seq\":%u,", data->seq) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"metrics\":{") < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"risk_level\":%d,", (int)risk->level) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"risk_confidence\":%.2f,", risk->confidence) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"risk_score\":%.2f", risk->score) < 0) {
+        output[0] = '\0';
+        return -1;
+    }
+    metric_count = 3;
+
+    if (data->imu_valid || data->tilt_valid) {
+        if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"tilt_x_deg\":%.*f", RS485_TILT_DECIMALS, data->angle_x) < 0 ||
+            BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"tilt_y_deg\":%.*f", RS485_TILT_DECIMALS, data->angle_y) < 0) {
+            output[0] = '\0';
+            return -1;
+        }
+    }
+    if (data->soil_valid) {
+        if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"soil_moisture_pct\":%.*f", RS485_SOIL_MOISTURE_DECIMALS, data->soil_moisture) < 0) {
+            output[0] = '\0';
+            return -1;
+        }
+    }
+    if (data->rain_valid) {
+        if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"rain_total_mm\":%.1f", data->rain_total) < 0) {
+            output[0] = '\0';
+            return -1;
+        }
+    }
+    if (data->gps_est_valid && data->gps_rate_valid) {
+        if (BeginJsonField(output, output_size, &len, &metric_count) < 0 ||
+            AppendJsonChunk(output, output_size, &len, "\"gps_rate_mm_per_day\":%.1f", data->gps_rate_mm_per_day) < 0) {
+            output[0] = '\0';
+            return -1;
+        }
+    }
+
+    if (AppendJsonChunk(output, output_size, &len, "},") < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"meta\":{") < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"uptime_s\":%u,", data->uptime) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"upload_trigger\":\"risk_alert\",") < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"risk\":\"%s\",", risk->description) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"risk_previous_level\":%d,", previous_level) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "\"time_source\":\"%s\"", time_source) < 0 ||
+        AppendJsonChunk(output, output_size, &len, "}") < 0 ||
+        AppendJsonChunk(output, output_size, &len, "}\n") < 0) {
+        output[0] = '\0';
+        return -1;
+    }
+
+    return len;
+}
@@ -2,6 +2,7 @@
 #define APP_TELEMETRY_ENVELOPE_BUILDER_H
 
 #include "sensor_data.h"
+#include "risk_engine.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -17,6 +18,23 @@ int BuildTelemetryEnvelopeV1(
     const char *upload_trigger,
     const char *event_ts,
     const char *time_source,
+    int time_jump_ms,
+    char *output,
+    int output_size
+);
+
+/**
+ * Compact risk_alert telemetry pushed on escalation: the same envelope with
+ * only the risk fields, tilt, soil moisture, rain and GNSS rate and a short
+ * meta, so it goes out in one short burst ahead of the gateway's next poll.
+ * @return length written, -1 on error
+ */
+int BuildTelemetryAlertV1(
+    const SensorData *data,
+    const RiskAssessment *risk,
+    int previous_level,
+    const char *event_ts,
+    const char *time_source,
     char *output,
     int output_size
 );
@@ -0,0 +1,194 @@
+/*
+ * Uplink Policy Implementation
+ *
+ * Hybrid uplink keeps the polled schedule while the node is safe. Above safe:
+ * - a rise past the highest level already pushed in this episode is an
+ *   alert; a drop lowers that mark so a renewed rise alerts again
+ * - otherwise a full report is due once the level's IOT_UPLOAD_*_INTERVAL_MS
+ *   has passed since the last upload of any kind, plus a per-push jitter
+ * Every push spends one token (UPLINK_PUSH_BURST, one back per
+ * UPLINK_PUSH_REFILL_MS) and keeps UPLINK_PUSH_MIN_GAP_MS from the previous
+ * one. Failed sends, and every UPLINK_PUSH_UNANSWERED_LIMIT pushes without a
+ * gateway command in between, double the interval and gap up to
+ * 2^UPLINK_PUSH_BACKOFF_MAX_SHIFT; hearing the gateway clears the backoff.
+ */
+
+#include "uplink_policy.h"
+#include "landslide_monitor.h"
+#include "../config/app_config.h"
+
+#ifndef UPLINK_PUSH_BURST
+#define UPLINK_PUSH_BURST 3U
+#endif
+
+#ifndef UPLINK_PUSH_REFILL_MS
+#define UPLINK_PUSH_REFILL_MS 2000U
+#endif
+
+#ifndef UPLINK_PUSH_MIN_GAP_MS
+#define UPLINK_PUSH_MIN_GAP_MS 1500U
+#endif
+
+#ifndef UPLINK_PUSH_JITTER_MS
+#define UPLINK_PUSH_JITTER_MS 500U
+#endif
+
+#ifndef UPLINK_PUSH_UNANSWERED_LIMIT
+#define UPLINK_PUSH_UNANSWERED_LIMIT 3U
+#endif
+
+#ifndef UPLINK_PUSH_BACKOFF_MAX_SHIFT
+#define UPLINK_PUSH_BACKOFF_MAX_SHIFT 3U
+#endif
+
+static RiskLevel g_alerted_level = RISK_LEVEL_SAFE;
+static uint32_t g_last_upload_ms = 0U;
+static uint32_t g_last_push_ms = 0U;
+static uint32_t g_refill_anchor_ms = 0U;
+static uint32_t g_tokens = UPLINK_PUSH_BURST;
+static uint32_t g_backoff_shift = 0U;
+static uint32_t g_unanswered = 0U;
+static uint32_t g_jitter_state = 1U;
+static uint32_t g_report_jitter_ms = 0U;
+static uint8_t g_upload_seen = 0U;
+static uint8_t g_push_seen = 0U;
+static uint8_t g_refill_started = 0U;
+
+static uint32_t NextJitter(void)
+{
+    // xorshift32: cheap, and distinct seeds keep neighbouring nodes apart.
+    g_jitter_state ^= g_jitter_state << 13;
+    g_jitter_state ^= g_jitter_state >> 17;
+    g_jitter_state ^= g_jitter_state << 5;
+    return g_jitter_state % (UPLINK_PUSH_JITTER_MS + 1U);
+}
+
+static void RefillTokens(uint32_t now_ms)
+{
+    uint32_t refills;
+
+    if (!g_refill_started) {
+        g_refill_started = 1U;
+        g_refill_anchor_ms = now_ms;
+        return;
+    }
+
+    refills = (now_ms - g_refill_anchor_ms) / UPLINK_PUSH_REFILL_MS;
+    if (refills == 0U) {
+        return;
+    }
+    if (refills >= UPLINK_PUSH_BURST - g_tokens) {
+        g_tokens = UPLINK_PUSH_BURST;
+        g_refill_anchor_ms = now_ms;
+    } else {
+        g_tokens += refills;
+        g_refill_anchor_ms += refills * UPLINK_PUSH_REFILL_MS;
+    }
+}
+
+static void GrowBackoff(void)
+{
+    if (g_backoff_shift < UPLINK_PUSH_BACKOFF_MAX_SHIFT) {
+        g_backoff_shift++;
+    }
+}
+
+void UplinkPolicy_Init(uint32_t seed)
+{
+    g_alerted_level = RISK_LEVEL_SAFE;
+    g_last_upload_ms = 0U;
+    g_last_push_ms = 0U;
+    g_refill_anchor_ms = 0U;
+    g_tokens = UPLINK_PUSH_BURST;
+    g_backoff_shift = 0U;
+    g_unanswered = 0U;
+    g_jitter_state = seed != 0U ? seed : 0x2545F491U;
+    g_report_jitter_ms = NextJitter();
+    g_upload_seen = 0U;
+    g_push_seen = 0U;
+    g_refill_started = 0U;
+}
+
+uint32_t UplinkPolicy_IntervalForLevel(RiskLevel level)
+{
+    switch (level) {
+        case RISK_LEVEL_LOW:
+            return IOT_UPLOAD_LOW_INTERVAL_MS;
+        case RISK_LEVEL_MEDIUM:
+            return IOT_UPLOAD_MEDIUM_INTERVAL_MS;
+        case RISK_LEVEL_HIGH:
+            return IOT_UPLOAD_HIGH_INTERVAL_MS;
+        case RISK_LEVEL_CRITICAL:
+            return IOT_UPLOAD_CRITICAL_INTERVAL_MS;
+        case RISK_LEVEL_SAFE:
+        default:
+            return IOT_UPLOAD_SAFE_INTERVAL_MS;
+    }
+}
+
+UplinkPushKind UplinkPolicy_Decide(RiskLevel level, uint32_t now_ms)
+{
+    uint32_t interval_ms;
+
+    RefillTokens(now_ms);
+
+    if (level < g_alerted_level) {
+        g_alerted_level = level;
+    }
+    if (level <= RISK_LEVEL_SAFE || g_tokens == 0U) {
+        return UPLINK_PUSH_NONE;
+    }
+    if (g_push_seen && now_ms - g_last_push_ms < (UPLINK_PUSH_MIN_GAP_MS << g_backoff_shift)) {
+        return UPLINK_PUSH_NONE;
+    }
+    if (level > g_alerted_level) {
+        return UPLINK_PUSH_ALERT;
+    }
+
+    interval_ms = (UplinkPolicy_IntervalForLevel(level) << g_backoff_shift) + g_report_jitter_ms;
+    if (!g_upload_seen || now_ms - g_last_upload_ms >= interval_ms) {
+        return UPLINK_PUSH_REPORT;
+    }
+    return UPLINK_PUSH_NONE;
+}
+
+void UplinkPolicy_OnSent(UplinkPushKind kind, RiskLevel level, int sent_ok, uint32_t now_ms)
+{
+    if (sent_ok) {
+        g_last_upload_ms = now_ms;
+        g_upload_seen = 1U;
+    }
+    if (kind == UPLINK_PUSH_NONE) {
+        return;
+    }
+
+    if (g_tokens > 0U) {
+        g_tokens--;
+    }
+    g_last_push_ms = now_ms;
+    g_push_seen = 1U;
+    g_report_jitter_ms = NextJitter();
+
+    if (!sent_ok) {
+        GrowBackoff();
+        return;
+    }
+    if (kind == UPLINK_PUSH_ALERT && level > g_alerted_level) {
+        g_alerted_level = level;
+    }
+    if (++g_unanswered >= UPLINK_PUSH_UNANSWERED_LIMIT) {
+        g_unanswered = 0U;
+        GrowBackoff();
+    }
+}
+
+void UplinkPolicy_OnGatewayContact(void)
+{
+    g_unanswered = 0U;
+    g_backoff_shift = 0U;
+}
+
+uint32_t UplinkPolicy_BackoffShift(void)
+{
+    return g_backoff_shift;
+}
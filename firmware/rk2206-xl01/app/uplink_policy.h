@@ -0,0 +1,62 @@
+/*
+ * Uplink Policy
+ * Decides when a hybrid-mode node pushes telemetry without being polled
+ */
+
+#ifndef APP_UPLINK_POLICY_H
+#define APP_UPLINK_POLICY_H
+
+#include <stdint.h>
+#include "risk_engine.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    UPLINK_PUSH_NONE = 0,       // Nothing due; wait for the gateway to poll
+    UPLINK_PUSH_ALERT = 1,      // Risk rose above the last pushed level: send the compact alert frame
+    UPLINK_PUSH_REPORT = 2      // Elevated level and its report interval elapsed: send full telemetry
+} UplinkPushKind;
+
+/**
+ * Reset the policy. seed spreads the report jitter of nodes that escalate
+ * together (e.g. a hash of the device id).
+ */
+void UplinkPolicy_Init(uint32_t seed);
+
+/**
+ * Report interval of a risk level (IOT_UPLOAD_*_INTERVAL_MS)
+ */
+uint32_t UplinkPolicy_IntervalForLevel(RiskLevel level);
+
+/**
+ * What to push now for the current level. Escalations come first; both kinds
+ * are held back by the push token bucket, UPLINK_PUSH_MIN_GAP_MS and the
+ * current backoff. Call from the uplink task only.
+ */
+UplinkPushKind UplinkPolicy_Decide(RiskLevel level, uint32_t now_ms);
+
+/**
+ * Record a transmitted frame. kind is UPLINK_PUSH_NONE for uploads the
+ * gateway asked for; those restart the report interval too. sent_ok=0 grows
+ * the backoff.
+ */
+void UplinkPolicy_OnSent(UplinkPushKind kind, RiskLevel level, int sent_ok, uint32_t now_ms);
+
+/**
+ * The gateway was heard (any accepted command): it is listening, so the
+ * backoff for unanswered pushes is cleared.
+ */
+void UplinkPolicy_OnGatewayContact(void);
+
+/**
+ * Current backoff as a shift of the report interval (0 = none)
+ */
+uint32_t UplinkPolicy_BackoffShift(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // APP_UPLINK_POLICY_H
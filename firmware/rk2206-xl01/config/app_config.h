@@ -55,10 +55,25 @@
 #define PLATFORM_MANUAL_COLLECT_DELAY_MS 1500 // manual_collect waits longer so ACK is not immediately followed by forced telemetry
 #define EDGE_UPLINK_MODE_PERIODIC 0
 #define EDGE_UPLINK_MODE_POLLED 1
-// Production pull mode:
-// sample locally, but upload telemetry only when the center/gateway polls it.
+#define EDGE_UPLINK_MODE_HYBRID 2
+// Production pull mode: sample locally and upload only when the center/gateway polls.
+// Hybrid mode (opt-in) behaves the same while the on-node risk level is safe. When
+// the level rises, it pushes a compact risk_alert frame at once, then full telemetry
+// at the IOT_UPLOAD_*_INTERVAL_MS tier of the level until it falls back to safe.
+// Keep it off until the RISK_* thresholds are calibrated on site: with the defaults,
+// ordinary wet soil holds a node at LOW/MEDIUM and it pushes every 10-30 s.
 #define EDGE_UPLINK_MODE EDGE_UPLINK_MODE_POLLED
-#define UPLOAD_INTERVAL_MS  5000        // Periodic-mode interval; polled mode uploads only on request
+// Unsolicited pushes share the channel with every other node's polls:
+// at most BURST back to back, one more per REFILL_MS, never closer than MIN_GAP_MS.
+// Failed sends and every UNANSWERED_LIMIT pushes without a gateway command double
+// the tier interval and gap, up to 2^MAX_SHIFT; any gateway command resets it.
+#define UPLINK_PUSH_BURST               3U
+#define UPLINK_PUSH_REFILL_MS           2000U  // Sustained ceiling = the critical tier
+#define UPLINK_PUSH_MIN_GAP_MS          1500U
+#define UPLINK_PUSH_JITTER_MS           500U   // Random extra delay per report so nodes escalating together drift apart
+#define UPLINK_PUSH_UNANSWERED_LIMIT    3U
+#define UPLINK_PUSH_BACKOFF_MAX_SHIFT   3U
+#define UPLOAD_INTERVAL_MS  5000        // Periodic-mode interval; polled/hybrid modes upload on request
 #define MAX_RETRY_COUNT     3           // Retry 3 times if send fails
 #define RETRY_DELAY_MS      500         // Wait 500ms between retries
 #define ACK_TIMEOUT_MS      1000        // Wait 1s for ACK from gateway
@@ -72,6 +87,54 @@
 #define FIELD_LINK_RECOVERY_CHECK_MS    1000U
 #define FIELD_LINK_RECOVERY_REBOOT_DELAY_MS 1000U
 
+// Raw sample history kept in RAM for fetch_history (tilt x/y/z, soil moisture/temperature).
+// Each channel holds BLOCKS x 64 samples; 8 blocks is about 2.1 KB per channel.
+#define ENABLE_SAMPLE_HISTORY           1
+#define SAMPLE_HISTORY_BLOCKS_PER_CHANNEL 8U
+#define SAMPLE_HISTORY_FRAME_GAP_MS     300U  // Pause between history frames so polls still get through
+// Closed history blocks are also appended to a flash ring that survives reboots
+// (including FIELD_LINK_STALE_REBOOT_MS recovery) and is drained with fetch_log.
+// Enable only after reserving the region below in the board flash layout.
+#define ENABLE_SAMPLE_FLASH_LOG         0
+#define SAMPLE_LOG_FLASH_OFFSET         0x00300000U  // Sector-aligned start of the reserved region
+#define SAMPLE_LOG_SECTOR_SIZE          4096U
+#define SAMPLE_LOG_SECTOR_COUNT         16U   // 64 KB, about 200 blocks of 64 samples
+#define SAMPLE_LOG_FRAMES_PER_FETCH     8U    // Frames per fetch_log; the gateway resumes at next_cursor
+
+// ==================== Risk Engine ====================
+// Per-factor scores reach 1.0 at these values (tilt and soil moisture start
+// scoring at half of theirs). Evaluated on every sample, no extra task.
+#define ENABLE_RISK_ENGINE                  1
+#define RISK_TILT_ALARM_DEG                 RS485_TILT_WARNING_DEG
+#define RISK_TILT_RATE_ALARM_DEG_PER_H      0.5f
+#define RISK_MOISTURE_ALARM_PCT             45.0f
+#define RISK_MOISTURE_TREND_ALARM_PCT_PER_H 3.0f
+#define RISK_RAIN_ALARM_MM_PER_H            20.0f
+#define RISK_GPS_RATE_ALARM_MM_PER_DAY      10.0f
+#define RISK_VIBRATION_ALARM_G              0.3f
+#define RISK_CLEAR_HOLD_MS                  60000U  // Score must stay below a level this long to leave it
+// MPU6050 features (tilt, |a| change rate, vibration RMS, zero crossings) are
+// computed in Q15/Q31 from raw counts. EW weights are 2^-SHIFT per sample.
+#define MOTION_MEAN_EW_SHIFT                6U      // Gravity/offset baseline, ~64 samples
+#define MOTION_VIBRATION_EW_SHIFT           3U      // Vibration mean square, ~8 samples
+#define MOTION_ZCR_HYSTERESIS_G             0.01f
+#define MOTION_ZCR_WINDOW_MS                10000U
+// 1 = block kernels use CMSIS-DSP (arm_sub_q15/arm_power_q15/arm_rms_q15);
+// needs arm_math.h and the CMSIS-DSP library in the GN include_dirs/deps.
+#define FIXED_DSP_USE_CMSIS                 0
+// MPU6050 FIFO capture: the chip samples the accelerometer at IMU_FIFO_RATE_HZ
+// into its 1 KB FIFO (170 samples) and ImuCaptureTask drains it in bursts into
+// the motion features, so vibration is seen at full rate without waking the
+// sensor loop per sample. Above ~400 Hz the 100 kHz bus cannot keep up; set
+// I2C_BAUDRATE to EI2C_FRE_400K. IMU_FIFO_INT_GPIO is the GPIO wired to the
+// MPU6050 INT pin (data-ready pulse), or -1 to drain every IMU_FIFO_DRAIN_MS.
+#define ENABLE_IMU_FIFO_CAPTURE             0
+#define IMU_FIFO_RATE_HZ                    200U    // 1000 / n Hz
+#define IMU_FIFO_INT_GPIO                   (-1)
+#define IMU_FIFO_WATERMARK_SAMPLES          32U     // Interrupts per wake-up
+#define IMU_FIFO_DRAIN_MS                   100U    // Timeout / polled drain period; keep under 170 samples
+#define IMU_FIFO_DRAIN_MAX_SAMPLES          170U
+
 // Shared-port source-control configuration
 #define SHARED_PORT_NODE_SLOT_COUNT          3
 #define SHARED_PORT_MAX_PAYLOAD_BYTES        896
@@ -106,6 +169,13 @@
 #define ENABLE_WATCHDOG     1           // Enable watchdog for system stability
 #define WATCHDOG_TIMEOUT    10          // Watchdog timeout (seconds)
 
+// Runtime Stats: per-task stack high-water marks, CPU share (kernel CPUP) and
+// switch counts for get_runtime_stats and a periodic stack headroom log.
+#define ENABLE_RUNTIME_STATS            1
+#define RUNTIME_STATS_SWITCH_HOOK       1       // Count switches via g_pfnUsrTskSwitchHook; 0 if the kernel lacks it
+#define RUNTIME_STATS_LOG_INTERVAL_MS   300000U // FieldLinkHealthTask log period; 0 = command only
+#define RUNTIME_STATS_STACK_WARN_PCT    85U     // Warn once a task's stack peak reaches this share
+
 // ==================== Hardware Configuration ====================
 
 // XL01 Wireless Module
@@ -139,6 +209,12 @@
 #define GPS_BAUDRATE        115200       // UM220-IV NK EVK config.ini WorkBaudrate defaults to 115200
 #define GPS_UART_PROBE_LOG_MODE 0        // 0=GPS UART confirmed; keep only parsed NMEA/fix logs
 #define GPS_VERBOSE_NMEA_LOG 0           // 0=hide raw GGA/RMC sentences; summary upload line shows GPS status
+#define GPS_RECEIVER_CONFIGURE 1         // Disable GLL/GSA/GSV/VTG/ZDA on the UM220 at boot and verify
+#define GPS_NMEA_OUTPUT_PERIOD_S 1U      // GGA/RMC output divider in 1 Hz epochs; keep <= sampling_s
+#define GPS_PROTOCOL_NMEA 0
+#define GPS_PROTOCOL_BINARY 1
+#define GPS_PROTOCOL GPS_PROTOCOL_NMEA   // BINARY=UBX-style NAV-PVT/NAV-DOP with NMEA fallback
+#define GPS_BINARY_FALLBACK_MS 3000U     // Use NMEA fixes after this long without a binary solution
 #endif
 
 #if ENABLE_RS485_BUS
@@ -152,7 +228,25 @@
 #define RS485_BAUDRATE        4800        // Soil and tilt manuals: factory default 4800 8N1
 #define RS485_RESPONSE_TIMEOUT_MS 800
 #define RS485_INTER_REQUEST_GAP_MS 80
-#define RS485_RAW_DIAG_MODE    0           // Production log: hide raw Modbus TX/RX frames
+// Per-(channel, address) timing learned from observed read latency. The two
+// constants above stay as the ceiling/starting point until a slave has enough
+// samples; get_rs485_timing reports the learned values.
+#define RS485_ADAPTIVE_TIMING  1
+#define RS485_ADAPTIVE_MIN_SAMPLES 8U      // Use defaults until this many good responses
+#define RS485_ADAPTIVE_TIMEOUT_MARGIN_MS 40U
+#define RS485_ADAPTIVE_TIMEOUT_MIN_MS 80U
+#define RS485_ADAPTIVE_GAP_MIN_MS 20U
+#define RS485_ADAPTIVE_GAP_MAX_MS 320U
+#define RS485_TIMING_PERSIST   0           // Save learned timing to kv_store; needs utils kv_store in product
+#define RS485_TIMING_PERSIST_EVERY 200U    // Good responses between persistence checks (flash wear)
+// Rs485BusTask polls each slave on its own period and publishes to a cache the
+// sensor loop copies; a value older than max(3 periods, 5 s) is reported invalid.
+// 0 = follow the global sampling_s; set_config "sensor_sampling_ms" overrides at runtime.
+#define RS485_SOIL_SAMPLE_PERIOD_MS 0U
+#define RS485_TILT_SAMPLE_PERIOD_MS 0U
+#define RS485_RAIN_SAMPLE_PERIOD_MS 0U
+#define RS485_CACHE_STALE_MIN_MS 5000U
+#define RS485_RAW_DIAG_MODE   0           // Production log: hide raw Modbus TX/RX frames
 #define RS485_TILT_AUTO_PROBE   0           // Production: fixed manual-confirmed channel/address/baud/clock
 #define RS485_TILT_PROBE_DIAG  0           // Hide one-time tilt probe details after bring-up
 #define RS485_SENSOR_RESULT_LOG 0          // Production: telemetry carries values; serial keeps only state/errors
@@ -185,6 +279,7 @@
 #define RS485_SOIL_EC_REG      0x0002
 #define RS485_SOIL_EC_SCALE    1.0f
 #define RS485_SOIL_EC_REPROBE_READS 60U
+#define RS485_SOIL_COALESCE_READS 1       // RS-ECTH: one 0x0000-0x0002 read; RS-WS falls back to split reads
 #define RS485_SOIL_CHANNEL     RS485_CHANNEL_1
 
 // RS-DIP-N01-1 tilt sensor manual: factory address 1, 4800 8N1.
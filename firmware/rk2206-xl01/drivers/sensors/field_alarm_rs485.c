@@ -310,17 +310,11 @@ const char *FieldAlarmRs485_ResultName(int code)
     return RS485_ModbusStatusName(code);
 }
 
-int FieldAlarmRs485_SetEnabled(int enabled)
+static int FieldAlarmRs485_SetEnabledLocked(int enabled)
 {
     int first_ret;
     int second_ret;
 
-    FieldAlarmRs485_ResetStepDiag(0, 0, 0);
-
-    if (!ENABLE_RS485_ALARM) {
-        return -1;
-    }
-
     if (enabled) {
         first_ret = FieldAlarmRs485_RunControlStep(
             1,
@@ -357,6 +351,24 @@ int FieldAlarmRs485_SetEnabled(int enabled)
     return first_ret;
 }
 
+int FieldAlarmRs485_SetEnabled(int enabled)
+{
+    int ret;
+
+    FieldAlarmRs485_ResetStepDiag(0, 0, 0);
+
+    if (!ENABLE_RS485_ALARM) {
+        return -1;
+    }
+
+    // The alarm switches the shared channel to its own baud rate; hold the bus
+    // so the sensor schedule cannot interleave a request at the wrong speed.
+    RS485_ModbusLockBus();
+    ret = FieldAlarmRs485_SetEnabledLocked(enabled);
+    RS485_ModbusUnlockBus();
+    return ret;
+}
+
 static int FieldAlarmRs485_SendRawPairOnChannel(
     uint8_t channel,
     const uint8_t *first_frame,
@@ -419,6 +431,7 @@ int FieldAlarmRs485_SendRawDiagnostic(int enabled)
         g_last_alarm_diag.value = RS485_ALARM_STOP_VALUE;
     }
 
+    RS485_ModbusLockBus();
     primary_ret = FieldAlarmRs485_SendRawPairOnChannel(
         primary_channel,
         first_frame,
@@ -434,6 +447,7 @@ int FieldAlarmRs485_SendRawDiagnostic(int enabled)
         first_len,
         second_frame,
         second_len);
+    RS485_ModbusUnlockBus();
 
     g_last_alarm_diag.channel = alternate_channel;
     g_last_alarm_diag.primary_ret = primary_ret;
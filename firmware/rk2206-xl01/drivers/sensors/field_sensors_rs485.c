@@ -3,9 +3,17 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include "los_mux.h"
 #include "los_task.h"
+#include "los_tick.h"
 #include "../../config/app_config.h"
 #include "../../utils/watchdog_mgr.h"
+#if ENABLE_SAMPLE_HISTORY
+#include "../../app/sample_history.h"
+#endif
+#if ENABLE_RISK_ENGINE
+#include "../../app/risk_engine.h"
+#endif
 #include "rs485_modbus.h"
 #if RS485_TRANSPORT_SC16IS752
 #include "sc16is752_driver.h"
@@ -39,6 +47,42 @@
 #define RS485_SENSOR_RESULT_LOG 1
 #endif
 
+#ifndef RS485_SOIL_COALESCE_READS
+#define RS485_SOIL_COALESCE_READS 1
+#endif
+
+#ifndef RS485_PLAN_SPLIT_VOTES
+#define RS485_PLAN_SPLIT_VOTES 2U
+#endif
+
+#ifndef RS485_SOIL_EC_REPROBE_READS
+#define RS485_SOIL_EC_REPROBE_READS 60U
+#endif
+
+#ifndef RS485_SOIL_SAMPLE_PERIOD_MS
+#define RS485_SOIL_SAMPLE_PERIOD_MS 0U
+#endif
+
+#ifndef RS485_TILT_SAMPLE_PERIOD_MS
+#define RS485_TILT_SAMPLE_PERIOD_MS 0U
+#endif
+
+#ifndef RS485_RAIN_SAMPLE_PERIOD_MS
+#define RS485_RAIN_SAMPLE_PERIOD_MS 0U
+#endif
+
+#ifndef RS485_DEFAULT_SAMPLE_PERIOD_MS
+#define RS485_DEFAULT_SAMPLE_PERIOD_MS 1000U
+#endif
+
+#ifndef RS485_CACHE_STALE_MIN_MS
+#define RS485_CACHE_STALE_MIN_MS 5000U
+#endif
+
+#ifndef RS485_BUS_IDLE_SLICE_MS
+#define RS485_BUS_IDLE_SLICE_MS 200U
+#endif
+
 #ifndef SC16IS752_ALT_XTAL_HZ
 #define SC16IS752_ALT_XTAL_HZ 14745600UL
 #endif
@@ -51,6 +95,50 @@ typedef struct {
     unsigned long xtal_hz;
 } Rs485ProbeUartConfig;
 
+typedef enum {
+    RS485_SPAN_UNPROBED = 0,
+    RS485_SPAN_COALESCED,
+    RS485_SPAN_SPLIT,
+} Rs485SpanMode;
+
+/*
+ * Read plan for one slave: a mandatory base block plus an optional extension
+ * block. When the blocks are adjacent the planner first tries one wide read;
+ * a slave that rejects the wider range (RS-WS without EC) is cached as split
+ * and from then on read as base + occasionally re-probed extension.
+ */
+typedef struct {
+    const char *tag;
+    uint8_t channel;
+    uint8_t addr;
+    uint16_t base_start;
+    uint16_t base_count;
+    uint16_t ext_start;
+    uint16_t ext_count;
+    Rs485SpanMode mode;
+    unsigned int split_votes;
+    int ext_supported;
+    int ext_unavailable_reported;
+    unsigned int ext_reprobe_countdown;
+} Rs485ReadPlan;
+
+typedef int (*FieldRs485DeviceReader)(FieldRs485Readings *out);
+
+typedef struct {
+    const char *tag;
+    FieldRs485DeviceReader read;
+    unsigned int period_ms;         // 0 follows g_default_period_ms
+
+    uint32_t next_due_tick;
+    uint32_t last_ok_tick;
+    unsigned int consecutive_failures;
+} FieldRs485ScheduledDevice;
+
+static UINT32 g_cache_mutex = 0U;
+static unsigned char g_cache_mutex_ready = 0U;
+static FieldRs485Readings g_latest_readings;
+static unsigned int g_default_period_ms = RS485_DEFAULT_SAMPLE_PERIOD_MS;
+
 static float SignedRegisterToScaledFloat(uint16_t value, float scale)
 {
     return (float)((int16_t)value) * scale;
@@ -83,7 +171,7 @@ static int ReadTiltRegisters(uint8_t channel, uint8_t addr, uint16_t *regs, unsi
         addr,
         regs,
         reg_capacity,
-        RS485_RESPONSE_TIMEOUT_MS);
+        RS485_ModbusGetResponseTimeoutMs(channel, addr));
 }
 
 static int ProbeTiltSingleRegister(
@@ -230,7 +318,7 @@ static int ProbeTiltSensor(
 #endif
                             return 0;
                         }
-                        LOS_Msleep(RS485_INTER_REQUEST_GAP_MS);
+                        LOS_Msleep(RS485_ModbusGetInterRequestGapMs(channel, addr));
                     }
                 }
             }
@@ -245,151 +333,212 @@ static int ProbeTiltSensor(
     return -1;
 }
 
-int FieldRs485_Init(void)
+static void ReadPlanExtension(Rs485ReadPlan *plan, uint16_t *ext_regs, int *ext_valid)
 {
-    return RS485_ModbusInit();
+    int ret;
+
+    if (!plan->ext_supported && plan->ext_reprobe_countdown > 0U) {
+        plan->ext_reprobe_countdown--;
+        return;
+    }
+
+    LOS_Msleep(RS485_ModbusGetInterRequestGapMs(plan->channel, plan->addr));
+    ret = RS485_ModbusReadHoldingRegistersOnChannel(
+        plan->channel,
+        plan->addr,
+        plan->ext_start,
+        plan->ext_count,
+        ext_regs,
+        plan->ext_count);
+    if (ret == RS485_MODBUS_OK) {
+        if (!plan->ext_supported) {
+            printf("[RS485 %s] optional register 0x%04X detected\n", plan->tag, plan->ext_start);
+        }
+        plan->ext_supported = 1;
+        plan->ext_unavailable_reported = 0;
+        plan->ext_reprobe_countdown = 0U;
+        *ext_valid = 1;
+    } else if (!plan->ext_supported) {
+        plan->ext_reprobe_countdown = RS485_SOIL_EC_REPROBE_READS;
+        if (!plan->ext_unavailable_reported) {
+            printf("[RS485 %s] optional register 0x%04X unavailable; base registers remain active\n",
+                   plan->tag, plan->ext_start);
+            plan->ext_unavailable_reported = 1;
+        }
+    }
 }
 
-int FieldRs485_Read(FieldRs485Readings *out)
+/*
+ * Fills regs[0..base_count) and, when *ext_valid is set on return,
+ * regs[base_count..base_count + ext_count). Returns 0 when the base block is valid.
+ */
+static int ReadPlannedRegisters(Rs485ReadPlan *plan, uint16_t *regs, unsigned int reg_capacity, int *ext_valid)
 {
-    int any_valid = 0;
+    unsigned int span_count = (unsigned int)plan->base_count + plan->ext_count;
+    int wide_failed = 0;
+    int ret;
 
-    if (out == NULL) {
-        return -1;
+    *ext_valid = 0;
+    if (reg_capacity < span_count) {
+        return RS485_MODBUS_ERR_INVALID;
     }
 
-    memset(out, 0, sizeof(*out));
+    if (plan->mode != RS485_SPAN_SPLIT &&
+        plan->ext_count > 0U &&
+        plan->ext_start == (uint16_t)(plan->base_start + plan->base_count)) {
+        ret = RS485_ModbusReadHoldingRegistersOnChannel(
+            plan->channel,
+            plan->addr,
+            plan->base_start,
+            (uint16_t)span_count,
+            regs,
+            reg_capacity);
+        if (ret == RS485_MODBUS_OK) {
+            if (plan->mode != RS485_SPAN_COALESCED) {
+                printf("[RS485 %s] ch=%u addr=%u read plan coalesced regs 0x%04X-0x%04X\n",
+                       plan->tag, plan->channel, plan->addr,
+                       plan->base_start, (unsigned int)(plan->base_start + span_count - 1U));
+            }
+            plan->mode = RS485_SPAN_COALESCED;
+            plan->split_votes = 0U;
+            plan->ext_supported = 1;
+            *ext_valid = 1;
+            return RS485_MODBUS_OK;
+        }
+
+        // A proven wide read that times out is treated as a transient bus
+        // fault; only an explicit exception demotes it to split reads.
+        if (plan->mode == RS485_SPAN_COALESCED && ret != RS485_MODBUS_ERR_EXCEPTION) {
+            return ret;
+        }
+        if (ret == RS485_MODBUS_ERR_EXCEPTION) {
+            plan->split_votes = RS485_PLAN_SPLIT_VOTES;
+        } else {
+            wide_failed = 1;
+        }
+        LOS_Msleep(RS485_ModbusGetInterRequestGapMs(plan->channel, plan->addr));
+    }
+
+    ret = RS485_ModbusReadHoldingRegistersOnChannel(
+        plan->channel,
+        plan->addr,
+        plan->base_start,
+        plan->base_count,
+        regs,
+        plan->base_count);
+    if (ret != RS485_MODBUS_OK) {
+        return ret;
+    }
+
+    // The base block answered but the wide read did not: count it against the wide span.
+    if (wide_failed) {
+        plan->split_votes++;
+    }
+    if (plan->mode != RS485_SPAN_SPLIT && plan->split_votes >= RS485_PLAN_SPLIT_VOTES) {
+        printf("[RS485 %s] ch=%u addr=%u rejects regs 0x%04X-0x%04X; read plan split\n",
+               plan->tag, plan->channel, plan->addr,
+               plan->base_start, (unsigned int)(plan->base_start + span_count - 1U));
+        plan->mode = RS485_SPAN_SPLIT;
+        plan->ext_supported = 0;
+    }
+
+    if (plan->ext_count > 0U) {
+        ReadPlanExtension(plan, regs + plan->base_count, ext_valid);
+    }
+    return RS485_MODBUS_OK;
+}
 
 #if ENABLE_RS485_SOIL_SENSOR
-    {
-#if RS485_SOIL_HAS_EC
-        static int soil_ec_supported = 0;
-        static int soil_ec_unavailable_reported = 0;
-        static unsigned int soil_ec_reprobe_countdown = 0U;
-#endif
-        uint16_t regs[RS485_SOIL_REG_COUNT] = {0};
-        (void)ReconfigureRs485ChannelWithClock(RS485_SOIL_CHANNEL, RS485_BAUDRATE, SC16IS752_XTAL_HZ);
-        if (RS485_ModbusReadHoldingRegistersOnChannel(
-                RS485_SOIL_CHANNEL,
-                RS485_SOIL_ADDR,
-                RS485_SOIL_REG_START,
-                RS485_SOIL_REG_COUNT,
-                regs,
-                RS485_SOIL_REG_COUNT) == 0) {
-            out->soil_moisture_pct =
-                (float)regs[RS485_SOIL_MOISTURE_REG_INDEX] * RS485_SOIL_MOISTURE_SCALE;
-            out->soil_temperature_c =
-                SignedRegisterToScaledFloat(regs[RS485_SOIL_TEMPERATURE_REG_INDEX], RS485_SOIL_TEMPERATURE_SCALE);
-            out->soil_valid = 1;
-            any_valid = 1;
+static int ReadSoilSensor(FieldRs485Readings *out)
+{
+    static Rs485ReadPlan soil_plan = {
+        .tag = "SOIL",
+        .channel = RS485_SOIL_CHANNEL,
+        .addr = RS485_SOIL_ADDR,
+        .base_start = RS485_SOIL_REG_START,
+        .base_count = RS485_SOIL_REG_COUNT,
 #if RS485_SOIL_HAS_EC
-            if (soil_ec_supported || soil_ec_reprobe_countdown == 0U) {
-                uint16_t ec_reg = 0;
-                int ec_read_ret;
-
-                LOS_Msleep(RS485_INTER_REQUEST_GAP_MS);
-                ec_read_ret = RS485_ModbusReadHoldingRegistersOnChannel(
-                    RS485_SOIL_CHANNEL,
-                    RS485_SOIL_ADDR,
-                    RS485_SOIL_EC_REG,
-                    1,
-                    &ec_reg,
-                    1);
-                if (ec_read_ret == 0) {
-                    if (!soil_ec_supported) {
-                        printf("[RS485 SOIL] optional EC register detected at 0x%04X\n", RS485_SOIL_EC_REG);
-                    }
-                    soil_ec_supported = 1;
-                    soil_ec_unavailable_reported = 0;
-                    soil_ec_reprobe_countdown = 0U;
-                    out->soil_ec_us_cm = (float)ec_reg * RS485_SOIL_EC_SCALE;
-                    out->soil_ec_valid = 1;
-                } else if (!soil_ec_supported) {
-                    soil_ec_reprobe_countdown = RS485_SOIL_EC_REPROBE_READS;
-                    if (!soil_ec_unavailable_reported) {
-                        printf("[RS485 SOIL] optional EC register unavailable; base temperature/moisture remain active\n");
-                        soil_ec_unavailable_reported = 1;
-                    }
-                }
-            }
-            if (!soil_ec_supported && soil_ec_reprobe_countdown > 0U) {
-                soil_ec_reprobe_countdown--;
-            }
+        .ext_start = RS485_SOIL_EC_REG,
+        .ext_count = 1U,
 #endif
-#if RS485_SENSOR_RESULT_LOG
-            if (out->soil_ec_valid) {
-                printf("[RS485 SOIL] ch=%u addr=%u temp=%.*fC moisture=%.*f%% ec=%.0fuS/cm\n",
-                       RS485_SOIL_CHANNEL,
-                       RS485_SOIL_ADDR,
-                       RS485_SOIL_TEMPERATURE_DECIMALS,
-                       out->soil_temperature_c,
-                       RS485_SOIL_MOISTURE_DECIMALS,
-                       out->soil_moisture_pct,
-                       out->soil_ec_us_cm);
-            } else {
-                printf("[RS485 SOIL] ch=%u addr=%u temp=%.*fC moisture=%.*f%% ec=N/A\n",
-                       RS485_SOIL_CHANNEL,
-                       RS485_SOIL_ADDR,
-                       RS485_SOIL_TEMPERATURE_DECIMALS,
-                       out->soil_temperature_c,
-                       RS485_SOIL_MOISTURE_DECIMALS,
-                       out->soil_moisture_pct);
-            }
+#if !RS485_SOIL_COALESCE_READS
+        .mode = RS485_SPAN_SPLIT,
 #endif
+    };
+    uint16_t regs[RS485_SOIL_REG_COUNT + 1] = {0};
+    int ec_valid = 0;
+    int any_valid = 0;
+
+    (void)ReconfigureRs485ChannelWithClock(RS485_SOIL_CHANNEL, RS485_BAUDRATE, SC16IS752_XTAL_HZ);
+    if (ReadPlannedRegisters(&soil_plan, regs, sizeof(regs) / sizeof(regs[0]), &ec_valid) == 0) {
+        out->soil_moisture_pct =
+            (float)regs[RS485_SOIL_MOISTURE_REG_INDEX] * RS485_SOIL_MOISTURE_SCALE;
+        out->soil_temperature_c =
+            SignedRegisterToScaledFloat(regs[RS485_SOIL_TEMPERATURE_REG_INDEX], RS485_SOIL_TEMPERATURE_SCALE);
+        out->soil_valid = 1;
+        any_valid = 1;
+        if (ec_valid) {
+            out->soil_ec_us_cm = (float)regs[RS485_SOIL_REG_COUNT] * RS485_SOIL_EC_SCALE;
+            out->soil_ec_valid = 1;
+        }
+#if RS485_SENSOR_RESULT_LOG
+        if (out->soil_ec_valid) {
+            printf("[RS485 SOIL] ch=%u addr=%u temp=%.*fC moisture=%.*f%% ec=%.0fuS/cm\n",
+                   RS485_SOIL_CHANNEL,
+                   RS485_SOIL_ADDR,
+                   RS485_SOIL_TEMPERATURE_DECIMALS,
+                   out->soil_temperature_c,
+                   RS485_SOIL_MOISTURE_DECIMALS,
+                   out->soil_moisture_pct,
+                   out->soil_ec_us_cm);
+        } else {
+            printf("[RS485 SOIL] ch=%u addr=%u temp=%.*fC moisture=%.*f%% ec=N/A\n",
+                   RS485_SOIL_CHANNEL,
+                   RS485_SOIL_ADDR,
+                   RS485_SOIL_TEMPERATURE_DECIMALS,
+                   out->soil_temperature_c,
+                   RS485_SOIL_MOISTURE_DECIMALS,
+                   out->soil_moisture_pct);
         }
-        LOS_Msleep(RS485_INTER_REQUEST_GAP_MS);
+#endif
     }
+    LOS_Msleep(RS485_ModbusGetInterRequestGapMs(RS485_SOIL_CHANNEL, RS485_SOIL_ADDR));
+
+    return any_valid ? 0 : -1;
+}
 #endif
 
 #if ENABLE_RS485_TILT_SENSOR
-    {
+static int ReadTiltSensor(FieldRs485Readings *out)
+{
 #if RS485_TILT_AUTO_PROBE
-        static int tilt_probe_done = 0;
-        static int tilt_probe_ok = 0;
+    static int tilt_probe_done = 0;
+    static int tilt_probe_ok = 0;
 #endif
-        static uint8_t tilt_channel = RS485_TILT_CHANNEL;
-        static uint8_t tilt_addr = RS485_TILT_ADDR;
-        static unsigned int tilt_baudrate = RS485_BAUDRATE;
-        static unsigned long tilt_xtal_hz = SC16IS752_XTAL_HZ;
-        static uint8_t tilt_function_code = MODBUS_FC_READ_HOLDING_REGISTERS;
-        uint16_t regs[RS485_TILT_REG_COUNT] = {0};
-        int read_ret;
+    static uint8_t tilt_channel = RS485_TILT_CHANNEL;
+    static uint8_t tilt_addr = RS485_TILT_ADDR;
+    static unsigned int tilt_baudrate = RS485_BAUDRATE;
+    static unsigned long tilt_xtal_hz = SC16IS752_XTAL_HZ;
+    static uint8_t tilt_function_code = MODBUS_FC_READ_HOLDING_REGISTERS;
+    uint16_t regs[RS485_TILT_REG_COUNT] = {0};
+    int read_ret;
+    int any_valid = 0;
 
 #if RS485_TILT_AUTO_PROBE
-        if (!tilt_probe_done) {
-            tilt_probe_done = 1;
-            tilt_probe_ok = (ProbeTiltSensor(
-                                 &tilt_channel,
-                                 &tilt_addr,
-                                 &tilt_baudrate,
-                                 &tilt_xtal_hz,
-                                 &tilt_function_code) == 0);
-            if (!tilt_probe_ok) {
-                printf("[RS485 TILT] probe found no response; check RS485 wiring, sensor power, A/B, and sensor address\n");
-            }
+    if (!tilt_probe_done) {
+        tilt_probe_done = 1;
+        tilt_probe_ok = (ProbeTiltSensor(
+                             &tilt_channel,
+                             &tilt_addr,
+                             &tilt_baudrate,
+                             &tilt_xtal_hz,
+                             &tilt_function_code) == 0);
+        if (!tilt_probe_ok) {
+            printf("[RS485 TILT] probe found no response; check RS485 wiring, sensor power, A/B, and sensor address\n");
         }
+    }
 
-        if (tilt_probe_ok) {
-            (void)ReconfigureRs485ChannelWithClock(tilt_channel, tilt_baudrate, tilt_xtal_hz);
-            read_ret = ReadTiltRegistersWithFunction(
-                tilt_channel,
-                tilt_function_code,
-                tilt_addr,
-                regs,
-                RS485_TILT_REG_COUNT,
-                RS485_RESPONSE_TIMEOUT_MS);
-        } else {
-            uint8_t fallback_channel = (RS485_TILT_CHANNEL == RS485_CHANNEL_1) ? RS485_CHANNEL_2 : RS485_CHANNEL_1;
-            read_ret = ReadTiltRegisters(RS485_TILT_CHANNEL, RS485_TILT_ADDR, regs, RS485_TILT_REG_COUNT);
-            if (read_ret != 0) {
-                memset(regs, 0, sizeof(regs));
-                read_ret = ReadTiltRegisters(fallback_channel, RS485_TILT_ADDR, regs, RS485_TILT_REG_COUNT);
-                tilt_channel = fallback_channel;
-            } else {
-                tilt_channel = RS485_TILT_CHANNEL;
-            }
-        }
-#else
+    if (tilt_probe_ok) {
         (void)ReconfigureRs485ChannelWithClock(tilt_channel, tilt_baudrate, tilt_xtal_hz);
         read_ret = ReadTiltRegistersWithFunction(
             tilt_channel,
@@ -397,51 +546,399 @@ int FieldRs485_Read(FieldRs485Readings *out)
             tilt_addr,
             regs,
             RS485_TILT_REG_COUNT,
-            RS485_RESPONSE_TIMEOUT_MS);
+            RS485_ModbusGetResponseTimeoutMs(tilt_channel, tilt_addr));
+    } else {
+        uint8_t fallback_channel = (RS485_TILT_CHANNEL == RS485_CHANNEL_1) ? RS485_CHANNEL_2 : RS485_CHANNEL_1;
+        read_ret = ReadTiltRegisters(RS485_TILT_CHANNEL, RS485_TILT_ADDR, regs, RS485_TILT_REG_COUNT);
+        if (read_ret != 0) {
+            memset(regs, 0, sizeof(regs));
+            read_ret = ReadTiltRegisters(fallback_channel, RS485_TILT_ADDR, regs, RS485_TILT_REG_COUNT);
+            tilt_channel = fallback_channel;
+        } else {
+            tilt_channel = RS485_TILT_CHANNEL;
+        }
+    }
+#else
+    (void)ReconfigureRs485ChannelWithClock(tilt_channel, tilt_baudrate, tilt_xtal_hz);
+    read_ret = ReadTiltRegistersWithFunction(
+        tilt_channel,
+        tilt_function_code,
+        tilt_addr,
+        regs,
+        RS485_TILT_REG_COUNT,
+        RS485_ModbusGetResponseTimeoutMs(tilt_channel, tilt_addr));
 #endif
 
-        if (read_ret == 0) {
-            out->tilt_x_deg = SignedRegisterToScaledFloat(regs[RS485_TILT_X_REG_INDEX], RS485_TILT_SCALE);
-            out->tilt_y_deg = SignedRegisterToScaledFloat(regs[RS485_TILT_Y_REG_INDEX], RS485_TILT_SCALE);
+    if (read_ret == 0) {
+        out->tilt_x_deg = SignedRegisterToScaledFloat(regs[RS485_TILT_X_REG_INDEX], RS485_TILT_SCALE);
+        out->tilt_y_deg = SignedRegisterToScaledFloat(regs[RS485_TILT_Y_REG_INDEX], RS485_TILT_SCALE);
 #if RS485_TILT_REG_COUNT > 2
-            out->tilt_z_deg = SignedRegisterToScaledFloat(regs[RS485_TILT_Z_REG_INDEX], RS485_TILT_SCALE);
+        out->tilt_z_deg = SignedRegisterToScaledFloat(regs[RS485_TILT_Z_REG_INDEX], RS485_TILT_SCALE);
 #endif
-            out->tilt_valid = 1;
-            any_valid = 1;
+        out->tilt_valid = 1;
+        any_valid = 1;
 #if RS485_SENSOR_RESULT_LOG
-            printf("[RS485 TILT] ch=%d addr=%d x=%.*fdeg y=%.*fdeg z=%.*fdeg\n",
-                   tilt_channel,
-                   tilt_addr,
-                   RS485_TILT_DECIMALS,
-                   out->tilt_x_deg,
-                   RS485_TILT_DECIMALS,
-                   out->tilt_y_deg,
-                   RS485_TILT_DECIMALS,
-                   out->tilt_z_deg);
+        printf("[RS485 TILT] ch=%d addr=%d x=%.*fdeg y=%.*fdeg z=%.*fdeg\n",
+               tilt_channel,
+               tilt_addr,
+               RS485_TILT_DECIMALS,
+               out->tilt_x_deg,
+               RS485_TILT_DECIMALS,
+               out->tilt_y_deg,
+               RS485_TILT_DECIMALS,
+               out->tilt_z_deg);
 #endif
-        }
-        LOS_Msleep(RS485_INTER_REQUEST_GAP_MS);
     }
+    LOS_Msleep(RS485_ModbusGetInterRequestGapMs(tilt_channel, tilt_addr));
+
+    return any_valid ? 0 : -1;
+}
 #endif
 
 #if ENABLE_RS485_RAIN_SENSOR
+static int ReadRainSensor(FieldRs485Readings *out)
+{
+    uint16_t regs[RS485_RAIN_REG_COUNT] = {0};
+    int any_valid = 0;
+
+    if (RS485_ModbusReadHoldingRegistersOnChannel(
+            RS485_RAIN_CHANNEL,
+            RS485_RAIN_ADDR,
+            RS485_RAIN_REG_START,
+            RS485_RAIN_REG_COUNT,
+            regs,
+            RS485_RAIN_REG_COUNT) == 0) {
+        out->rain_total_mm = (float)regs[0] * RS485_RAIN_TOTAL_SCALE;
+        out->rain_valid = 1;
+        any_valid = 1;
+        printf("[RS485 RAIN] total=%.1fmm\n", out->rain_total_mm);
+    }
+    LOS_Msleep(RS485_ModbusGetInterRequestGapMs(RS485_RAIN_CHANNEL, RS485_RAIN_ADDR));
+
+    return any_valid ? 0 : -1;
+}
+#endif
+
+static FieldRs485ScheduledDevice g_bus_schedule[FIELD_RS485_DEVICE_COUNT] = {
+#if ENABLE_RS485_SOIL_SENSOR
+    [FIELD_RS485_DEVICE_SOIL] = {"SOIL", ReadSoilSensor, RS485_SOIL_SAMPLE_PERIOD_MS, 0U, 0U, 0U},
+#endif
+#if ENABLE_RS485_TILT_SENSOR
+    [FIELD_RS485_DEVICE_TILT] = {"TILT", ReadTiltSensor, RS485_TILT_SAMPLE_PERIOD_MS, 0U, 0U, 0U},
+#endif
+#if ENABLE_RS485_RAIN_SENSOR
+    [FIELD_RS485_DEVICE_RAIN] = {"RAIN", ReadRainSensor, RS485_RAIN_SAMPLE_PERIOD_MS, 0U, 0U, 0U},
+#endif
+};
+
+static void Cache_Lock(void)
+{
+    if (g_cache_mutex_ready) {
+        (void)LOS_MuxPend(g_cache_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+static void Cache_Unlock(void)
+{
+    if (g_cache_mutex_ready) {
+        (void)LOS_MuxPost(g_cache_mutex);
+    }
+}
+
+// Only the fields owned by the device are overwritten, so a slow slave never
+// clears values another device published. Called for successful reads only:
+// after a failure the last good values stay until IsDeviceStale retires them.
+static void PublishDeviceResult(unsigned int device, const FieldRs485Readings *sample)
+{
+    Cache_Lock();
+    switch (device) {
+        case FIELD_RS485_DEVICE_SOIL:
+            g_latest_readings.soil_temperature_c = sample->soil_temperature_c;
+            g_latest_readings.soil_moisture_pct = sample->soil_moisture_pct;
+            g_latest_readings.soil_ec_us_cm = sample->soil_ec_us_cm;
+            g_latest_readings.soil_ec_valid = sample->soil_ec_valid;
+            g_latest_readings.soil_valid = sample->soil_valid;
+            break;
+        case FIELD_RS485_DEVICE_TILT:
+            g_latest_readings.tilt_x_deg = sample->tilt_x_deg;
+            g_latest_readings.tilt_y_deg = sample->tilt_y_deg;
+            g_latest_readings.tilt_z_deg = sample->tilt_z_deg;
+            g_latest_readings.tilt_valid = sample->tilt_valid;
+            break;
+        case FIELD_RS485_DEVICE_RAIN:
+            g_latest_readings.rain_total_mm = sample->rain_total_mm;
+            g_latest_readings.rain_valid = sample->rain_valid;
+            break;
+        default:
+            break;
+    }
+    Cache_Unlock();
+}
+
+static unsigned int EffectivePeriodMs(const FieldRs485ScheduledDevice *device)
+{
+    return (device->period_ms > 0U) ? device->period_ms : g_default_period_ms;
+}
+
+#if ENABLE_SAMPLE_HISTORY
+// Recorded at the real read time, once per read, not per SensorCollectionTask pass.
+static void RecordHistory(unsigned int device, const FieldRs485Readings *sample, uint32_t now_tick)
+{
+    uint32_t now_ms = (uint32_t)(((uint64_t)now_tick * 1000U) / LOS_MS2Tick(1000U));
+
+    if (device == FIELD_RS485_DEVICE_TILT && sample->tilt_valid) {
+        SampleHistory_Append(SAMPLE_HISTORY_TILT_X, sample->tilt_x_deg, now_ms);
+        SampleHistory_Append(SAMPLE_HISTORY_TILT_Y, sample->tilt_y_deg, now_ms);
+        SampleHistory_Append(SAMPLE_HISTORY_TILT_Z, sample->tilt_z_deg, now_ms);
+    } else if (device == FIELD_RS485_DEVICE_SOIL && sample->soil_valid) {
+        SampleHistory_Append(SAMPLE_HISTORY_SOIL_MOISTURE, sample->soil_moisture_pct, now_ms);
+        SampleHistory_Append(SAMPLE_HISTORY_SOIL_TEMPERATURE, sample->soil_temperature_c, now_ms);
+    }
+}
+#endif
+
+#if ENABLE_RISK_ENGINE
+// Same cadence as RecordHistory: every real read feeds the incremental statistics.
+static void RecordRisk(unsigned int device, const FieldRs485Readings *sample, uint32_t now_tick)
+{
+    uint32_t now_ms = (uint32_t)(((uint64_t)now_tick * 1000U) / LOS_MS2Tick(1000U));
+
+    if (device == FIELD_RS485_DEVICE_TILT && sample->tilt_valid) {
+        RiskEngine_ObserveTilt(sample->tilt_x_deg, sample->tilt_y_deg, now_ms);
+    } else if (device == FIELD_RS485_DEVICE_SOIL && sample->soil_valid) {
+        RiskEngine_ObserveSoilMoisture(sample->soil_moisture_pct, now_ms);
+    } else if (device == FIELD_RS485_DEVICE_RAIN && sample->rain_valid) {
+        RiskEngine_ObserveRainTotal(sample->rain_total_mm, now_ms);
+    }
+}
+#endif
+
+static int IsDeviceStale(const FieldRs485ScheduledDevice *device, uint32_t now_tick)
+{
+    unsigned int stale_ms = EffectivePeriodMs(device) * 3U;
+
+    if (stale_ms < RS485_CACHE_STALE_MIN_MS) {
+        stale_ms = RS485_CACHE_STALE_MIN_MS;
+    }
+    return device->last_ok_tick == 0U || (now_tick - device->last_ok_tick) > LOS_MS2Tick(stale_ms);
+}
+
+int FieldRs485_Init(void)
+{
+    if (!g_cache_mutex_ready) {
+        memset(&g_latest_readings, 0, sizeof(g_latest_readings));
+        g_cache_mutex_ready = (LOS_MuxCreate(&g_cache_mutex) == LOS_OK) ? 1U : 0U;
+        if (!g_cache_mutex_ready) {
+            printf("[RS485] cache mutex create failed; latest readings are best-effort\n");
+        }
+    }
+    return RS485_ModbusInit();
+}
+
+unsigned int FieldRs485_ServiceBus(void)
+{
+    uint32_t now_tick = (uint32_t)LOS_TickCountGet();
+    FieldRs485ScheduledDevice *due = NULL;
+    unsigned int due_index = 0U;
+    int32_t earliest = 0;
+    unsigned int i;
+
+    // Earliest deadline first; with three slaves a linear scan is the whole queue.
+    // The command task retunes periods, so the schedule is read under the cache lock.
+    Cache_Lock();
+    for (i = 0; i < FIELD_RS485_DEVICE_COUNT; ++i) {
+        FieldRs485ScheduledDevice *device = &g_bus_schedule[i];
+        int32_t remaining;
+
+        if (device->read == NULL) {
+            continue;
+        }
+        remaining = (int32_t)(device->next_due_tick - now_tick);
+        if (due == NULL || remaining < earliest) {
+            due = device;
+            due_index = i;
+            earliest = remaining;
+        }
+    }
+    Cache_Unlock();
+
+    if (due == NULL) {
+        return RS485_BUS_IDLE_SLICE_MS;
+    }
+    if (earliest > 0) {
+        unsigned int wait_ms = ((unsigned int)earliest * 1000U) / LOS_MS2Tick(1000U);
+        return (wait_ms < RS485_BUS_IDLE_SLICE_MS) ? (wait_ms > 0U ? wait_ms : 1U) : RS485_BUS_IDLE_SLICE_MS;
+    }
+
     {
-        uint16_t regs[RS485_RAIN_REG_COUNT] = {0};
-        if (RS485_ModbusReadHoldingRegistersOnChannel(
-                RS485_RAIN_CHANNEL,
-                RS485_RAIN_ADDR,
-                RS485_RAIN_REG_START,
-                RS485_RAIN_REG_COUNT,
-                regs,
-                RS485_RAIN_REG_COUNT) == 0) {
-            out->rain_total_mm = (float)regs[0] * RS485_RAIN_TOTAL_SCALE;
-            out->rain_valid = 1;
-            any_valid = 1;
-            printf("[RS485 RAIN] total=%.1fmm\n", out->rain_total_mm);
+        FieldRs485Readings sample;
+        int ret;
+
+        memset(&sample, 0, sizeof(sample));
+        RS485_ModbusLockBus();
+        ret = due->read(&sample);
+        RS485_ModbusUnlockBus();
+
+        now_tick = (uint32_t)LOS_TickCountGet();
+        Cache_Lock();
+        if (ret == 0) {
+            due->last_ok_tick = now_tick;
+            due->consecutive_failures = 0U;
+        } else {
+            due->consecutive_failures++;
+        }
+        // Keep the cadence when on time; after an overrun restart from now
+        // instead of issuing a burst of catch-up reads.
+        due->next_due_tick += LOS_MS2Tick(EffectivePeriodMs(due));
+        if ((int32_t)(due->next_due_tick - now_tick) <= 0) {
+            due->next_due_tick = now_tick + LOS_MS2Tick(EffectivePeriodMs(due));
         }
-        LOS_Msleep(RS485_INTER_REQUEST_GAP_MS);
+        Cache_Unlock();
+
+        if (ret == 0) {
+            PublishDeviceResult(due_index, &sample);
+#if ENABLE_SAMPLE_HISTORY
+            RecordHistory(due_index, &sample, now_tick);
+#endif
+#if ENABLE_RISK_ENGINE
+            RecordRisk(due_index, &sample, now_tick);
+#endif
+        }
+    }
+
+    return 0U;
+}
+
+// Called with the cache lock held.
+static void PullInDeadline(FieldRs485ScheduledDevice *device)
+{
+    uint32_t now_tick = (uint32_t)LOS_TickCountGet();
+    uint32_t due_tick = now_tick + LOS_MS2Tick(EffectivePeriodMs(device));
+
+    // A faster rate takes effect on the next slot instead of after the old period.
+    if ((int32_t)(device->next_due_tick - due_tick) > 0) {
+        device->next_due_tick = due_tick;
+    }
+}
+
+void FieldRs485_SetDefaultPeriodMs(unsigned int period_ms)
+{
+    unsigned int i;
+
+    if (period_ms == 0U) {
+        return;
+    }
+    Cache_Lock();
+    g_default_period_ms = period_ms;
+    for (i = 0; i < FIELD_RS485_DEVICE_COUNT; ++i) {
+        if (g_bus_schedule[i].read != NULL && g_bus_schedule[i].period_ms == 0U) {
+            PullInDeadline(&g_bus_schedule[i]);
+        }
+    }
+    Cache_Unlock();
+}
+
+int FieldRs485_SetDevicePeriodMs(unsigned int device, unsigned int period_ms)
+{
+    if (device >= FIELD_RS485_DEVICE_COUNT || g_bus_schedule[device].read == NULL) {
+        return -1;
+    }
+    Cache_Lock();
+    g_bus_schedule[device].period_ms = period_ms;
+    PullInDeadline(&g_bus_schedule[device]);
+    Cache_Unlock();
+    return 0;
+}
+
+unsigned int FieldRs485_GetDevicePeriodMs(unsigned int device)
+{
+    unsigned int period_ms;
+
+    if (device >= FIELD_RS485_DEVICE_COUNT || g_bus_schedule[device].read == NULL) {
+        return 0U;
+    }
+    Cache_Lock();
+    period_ms = EffectivePeriodMs(&g_bus_schedule[device]);
+    Cache_Unlock();
+    return period_ms;
+}
+
+unsigned int FieldRs485_GetFastestPeriodMs(void)
+{
+    unsigned int fastest = 0U;
+    unsigned int i;
+
+    Cache_Lock();
+    for (i = 0; i < FIELD_RS485_DEVICE_COUNT; ++i) {
+        unsigned int period_ms;
+
+        if (g_bus_schedule[i].read == NULL) {
+            continue;
+        }
+        period_ms = EffectivePeriodMs(&g_bus_schedule[i]);
+        if (fastest == 0U || period_ms < fastest) {
+            fastest = period_ms;
+        }
+    }
+    Cache_Unlock();
+    return fastest;
+}
+
+int FieldRs485_GetLatest(FieldRs485Readings *out)
+{
+    uint32_t now_tick = (uint32_t)LOS_TickCountGet();
+
+    if (out == NULL) {
+        return -1;
+    }
+
+    Cache_Lock();
+    *out = g_latest_readings;
+    if (g_bus_schedule[FIELD_RS485_DEVICE_SOIL].read == NULL ||
+        IsDeviceStale(&g_bus_schedule[FIELD_RS485_DEVICE_SOIL], now_tick)) {
+        out->soil_valid = 0;
+        out->soil_ec_valid = 0;
+    }
+    if (g_bus_schedule[FIELD_RS485_DEVICE_TILT].read == NULL ||
+        IsDeviceStale(&g_bus_schedule[FIELD_RS485_DEVICE_TILT], now_tick)) {
+        out->tilt_valid = 0;
+    }
+    if (g_bus_schedule[FIELD_RS485_DEVICE_RAIN].read == NULL ||
+        IsDeviceStale(&g_bus_schedule[FIELD_RS485_DEVICE_RAIN], now_tick)) {
+        out->rain_valid = 0;
+    }
+    Cache_Unlock();
+
+    return (out->soil_valid || out->tilt_valid || out->rain_valid) ? 0 : -1;
+}
+
+int FieldRs485_Read(FieldRs485Readings *out)
+{
+    int any_valid = 0;
+
+    if (out == NULL) {
+        return -1;
+    }
+
+    memset(out, 0, sizeof(*out));
+
+    RS485_ModbusLockBus();
+#if ENABLE_RS485_SOIL_SENSOR
+    if (ReadSoilSensor(out) == 0) {
+        any_valid = 1;
+    }
+#endif
+#if ENABLE_RS485_TILT_SENSOR
+    if (ReadTiltSensor(out) == 0) {
+        any_valid = 1;
+    }
+#endif
+#if ENABLE_RS485_RAIN_SENSOR
+    if (ReadRainSensor(out) == 0) {
+        any_valid = 1;
     }
 #endif
+    RS485_ModbusUnlockBus();
 
     return any_valid ? 0 : -1;
 }
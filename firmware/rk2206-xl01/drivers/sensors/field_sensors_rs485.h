@@ -17,7 +17,52 @@ typedef struct {
     int rain_valid;
 } FieldRs485Readings;
 
+#define FIELD_RS485_DEVICE_SOIL  0U
+#define FIELD_RS485_DEVICE_TILT  1U
+#define FIELD_RS485_DEVICE_RAIN  2U
+#define FIELD_RS485_DEVICE_COUNT 3U
+
 int FieldRs485_Init(void);
+
+/**
+ * Synchronous read of every enabled device in turn. Kept for bring-up and
+ * diagnostics; the sampling path reads the cache filled by FieldRs485_ServiceBus.
+ */
 int FieldRs485_Read(FieldRs485Readings *out);
 
+/**
+ * Run the bus owner schedule once: read the device whose deadline is
+ * earliest if it is due and publish it to the latest-value cache.
+ * Returns how long the caller may sleep before the next call, in ms.
+ */
+unsigned int FieldRs485_ServiceBus(void);
+
+/**
+ * Copy the latest-value cache. Devices with no good read within
+ * max(3 * period, RS485_CACHE_STALE_MIN_MS) are reported invalid.
+ * Returns 0 when at least one device is valid.
+ */
+int FieldRs485_GetLatest(FieldRs485Readings *out);
+
+/**
+ * Period used by devices without their own rate (the runtime sampling_s).
+ */
+void FieldRs485_SetDefaultPeriodMs(unsigned int period_ms);
+
+/**
+ * Per-device polling period; 0 makes the device follow the default period.
+ * Returns -1 for a device that is not compiled in.
+ */
+int FieldRs485_SetDevicePeriodMs(unsigned int device, unsigned int period_ms);
+
+/**
+ * Effective period for one device, or 0 when the device is not compiled in.
+ */
+unsigned int FieldRs485_GetDevicePeriodMs(unsigned int device);
+
+/**
+ * Shortest effective period across enabled devices, or 0 when none are enabled.
+ */
+unsigned int FieldRs485_GetFastestPeriodMs(void);
+
 #endif // DRIVERS_SENSORS_FIELD_SENSORS_RS485_H
@@ -0,0 +1,211 @@
+#include "gps_binary_frame.h"
+
+#include <stddef.h>
+
+typedef enum {
+    GPS_BINARY_STATE_SYNC_1 = 0,
+    GPS_BINARY_STATE_SYNC_2,
+    GPS_BINARY_STATE_CLASS,
+    GPS_BINARY_STATE_ID,
+    GPS_BINARY_STATE_LEN_LO,
+    GPS_BINARY_STATE_LEN_HI,
+    GPS_BINARY_STATE_PAYLOAD,
+    GPS_BINARY_STATE_CK_A,
+    GPS_BINARY_STATE_CK_B
+} GpsBinaryState;
+
+static uint16_t ReadU16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t ReadU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void FletcherUpdate(GpsBinaryFrameDecoder *decoder, uint8_t value)
+{
+    decoder->ck_a = (uint8_t)(decoder->ck_a + value);
+    decoder->ck_b = (uint8_t)(decoder->ck_b + decoder->ck_a);
+}
+
+// Frames other than NAV-PVT/NAV-DOP are checksummed but never buffered.
+static int IsKeptMessage(uint8_t msg_class, uint8_t msg_id, uint16_t length)
+{
+    if (msg_class != GPS_BINARY_CLASS_NAV) {
+        return 0;
+    }
+    return (msg_id == GPS_BINARY_ID_NAV_PVT && length == GPS_BINARY_NAV_PVT_LEN) ||
+           (msg_id == GPS_BINARY_ID_NAV_DOP && length == GPS_BINARY_NAV_DOP_LEN);
+}
+
+/*
+ * NAV-PVT offsets: 0 iTOW, 4 year, 6 month, 7 day, 8 hour, 9 min, 10 sec,
+ * 11 valid, 20 fixType, 21 flags, 23 numSV, 24 lon, 28 lat, 36 hMSL, 40 hAcc.
+ */
+static void DecodeNavPvt(const GpsBinaryFrameDecoder *decoder, GpsBinaryNav *out)
+{
+    const uint8_t *p = decoder->payload;
+    uint8_t fix_type = p[20];
+    uint8_t flags = p[21];
+    uint8_t carrier_solution = (uint8_t)((flags >> 6) & 0x03U);
+
+    out->itow_ms = ReadU32(p + 0);
+    out->year = ReadU16(p + 4);
+    out->month = p[6];
+    out->day = p[7];
+    out->hour = p[8];
+    out->minute = p[9];
+    out->second = p[10];
+    out->utc_valid = (uint8_t)((p[11] & 0x03U) == 0x03U);
+    out->sats = p[23];
+    out->lon_e7 = (int32_t)ReadU32(p + 24);
+    out->lat_e7 = (int32_t)ReadU32(p + 28);
+    out->height_msl_mm = (int32_t)ReadU32(p + 36);
+    out->h_acc_mm = ReadU32(p + 40);
+    out->hdop_x100 = (decoder->dop_itow_ms == out->itow_ms) ? decoder->dop_hdop_x100 : 0U;
+
+    if ((flags & 0x01U) == 0U || fix_type < 2U || fix_type > 4U) {
+        out->quality = 0;
+    } else if (carrier_solution == 2U) {
+        out->quality = 4;
+    } else if (carrier_solution == 1U) {
+        out->quality = 5;
+    } else if ((flags & 0x02U) != 0U) {
+        out->quality = 2;
+    } else {
+        out->quality = 1;
+    }
+}
+
+void GpsBinaryFrameDecoder_Init(GpsBinaryFrameDecoder *decoder)
+{
+    if (decoder == NULL) {
+        return;
+    }
+    decoder->state = GPS_BINARY_STATE_SYNC_1;
+    decoder->dop_itow_ms = 0xFFFFFFFFU;
+    decoder->dop_hdop_x100 = 0;
+}
+
+int GpsBinaryFrameDecoder_FeedByte(GpsBinaryFrameDecoder *decoder, uint8_t value, GpsBinaryNav *out)
+{
+    if (decoder == NULL || out == NULL) {
+        return -1;
+    }
+
+    switch (decoder->state) {
+        case GPS_BINARY_STATE_SYNC_1:
+            if (value == GPS_BINARY_SYNC_1) {
+                decoder->state = GPS_BINARY_STATE_SYNC_2;
+            }
+            return 0;
+
+        case GPS_BINARY_STATE_SYNC_2:
+            if (value == GPS_BINARY_SYNC_2) {
+                decoder->ck_a = 0;
+                decoder->ck_b = 0;
+                decoder->state = GPS_BINARY_STATE_CLASS;
+            } else {
+                decoder->state = (value == GPS_BINARY_SYNC_1) ? GPS_BINARY_STATE_SYNC_2 : GPS_BINARY_STATE_SYNC_1;
+            }
+            return 0;
+
+        case GPS_BINARY_STATE_CLASS:
+            decoder->msg_class = value;
+            FletcherUpdate(decoder, value);
+            decoder->state = GPS_BINARY_STATE_ID;
+            return 0;
+
+        case GPS_BINARY_STATE_ID:
+            decoder->msg_id = value;
+            FletcherUpdate(decoder, value);
+            decoder->state = GPS_BINARY_STATE_LEN_LO;
+            return 0;
+
+        case GPS_BINARY_STATE_LEN_LO:
+            decoder->length = value;
+            FletcherUpdate(decoder, value);
+            decoder->state = GPS_BINARY_STATE_LEN_HI;
+            return 0;
+
+        case GPS_BINARY_STATE_LEN_HI:
+            decoder->length = (uint16_t)(decoder->length | ((uint16_t)value << 8));
+            FletcherUpdate(decoder, value);
+            decoder->received = 0;
+            decoder->keep = (uint8_t)IsKeptMessage(decoder->msg_class, decoder->msg_id, decoder->length);
+            if (decoder->length > 1024U) {
+                // Longer than anything a receiver sends: this was not a real sync.
+                decoder->state = GPS_BINARY_STATE_SYNC_1;
+                return -1;
+            }
+            decoder->state = decoder->length > 0U ? GPS_BINARY_STATE_PAYLOAD : GPS_BINARY_STATE_CK_A;
+            return 0;
+
+        case GPS_BINARY_STATE_PAYLOAD:
+            FletcherUpdate(decoder, value);
+            if (decoder->keep) {
+                decoder->payload[decoder->received] = value;
+            }
+            decoder->received++;
+            if (decoder->received >= decoder->length) {
+                decoder->state = GPS_BINARY_STATE_CK_A;
+            }
+            return 0;
+
+        case GPS_BINARY_STATE_CK_A:
+            if (value != decoder->ck_a) {
+                decoder->state = GPS_BINARY_STATE_SYNC_1;
+                return -1;
+            }
+            decoder->state = GPS_BINARY_STATE_CK_B;
+            return 0;
+
+        case GPS_BINARY_STATE_CK_B:
+        default:
+            decoder->state = GPS_BINARY_STATE_SYNC_1;
+            if (value != decoder->ck_b) {
+                return -1;
+            }
+            if (!decoder->keep) {
+                return 0;
+            }
+            if (decoder->msg_id == GPS_BINARY_ID_NAV_DOP) {
+                // NAV-DOP offsets: 0 iTOW, 12 hDOP (x100)
+                decoder->dop_itow_ms = ReadU32(decoder->payload);
+                decoder->dop_hdop_x100 = ReadU16(decoder->payload + 12);
+                return 0;
+            }
+            DecodeNavPvt(decoder, out);
+            return 1;
+    }
+}
+
+int GpsBinaryFrame_EncodeCfgMsg(uint8_t msg_class, uint8_t msg_id, uint8_t rate, uint8_t *output, int output_size)
+{
+    uint8_t ck_a = 0;
+    uint8_t ck_b = 0;
+    int i;
+
+    if (output == NULL || output_size < GPS_BINARY_CFG_FRAME_BYTES) {
+        return -1;
+    }
+
+    output[0] = GPS_BINARY_SYNC_1;
+    output[1] = GPS_BINARY_SYNC_2;
+    output[2] = GPS_BINARY_CLASS_CFG;
+    output[3] = GPS_BINARY_ID_CFG_MSG;
+    output[4] = 3;
+    output[5] = 0;
+    output[6] = msg_class;
+    output[7] = msg_id;
+    output[8] = rate;
+    for (i = 2; i < 9; ++i) {
+        ck_a = (uint8_t)(ck_a + output[i]);
+        ck_b = (uint8_t)(ck_b + ck_a);
+    }
+    output[9] = ck_a;
+    output[10] = ck_b;
+    return GPS_BINARY_CFG_FRAME_BYTES;
+}
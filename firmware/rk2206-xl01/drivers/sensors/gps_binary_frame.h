@@ -0,0 +1,71 @@
+#ifndef DRIVERS_SENSORS_GPS_BINARY_FRAME_H
+#define DRIVERS_SENSORS_GPS_BINARY_FRAME_H
+
+#include <stdint.h>
+
+// UBX-style binary navigation framing:
+// 0xB5 0x62 | class | id | len (LE16) | payload | CK_A CK_B (8-bit Fletcher over class..payload)
+#define GPS_BINARY_SYNC_1 0xB5
+#define GPS_BINARY_SYNC_2 0x62
+
+#define GPS_BINARY_CLASS_NAV 0x01
+#define GPS_BINARY_CLASS_CFG 0x06
+#define GPS_BINARY_ID_NAV_DOP 0x04
+#define GPS_BINARY_ID_NAV_PVT 0x07
+#define GPS_BINARY_ID_CFG_MSG 0x01
+
+#define GPS_BINARY_NAV_DOP_LEN 18
+#define GPS_BINARY_NAV_PVT_LEN 92
+#define GPS_BINARY_MAX_PAYLOAD GPS_BINARY_NAV_PVT_LEN
+
+// Largest frame the encoder produces (CFG-MSG with 3-byte payload).
+#define GPS_BINARY_CFG_FRAME_BYTES (6 + 3 + 2)
+
+typedef struct {
+    int32_t lat_e7;          // degrees x 1e7
+    int32_t lon_e7;
+    int32_t height_msl_mm;
+    uint32_t h_acc_mm;
+    uint32_t itow_ms;        // GPS time of week of the solution
+    uint16_t hdop_x100;      // from NAV-DOP of the same epoch, 0 if not seen
+    uint16_t year;
+    uint8_t month;
+    uint8_t day;
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t utc_valid;       // date and time both flagged valid
+    uint8_t quality;         // GGA scale: 0 none, 1 GNSS, 2 DGNSS, 4 RTK fixed, 5 RTK float
+    uint8_t sats;
+} GpsBinaryNav;
+
+typedef struct {
+    uint8_t state;
+    uint8_t msg_class;
+    uint8_t msg_id;
+    uint8_t ck_a;
+    uint8_t ck_b;
+    uint8_t keep;            // payload is buffered only for NAV-PVT/NAV-DOP
+    uint16_t length;
+    uint16_t received;
+    uint32_t dop_itow_ms;
+    uint16_t dop_hdop_x100;
+    uint8_t payload[GPS_BINARY_MAX_PAYLOAD];
+} GpsBinaryFrameDecoder;
+
+void GpsBinaryFrameDecoder_Init(GpsBinaryFrameDecoder *decoder);
+
+/**
+ * Feed one received byte.
+ * @return 1 when a NAV-PVT solution was decoded into out, 0 if more bytes are
+ *         needed, -1 on a checksum or length error (decoder resyncs itself)
+ */
+int GpsBinaryFrameDecoder_FeedByte(GpsBinaryFrameDecoder *decoder, uint8_t value, GpsBinaryNav *out);
+
+/**
+ * Encode CFG-MSG setting the output rate of one message on the current port.
+ * @return frame length, or -1 if output is too small
+ */
+int GpsBinaryFrame_EncodeCfgMsg(uint8_t msg_class, uint8_t msg_id, uint8_t rate, uint8_t *output, int output_size);
+
+#endif // DRIVERS_SENSORS_GPS_BINARY_FRAME_H
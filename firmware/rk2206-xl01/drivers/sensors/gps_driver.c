@@ -13,6 +13,7 @@
  */
 
 #include "gps_driver.h"
+#include "gps_binary_frame.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,8 +22,10 @@
 #include "iot_errno.h"
 #include "../../config/app_config.h"
 #include "utils/fifo.h"  // 使用项目FIFO模块
+#include "utils/time_discipline.h"
 #include "los_tick.h"  // For LOS_TickCountGet
 #include "los_task.h"  // For LOS_TaskCreate
+#include "los_config.h"  // For LOSCFG_BASE_CORE_TICK_PER_SECOND
 #include "cmsis_os2.h"  // For LOS_Msleep
 
 // GPS UART Configuration (moved from config to avoid dependency)
@@ -40,6 +43,8 @@
 #define GPS_POLL_DRAIN_BUDGET_BYTES FIFO_SIZE
 #define GPS_FIX_STALE_TIMEOUT_MS 15000U
 #define GPS_FIFO_STATUS_LOG_INTERVAL_MS 10000U
+#define GPS_NMEA_MAX_FIELDS 24      // RMC/GGA use <= 15; GSV-sized lines are truncated, not rejected
+#define GPS_COORD_FRACTION_DIGITS 6 // DDMM.mmmmmm resolution kept by the integer parser
 
 #ifndef GPS_VERBOSE_NMEA_LOG
 #define GPS_VERBOSE_NMEA_LOG 0
@@ -49,16 +54,78 @@
 #define GPS_UART_PROBE_LOG_MODE 1
 #endif
 
+/*
+ * UM220-IV receiver setup (Unicore N protocol, $CFGMSG,class,id,rate).
+ * GPS_Init leaves the receiver alone; GPS_Poll first measures the default RX
+ * rate, then disables the standard sentences the node never parses, sets the
+ * GGA/RMC output divider, and verifies by watching the stream rather than
+ * trusting an acknowledgement. Settings are not saved to receiver flash, so
+ * they are re-applied each boot.
+ */
+#ifndef GPS_RECEIVER_CONFIGURE
+#define GPS_RECEIVER_CONFIGURE 1
+#endif
+
+#ifndef GPS_NMEA_OUTPUT_PERIOD_S
+#define GPS_NMEA_OUTPUT_PERIOD_S 1U        // GGA/RMC every N 1 Hz epochs
+#endif
+
+#ifndef GPS_CONFIG_BASELINE_MS
+#define GPS_CONFIG_BASELINE_MS 3000U       // measure unconfigured RX rate first
+#endif
+
+#ifndef GPS_CONFIG_SETTLE_MS
+#define GPS_CONFIG_SETTLE_MS 1500U         // sentences already queued in the receiver
+#endif
+
+#ifndef GPS_CONFIG_VERIFY_MS
+#define GPS_CONFIG_VERIFY_MS 5000U
+#endif
+
+#ifndef GPS_CONFIG_MAX_ATTEMPTS
+#define GPS_CONFIG_MAX_ATTEMPTS 3U
+#endif
+
+#ifndef GPS_CONFIG_COMMAND_GAP_MS
+#define GPS_CONFIG_COMMAND_GAP_MS 20U      // receiver needs a pause between CFGMSG commands
+#endif
+
+/*
+ * GPS_PROTOCOL_BINARY decodes UBX-style NAV-PVT/NAV-DOP frames (fixed-layout
+ * position, fix quality, satellites, HDOP, UTC) alongside the NMEA assembler.
+ * NMEA fixes are ignored while binary solutions are fresh and take over again
+ * once none has arrived for GPS_BINARY_FALLBACK_MS.
+ */
+#ifndef GPS_PROTOCOL_NMEA
+#define GPS_PROTOCOL_NMEA 0
+#endif
+
+#ifndef GPS_PROTOCOL_BINARY
+#define GPS_PROTOCOL_BINARY 1
+#endif
+
+#ifndef GPS_PROTOCOL
+#define GPS_PROTOCOL GPS_PROTOCOL_NMEA
+#endif
+
+#ifndef GPS_BINARY_FALLBACK_MS
+#define GPS_BINARY_FALLBACK_MS 3000U
+#endif
+
+#ifndef LOSCFG_BASE_CORE_TICK_PER_SECOND
+#define LOSCFG_BASE_CORE_TICK_PER_SECOND 1000UL
+#endif
+
 #define GPS_UART_PROBE_IDLE_LOG_INTERVAL_MS 3000U
 #define GPS_UART_PROBE_RX_LOG_INTERVAL_MS 1000U
 #define GPS_UART_PROBE_PREVIEW_BYTES 24
 
 // GPS global data
-static float g_gps_latitude = 0.0f;
-static float g_gps_longitude = 0.0f;
+static GpsFix g_gps_fix;
+static GpsEstimator g_gps_estimator;
 static bool g_gps_valid = false;
 static bool g_gps_fixed = false;  // GPS定位状态
-static uint32_t g_gps_last_fix_tick = 0;
+static uint64_t g_gps_last_fix_tick = 0;
 
 // NMEA parsing buffer
 static char g_line_buffer[GPS_LINE_BUF_SIZE];
@@ -67,25 +134,112 @@ static unsigned int g_last_reported_fifo_drop_events = 0;
 static uint32_t g_last_fifo_write_warn_tick = 0;
 static int g_last_uart_read_status = 0;
 static volatile int g_gps_resync_requested = 0;
+static uint32_t g_gps_resync_count = 0;
 static uint32_t g_uart_last_idle_probe_tick = 0;
 static uint32_t g_uart_last_rx_probe_tick = 0;
 static uint32_t g_uart_total_rx_bytes = 0;
-static bool g_line_collecting = false;
+static uint8_t g_line_state = 0;      // NmeaLineState
+static uint8_t g_line_type = 0;       // NmeaSentenceType
+static uint8_t g_line_checksum = 0;   // running XOR of bytes between '$' and '*'
+static uint8_t g_line_expected = 0;   // checksum digits received so far
+static uint32_t g_nmea_parsed_count = 0;
+static uint32_t g_nmea_skipped_count = 0;
+static uint32_t g_nmea_checksum_errors = 0;
+static uint32_t g_nmea_suppressible_count = 0;  // skipped sentences the receiver config disables
+static uint32_t g_binary_frame_count = 0;        // NAV-PVT solutions decoded
+static uint32_t g_binary_error_count = 0;
+static uint32_t g_binary_last_tick = 0;
+#if GPS_PROTOCOL == GPS_PROTOCOL_BINARY
+static GpsBinaryFrameDecoder g_gps_binary_decoder;
+#endif
+
+static uint8_t g_cfg_state = GPS_RECEIVER_CONFIG_DISABLED;
+static uint8_t g_cfg_attempts = 0;
+static bool g_cfg_window_open = false;
+static uint32_t g_cfg_phase_tick = 0;
+static uint32_t g_cfg_phase_rx_bytes = 0;
+static uint32_t g_cfg_phase_parsed = 0;
+static uint32_t g_cfg_phase_suppressible = 0;
+static uint32_t g_cfg_phase_binary = 0;
+static uint8_t g_cfg_send_index = 0;       // next command of the sequence, one per GPS_Poll pass
+static uint8_t g_cfg_send_failures = 0;
+static uint32_t g_cfg_send_tick = 0;
+static uint32_t g_rx_bytes_per_sec = 0;
+static uint32_t g_rx_bytes_per_sec_baseline = 0;
+static uint32_t g_rx_rate_tick = 0;
+static uint32_t g_rx_rate_bytes = 0;
+
+typedef struct {
+    char formatter[4];
+    uint8_t msg_id;
+} GpsNmeaMessageId;
+
+// Standard NMEA sentences the UM220 emits by default and the node never parses.
+static const GpsNmeaMessageId g_gps_suppressed_messages[] = {
+    {"GLL", 1},
+    {"GSA", 2},
+    {"GSV", 3},
+    {"VTG", 5},
+    {"ZDA", 6},
+};
+
+static const GpsNmeaMessageId g_gps_enabled_messages[] = {
+    {"GGA", 0},
+    {"RMC", 4},
+};
 
 // UART中断接收FIFO (1024 bytes, defined in fifo.h)
 static Fifo g_gps_fifo;
 
+/*
+ * Field offsets into g_line_buffer, filled by one pass over the sentence.
+ * Field 0 is the "$GPGGA" address; empty fields (",,") keep their slot with
+ * len 0, which strtok_r used to collapse and shift every later field.
+ */
+/*
+ * Line assembler states. The checksum is folded as bytes arrive and the
+ * sentence type is known after "$ttSSS", so unused sentences (GSV/GSA/VTG/
+ * TXT...) are dropped after 6 bytes instead of being buffered and rescanned.
+ */
+typedef enum {
+    NMEA_LINE_IDLE = 0,     // waiting for '$'
+    NMEA_LINE_ADDRESS,      // talker + formatter, 5 chars
+    NMEA_LINE_BODY,         // buffering fields until '*'
+    NMEA_LINE_CHECKSUM_HI,
+    NMEA_LINE_CHECKSUM_LO,
+    NMEA_LINE_COMPLETE,     // checksum matched, waiting for CR/LF
+    NMEA_LINE_SKIP          // unused or broken sentence, waiting for next '$'
+} NmeaLineState;
+
+typedef enum {
+    NMEA_SENTENCE_UNUSED = 0,
+    NMEA_SENTENCE_GGA,
+    NMEA_SENTENCE_RMC
+} NmeaSentenceType;
+
+#define NMEA_ADDRESS_LEN 6  // "$GNGGA"
+
+typedef struct {
+    const char *line;
+    uint8_t start[GPS_NMEA_MAX_FIELDS];
+    uint8_t len[GPS_NMEA_MAX_FIELDS];
+    uint8_t count;
+} NmeaFields;
+
+// The line is always rewritten from index 0 and NUL-terminated at g_line_pos
+// before parsing, so stale bytes past the cursor are never read.
 static void ResetGpsLineState(void)
 {
-    g_line_collecting = false;
+    g_line_state = NMEA_LINE_IDLE;
     g_line_pos = 0;
-    memset(g_line_buffer, 0, sizeof(g_line_buffer));
 }
 
 static void StartGpsLineState(void)
 {
-    ResetGpsLineState();
-    g_line_collecting = true;
+    g_line_state = NMEA_LINE_ADDRESS;
+    g_line_type = NMEA_SENTENCE_UNUSED;
+    g_line_checksum = 0;
+    g_line_pos = 0;
     g_line_buffer[g_line_pos++] = '$';
 }
 
@@ -103,38 +257,6 @@ static int HexCharValue(char c)
     return -1;
 }
 
-static bool IsNmeaChecksumValid(const char *line)
-{
-    const char *star;
-    unsigned char checksum = 0;
-    unsigned char expected;
-    int hi;
-    int lo;
-    const char *p;
-
-    if (line == NULL || line[0] != '$') {
-        return false;
-    }
-
-    star = strchr(line, '*');
-    if (star == NULL || star <= line + 1 || star[1] == '\0' || star[2] == '\0') {
-        return false;
-    }
-
-    for (p = line + 1; p < star; ++p) {
-        checksum ^= (unsigned char)(*p);
-    }
-
-    hi = HexCharValue(star[1]);
-    lo = HexCharValue(star[2]);
-    if (hi < 0 || lo < 0) {
-        return false;
-    }
-
-    expected = (unsigned char)((hi << 4) | lo);
-    return checksum == expected;
-}
-
 static void PrintGpsUartProbeChunk(const unsigned char *data, int len)
 {
 #if GPS_UART_PROBE_LOG_MODE
@@ -172,202 +294,395 @@ static void PrintGpsUartProbeChunk(const unsigned char *data, int len)
 #endif
 }
 
-// Convert NMEA format (DDMM.MMMM) to decimal degrees (DD.DDDDDD)
-static double ConvertToDegrees(const char* data)
+// Index comma positions of a '$...*hh' sentence of length len; stops at '*'.
+static void TokenizeNmeaFields(const char *line, int len, NmeaFields *fields)
 {
-    if (!data || strlen(data) < 4) {
-        return 0.0;
+    int i;
+    int field_start = 0;
+
+    fields->line = line;
+    fields->count = 0;
+    for (i = 0; i <= len; ++i) {
+        char c = (i < len) ? line[i] : '\0';
+
+        if (c != ',' && c != '*' && c != '\0') {
+            continue;
+        }
+        fields->start[fields->count] = (uint8_t)field_start;
+        fields->len[fields->count] = (uint8_t)(i - field_start);
+        fields->count++;
+        if (c != ',' || fields->count >= GPS_NMEA_MAX_FIELDS) {
+            break;
+        }
+        field_start = i + 1;
     }
-    
-    double temp = atof(data);
-    int degree = (int)(temp / 100);
-    double minutes = temp - degree * 100.0;
-    return degree + minutes / 60.0;
 }
 
-static bool IsNmeaSentenceType(const char *line, const char *sentence_type)
+static char NmeaFieldChar(const NmeaFields *fields, int index)
 {
-    size_t type_len;
+    if (index >= fields->count || fields->len[index] == 0U) {
+        return 0;
+    }
+    return fields->line[fields->start[index]];
+}
 
-    if (line == NULL || sentence_type == NULL || line[0] != '$') {
-        return false;
+/*
+ * Parse an NMEA DDMM.mmmm / DDDMM.mmmm field plus its hemisphere field into
+ * signed degrees x 1e7 using integer arithmetic only (no atof, no copy).
+ * @return 0 on success, -1 if the field is empty or malformed
+ */
+static int ParseNmeaCoordinateE7(const NmeaFields *fields, int index, int max_degrees, int32_t *out_e7)
+{
+    const char *p;
+    const char *end;
+    uint32_t whole = 0;
+    uint32_t micro_minutes;
+    uint32_t fraction = 0;
+    int int_digits = 0;
+    int frac_digits = 0;
+    char hemisphere;
+    uint32_t degrees;
+    uint32_t minutes;
+    int32_t value;
+
+    if (index + 1 >= fields->count || fields->len[index] == 0U) {
+        return -1;
     }
 
-    type_len = strlen(sentence_type);
-    if (type_len == 0U) {
-        return false;
+    p = fields->line + fields->start[index];
+    end = p + fields->len[index];
+    while (p < end && *p >= '0' && *p <= '9') {
+        if (int_digits >= 5) {
+            return -1;
+        }
+        whole = whole * 10U + (uint32_t)(*p - '0');
+        int_digits++;
+        p++;
+    }
+    if (int_digits < 3) {
+        return -1;
+    }
+    if (p < end) {
+        if (*p != '.') {
+            return -1;
+        }
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (frac_digits < GPS_COORD_FRACTION_DIGITS) {
+                fraction = fraction * 10U + (uint32_t)(*p - '0');
+                frac_digits++;
+            }
+            p++;
+        }
+        if (p != end) {
+            return -1;
+        }
+    }
+    for (; frac_digits < GPS_COORD_FRACTION_DIGITS; ++frac_digits) {
+        fraction *= 10U;
     }
 
-    // NMEA talker IDs vary by GNSS constellation: GP/GN/GB/BD/GA/GL...
-    // The sentence formatter is always the last 3 chars after the 2-char talker.
-    return strlen(line) >= (1U + 2U + type_len) &&
-           strncmp(line + 3, sentence_type, type_len) == 0;
+    degrees = whole / 100U;
+    minutes = whole % 100U;
+    if (minutes >= 60U || degrees > (uint32_t)max_degrees) {
+        return -1;
+    }
+
+    // 1e-6 minute / 6 = 1e-7 degree
+    micro_minutes = minutes * 1000000U + fraction;
+    value = (int32_t)(degrees * 10000000U + micro_minutes / 6U);
+    if (value > max_degrees * 10000000) {
+        return -1;
+    }
+
+    hemisphere = NmeaFieldChar(fields, index + 1);
+    if (hemisphere == 'S' || hemisphere == 's' || hemisphere == 'W' || hemisphere == 'w') {
+        value = -value;
+    } else if (hemisphere != 'N' && hemisphere != 'n' && hemisphere != 'E' && hemisphere != 'e') {
+        return -1;
+    }
+
+    *out_e7 = value;
+    return 0;
 }
 
-// Parse GGA sentence from any GNSS talker, for example $GPGGA/$GNGGA/$GBGGA.
-static void ParseGGA(const char* line)
+// Parse an unsigned integer field; 0 on success, -1 if empty or not a number.
+static int ParseNmeaUnsigned(const NmeaFields *fields, int index, uint32_t *out)
 {
-    if (!line) return;
-    bool had_fix = g_gps_fixed;
-    
-    // Make a copy for strtok_r
-    char copy[GPS_LINE_BUF_SIZE];
-    strncpy(copy, line, GPS_LINE_BUF_SIZE - 1);
-    copy[GPS_LINE_BUF_SIZE - 1] = '\0';
-    
-    char latitude_str[16] = {0};
-    char longitude_str[16] = {0};
-    char ns = 0, ew = 0;
-    char fix_quality[2] = {0};
-    
-    int field_index = 0;
-    char *token;
-    char *saveptr;
-    char *p = copy;
-    
-    while ((token = strtok_r(p, ",", &saveptr)) != NULL) {
-        p = NULL;
-        field_index++;
-        
-        switch (field_index) {
-            case 3:  // Latitude (DDMM.MMMM)
-                strncpy(latitude_str, token, sizeof(latitude_str) - 1);
-                break;
-            case 4:  // N/S
-                ns = token[0];
-                break;
-            case 5:  // Longitude (DDDMM.MMMM)
-                strncpy(longitude_str, token, sizeof(longitude_str) - 1);
-                break;
-            case 6:  // E/W
-                ew = token[0];
-                break;
-            case 7:  // Fix quality (0=invalid, 1=GPS fix, 2=DGPS fix)
-                fix_quality[0] = token[0];
-                break;
-            default:
-                break;
+    const char *p;
+    const char *end;
+    uint32_t value = 0;
+
+    if (index >= fields->count || fields->len[index] == 0U) {
+        return -1;
+    }
+    p = fields->line + fields->start[index];
+    end = p + fields->len[index];
+    for (; p < end; ++p) {
+        if (*p < '0' || *p > '9' || value > 99999999U) {
+            return -1;
         }
+        value = value * 10U + (uint32_t)(*p - '0');
     }
-    
+    *out = value;
+    return 0;
+}
+
+// Parse "d.dd" into value x 100 (HDOP "0.8" -> 80); extra decimals are truncated.
+static int ParseNmeaDecimalX100(const NmeaFields *fields, int index, uint32_t *out)
+{
+    const char *p;
+    const char *end;
+    uint32_t whole = 0;
+    uint32_t fraction = 0;
+    int frac_digits = 0;
+
+    if (index >= fields->count || fields->len[index] == 0U) {
+        return -1;
+    }
+    p = fields->line + fields->start[index];
+    end = p + fields->len[index];
+    while (p < end && *p >= '0' && *p <= '9' && whole < 100000U) {
+        whole = whole * 10U + (uint32_t)(*p - '0');
+        p++;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            if (frac_digits < 2) {
+                fraction = fraction * 10U + (uint32_t)(*p - '0');
+                frac_digits++;
+            }
+            p++;
+        }
+    }
+    if (p != end) {
+        return -1;
+    }
+    for (; frac_digits < 2; ++frac_digits) {
+        fraction *= 10U;
+    }
+    *out = whole * 100U + fraction;
+    return 0;
+}
+
+// "hhmmss.sss" -> ms since midnight
+static int ParseNmeaTimeMs(const NmeaFields *fields, int index, uint32_t *out)
+{
+    const char *p;
+    uint32_t hh;
+    uint32_t mm;
+    uint32_t ss;
+    uint32_t ms = 0;
+    uint32_t scale = 100;
+    int i;
+
+    if (index >= fields->count || fields->len[index] < 6U) {
+        return -1;
+    }
+    p = fields->line + fields->start[index];
+    for (i = 0; i < 6; ++i) {
+        if (p[i] < '0' || p[i] > '9') {
+            return -1;
+        }
+    }
+    hh = (uint32_t)((p[0] - '0') * 10 + (p[1] - '0'));
+    mm = (uint32_t)((p[2] - '0') * 10 + (p[3] - '0'));
+    ss = (uint32_t)((p[4] - '0') * 10 + (p[5] - '0'));
+    if (hh > 23U || mm > 59U || ss > 60U) {
+        return -1;
+    }
+    if (fields->len[index] > 6U) {
+        if (p[6] != '.') {
+            return -1;
+        }
+        for (i = 7; i < fields->len[index] && scale > 0U; ++i) {
+            if (p[i] < '0' || p[i] > '9') {
+                return -1;
+            }
+            ms += (uint32_t)(p[i] - '0') * scale;
+            scale /= 10U;
+        }
+    }
+    *out = ((hh * 60U + mm) * 60U + ss) * 1000U + ms;
+    return 0;
+}
+
+// RMC "ddmmyy"
+static int ParseNmeaDate(const NmeaFields *fields, int index, GpsFix *fix)
+{
+    uint32_t ddmmyy;
+    uint32_t day;
+    uint32_t month;
+
+    if (index >= fields->count || fields->len[index] != 6U || ParseNmeaUnsigned(fields, index, &ddmmyy) != 0) {
+        return -1;
+    }
+    day = ddmmyy / 10000U;
+    month = (ddmmyy / 100U) % 100U;
+    if (day < 1U || day > 31U || month < 1U || month > 12U) {
+        return -1;
+    }
+    fix->utc_day = (uint8_t)day;
+    fix->utc_month = (uint8_t)month;
+    fix->utc_year = (uint16_t)(2000U + ddmmyy % 100U);
+    fix->utc_date_valid = 1;
+    return 0;
+}
+
+static void ApplyGpsFix(int32_t lat_e7, int32_t lon_e7)
+{
+    g_gps_fix.lat_e7 = lat_e7;
+    g_gps_fix.lon_e7 = lon_e7;
+    g_gps_valid = true;
+    g_gps_fixed = true;
+    g_gps_last_fix_tick = LOS_TickCountGet();
+    g_gps_fix.fix_tick = g_gps_last_fix_tick;
+}
+
+// One estimator sample per epoch: GGA or NAV-PVT, not RMC (same epoch as GGA).
+static void FeedGpsEstimator(void)
+{
+    uint32_t now_ms = (uint32_t)((g_gps_fix.fix_tick * 1000U) / LOSCFG_BASE_CORE_TICK_PER_SECOND);
+
+    (void)GpsEstimator_AddFix(&g_gps_estimator, g_gps_fix.lat_e7, g_gps_fix.lon_e7, g_gps_fix.hdop_x100, now_ms);
+}
+
+// Only sentences that carry date and time together (RMC, NAV-PVT) steer the
+// clock; pairing GGA time with an older RMC date breaks at midnight.
+static void FeedTimeDiscipline(void)
+{
+    if (!g_gps_fix.utc_time_valid || !g_gps_fix.utc_date_valid) {
+        return;
+    }
+    (void)TimeDiscipline_ObserveGnss(g_gps_fix.utc_year, g_gps_fix.utc_month, g_gps_fix.utc_day,
+                                     g_gps_fix.utc_ms_of_day, g_gps_fix.fix_tick);
+}
+
+static void MarkGpsFixLost(void)
+{
+    g_gps_fixed = false;
+    g_gps_last_fix_tick = 0;
+    g_gps_fix.quality = 0;
+}
+
+// NMEA talker IDs vary by GNSS constellation: GP/GN/GB/BD/GA/GL...
+// The sentence formatter is always the 3 chars after the 2-char talker.
+static NmeaSentenceType ClassifyNmeaAddress(const char *address)
+{
+    const char *formatter = address + 3;
+
+    if (formatter[0] == 'G' && formatter[1] == 'G' && formatter[2] == 'A') {
+        return NMEA_SENTENCE_GGA;
+    }
+    if (formatter[0] == 'R' && formatter[1] == 'M' && formatter[2] == 'C') {
+        return NMEA_SENTENCE_RMC;
+    }
+    return NMEA_SENTENCE_UNUSED;
+}
+
+static bool IsSuppressedNmeaAddress(const char *address)
+{
+    unsigned int i;
+
+    for (i = 0; i < sizeof(g_gps_suppressed_messages) / sizeof(g_gps_suppressed_messages[0]); ++i) {
+        if (strncmp(address + 3, g_gps_suppressed_messages[i].formatter, 3) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Parse GGA sentence from any GNSS talker, for example $GPGGA/$GNGGA/$GBGGA.
+// Format: $GNGGA,time,lat,N/S,lon,E/W,quality,sats,hdop,alt,M,sep,M,age,station*checksum
+static void ParseGGA(const char *line, int len)
+{
+    NmeaFields fields;
+    bool had_fix = g_gps_fixed;
+    char fix_quality;
+    int32_t lat_e7;
+    int32_t lon_e7;
+
+    if (!line) return;
+    TokenizeNmeaFields(line, len, &fields);
+    fix_quality = NmeaFieldChar(&fields, 6);
+
     // GGA fix quality:
     // 1=GPS fix, 2=DGPS fix, 4=RTK fixed, 5=RTK float.
     bool is_position_fix =
-        fix_quality[0] == '1' ||
-        fix_quality[0] == '2' ||
-        fix_quality[0] == '4' ||
-        fix_quality[0] == '5';
-
-    // Check if we have valid data
-    if (latitude_str[0] && longitude_str[0] && is_position_fix) {
-        double lat = ConvertToDegrees(latitude_str);
-        double lon = ConvertToDegrees(longitude_str);
-        
-        if (ns == 'S' || ns == 's') {
-            lat = -lat;
-        }
-        if (ew == 'W' || ew == 'w') {
-            lon = -lon;
-        }
-        
-        // Update global data
-        g_gps_latitude = (float)lat;
-        g_gps_longitude = (float)lon;
-        g_gps_valid = true;
-        g_gps_fixed = true;
-        g_gps_last_fix_tick = LOS_TickCountGet();
+        fix_quality == '1' ||
+        fix_quality == '2' ||
+        fix_quality == '4' ||
+        fix_quality == '5';
+
+    if (is_position_fix &&
+        ParseNmeaCoordinateE7(&fields, 2, 90, &lat_e7) == 0 &&
+        ParseNmeaCoordinateE7(&fields, 4, 180, &lon_e7) == 0) {
+        uint32_t value;
+
+        ApplyGpsFix(lat_e7, lon_e7);
+        g_gps_fix.quality = (uint8_t)(fix_quality - '0');
+        g_gps_fix.sats = (ParseNmeaUnsigned(&fields, 7, &value) == 0 && value < 256U) ? (uint8_t)value : 0U;
+        g_gps_fix.hdop_x100 = (ParseNmeaDecimalX100(&fields, 8, &value) == 0 && value <= 0xFFFFU) ? (uint16_t)value : 0U;
+        g_gps_fix.utc_time_valid = (uint8_t)(ParseNmeaTimeMs(&fields, 1, &g_gps_fix.utc_ms_of_day) == 0);
+        FeedGpsEstimator();
 
         if (!had_fix) {
-            printf("[GPS] Fix acquired (GGA q=%c): lat=%.6f lon=%.6f\n", fix_quality[0], lat, lon);
+            printf("[GPS] Fix acquired (GGA q=%c): lat=%.6f lon=%.6f\n",
+                   fix_quality, (double)lat_e7 / 10000000.0, (double)lon_e7 / 10000000.0);
         }
-    } else if (fix_quality[0] == '0') {
+    } else if (fix_quality == '0') {
         if (had_fix) {
             printf("[GPS] Fix lost (GGA)\n");
         }
-        g_gps_fixed = false;
-        g_gps_last_fix_tick = 0;
+        MarkGpsFixLost();
     }
 }
 
 // Parse RMC sentence from any GNSS talker, for example $GPRMC/$GNRMC/$GBRMC.
 // Format: $GNRMC,time,status,lat,N/S,lon,E/W,speed,course,date,mag_var,mag_dir*checksum
-static void ParseRMC(const char* line)
+static void ParseRMC(const char *line, int len)
 {
-    if (!line) return;
+    NmeaFields fields;
     bool had_fix = g_gps_fixed;
-    
-    // Make a copy for strtok_r
-    char copy[GPS_LINE_BUF_SIZE];
-    strncpy(copy, line, GPS_LINE_BUF_SIZE - 1);
-    copy[GPS_LINE_BUF_SIZE - 1] = '\0';
-    
-    char latitude_str[16] = {0};
-    char longitude_str[16] = {0};
-    char ns = 0, ew = 0;
-    char status = 0;
-    
-    int field_index = 0;
-    char *token;
-    char *saveptr;
-    char *p = copy;
-    
-    while ((token = strtok_r(p, ",", &saveptr)) != NULL) {
-        p = NULL;
-        field_index++;
-        
-        switch (field_index) {
-            case 3:  // Status (A=valid, V=invalid)
-                status = token[0];
-                break;
-            case 4:  // Latitude (DDMM.MMMM)
-                strncpy(latitude_str, token, sizeof(latitude_str) - 1);
-                break;
-            case 5:  // N/S
-                ns = token[0];
-                break;
-            case 6:  // Longitude (DDDMM.MMMM)
-                strncpy(longitude_str, token, sizeof(longitude_str) - 1);
-                break;
-            case 7:  // E/W
-                ew = token[0];
-                break;
-            default:
-                break;
-        }
-    }
-    
+    char status;
+    int32_t lat_e7;
+    int32_t lon_e7;
+    bool has_position;
+
+    if (!line) return;
+    TokenizeNmeaFields(line, len, &fields);
+    status = NmeaFieldChar(&fields, 2);
+    has_position =
+        ParseNmeaCoordinateE7(&fields, 3, 90, &lat_e7) == 0 &&
+        ParseNmeaCoordinateE7(&fields, 5, 180, &lon_e7) == 0;
+
     // Check if we have valid data (status='A' means valid)
-    if (latitude_str[0] && longitude_str[0] && (status == 'A' || status == 'a')) {
-        double lat = ConvertToDegrees(latitude_str);
-        double lon = ConvertToDegrees(longitude_str);
-        
-        if (ns == 'S' || ns == 's') {
-            lat = -lat;
+    if (has_position && (status == 'A' || status == 'a')) {
+        ApplyGpsFix(lat_e7, lon_e7);
+        // RMC carries no quality/satellites/HDOP; keep what the epoch's GGA reported.
+        if (g_gps_fix.quality == 0U) {
+            g_gps_fix.quality = 1;
         }
-        if (ew == 'W' || ew == 'w') {
-            lon = -lon;
+        g_gps_fix.utc_time_valid = (uint8_t)(ParseNmeaTimeMs(&fields, 1, &g_gps_fix.utc_ms_of_day) == 0);
+        if (ParseNmeaDate(&fields, 9, &g_gps_fix) != 0) {
+            g_gps_fix.utc_date_valid = 0;
         }
-        
-        // Update global data
-        g_gps_latitude = (float)lat;
-        g_gps_longitude = (float)lon;
-        g_gps_valid = true;
-        g_gps_fixed = true;
-        g_gps_last_fix_tick = LOS_TickCountGet();
+        FeedTimeDiscipline();
 
         if (!had_fix) {
-            printf("[GPS] Fix acquired (RMC): lat=%.6f lon=%.6f\n", lat, lon);
+            printf("[GPS] Fix acquired (RMC): lat=%.6f lon=%.6f\n",
+                   (double)lat_e7 / 10000000.0, (double)lon_e7 / 10000000.0);
         }
     } else if (status == 'V' || status == 'v') {
         if (had_fix) {
             printf("[GPS] Fix lost (RMC)\n");
         }
-        g_gps_fixed = false;
-        g_gps_last_fix_tick = 0;
+        MarkGpsFixLost();
     } else {
         // 数据不完整的警告
-        if (GPS_VERBOSE_NMEA_LOG && status == 'A' && (!latitude_str[0] || !longitude_str[0])) {
-            printf("[GPS] WARN RMC data incomplete: lat=%s lon=%s\n", latitude_str, longitude_str);
+        if (GPS_VERBOSE_NMEA_LOG && status == 'A' && !has_position) {
+            printf("[GPS] WARN RMC data incomplete: %s\n", line);
         }
     }
 }
@@ -450,63 +765,350 @@ static void GPS_UartPollTask(void)
     }
 }
 
-// Process received UART data
+static uint32_t MsToTicksAtLeastOne(uint32_t ms)
+{
+    uint32_t ticks = LOS_MS2Tick(ms);
+    return ticks == 0U ? 1U : ticks;
+}
+
+static bool IsBinaryNavFresh(void)
+{
+    return g_binary_last_tick != 0U &&
+           (LOS_TickCountGet() - g_binary_last_tick) < MsToTicksAtLeastOne(GPS_BINARY_FALLBACK_MS);
+}
+
+#if GPS_PROTOCOL == GPS_PROTOCOL_BINARY
+static void ProcessGpsBinaryByte(uint8_t value)
+{
+    GpsBinaryNav nav;
+    bool had_fix = g_gps_fixed;
+    int ret = GpsBinaryFrameDecoder_FeedByte(&g_gps_binary_decoder, value, &nav);
+
+    if (ret < 0) {
+        g_binary_error_count++;
+        return;
+    }
+    if (ret == 0) {
+        return;
+    }
+
+    g_binary_frame_count++;
+    g_binary_last_tick = LOS_TickCountGet();
+    if (nav.quality != 0U) {
+        ApplyGpsFix(nav.lat_e7, nav.lon_e7);
+        g_gps_fix.quality = nav.quality;
+        g_gps_fix.sats = nav.sats;
+        g_gps_fix.hdop_x100 = nav.hdop_x100;
+        g_gps_fix.utc_time_valid = nav.utc_valid;
+        g_gps_fix.utc_date_valid = nav.utc_valid;
+        g_gps_fix.utc_year = nav.year;
+        g_gps_fix.utc_month = nav.month;
+        g_gps_fix.utc_day = nav.day;
+        g_gps_fix.utc_ms_of_day = ((uint32_t)nav.hour * 3600U + (uint32_t)nav.minute * 60U + nav.second) * 1000U;
+        FeedGpsEstimator();
+        FeedTimeDiscipline();
+        if (!had_fix) {
+            printf("[GPS] Fix acquired (PVT q=%u sats=%u hdop=%u.%02u): lat=%.7f lon=%.7f\n",
+                   nav.quality, nav.sats, nav.hdop_x100 / 100U, nav.hdop_x100 % 100U,
+                   (double)nav.lat_e7 / 10000000.0, (double)nav.lon_e7 / 10000000.0);
+        }
+    } else if (had_fix) {
+        printf("[GPS] Fix lost (PVT)\n");
+        MarkGpsFixLost();
+    }
+}
+#endif
+
+static void DispatchGpsLine(void)
+{
+    g_line_buffer[g_line_pos] = '\0';
+    g_nmea_parsed_count++;
+
+    // NMEA is only the fallback while binary navigation frames are arriving.
+    if (IsBinaryNavFresh()) {
+        return;
+    }
+
+    if (g_line_type == NMEA_SENTENCE_GGA) {
+        ParseGGA(g_line_buffer, g_line_pos);
+    } else if (g_line_type == NMEA_SENTENCE_RMC) {
+        ParseRMC(g_line_buffer, g_line_pos);
+    }
+
+    // 只打印有用的语句（减少输出噪音）
+    if (GPS_VERBOSE_NMEA_LOG) {
+        printf("[GPS RAW] %s\n", g_line_buffer);
+    }
+}
+
+// Process received UART data one byte at a time; see NmeaLineState.
 static void ProcessGPSData(const unsigned char* data, int len)
 {
     for (int i = 0; i < len; i++) {
-        char c = data[i];
+        char c = (char)data[i];
+        int nibble;
+
+#if GPS_PROTOCOL == GPS_PROTOCOL_BINARY
+        ProcessGpsBinaryByte((uint8_t)data[i]);
+#endif
 
         if (c == '$') {
             StartGpsLineState();
             continue;
         }
 
-        // 只接受可打印字符和换行符，过滤乱码
-        if (c == '\n' || c == '\r') {
-            if (g_line_collecting && g_line_pos > 6) {  // 至少需要"$XXXXX"
-                g_line_buffer[g_line_pos] = '\0';
+        switch (g_line_state) {
+            case NMEA_LINE_ADDRESS:
+                if (c < 0x20 || c > 0x7E || c == ',' || c == '*') {
+                    ResetGpsLineState();
+                    break;
+                }
+                g_line_checksum ^= (uint8_t)c;
+                g_line_buffer[g_line_pos++] = c;
+                if (g_line_pos == NMEA_ADDRESS_LEN) {
+                    g_line_type = (uint8_t)ClassifyNmeaAddress(g_line_buffer);
+                    if (g_line_type == NMEA_SENTENCE_UNUSED) {
+                        g_nmea_skipped_count++;
+                        if (IsSuppressedNmeaAddress(g_line_buffer)) {
+                            g_nmea_suppressible_count++;
+                        }
+                        g_line_state = NMEA_LINE_SKIP;
+                    } else {
+                        g_line_state = NMEA_LINE_BODY;
+                    }
+                }
+                break;
 
-                // 只处理关键的NMEA语句（RMC和GGA），兼容 GP/GN/GB 等 talker。
-                bool is_useful = false;
-                if (!IsNmeaChecksumValid(g_line_buffer)) {
+            case NMEA_LINE_BODY:
+                if (c == '*') {
+                    g_line_state = NMEA_LINE_CHECKSUM_HI;
+                } else if (c >= 0x20 && c <= 0x7E && g_line_pos < GPS_LINE_BUF_SIZE - 1) {
+                    g_line_checksum ^= (uint8_t)c;
+                    g_line_buffer[g_line_pos++] = c;
+                } else {
+                    // 乱码、提前换行或超长行：丢弃整行
                     ResetGpsLineState();
-                    continue;
                 }
+                break;
 
-                if (IsNmeaSentenceType(g_line_buffer, "GGA")) {
-                    is_useful = true;
-                    ParseGGA(g_line_buffer);
+            case NMEA_LINE_CHECKSUM_HI:
+            case NMEA_LINE_CHECKSUM_LO:
+                nibble = HexCharValue(c);
+                if (nibble < 0) {
+                    ResetGpsLineState();
+                    break;
                 }
-                else if (IsNmeaSentenceType(g_line_buffer, "RMC")) {
-                    is_useful = true;
-                    ParseRMC(g_line_buffer);
+                if (g_line_state == NMEA_LINE_CHECKSUM_HI) {
+                    g_line_expected = (uint8_t)(nibble << 4);
+                    g_line_state = NMEA_LINE_CHECKSUM_LO;
+                } else if ((uint8_t)(g_line_expected | nibble) == g_line_checksum) {
+                    g_line_state = NMEA_LINE_COMPLETE;
+                } else {
+                    g_nmea_checksum_errors++;
+                    ResetGpsLineState();
                 }
-                
-                // 只打印有用的语句（减少输出噪音）
-                if (GPS_VERBOSE_NMEA_LOG && is_useful) {
-                    printf("[GPS RAW] %s\n", g_line_buffer);
+                break;
+
+            case NMEA_LINE_COMPLETE:
+                if (c == '\r' || c == '\n') {
+                    DispatchGpsLine();
                 }
-                
-                ResetGpsLineState();
-            } else {
-                // 丢弃过短的行
-                ResetGpsLineState();
-            }
-        } else if (c >= 0x20 && c <= 0x7E) {  // 只接受可打印ASCII字符
-            if (!g_line_collecting) {
-                continue;
-            }
-            if (g_line_pos < GPS_LINE_BUF_SIZE - 1) {
-                g_line_buffer[g_line_pos++] = c;
-            } else {
-                // Buffer overflow - 丢弃整行
                 ResetGpsLineState();
-            }
+                break;
+
+            case NMEA_LINE_SKIP:
+            case NMEA_LINE_IDLE:
+            default:
+                break;
         }
-        // 忽略其他字符（乱码）
     }
 }
 
+// Frame "$<body>*hh\r\n" and write it to the receiver.
+static int SendReceiverCommand(const char *body)
+{
+    char frame[48];
+    uint8_t checksum = 0;
+    const char *p;
+    int len;
+
+    for (p = body; *p != '\0'; ++p) {
+        checksum ^= (uint8_t)*p;
+    }
+    len = snprintf(frame, sizeof(frame), "$%s*%02X\r\n", body, checksum);
+    if (len <= 0 || len >= (int)sizeof(frame)) {
+        return -1;
+    }
+    return IoTUartWrite(GPS_UART_ID, (unsigned char *)frame, (unsigned int)len) == len ? 0 : -1;
+}
+
+#define GPS_SUPPRESSED_COUNT (sizeof(g_gps_suppressed_messages) / sizeof(g_gps_suppressed_messages[0]))
+#define GPS_ENABLED_COUNT (sizeof(g_gps_enabled_messages) / sizeof(g_gps_enabled_messages[0]))
+
+#if GPS_PROTOCOL == GPS_PROTOCOL_BINARY
+static const uint8_t g_gps_binary_cfg_ids[] = {GPS_BINARY_ID_NAV_PVT, GPS_BINARY_ID_NAV_DOP};
+#define GPS_CONFIG_COMMAND_COUNT (GPS_SUPPRESSED_COUNT + GPS_ENABLED_COUNT + sizeof(g_gps_binary_cfg_ids))
+#else
+#define GPS_CONFIG_COMMAND_COUNT (GPS_SUPPRESSED_COUNT + GPS_ENABLED_COUNT)
+#endif
+
+// Write command index of the configuration sequence.
+static int SendReceiverConfigCommand(unsigned int index)
+{
+    char body[32];
+
+    if (index < GPS_SUPPRESSED_COUNT) {
+        snprintf(body, sizeof(body), "CFGMSG,0,%u,0", g_gps_suppressed_messages[index].msg_id);
+        return SendReceiverCommand(body);
+    }
+    index -= GPS_SUPPRESSED_COUNT;
+    if (index < GPS_ENABLED_COUNT) {
+        snprintf(body, sizeof(body), "CFGMSG,0,%u,%u", g_gps_enabled_messages[index].msg_id, GPS_NMEA_OUTPUT_PERIOD_S);
+        return SendReceiverCommand(body);
+    }
+#if GPS_PROTOCOL == GPS_PROTOCOL_BINARY
+    index -= GPS_ENABLED_COUNT;
+    {
+        uint8_t frame[GPS_BINARY_CFG_FRAME_BYTES];
+        int len = GpsBinaryFrame_EncodeCfgMsg(GPS_BINARY_CLASS_NAV, g_gps_binary_cfg_ids[index],
+                                              (uint8_t)GPS_NMEA_OUTPUT_PERIOD_S, frame, sizeof(frame));
+
+        return (len > 0 && IoTUartWrite(GPS_UART_ID, frame, (unsigned int)len) == len) ? 0 : -1;
+    }
+#else
+    return -1;
+#endif
+}
+
+static void BeginReceiverConfiguration(void)
+{
+    g_cfg_send_index = 0U;
+    g_cfg_send_failures = 0U;
+}
+
+/*
+ * Send the next command once the gap since the previous one has passed, so
+ * GPS_Poll never sleeps for the receiver.
+ * @return true once the whole sequence has been written
+ */
+static bool StepReceiverConfiguration(uint32_t now)
+{
+    if (g_cfg_send_index >= GPS_CONFIG_COMMAND_COUNT) {
+        return true;
+    }
+    if (g_cfg_send_index > 0U && (now - g_cfg_send_tick) < MsToTicksAtLeastOne(GPS_CONFIG_COMMAND_GAP_MS)) {
+        return false;
+    }
+    g_cfg_send_failures += (SendReceiverConfigCommand(g_cfg_send_index) != 0);
+    g_cfg_send_index++;
+    g_cfg_send_tick = now;
+    if (g_cfg_send_index < GPS_CONFIG_COMMAND_COUNT) {
+        return false;
+    }
+    if (g_cfg_send_failures > 0U) {
+        printf("[GPS] WARN receiver config: %u command writes failed\n", g_cfg_send_failures);
+    }
+    return true;
+}
+
+static uint32_t BytesPerSecond(uint32_t bytes, uint32_t ticks)
+{
+    if (ticks == 0U) {
+        return 0U;
+    }
+    return (uint32_t)(((uint64_t)bytes * LOSCFG_BASE_CORE_TICK_PER_SECOND) / ticks);
+}
+
+static void StartReceiverConfigPhase(uint32_t now)
+{
+    g_cfg_phase_tick = now;
+    g_cfg_phase_rx_bytes = g_uart_total_rx_bytes;
+    g_cfg_phase_parsed = g_nmea_parsed_count;
+    g_cfg_phase_suppressible = g_nmea_suppressible_count;
+    g_cfg_phase_binary = g_binary_frame_count;
+}
+
+/*
+ * Non-blocking receiver configuration, stepped from GPS_Poll. Verification
+ * passes when no suppressed sentence arrives in the window and GGA/RMC do,
+ * at no more than the requested rate.
+ */
+static void ServiceReceiverConfig(uint32_t now)
+{
+    uint32_t elapsed = now - g_cfg_phase_tick;
+
+    if (g_cfg_state == GPS_RECEIVER_CONFIG_PENDING) {
+        if (elapsed < MsToTicksAtLeastOne(GPS_CONFIG_BASELINE_MS)) {
+            return;
+        }
+        g_rx_bytes_per_sec_baseline = BytesPerSecond(g_uart_total_rx_bytes - g_cfg_phase_rx_bytes, elapsed);
+        g_cfg_attempts++;
+        BeginReceiverConfiguration();
+        g_cfg_state = GPS_RECEIVER_CONFIG_VERIFYING;
+        g_cfg_window_open = false;
+        printf("[GPS] Receiver config sending (attempt %u, baseline %u B/s)\n",
+               g_cfg_attempts, g_rx_bytes_per_sec_baseline);
+        return;
+    }
+
+    if (g_cfg_state != GPS_RECEIVER_CONFIG_VERIFYING) {
+        return;
+    }
+
+    if (g_cfg_send_index < GPS_CONFIG_COMMAND_COUNT) {
+        // Settle counts from the last command.
+        if (StepReceiverConfiguration(now)) {
+            StartReceiverConfigPhase(now);
+        }
+        return;
+    }
+
+    if (!g_cfg_window_open) {
+        if (elapsed >= MsToTicksAtLeastOne(GPS_CONFIG_SETTLE_MS)) {
+            g_cfg_window_open = true;
+            StartReceiverConfigPhase(now);
+        }
+        return;
+    }
+
+    if (elapsed >= MsToTicksAtLeastOne(GPS_CONFIG_VERIFY_MS)) {
+        uint32_t parsed = g_nmea_parsed_count - g_cfg_phase_parsed;
+        uint32_t residual = g_nmea_suppressible_count - g_cfg_phase_suppressible;
+        uint32_t binary = g_binary_frame_count - g_cfg_phase_binary;
+        uint32_t rx_bps = BytesPerSecond(g_uart_total_rx_bytes - g_cfg_phase_rx_bytes, elapsed);
+        // Two sentences per output epoch, plus one epoch of slack at each window edge.
+        uint32_t max_parsed = 2U * (GPS_CONFIG_VERIFY_MS / (GPS_NMEA_OUTPUT_PERIOD_S * 1000U) + 2U);
+
+        if (residual == 0U && (parsed > 0U || binary > 0U) && parsed <= max_parsed) {
+            g_cfg_state = GPS_RECEIVER_CONFIG_VERIFIED;
+            printf("[GPS] Receiver config verified: GGA/RMC every %us, rx %u -> %u B/s\n",
+                   GPS_NMEA_OUTPUT_PERIOD_S, g_rx_bytes_per_sec_baseline, rx_bps);
+        } else if (g_cfg_attempts < GPS_CONFIG_MAX_ATTEMPTS) {
+            printf("[GPS] Receiver config not applied (residual=%u parsed=%u), retrying\n", residual, parsed);
+            g_cfg_attempts++;
+            BeginReceiverConfiguration();
+            g_cfg_window_open = false;
+        } else {
+            g_cfg_state = GPS_RECEIVER_CONFIG_FAILED;
+            printf("[GPS] WARN receiver config failed after %u attempts (residual=%u parsed=%u rx=%u B/s); "
+                   "unused sentences are still dropped by the parser\n",
+                   g_cfg_attempts, residual, parsed, rx_bps);
+        }
+    }
+}
+
+static void UpdateRxRate(uint32_t now)
+{
+    uint32_t elapsed = now - g_rx_rate_tick;
+
+    if (elapsed < MsToTicksAtLeastOne(GPS_FIFO_STATUS_LOG_INTERVAL_MS)) {
+        return;
+    }
+    g_rx_bytes_per_sec = BytesPerSecond(g_uart_total_rx_bytes - g_rx_rate_bytes, elapsed);
+    g_rx_rate_tick = now;
+    g_rx_rate_bytes = g_uart_total_rx_bytes;
+}
+
 int GPS_Init(void)
 {
     printf("[GPS] Initializing UART id=%u with polling task (baud=%d)...\n", GPS_UART_ID, GPS_BAUDRATE);
@@ -549,6 +1151,18 @@ int GPS_Init(void)
         return -1;
     }
     
+#if GPS_PROTOCOL == GPS_PROTOCOL_BINARY
+    GpsBinaryFrameDecoder_Init(&g_gps_binary_decoder);
+#endif
+    GpsEstimator_Init(&g_gps_estimator);
+
+    g_rx_rate_tick = LOS_TickCountGet();
+    g_rx_rate_bytes = g_uart_total_rx_bytes;
+#if GPS_RECEIVER_CONFIGURE
+    g_cfg_state = GPS_RECEIVER_CONFIG_PENDING;
+    StartReceiverConfigPhase(g_rx_rate_tick);
+#endif
+
     printf("[OK] GPS initialized with NMEA parsing + polling task\n");
     g_gps_valid = true;  // UART is valid, waiting for fix
     
@@ -562,15 +1176,16 @@ void GPS_Poll(void)
     unsigned char recv_buf[GPS_RECV_BUF_SIZE];
     unsigned int total_drained = 0;
     unsigned int dropped_events = Fifo_DroppedEvents(&g_gps_fifo);
+    bool resync = false;
 
     if (g_gps_resync_requested) {
         g_gps_resync_requested = 0;
-        ResetGpsLineState();
+        resync = true;
     }
 
     if (dropped_events != g_last_reported_fifo_drop_events) {
         g_last_reported_fifo_drop_events = dropped_events;
-        ResetGpsLineState();
+        resync = true;
         printf("[GPS] FIFO overrun detected: dropped_bytes=%u dropped_events=%u avail=%d high_water=%u\n",
                Fifo_DroppedBytes(&g_gps_fifo),
                dropped_events,
@@ -578,6 +1193,11 @@ void GPS_Poll(void)
                Fifo_HighWatermark(&g_gps_fifo));
     }
 
+    if (resync) {
+        g_gps_resync_count++;
+        ResetGpsLineState();
+    }
+
     // 从FIFO读取数据（轮询任务已经把数据写入FIFO），单次尽量清空 backlog。
     while (total_drained < GPS_POLL_DRAIN_BUDGET_BYTES) {
         unsigned int remaining_budget = GPS_POLL_DRAIN_BUDGET_BYTES - total_drained;
@@ -597,6 +1217,11 @@ void GPS_Poll(void)
         total_drained += (unsigned int)len;
     }
 
+    UpdateRxRate(LOS_TickCountGet());
+#if GPS_RECEIVER_CONFIGURE
+    ServiceReceiverConfig(LOS_TickCountGet());
+#endif
+
     // 调试：每10秒打印一次FIFO状态
     {
         static uint32_t last_print = 0;
@@ -617,11 +1242,18 @@ void GPS_Poll(void)
                        Fifo_DroppedEvents(&g_gps_fifo),
                        Fifo_HighWatermark(&g_gps_fifo));
             }
+            if (GPS_VERBOSE_NMEA_LOG) {
+                printf("[GPS] NMEA: rx=%u B/s parsed=%u skipped=%u checksum_errors=%u\n",
+                       g_rx_bytes_per_sec,
+                       g_nmea_parsed_count,
+                       g_nmea_skipped_count,
+                       g_nmea_checksum_errors);
+            }
         }
     }
 
     if (g_gps_fixed && g_gps_last_fix_tick != 0U) {
-        uint32_t now = LOS_TickCountGet();
+        uint64_t now = LOS_TickCountGet();
         uint32_t stale_timeout_ticks = LOS_MS2Tick(GPS_FIX_STALE_TIMEOUT_MS);
 
         if (stale_timeout_ticks == 0U) {
@@ -629,8 +1261,7 @@ void GPS_Poll(void)
         }
 
         if ((now - g_gps_last_fix_tick) > stale_timeout_ticks) {
-            g_gps_fixed = false;
-            g_gps_last_fix_tick = 0U;
+            MarkGpsFixLost();
             printf("[GPS] Fix expired after %u ms without fresh valid sentence\n", GPS_FIX_STALE_TIMEOUT_MS);
         }
     }
@@ -643,10 +1274,78 @@ int GPS_Read(float *lat, float *lon)
     }
     
     // 总是更新坐标值（即使fix状态为false）
-    *lat = g_gps_latitude;
-    *lon = g_gps_longitude;
+    *lat = (float)((double)g_gps_fix.lat_e7 / 10000000.0);
+    *lon = (float)((double)g_gps_fix.lon_e7 / 10000000.0);
     
     // 返回值表示GPS是否有有效定位
     // 但坐标值已经被更新（可能是最后一次有效定位的坐标）
     return g_gps_fixed ? 0 : -1;
 }
+
+int GPS_ReadFix(GpsFix *fix)
+{
+    if (fix == NULL || !g_gps_valid) {
+        return -1;
+    }
+
+    *fix = g_gps_fix;
+    fix->age_ms = (g_gps_fix.fix_tick != 0U)
+        ? (uint32_t)(((LOS_TickCountGet() - g_gps_fix.fix_tick) * 1000U) / LOSCFG_BASE_CORE_TICK_PER_SECOND)
+        : 0U;
+    return g_gps_fixed ? 0 : -1;
+}
+
+int GPS_GetEstimate(GpsEstimate *estimate)
+{
+    return GpsEstimator_GetResult(&g_gps_estimator, estimate);
+}
+
+int GPS_GetStats(GpsStats *stats)
+{
+    if (stats == NULL) {
+        return -1;
+    }
+
+    stats->rx_bytes_total = g_uart_total_rx_bytes;
+    stats->rx_bytes_per_sec = g_rx_bytes_per_sec;
+    stats->rx_bytes_per_sec_baseline = g_rx_bytes_per_sec_baseline;
+    stats->nmea_parsed = g_nmea_parsed_count;
+    stats->nmea_skipped = g_nmea_skipped_count;
+    stats->nmea_checksum_errors = g_nmea_checksum_errors;
+    stats->fifo_high_watermark = Fifo_HighWatermark(&g_gps_fifo);
+    stats->fifo_dropped_bytes = Fifo_DroppedBytes(&g_gps_fifo);
+    stats->resync_events = g_gps_resync_count;
+    stats->binary_frames = g_binary_frame_count;
+    stats->binary_errors = g_binary_error_count;
+    stats->binary_active = IsBinaryNavFresh() ? 1U : 0U;
+    stats->receiver_config_state = g_cfg_state;
+    stats->receiver_config_attempts = g_cfg_attempts;
+    return 0;
+}
+
+const char *GPS_ReceiverConfigStateName(uint8_t state)
+{
+    switch (state) {
+        case GPS_RECEIVER_CONFIG_DISABLED:
+            return "disabled";
+        case GPS_RECEIVER_CONFIG_PENDING:
+            return "pending";
+        case GPS_RECEIVER_CONFIG_VERIFYING:
+            return "verifying";
+        case GPS_RECEIVER_CONFIG_VERIFIED:
+            return "verified";
+        case GPS_RECEIVER_CONFIG_FAILED:
+            return "failed";
+        default:
+            return "unknown";
+    }
+}
+
+#if GPS_ENABLE_HOST_HOOKS
+void GPS_ProcessBytes(const unsigned char *data, int len)
+{
+    if (data != NULL && len > 0) {
+        ProcessGPSData(data, len);
+    }
+}
+#endif
@@ -12,6 +12,54 @@
 #ifndef DRIVERS_SENSORS_GPS_DRIVER_H
 #define DRIVERS_SENSORS_GPS_DRIVER_H
 
+#include <stdint.h>
+#include "gps_estimator.h"
+
+/*
+ * Latest position solution. Coordinates are signed degrees x 1e7 (~1.1 cm),
+ * which a float cannot hold near 30N/110E (~2 m steps).
+ */
+typedef struct {
+    int32_t lat_e7;
+    int32_t lon_e7;
+    uint8_t quality;            // GGA scale: 0 none, 1 GNSS, 2 DGNSS, 4 RTK fixed, 5 RTK float
+    uint8_t sats;               // satellites used, 0 if not reported
+    uint16_t hdop_x100;         // 0 if not reported
+    uint16_t utc_year;          // date fields valid when utc_date_valid
+    uint8_t utc_month;
+    uint8_t utc_day;
+    uint8_t utc_time_valid;
+    uint8_t utc_date_valid;
+    uint32_t utc_ms_of_day;     // UTC time of the solution, ms since 00:00
+    uint64_t fix_tick;          // LOS tick when the solution was received, full width
+    uint32_t age_ms;            // filled by GPS_ReadFix
+} GpsFix;
+
+typedef enum {
+    GPS_RECEIVER_CONFIG_DISABLED = 0,  // GPS_RECEIVER_CONFIGURE=0, receiver defaults kept
+    GPS_RECEIVER_CONFIG_PENDING,       // measuring the unconfigured RX rate
+    GPS_RECEIVER_CONFIG_VERIFYING,     // commands sent, watching the sentence stream
+    GPS_RECEIVER_CONFIG_VERIFIED,
+    GPS_RECEIVER_CONFIG_FAILED
+} GpsReceiverConfigState;
+
+typedef struct {
+    uint32_t rx_bytes_total;
+    uint32_t rx_bytes_per_sec;          // over the last status interval
+    uint32_t rx_bytes_per_sec_baseline; // before receiver configuration, 0 if not measured
+    uint32_t nmea_parsed;               // GGA/RMC with valid checksum
+    uint32_t nmea_skipped;              // sentences dropped after the address field
+    uint32_t nmea_checksum_errors;
+    uint32_t fifo_high_watermark;       // most bytes queued between the poll task and GPS_Poll
+    uint32_t fifo_dropped_bytes;        // lost to a full FIFO
+    uint32_t resync_events;             // line parser restarts after FIFO overruns
+    uint32_t binary_frames;             // GPS_PROTOCOL_BINARY navigation solutions
+    uint32_t binary_errors;             // binary checksum/length errors
+    uint8_t binary_active;              // 1 while binary frames are fresh, 0 = NMEA in use
+    uint8_t receiver_config_state;      // GpsReceiverConfigState
+    uint8_t receiver_config_attempts;
+} GpsStats;
+
 /**
  * Initialize GPS module
  * @return 0 on success, negative on error
@@ -31,4 +79,38 @@ void GPS_Poll(void);
  */
 int GPS_Read(float *lat, float *lon);
 
+/**
+ * Read the latest solution with quality, satellites, HDOP, UTC and age
+ * @param fix Output: last received solution (kept after the fix is lost)
+ * @return 0 if GPS has a current fix, negative otherwise
+ */
+int GPS_ReadFix(GpsFix *fix);
+
+/**
+ * Averaged position, scatter and displacement rate from the on-node estimator
+ * (fed by GGA or binary solutions)
+ * @return 0 when enough fixes were accepted, negative otherwise
+ */
+int GPS_GetEstimate(GpsEstimate *estimate);
+
+/**
+ * Copy UART/NMEA counters and receiver configuration progress
+ * @return 0 on success, -1 on NULL output
+ */
+int GPS_GetStats(GpsStats *stats);
+
+/**
+ * Short name of a GpsReceiverConfigState for logs and command results
+ */
+const char *GPS_ReceiverConfigStateName(uint8_t state);
+
+#if GPS_ENABLE_HOST_HOOKS
+/**
+ * Run received bytes straight through the NMEA/binary parser, bypassing the
+ * UART and FIFO. Host benchmarks and replay harnesses only; firmware builds
+ * leave GPS_ENABLE_HOST_HOOKS unset.
+ */
+void GPS_ProcessBytes(const unsigned char *data, int len);
+#endif
+
 #endif // DRIVERS_SENSORS_GPS_DRIVER_H
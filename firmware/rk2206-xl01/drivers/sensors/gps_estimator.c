@@ -0,0 +1,199 @@
+#include "gps_estimator.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#define GPS_EST_EARTH_RADIUS_M 6371008.8
+#define GPS_EST_PI 3.14159265358979323846
+#define GPS_EST_SECONDS_PER_DAY 86400.0f
+
+static void SetReference(GpsEstimator *est, int32_t lat_e7, int32_t lon_e7)
+{
+    double m_per_deg = GPS_EST_EARTH_RADIUS_M * GPS_EST_PI / 180.0;
+    double lat_rad = ((double)lat_e7 / 10000000.0) * GPS_EST_PI / 180.0;
+
+    est->ref_lat_e7 = lat_e7;
+    est->ref_lon_e7 = lon_e7;
+    est->m_per_lat_e7 = (float)(m_per_deg / 10000000.0);
+    est->m_per_lon_e7 = (float)(m_per_deg * cos(lat_rad) / 10000000.0);
+    est->has_reference = 1;
+}
+
+static void AdvanceClock(GpsEstimator *est, uint32_t now_ms)
+{
+    if (!est->has_clock) {
+        est->has_clock = 1;
+        est->last_ms = now_ms;
+        return;
+    }
+    est->clock_ms += now_ms - est->last_ms;
+    est->last_ms = now_ms;
+    est->clock_s += est->clock_ms / 1000U;
+    est->clock_ms %= 1000U;
+}
+
+static void CloseBucket(GpsEstimator *est)
+{
+    GpsEstimatorBucket *slot;
+
+    if (est->bucket_weight > 0.0f) {
+        slot = &est->ring[est->ring_head];
+        slot->t_s = est->bucket_start_s + GPS_EST_BUCKET_S / 2U;
+        slot->east_m = est->bucket_east / est->bucket_weight;
+        slot->north_m = est->bucket_north / est->bucket_weight;
+        est->ring_head = (uint16_t)((est->ring_head + 1U) % GPS_EST_RATE_BUCKETS);
+        if (est->ring_count < GPS_EST_RATE_BUCKETS) {
+            est->ring_count++;
+        }
+    }
+    est->bucket_weight = 0.0f;
+    est->bucket_east = 0.0f;
+    est->bucket_north = 0.0f;
+}
+
+void GpsEstimator_Init(GpsEstimator *est)
+{
+    if (est == NULL) {
+        return;
+    }
+    memset(est, 0, sizeof(*est));
+}
+
+int GpsEstimator_AddFix(GpsEstimator *est, int32_t lat_e7, int32_t lon_e7, uint16_t hdop_x100, uint32_t now_ms)
+{
+    float hdop;
+    float weight;
+    float east;
+    float north;
+    float d_east;
+    float d_north;
+
+    if (est == NULL) {
+        return -1;
+    }
+
+    AdvanceClock(est, now_ms);
+    if (!est->has_reference) {
+        SetReference(est, lat_e7, lon_e7);
+        est->bucket_start_s = est->clock_s;
+    }
+
+    east = (float)(lon_e7 - est->ref_lon_e7) * est->m_per_lon_e7;
+    north = (float)(lat_e7 - est->ref_lat_e7) * est->m_per_lat_e7;
+    d_east = east - est->mean_east;
+    d_north = north - est->mean_north;
+
+    if (est->accepted >= GPS_EST_MIN_FIXES && est->weight_sum > 0.0f) {
+        float variance = (est->m2_east + est->m2_north) / est->weight_sum;
+        float limit = GPS_EST_OUTLIER_SIGMA * sqrtf(variance);
+
+        if (limit < GPS_EST_OUTLIER_FLOOR_M) {
+            limit = GPS_EST_OUTLIER_FLOOR_M;
+        }
+        if (d_east * d_east + d_north * d_north > limit * limit) {
+            est->rejected++;
+            est->consecutive_rejects++;
+            if (est->consecutive_rejects >= GPS_EST_MAX_CONSECUTIVE_REJECTS) {
+                // The antenna (or the reference) moved for good: start over here.
+                uint32_t rejected = est->rejected;
+                GpsEstimator_Init(est);
+                est->rejected = rejected;
+                return GpsEstimator_AddFix(est, lat_e7, lon_e7, hdop_x100, now_ms);
+            }
+            return 0;
+        }
+    }
+    est->consecutive_rejects = 0;
+
+    // Weight 1/HDOP^2; a missing HDOP counts as 1.0. Clamp so one
+    // over-optimistic epoch cannot dominate the window.
+    hdop = (hdop_x100 > 0U) ? (float)hdop_x100 / 100.0f : 1.0f;
+    if (hdop < 0.5f) {
+        hdop = 0.5f;
+    }
+    weight = 1.0f / (hdop * hdop);
+
+    // Weighted Welford (West 1979); capping weight_sum turns it into an
+    // exponential window of about GPS_EST_MEAN_WINDOW fixes.
+    if (est->weight_sum + weight > GPS_EST_MEAN_WINDOW) {
+        float scale = (GPS_EST_MEAN_WINDOW - weight) / est->weight_sum;
+
+        est->weight_sum *= scale;
+        est->m2_east *= scale;
+        est->m2_north *= scale;
+    }
+    est->weight_sum += weight;
+    est->mean_east += d_east * (weight / est->weight_sum);
+    est->mean_north += d_north * (weight / est->weight_sum);
+    est->m2_east += weight * d_east * (east - est->mean_east);
+    est->m2_north += weight * d_north * (north - est->mean_north);
+    est->accepted++;
+
+    if (est->clock_s - est->bucket_start_s >= GPS_EST_BUCKET_S) {
+        CloseBucket(est);
+        est->bucket_start_s = est->clock_s;
+    }
+    est->bucket_weight += weight;
+    est->bucket_east += weight * east;
+    est->bucket_north += weight * north;
+    return 1;
+}
+
+int GpsEstimator_GetResult(const GpsEstimator *est, GpsEstimate *out)
+{
+    if (est == NULL || out == NULL || est->accepted < GPS_EST_MIN_FIXES || est->weight_sum <= 0.0f) {
+        return -1;
+    }
+
+    out->mean_lat_deg = ((double)est->ref_lat_e7 + (double)(est->mean_north / est->m_per_lat_e7)) / 10000000.0;
+    out->mean_lon_deg = ((double)est->ref_lon_e7 + (double)(est->mean_east / est->m_per_lon_e7)) / 10000000.0;
+    out->std_m = sqrtf((est->m2_east + est->m2_north) / est->weight_sum);
+    out->accepted = est->accepted;
+    out->rejected = est->rejected;
+    out->rate_valid = 0;
+    out->rate_mm_per_day = 0.0f;
+    out->rate_east_mm_per_day = 0.0f;
+    out->rate_north_mm_per_day = 0.0f;
+
+    if (est->ring_count >= GPS_EST_RATE_MIN_BUCKETS) {
+        // Least squares over the ring, times relative to the newest bucket.
+        unsigned int newest = (est->ring_head + GPS_EST_RATE_BUCKETS - 1U) % GPS_EST_RATE_BUCKETS;
+        uint32_t t_ref = est->ring[newest].t_s;
+        float sum_t = 0.0f;
+        float sum_e = 0.0f;
+        float sum_n = 0.0f;
+        float mean_t;
+        float mean_e;
+        float mean_n;
+        float s_tt = 0.0f;
+        float s_te = 0.0f;
+        float s_tn = 0.0f;
+        unsigned int i;
+
+        for (i = 0; i < est->ring_count; ++i) {
+            const GpsEstimatorBucket *b = &est->ring[(newest + GPS_EST_RATE_BUCKETS - i) % GPS_EST_RATE_BUCKETS];
+            sum_t += -(float)(t_ref - b->t_s);
+            sum_e += b->east_m;
+            sum_n += b->north_m;
+        }
+        mean_t = sum_t / (float)est->ring_count;
+        mean_e = sum_e / (float)est->ring_count;
+        mean_n = sum_n / (float)est->ring_count;
+        for (i = 0; i < est->ring_count; ++i) {
+            const GpsEstimatorBucket *b = &est->ring[(newest + GPS_EST_RATE_BUCKETS - i) % GPS_EST_RATE_BUCKETS];
+            float dt = -(float)(t_ref - b->t_s) - mean_t;
+            s_tt += dt * dt;
+            s_te += dt * (b->east_m - mean_e);
+            s_tn += dt * (b->north_m - mean_n);
+        }
+        if (s_tt > 0.0f) {
+            out->rate_east_mm_per_day = s_te / s_tt * GPS_EST_SECONDS_PER_DAY * 1000.0f;
+            out->rate_north_mm_per_day = s_tn / s_tt * GPS_EST_SECONDS_PER_DAY * 1000.0f;
+            out->rate_mm_per_day = sqrtf(out->rate_east_mm_per_day * out->rate_east_mm_per_day +
+                                         out->rate_north_mm_per_day * out->rate_north_mm_per_day);
+            out->rate_valid = 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+#ifndef DRIVERS_SENSORS_GPS_ESTIMATOR_H
+#define DRIVERS_SENSORS_GPS_ESTIMATOR_H
+
+#include <stdint.h>
+
+/*
+ * Streaming position estimator for a static GNSS antenna.
+ * Fixes are projected to east/north metres around the first accepted fix.
+ * - Mean/variance: HDOP-weighted Welford with the total weight capped at
+ *   GPS_EST_MEAN_WINDOW, so old fixes fade out instead of freezing the mean.
+ * - Outliers: fixes further than max(K sigma, floor) from the mean are dropped;
+ *   a long run of rejections restarts the estimator (antenna moved).
+ * - Rate: fixes are averaged into GPS_EST_BUCKET_S buckets kept in a ring of
+ *   GPS_EST_RATE_BUCKETS, and a least-squares line over the ring gives mm/day.
+ * Fixed memory; O(1) per fix, O(GPS_EST_RATE_BUCKETS) per GetResult.
+ */
+#ifndef GPS_EST_MEAN_WINDOW
+#define GPS_EST_MEAN_WINDOW 600.0f        // fixes at HDOP 1.0
+#endif
+
+#ifndef GPS_EST_MIN_FIXES
+#define GPS_EST_MIN_FIXES 10U             // before outlier rejection starts
+#endif
+
+#ifndef GPS_EST_OUTLIER_SIGMA
+#define GPS_EST_OUTLIER_SIGMA 4.0f
+#endif
+
+#ifndef GPS_EST_OUTLIER_FLOOR_M
+#define GPS_EST_OUTLIER_FLOOR_M 3.0f
+#endif
+
+#ifndef GPS_EST_MAX_CONSECUTIVE_REJECTS
+#define GPS_EST_MAX_CONSECUTIVE_REJECTS 120U
+#endif
+
+#ifndef GPS_EST_BUCKET_S
+#define GPS_EST_BUCKET_S 900U             // 15 min
+#endif
+
+#ifndef GPS_EST_RATE_BUCKETS
+#define GPS_EST_RATE_BUCKETS 96U          // 24 h of buckets
+#endif
+
+#ifndef GPS_EST_RATE_MIN_BUCKETS
+#define GPS_EST_RATE_MIN_BUCKETS 4U
+#endif
+
+typedef struct {
+    uint32_t t_s;       // bucket midpoint, seconds on the estimator clock
+    float east_m;
+    float north_m;
+} GpsEstimatorBucket;
+
+typedef struct {
+    int32_t ref_lat_e7;
+    int32_t ref_lon_e7;
+    float m_per_lat_e7;
+    float m_per_lon_e7;
+    uint8_t has_reference;
+
+    float weight_sum;
+    float mean_east;
+    float mean_north;
+    float m2_east;
+    float m2_north;
+    uint32_t accepted;
+    uint32_t rejected;
+    uint32_t consecutive_rejects;
+
+    uint8_t has_clock;
+    uint32_t last_ms;
+    uint32_t clock_ms;
+    uint32_t clock_s;
+
+    uint32_t bucket_start_s;
+    float bucket_weight;
+    float bucket_east;
+    float bucket_north;
+
+    GpsEstimatorBucket ring[GPS_EST_RATE_BUCKETS];
+    uint16_t ring_head;
+    uint16_t ring_count;
+} GpsEstimator;
+
+typedef struct {
+    double mean_lat_deg;
+    double mean_lon_deg;
+    float std_m;                // horizontal 1-sigma of accepted fixes
+    float rate_mm_per_day;      // horizontal displacement speed
+    float rate_east_mm_per_day;
+    float rate_north_mm_per_day;
+    uint32_t accepted;
+    uint32_t rejected;
+    uint8_t rate_valid;
+} GpsEstimate;
+
+void GpsEstimator_Init(GpsEstimator *est);
+
+/**
+ * Add one fix. now_ms is any monotonic millisecond counter (wraps allowed).
+ * @return 1 if accepted, 0 if rejected as an outlier, -1 on bad arguments
+ */
+int GpsEstimator_AddFix(GpsEstimator *est, int32_t lat_e7, int32_t lon_e7, uint16_t hdop_x100, uint32_t now_ms);
+
+/**
+ * @return 0 when enough fixes were accepted to report a mean, -1 otherwise
+ */
+int GpsEstimator_GetResult(const GpsEstimator *est, GpsEstimate *out);
+
+#endif // DRIVERS_SENSORS_GPS_ESTIMATOR_H
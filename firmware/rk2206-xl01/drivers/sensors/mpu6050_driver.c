@@ -6,7 +6,11 @@
 #include <stdio.h>
 #include <stdint.h>
 #include "los_task.h"
+#include "los_mux.h"
+#include "los_sem.h"
+#include "los_tick.h"
 #include "iot_i2c.h"
+#include "iot_gpio.h"
 #include "iot_errno.h"
 
 // MPU6050 I2C Address (moved from config to avoid dependency)
@@ -22,6 +26,10 @@
 #define I2C_BAUDRATE        EI2C_FRE_100K
 #endif
 
+#ifndef MPU6050_RAW_DIAG_MODE
+#define MPU6050_RAW_DIAG_MODE 0        // 1=print raw counts every tenth MPU6050_ReadRaw
+#endif
+
 // MPU6050 Register Definitions
 #define MPU6050_REG_PWR_MGMT_1      0x6B    // Power management 1
 #define MPU6050_REG_WHO_AM_I        0x75    // Device ID register
@@ -29,15 +37,59 @@
 #define MPU6050_REG_GYRO_CONFIG     0x1B    // Gyroscope config
 #define MPU6050_REG_CONFIG          0x1A    // General config
 #define MPU6050_REG_ACCEL_XOUT_H    0x3B    // Accelerometer X high byte
+#define MPU6050_REG_SMPLRT_DIV      0x19    // Sample rate = gyro output rate / (1 + div)
+#define MPU6050_REG_FIFO_EN         0x23    // Which sensors feed the FIFO
+#define MPU6050_REG_INT_PIN_CFG     0x37    // INT pin level/latch behaviour
+#define MPU6050_REG_INT_ENABLE      0x38    // Interrupt sources
+#define MPU6050_REG_INT_STATUS      0x3A    // Interrupt status, cleared on read
+#define MPU6050_REG_USER_CTRL       0x6A    // FIFO enable/reset
+#define MPU6050_REG_FIFO_COUNTH     0x72    // FIFO byte count high byte
+#define MPU6050_REG_FIFO_R_W        0x74    // FIFO data port
+#define MPU6050_FIFO_EN_ACCEL       0x08
+#define MPU6050_USER_CTRL_FIFO_EN   0x40
+#define MPU6050_USER_CTRL_FIFO_RST  0x04
+#define MPU6050_INT_DATA_RDY        0x01
+#define MPU6050_INT_FIFO_OFLOW      0x10
+#define MPU6050_DLPF_DEFAULT        0x03    // 44 Hz, used by the register-read path
+#define MPU6050_FIFO_BURST_SAMPLES  42U     // 252 bytes, the longest single I2C read
 #define MPU6050_I2C_RETRY_COUNT     3
 #define MPU6050_I2C_RETRY_DELAY_MS  2
 
+static UINT32 g_mpu6050_mutex = 0U;
+static unsigned char g_mpu6050_mutex_ready = 0U;
+static UINT32 g_fifo_sem = 0U;
+static unsigned char g_fifo_sem_ready = 0U;
+static int g_fifo_int_gpio = MPU6050_NO_INT_GPIO;
+static volatile uint16_t g_fifo_watermark = 1U;
+static volatile uint16_t g_fifo_pending = 0U;
+
 // ==================== Private Functions ====================
 
+// The capture task and the sensor loop both address the MPU6050; a register
+// pointer write from one must not land between the other's write and read.
+static void MPU6050_Lock(void)
+{
+    if (g_mpu6050_mutex_ready) {
+        (void)LOS_MuxPend(g_mpu6050_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+static void MPU6050_Unlock(void)
+{
+    if (g_mpu6050_mutex_ready) {
+        (void)LOS_MuxPost(g_mpu6050_mutex);
+    }
+}
+
 static int MPU6050_WriteReg(uint8_t reg, uint8_t value)
 {
     uint8_t data[2] = {reg, value};
-    return IoTI2cWrite(I2C_IDX, MPU6050_I2C_ADDR, data, 2);
+    int ret;
+
+    MPU6050_Lock();
+    ret = IoTI2cWrite(I2C_IDX, MPU6050_I2C_ADDR, data, 2);
+    MPU6050_Unlock();
+    return ret;
 }
 
 static int MPU6050_ReadReg(uint8_t reg, uint8_t *value)
@@ -46,16 +98,19 @@ static int MPU6050_ReadReg(uint8_t reg, uint8_t *value)
     int last_ret = -1;
 
     for (attempt = 0; attempt < MPU6050_I2C_RETRY_COUNT; ++attempt) {
+        MPU6050_Lock();
         unsigned int ret = IoTI2cWrite(I2C_IDX, MPU6050_I2C_ADDR, &reg, 1);
         if (ret != IOT_SUCCESS) {
             last_ret = -1;
         } else {
             ret = IoTI2cRead(I2C_IDX, MPU6050_I2C_ADDR, value, 1);
             if (ret == IOT_SUCCESS) {
+                MPU6050_Unlock();
                 return 0;
             }
             last_ret = -2;
         }
+        MPU6050_Unlock();
 
         if (attempt + 1 < MPU6050_I2C_RETRY_COUNT) {
             LOS_Msleep(MPU6050_I2C_RETRY_DELAY_MS);
@@ -71,16 +126,19 @@ static int MPU6050_ReadMultiReg(uint8_t reg, uint8_t *buffer, uint8_t len)
     int last_ret = -1;
 
     for (attempt = 0; attempt < MPU6050_I2C_RETRY_COUNT; ++attempt) {
+        MPU6050_Lock();
         unsigned int ret = IoTI2cWrite(I2C_IDX, MPU6050_I2C_ADDR, &reg, 1);
         if (ret != IOT_SUCCESS) {
             last_ret = -1;
         } else {
             ret = IoTI2cRead(I2C_IDX, MPU6050_I2C_ADDR, buffer, len);
             if (ret == IOT_SUCCESS) {
+                MPU6050_Unlock();
                 return 0;
             }
             last_ret = -2;
         }
+        MPU6050_Unlock();
 
         if (attempt + 1 < MPU6050_I2C_RETRY_COUNT) {
             LOS_Msleep(MPU6050_I2C_RETRY_DELAY_MS);
@@ -90,6 +148,37 @@ static int MPU6050_ReadMultiReg(uint8_t reg, uint8_t *buffer, uint8_t len)
     return last_ret;
 }
 
+// Counts data-ready pulses; the MPU6050 has no FIFO watermark interrupt of its own.
+static void MPU6050_DataReadyIsr(char *arg)
+{
+    (void)arg;
+    if (++g_fifo_pending >= g_fifo_watermark) {
+        g_fifo_pending = 0U;
+        (void)LOS_SemPost(g_fifo_sem);
+    }
+}
+
+// Widest DLPF that still keeps the bandwidth under half the sample rate
+static uint8_t MPU6050_DlpfForRate(uint16_t rate_hz)
+{
+    if (rate_hz >= 400U) {
+        return 0x01;    // 184 Hz
+    }
+    if (rate_hz >= 200U) {
+        return 0x02;    // 94 Hz
+    }
+    if (rate_hz >= 100U) {
+        return 0x03;    // 44 Hz
+    }
+    if (rate_hz >= 50U) {
+        return 0x04;    // 21 Hz
+    }
+    if (rate_hz >= 20U) {
+        return 0x05;    // 10 Hz
+    }
+    return 0x06;        // 5 Hz
+}
+
 // ==================== Public Functions ====================
 
 int MPU6050_Init(void)
@@ -97,6 +186,10 @@ int MPU6050_Init(void)
     uint8_t device_id = 0;
     int ret;
     
+    if (!g_mpu6050_mutex_ready) {
+        g_mpu6050_mutex_ready = (LOS_MuxCreate(&g_mpu6050_mutex) == LOS_OK) ? 1U : 0U;
+    }
+
     printf("[MPU6050] Initializing...\n");
     printf("[DEBUG] I2C_IDX = %d, I2C_ADDR = 0x%02X\n", I2C_IDX, MPU6050_I2C_ADDR);
     
@@ -150,7 +243,7 @@ int MPU6050_Init(void)
     
     // Configure digital low-pass filter (44Hz)
     printf("[DEBUG] Configuring low-pass filter (44Hz)...\n");
-    if (MPU6050_WriteReg(MPU6050_REG_CONFIG, 0x03) != 0) {
+    if (MPU6050_WriteReg(MPU6050_REG_CONFIG, MPU6050_DLPF_DEFAULT) != 0) {
         printf("[ERROR] Filter config failed\n");
         return -6;
     }
@@ -159,11 +252,12 @@ int MPU6050_Init(void)
     return 0;
 }
 
-int MPU6050_Read(float *ax, float *ay, float *az,
-                 float *gx, float *gy, float *gz)
+int MPU6050_ReadRaw(int16_t accel[3], int16_t gyro[3])
 {
     uint8_t buffer[14];
+#if MPU6050_RAW_DIAG_MODE
     static int read_count = 0;
+#endif
     
     // Read 14 bytes starting from accelerometer register
     int ret = MPU6050_ReadMultiReg(MPU6050_REG_ACCEL_XOUT_H, buffer, 14);
@@ -174,32 +268,178 @@ int MPU6050_Read(float *ax, float *ay, float *az,
     }
     
     // Parse raw data
-    int16_t accel_x_raw = (int16_t)((buffer[0] << 8) | buffer[1]);
-    int16_t accel_y_raw = (int16_t)((buffer[2] << 8) | buffer[3]);
-    int16_t accel_z_raw = (int16_t)((buffer[4] << 8) | buffer[5]);
+    accel[0] = (int16_t)((buffer[0] << 8) | buffer[1]);
+    accel[1] = (int16_t)((buffer[2] << 8) | buffer[3]);
+    accel[2] = (int16_t)((buffer[4] << 8) | buffer[5]);
     // buffer[6-7] = temperature
-    int16_t gyro_x_raw = (int16_t)((buffer[8] << 8) | buffer[9]);
-    int16_t gyro_y_raw = (int16_t)((buffer[10] << 8) | buffer[11]);
-    int16_t gyro_z_raw = (int16_t)((buffer[12] << 8) | buffer[13]);
+    gyro[0] = (int16_t)((buffer[8] << 8) | buffer[9]);
+    gyro[1] = (int16_t)((buffer[10] << 8) | buffer[11]);
+    gyro[2] = (int16_t)((buffer[12] << 8) | buffer[13]);
     
+#if MPU6050_RAW_DIAG_MODE
     // Debug: Print raw values every 10 reads
     read_count++;
     if (read_count % 10 == 1) {
         printf("[DEBUG] MPU6050 Raw: AX=%d AY=%d AZ=%d GX=%d GY=%d GZ=%d\n",
-               accel_x_raw, accel_y_raw, accel_z_raw,
-               gyro_x_raw, gyro_y_raw, gyro_z_raw);
+               accel[0], accel[1], accel[2],
+               gyro[0], gyro[1], gyro[2]);
+    }
+#endif
+    
+    return 0;
+}
+
+int MPU6050_Read(float *ax, float *ay, float *az,
+                 float *gx, float *gy, float *gz)
+{
+    int16_t accel[3];
+    int16_t gyro[3];
+    
+    if (MPU6050_ReadRaw(accel, gyro) != 0) {
+        return -1;
     }
     
     // Convert to physical values
-    float accel_scale = 2.0f / 32768.0f;    // ±2g range
-    float gyro_scale = 250.0f / 32768.0f;   // ±250°/s range
+    float accel_scale = 1.0f / MPU6050_ACCEL_LSB_PER_G;
+    float gyro_scale = 1.0f / MPU6050_GYRO_LSB_PER_DPS;
     
-    *ax = accel_x_raw * accel_scale;
-    *ay = accel_y_raw * accel_scale;
-    *az = accel_z_raw * accel_scale;
-    *gx = gyro_x_raw * gyro_scale;
-    *gy = gyro_y_raw * gyro_scale;
-    *gz = gyro_z_raw * gyro_scale;
+    *ax = accel[0] * accel_scale;
+    *ay = accel[1] * accel_scale;
+    *az = accel[2] * accel_scale;
+    *gx = gyro[0] * gyro_scale;
+    *gy = gyro[1] * gyro_scale;
+    *gz = gyro[2] * gyro_scale;
     
     return 0;
 }
+
+int MPU6050_StartFifoCapture(uint16_t rate_hz, int int_gpio, uint16_t watermark)
+{
+    uint8_t dlpf;
+    uint8_t divider;
+
+    if (rate_hz < MPU6050_FIFO_MIN_RATE_HZ || rate_hz > MPU6050_FIFO_MAX_RATE_HZ) {
+        return -1;
+    }
+
+    // With the DLPF on, the gyro output (and sample clock) runs at 1 kHz.
+    dlpf = MPU6050_DlpfForRate(rate_hz);
+    divider = (uint8_t)(1000U / rate_hz - 1U);
+    if (MPU6050_WriteReg(MPU6050_REG_INT_ENABLE, 0x00) != 0 ||
+        MPU6050_WriteReg(MPU6050_REG_USER_CTRL, 0x00) != 0 ||
+        MPU6050_WriteReg(MPU6050_REG_CONFIG, dlpf) != 0 ||
+        MPU6050_WriteReg(MPU6050_REG_SMPLRT_DIV, divider) != 0 ||
+        MPU6050_WriteReg(MPU6050_REG_FIFO_EN, MPU6050_FIFO_EN_ACCEL) != 0 ||
+        MPU6050_WriteReg(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RST) != 0 ||
+        MPU6050_WriteReg(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_EN) != 0) {
+        printf("[MPU6050] FIFO capture setup failed\n");
+        return -2;
+    }
+
+    g_fifo_watermark = watermark > 0U ? watermark : 1U;
+    g_fifo_pending = 0U;
+    if (int_gpio != MPU6050_NO_INT_GPIO && int_gpio != g_fifo_int_gpio) {
+        if (!g_fifo_sem_ready) {
+            g_fifo_sem_ready = (LOS_BinarySemCreate(0, &g_fifo_sem) == LOS_OK) ? 1U : 0U;
+        }
+        // 50 us active-high pulse per sample, status cleared by reading INT_STATUS
+        if (!g_fifo_sem_ready ||
+            MPU6050_WriteReg(MPU6050_REG_INT_PIN_CFG, 0x00) != 0 ||
+            IoTGpioInit((unsigned int)int_gpio) != IOT_SUCCESS ||
+            IoTGpioSetDir((unsigned int)int_gpio, IOT_GPIO_DIR_IN) != IOT_SUCCESS ||
+            IoTGpioRegisterIsrFunc(
+                (unsigned int)int_gpio,
+                IOT_INT_TYPE_EDGE,
+                IOT_GPIO_EDGE_RISE_LEVEL_HIGH,
+                MPU6050_DataReadyIsr,
+                NULL
+            ) != IOT_SUCCESS) {
+            printf("[MPU6050] INT gpio=%d unavailable; draining on timeout only\n", int_gpio);
+        } else {
+            g_fifo_int_gpio = int_gpio;
+        }
+    }
+    if (g_fifo_int_gpio != MPU6050_NO_INT_GPIO &&
+        MPU6050_WriteReg(MPU6050_REG_INT_ENABLE, MPU6050_INT_DATA_RDY) != 0) {
+        return -2;
+    }
+
+    printf("[MPU6050] FIFO capture %u Hz dlpf=%u int=%d watermark=%u\n",
+           (unsigned int)rate_hz,
+           (unsigned int)dlpf,
+           g_fifo_int_gpio,
+           (unsigned int)g_fifo_watermark);
+    return 0;
+}
+
+void MPU6050_StopFifoCapture(void)
+{
+    (void)MPU6050_WriteReg(MPU6050_REG_INT_ENABLE, 0x00);
+    (void)MPU6050_WriteReg(MPU6050_REG_USER_CTRL, 0x00);
+    (void)MPU6050_WriteReg(MPU6050_REG_FIFO_EN, 0x00);
+    (void)MPU6050_WriteReg(MPU6050_REG_SMPLRT_DIV, 0x00);
+    (void)MPU6050_WriteReg(MPU6050_REG_CONFIG, MPU6050_DLPF_DEFAULT);
+}
+
+int MPU6050_WaitFifo(uint32_t timeout_ms)
+{
+    if (g_fifo_int_gpio == MPU6050_NO_INT_GPIO || !g_fifo_sem_ready) {
+        LOS_Msleep(timeout_ms);
+        return 0;
+    }
+    return LOS_SemPend(g_fifo_sem, LOS_MS2Tick(timeout_ms)) == LOS_OK ? 1 : 0;
+}
+
+int MPU6050_ReadFifoAccel(int16_t (*accel)[3], uint16_t max_samples)
+{
+    uint8_t buffer[MPU6050_FIFO_BURST_SAMPLES * MPU6050_FIFO_SAMPLE_BYTES];
+    uint8_t status = 0;
+    uint16_t count;
+    uint16_t done = 0U;
+
+    if (accel == NULL || max_samples == 0U) {
+        return -1;
+    }
+
+    if (MPU6050_ReadReg(MPU6050_REG_INT_STATUS, &status) != 0 ||
+        MPU6050_ReadMultiReg(MPU6050_REG_FIFO_COUNTH, buffer, 2) != 0) {
+        return -2;
+    }
+    count = (uint16_t)((buffer[0] << 8) | buffer[1]);
+
+    // After an overflow the FIFO holds a partial sample at its head; start over.
+    if ((status & MPU6050_INT_FIFO_OFLOW) != 0U || count >= MPU6050_FIFO_SIZE_BYTES ||
+        count % MPU6050_FIFO_SAMPLE_BYTES != 0U) {
+        (void)MPU6050_WriteReg(MPU6050_REG_USER_CTRL, MPU6050_USER_CTRL_FIFO_RST | MPU6050_USER_CTRL_FIFO_EN);
+        return MPU6050_ERR_FIFO_OVERFLOW;
+    }
+
+    count /= MPU6050_FIFO_SAMPLE_BYTES;
+    if (count > max_samples) {
+        count = max_samples;
+    }
+    while (done < count) {
+        uint16_t chunk = (uint16_t)(count - done);
+        uint16_t i;
+
+        if (chunk > MPU6050_FIFO_BURST_SAMPLES) {
+            chunk = MPU6050_FIFO_BURST_SAMPLES;
+        }
+        if (MPU6050_ReadMultiReg(
+                MPU6050_REG_FIFO_R_W,
+                buffer,
+                (uint8_t)(chunk * MPU6050_FIFO_SAMPLE_BYTES)
+            ) != 0) {
+            return -2;
+        }
+        for (i = 0U; i < chunk; ++i) {
+            const uint8_t *p = &buffer[i * MPU6050_FIFO_SAMPLE_BYTES];
+
+            accel[done + i][0] = (int16_t)((p[0] << 8) | p[1]);
+            accel[done + i][1] = (int16_t)((p[2] << 8) | p[3]);
+            accel[done + i][2] = (int16_t)((p[4] << 8) | p[5]);
+        }
+        done = (uint16_t)(done + chunk);
+    }
+    return (int)done;
+}
@@ -6,6 +6,19 @@
 #ifndef DRIVERS_SENSORS_MPU6050_DRIVER_H
 #define DRIVERS_SENSORS_MPU6050_DRIVER_H
 
+#include <stdint.h>
+
+#define MPU6050_ACCEL_LSB_PER_G     16384.0f    // ±2g range
+#define MPU6050_GYRO_LSB_PER_DPS    131.072f    // ±250°/s range (32768 / 250)
+
+#define MPU6050_FIFO_SIZE_BYTES     1024U
+#define MPU6050_FIFO_SAMPLE_BYTES   6U          // Accelerometer x/y/z only
+#define MPU6050_FIFO_CAPACITY       (MPU6050_FIFO_SIZE_BYTES / MPU6050_FIFO_SAMPLE_BYTES)
+#define MPU6050_FIFO_MIN_RATE_HZ    4U
+#define MPU6050_FIFO_MAX_RATE_HZ    1000U
+#define MPU6050_NO_INT_GPIO         (-1)
+#define MPU6050_ERR_FIFO_OVERFLOW   (-3)
+
 /**
  * Initialize MPU6050 sensor
  * @return 0 on success, negative on error
@@ -21,4 +34,40 @@ int MPU6050_Init(void);
 int MPU6050_Read(float *ax, float *ay, float *az,
                  float *gx, float *gy, float *gz);
 
+/**
+ * Read raw accelerometer and gyroscope counts (MPU6050_*_LSB_PER_* per unit)
+ * @param accel Output: x, y, z acceleration counts
+ * @param gyro Output: x, y, z angular velocity counts
+ * @return 0 on success, negative on error
+ */
+int MPU6050_ReadRaw(int16_t accel[3], int16_t gyro[3]);
+
+/**
+ * Sample the accelerometer into the on-chip FIFO at rate_hz (1 kHz / n,
+ * MPU6050_FIFO_MIN_RATE_HZ..MPU6050_FIFO_MAX_RATE_HZ) with a matching DLPF.
+ * MPU6050_ReadRaw keeps working alongside. Re-run after MPU6050_Init.
+ * @param int_gpio GPIO wired to the INT pin, or MPU6050_NO_INT_GPIO to drain on a timer
+ * @param watermark Data-ready pulses per MPU6050_WaitFifo wake-up
+ * @return 0 on success, negative on error
+ */
+int MPU6050_StartFifoCapture(uint16_t rate_hz, int int_gpio, uint16_t watermark);
+
+/**
+ * Stop FIFO capture and restore the register-read configuration
+ */
+void MPU6050_StopFifoCapture(void);
+
+/**
+ * Sleep until watermark samples have been signalled or timeout_ms passes
+ * @return 1 if woken by the interrupt, 0 on timeout
+ */
+int MPU6050_WaitFifo(uint32_t timeout_ms);
+
+/**
+ * Drain up to max_samples accelerometer samples (oldest first) in bursts
+ * @return samples read, MPU6050_ERR_FIFO_OVERFLOW if the FIFO overflowed and
+ *         was reset (samples lost), other negative values on I2C errors
+ */
+int MPU6050_ReadFifoAccel(int16_t (*accel)[3], uint16_t max_samples);
+
 #endif // DRIVERS_SENSORS_MPU6050_DRIVER_H
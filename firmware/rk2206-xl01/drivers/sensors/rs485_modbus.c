@@ -4,9 +4,12 @@
 #include <string.h>
 #include "iot_errno.h"
 #include "iot_uart.h"
+#include "los_config.h"
+#include "los_mux.h"
 #include "los_task.h"
 #include "los_tick.h"
 #include "../../config/app_config.h"
+#include "../../utils/crc.h"
 
 #ifndef RS485_TRANSPORT_SC16IS752
 #define RS485_TRANSPORT_SC16IS752 0
@@ -28,6 +31,70 @@
 #define RS485_RESPONSE_TIMEOUT_MS 300
 #endif
 
+#ifndef RS485_INTER_REQUEST_GAP_MS
+#define RS485_INTER_REQUEST_GAP_MS 80
+#endif
+
+#ifndef RS485_ADAPTIVE_TIMING
+#define RS485_ADAPTIVE_TIMING 0
+#endif
+
+#ifndef RS485_ADAPTIVE_MIN_SAMPLES
+#define RS485_ADAPTIVE_MIN_SAMPLES 8U
+#endif
+
+#ifndef RS485_ADAPTIVE_TIMEOUT_MARGIN_MS
+#define RS485_ADAPTIVE_TIMEOUT_MARGIN_MS 40U
+#endif
+
+#ifndef RS485_ADAPTIVE_TIMEOUT_MIN_MS
+#define RS485_ADAPTIVE_TIMEOUT_MIN_MS 80U
+#endif
+
+#ifndef RS485_ADAPTIVE_GAP_MIN_MS
+#define RS485_ADAPTIVE_GAP_MIN_MS 20U
+#endif
+
+#ifndef RS485_ADAPTIVE_GAP_MAX_MS
+#define RS485_ADAPTIVE_GAP_MAX_MS 320U
+#endif
+
+#ifndef RS485_ADAPTIVE_GAP_STEP_MS
+#define RS485_ADAPTIVE_GAP_STEP_MS 5U
+#endif
+
+#ifndef RS485_ADAPTIVE_GAP_DECREASE_AFTER
+#define RS485_ADAPTIVE_GAP_DECREASE_AFTER 8U
+#endif
+
+#ifndef RS485_ADAPTIVE_PEAK_DECAY_SHIFT
+#define RS485_ADAPTIVE_PEAK_DECAY_SHIFT 4U  // Each good reply removes 1/16 of the peak's excess
+#endif
+
+#ifndef RS485_TIMING_MAX_SLAVES
+#define RS485_TIMING_MAX_SLAVES 8U
+#endif
+
+#ifndef RS485_TIMING_PERSIST
+#define RS485_TIMING_PERSIST 0
+#endif
+
+#ifndef RS485_TIMING_PERSIST_EVERY
+#define RS485_TIMING_PERSIST_EVERY 200U
+#endif
+
+#ifndef RS485_TIMING_PERSIST_MIN_DELTA_MS
+#define RS485_TIMING_PERSIST_MIN_DELTA_MS 10U
+#endif
+
+#ifndef LOSCFG_BASE_CORE_TICK_PER_SECOND
+#define LOSCFG_BASE_CORE_TICK_PER_SECOND 1000UL
+#endif
+
+#if RS485_ADAPTIVE_TIMING && RS485_TIMING_PERSIST
+#include "kv_store.h"
+#endif
+
 #ifndef RS485_RAW_DIAG_MODE
 #define RS485_RAW_DIAG_MODE 0
 #endif
@@ -45,6 +112,8 @@
 #define MODBUS_WRITE_SINGLE_REGISTER 0x06
 #define MODBUS_MAX_RESPONSE_BYTES 96
 
+static UINT32 g_bus_mutex = 0U;
+static unsigned char g_bus_mutex_ready = 0U;
 static uint8_t g_last_write_response_addr = 0U;
 static unsigned int g_last_write_response_bytes = 0U;
 static uint8_t g_last_write_response[8] = {0};
@@ -70,6 +139,8 @@ const char *RS485_ModbusStatusName(int code)
             return "modbus_exception";
         case RS485_MODBUS_ERR_ECHO:
             return "malformed_echo";
+        case RS485_MODBUS_ERR_MALFORMED:
+            return "malformed_response";
         default:
             return "unknown";
     }
@@ -107,24 +178,388 @@ unsigned int RS485_ModbusGetLastWriteResponse(uint8_t *out, unsigned int out_cap
     return copy_len;
 }
 
-static uint16_t ModbusCrc16(const uint8_t *data, unsigned int len)
+#if RS485_ADAPTIVE_TIMING
+/*
+ * Jacobson/Karels style estimator kept in fixed point: latency_avg_x8 is the
+ * mean latency in 1/8 ms, latency_dev_x4 the mean deviation in 1/4 ms. The
+ * timeout is mean + 4 * deviation + margin, which covers the p99 of the
+ * response times seen on the bench without holding the bus for 800 ms.
+ * latency_max_ms is a decaying peak: it jumps to a slower reply and then
+ * falls back toward the current latency, so one outlier floors the timeout
+ * for a few dozen replies rather than for good.
+ */
+typedef struct {
+    uint8_t in_use;
+    uint8_t channel;
+    uint8_t slave_addr;
+    uint8_t restored;
+    uint8_t persist_pending;    // RS485_ModbusPersistTiming writes it outside the bus lock
+    unsigned int samples;
+    unsigned int latency_avg_x8;
+    unsigned int latency_dev_x4;
+    unsigned int latency_max_ms;
+    unsigned int gap_ms;
+    unsigned int consecutive_ok;
+    unsigned int consecutive_timeouts;
+    unsigned int timeouts;
+    unsigned int errors;
+    unsigned int persisted_timeout_ms;
+    unsigned int persisted_gap_ms;
+} Rs485TimingSlot;
+
+static Rs485TimingSlot g_timing_slots[RS485_TIMING_MAX_SLAVES];
+
+static unsigned int TicksToMs(uint32_t ticks)
+{
+    return (unsigned int)(((unsigned long)ticks * 1000UL) / (unsigned long)LOSCFG_BASE_CORE_TICK_PER_SECOND);
+}
+
+static unsigned int GapFloorMs(void)
+{
+    // Modbus RTU frame silence is 3.5 characters of 11 bits; round up and add 1 ms.
+    unsigned int silence_ms = (unsigned int)((3500UL * 11UL + (unsigned long)RS485_BAUDRATE - 1UL) /
+                                             (unsigned long)RS485_BAUDRATE) + 1U;
+    return (silence_ms > RS485_ADAPTIVE_GAP_MIN_MS) ? silence_ms : RS485_ADAPTIVE_GAP_MIN_MS;
+}
+
+static unsigned int LearnedTimeoutMs(const Rs485TimingSlot *slot)
+{
+    unsigned int timeout_ms;
+
+    if (slot == NULL || slot->samples < RS485_ADAPTIVE_MIN_SAMPLES) {
+        return RS485_RESPONSE_TIMEOUT_MS;
+    }
+
+    timeout_ms = (slot->latency_avg_x8 >> 3) + slot->latency_dev_x4 + RS485_ADAPTIVE_TIMEOUT_MARGIN_MS;
+    if (timeout_ms < slot->latency_max_ms + RS485_ADAPTIVE_TIMEOUT_MARGIN_MS / 2U) {
+        timeout_ms = slot->latency_max_ms + RS485_ADAPTIVE_TIMEOUT_MARGIN_MS / 2U;
+    }
+    // Each consecutive timeout doubles the window until the configured ceiling.
+    if (slot->consecutive_timeouts > 0U) {
+        unsigned int shift = (slot->consecutive_timeouts > 4U) ? 4U : slot->consecutive_timeouts;
+        timeout_ms <<= shift;
+    }
+    if (timeout_ms < RS485_ADAPTIVE_TIMEOUT_MIN_MS) {
+        timeout_ms = RS485_ADAPTIVE_TIMEOUT_MIN_MS;
+    }
+    if (timeout_ms > RS485_RESPONSE_TIMEOUT_MS) {
+        timeout_ms = RS485_RESPONSE_TIMEOUT_MS;
+    }
+    return timeout_ms;
+}
+
+#if RS485_TIMING_PERSIST
+static void BuildTimingKey(uint8_t channel, uint8_t slave_addr, char *key, unsigned int key_size)
+{
+    snprintf(key, key_size, "rs485_t_%u_%u", channel, slave_addr);
+}
+
+static void RestoreTimingSlot(Rs485TimingSlot *slot)
+{
+    char key[24];
+    char value[48];
+    unsigned int avg_x8 = 0U;
+    unsigned int dev_x4 = 0U;
+    unsigned int max_ms = 0U;
+    unsigned int gap_ms = 0U;
+    int len;
+
+    BuildTimingKey(slot->channel, slot->slave_addr, key, sizeof(key));
+    memset(value, 0, sizeof(value));
+    len = UtilsGetValue(key, value, sizeof(value) - 1U);
+    if (len <= 0) {
+        return;
+    }
+    if (sscanf(value, "v1,%u,%u,%u,%u", &avg_x8, &dev_x4, &max_ms, &gap_ms) != 4 ||
+        (avg_x8 >> 3) > RS485_RESPONSE_TIMEOUT_MS ||
+        gap_ms > RS485_ADAPTIVE_GAP_MAX_MS) {
+        printf("[RS485] ignore stored timing %s=%s\n", key, value);
+        return;
+    }
+
+    slot->latency_avg_x8 = avg_x8;
+    slot->latency_dev_x4 = dev_x4;
+    slot->latency_max_ms = max_ms;
+    slot->gap_ms = (gap_ms < GapFloorMs()) ? GapFloorMs() : gap_ms;
+    slot->samples = RS485_ADAPTIVE_MIN_SAMPLES;
+    slot->restored = 1U;
+    slot->persisted_timeout_ms = LearnedTimeoutMs(slot);
+    slot->persisted_gap_ms = slot->gap_ms;
+    printf("[RS485] restored timing ch=%u addr=%u timeout=%ums gap=%ums\n",
+           slot->channel, slot->slave_addr, slot->persisted_timeout_ms, slot->gap_ms);
+}
+
+static unsigned int AbsDiff(unsigned int a, unsigned int b)
+{
+    return (a > b) ? (a - b) : (b - a);
+}
+
+// Runs inside the transaction, so it only flags the slot; the flash write comes later.
+static void MarkTimingSlotIfChanged(Rs485TimingSlot *slot)
+{
+    unsigned int timeout_ms;
+
+    if (slot->samples < RS485_ADAPTIVE_MIN_SAMPLES || (slot->samples % RS485_TIMING_PERSIST_EVERY) != 0U) {
+        return;
+    }
+
+    timeout_ms = LearnedTimeoutMs(slot);
+    if (AbsDiff(timeout_ms, slot->persisted_timeout_ms) < RS485_TIMING_PERSIST_MIN_DELTA_MS &&
+        AbsDiff(slot->gap_ms, slot->persisted_gap_ms) < RS485_TIMING_PERSIST_MIN_DELTA_MS) {
+        return;
+    }
+    slot->persist_pending = 1U;
+}
+#endif
+
+static Rs485TimingSlot *FindTimingSlot(uint8_t channel, uint8_t slave_addr, int create)
 {
-    uint16_t crc = 0xFFFF;
     unsigned int i;
-    int bit;
 
-    for (i = 0; i < len; ++i) {
-        crc ^= data[i];
-        for (bit = 0; bit < 8; ++bit) {
-            if ((crc & 0x0001U) != 0U) {
-                crc = (uint16_t)((crc >> 1) ^ 0xA001U);
-            } else {
-                crc = (uint16_t)(crc >> 1);
-            }
+    for (i = 0; i < RS485_TIMING_MAX_SLAVES; ++i) {
+        if (g_timing_slots[i].in_use &&
+            g_timing_slots[i].channel == channel &&
+            g_timing_slots[i].slave_addr == slave_addr) {
+            return &g_timing_slots[i];
+        }
+    }
+    if (!create) {
+        return NULL;
+    }
+
+    for (i = 0; i < RS485_TIMING_MAX_SLAVES; ++i) {
+        if (!g_timing_slots[i].in_use) {
+            Rs485TimingSlot *slot = &g_timing_slots[i];
+            memset(slot, 0, sizeof(*slot));
+            slot->channel = channel;
+            slot->slave_addr = slave_addr;
+            slot->gap_ms = RS485_INTER_REQUEST_GAP_MS;
+#if RS485_TIMING_PERSIST
+            RestoreTimingSlot(slot);
+#endif
+            slot->in_use = 1U;
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+static void RecordResponseLatency(uint8_t channel, uint8_t slave_addr, unsigned int latency_ms)
+{
+    Rs485TimingSlot *slot = FindTimingSlot(channel, slave_addr, 1);
+    unsigned int floor_ms = GapFloorMs();
+
+    if (slot == NULL) {
+        return;
+    }
+
+    if (slot->samples == 0U) {
+        slot->latency_avg_x8 = latency_ms << 3;
+        slot->latency_dev_x4 = latency_ms << 1;
+    } else {
+        int err = (int)latency_ms - (int)(slot->latency_avg_x8 >> 3);
+        slot->latency_avg_x8 = (unsigned int)((int)slot->latency_avg_x8 + err);
+        if (err < 0) {
+            err = -err;
+        }
+        slot->latency_dev_x4 = (unsigned int)((int)slot->latency_dev_x4 + err - (int)(slot->latency_dev_x4 >> 2));
+    }
+    if (latency_ms >= slot->latency_max_ms) {
+        slot->latency_max_ms = latency_ms;
+    } else {
+        // Round the step up so the peak settles on the latency instead of just above it.
+        slot->latency_max_ms -= (slot->latency_max_ms - latency_ms + (1U << RS485_ADAPTIVE_PEAK_DECAY_SHIFT) - 1U) >>
+                                RS485_ADAPTIVE_PEAK_DECAY_SHIFT;
+    }
+    slot->samples++;
+    slot->consecutive_timeouts = 0U;
+    slot->consecutive_ok++;
+
+    // Additive decrease after a run of clean transactions; failures double it again.
+    if (slot->consecutive_ok >= RS485_ADAPTIVE_GAP_DECREASE_AFTER && slot->gap_ms > floor_ms) {
+        slot->gap_ms = (slot->gap_ms > floor_ms + RS485_ADAPTIVE_GAP_STEP_MS)
+                           ? (slot->gap_ms - RS485_ADAPTIVE_GAP_STEP_MS)
+                           : floor_ms;
+        slot->consecutive_ok = 0U;
+    }
+
+#if RS485_TIMING_PERSIST
+    MarkTimingSlotIfChanged(slot);
+#endif
+}
+
+static void RecordResponseFailure(uint8_t channel, uint8_t slave_addr, int timed_out)
+{
+    Rs485TimingSlot *slot = FindTimingSlot(channel, slave_addr, 1);
+
+    if (slot == NULL) {
+        return;
+    }
+
+    if (timed_out) {
+        slot->timeouts++;
+        slot->consecutive_timeouts++;
+    } else {
+        slot->errors++;
+    }
+    slot->consecutive_ok = 0U;
+    slot->gap_ms <<= 1;
+    if (slot->gap_ms > RS485_ADAPTIVE_GAP_MAX_MS) {
+        slot->gap_ms = RS485_ADAPTIVE_GAP_MAX_MS;
+    }
+}
+#endif
+
+unsigned int RS485_ModbusGetResponseTimeoutMs(uint8_t channel, uint8_t slave_addr)
+{
+#if RS485_ADAPTIVE_TIMING
+    return LearnedTimeoutMs(FindTimingSlot(channel, slave_addr, 0));
+#else
+    (void)channel;
+    (void)slave_addr;
+    return RS485_RESPONSE_TIMEOUT_MS;
+#endif
+}
+
+unsigned int RS485_ModbusGetInterRequestGapMs(uint8_t channel, uint8_t slave_addr)
+{
+#if RS485_ADAPTIVE_TIMING
+    const Rs485TimingSlot *slot = FindTimingSlot(channel, slave_addr, 0);
+    return (slot != NULL) ? slot->gap_ms : RS485_INTER_REQUEST_GAP_MS;
+#else
+    (void)channel;
+    (void)slave_addr;
+    return RS485_INTER_REQUEST_GAP_MS;
+#endif
+}
+
+unsigned int RS485_ModbusGetSlaveTimingCount(void)
+{
+#if RS485_ADAPTIVE_TIMING
+    unsigned int count = 0U;
+    unsigned int i;
+
+    for (i = 0; i < RS485_TIMING_MAX_SLAVES; ++i) {
+        if (g_timing_slots[i].in_use) {
+            count++;
+        }
+    }
+    return count;
+#else
+    return 0U;
+#endif
+}
+
+int RS485_ModbusGetSlaveTiming(unsigned int index, Rs485SlaveTiming *out)
+{
+#if RS485_ADAPTIVE_TIMING
+    unsigned int i;
+
+    if (out == NULL) {
+        return -1;
+    }
+
+    for (i = 0; i < RS485_TIMING_MAX_SLAVES; ++i) {
+        const Rs485TimingSlot *slot = &g_timing_slots[i];
+        if (!slot->in_use) {
+            continue;
+        }
+        if (index > 0U) {
+            index--;
+            continue;
+        }
+        out->channel = slot->channel;
+        out->slave_addr = slot->slave_addr;
+        out->samples = slot->samples;
+        out->latency_avg_ms = slot->latency_avg_x8 >> 3;
+        out->latency_jitter_ms = slot->latency_dev_x4 >> 2;
+        out->latency_max_ms = slot->latency_max_ms;
+        out->timeout_ms = LearnedTimeoutMs(slot);
+        out->gap_ms = slot->gap_ms;
+        out->timeouts = slot->timeouts;
+        out->errors = slot->errors;
+        out->restored = slot->restored;
+        return 0;
+    }
+    return -1;
+#else
+    (void)index;
+    (void)out;
+    return -1;
+#endif
+}
+
+void RS485_ModbusPersistTiming(void)
+{
+#if RS485_ADAPTIVE_TIMING && RS485_TIMING_PERSIST
+    unsigned int i;
+
+    for (i = 0; i < RS485_TIMING_MAX_SLAVES; ++i) {
+        Rs485TimingSlot *slot = &g_timing_slots[i];
+        char key[24];
+        char value[48];
+        unsigned int timeout_ms;
+        unsigned int gap_ms;
+
+        // Copy under the bus lock, write without it: a kv_store write can take
+        // long enough to stall the next transaction.
+        RS485_ModbusLockBus();
+        if (!slot->in_use || !slot->persist_pending) {
+            RS485_ModbusUnlockBus();
+            continue;
+        }
+        slot->persist_pending = 0U;
+        timeout_ms = LearnedTimeoutMs(slot);
+        gap_ms = slot->gap_ms;
+        BuildTimingKey(slot->channel, slot->slave_addr, key, sizeof(key));
+        snprintf(value, sizeof(value), "v1,%u,%u,%u,%u",
+                 slot->latency_avg_x8, slot->latency_dev_x4, slot->latency_max_ms, gap_ms);
+        RS485_ModbusUnlockBus();
+
+        if (UtilsSetValue(key, value) != 0) {
+            printf("[RS485] persist timing failed %s\n", key);
+            continue;
         }
+        RS485_ModbusLockBus();
+        // A reset in between cleared the slot; leave it to relearn.
+        if (slot->in_use) {
+            slot->persisted_timeout_ms = timeout_ms;
+            slot->persisted_gap_ms = gap_ms;
+        }
+        RS485_ModbusUnlockBus();
     }
+#endif
+}
+
+void RS485_ModbusResetSlaveTiming(void)
+{
+#if RS485_ADAPTIVE_TIMING
+    unsigned int i;
+#if RS485_TIMING_PERSIST
+    char keys[RS485_TIMING_MAX_SLAVES][24];
+    unsigned int key_count = 0U;
+#endif
 
-    return crc;
+    // Called from the command task; Rs485BusTask updates the slots inside its transactions.
+    RS485_ModbusLockBus();
+    for (i = 0; i < RS485_TIMING_MAX_SLAVES; ++i) {
+#if RS485_TIMING_PERSIST
+        if (g_timing_slots[i].in_use) {
+            BuildTimingKey(g_timing_slots[i].channel, g_timing_slots[i].slave_addr, keys[key_count], sizeof(keys[0]));
+            key_count++;
+        }
+#endif
+        memset(&g_timing_slots[i], 0, sizeof(g_timing_slots[i]));
+    }
+    RS485_ModbusUnlockBus();
+
+#if RS485_TIMING_PERSIST
+    // Stored entries go after the lock is released, like RS485_ModbusPersistTiming.
+    for (i = 0; i < key_count; ++i) {
+        (void)UtilsDeleteValue(keys[i]);
+    }
+#endif
+#endif
 }
 
 static void PrintHexFrame(const char *prefix, const uint8_t *data, unsigned int len)
@@ -250,8 +685,29 @@ static void Rs485ExternalLoopbackDiag(void)
 }
 #endif
 
+void RS485_ModbusLockBus(void)
+{
+    if (g_bus_mutex_ready) {
+        (void)LOS_MuxPend(g_bus_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+void RS485_ModbusUnlockBus(void)
+{
+    if (g_bus_mutex_ready) {
+        (void)LOS_MuxPost(g_bus_mutex);
+    }
+}
+
 int RS485_ModbusInit(void)
 {
+    if (!g_bus_mutex_ready) {
+        g_bus_mutex_ready = (LOS_MuxCreate(&g_bus_mutex) == LOS_OK) ? 1U : 0U;
+        if (!g_bus_mutex_ready) {
+            printf("[RS485] bus mutex create failed; concurrent bus users are unprotected\n");
+        }
+    }
+
 #if RS485_TRANSPORT_SC16IS752
     printf("[RS485] Initializing Modbus via SC16IS752 baud=%u...\n", RS485_BAUDRATE);
     if (SC16IS752_Init() != 0) {
@@ -306,18 +762,20 @@ int RS485_ModbusReadRegistersWithTimeoutOnChannel(
     uint16_t crc;
     uint32_t start_tick;
     uint32_t timeout_ticks;
+    uint32_t response_ticks = 0U;
+    uint16_t rx_crc = CRC16_MODBUS_INIT;
     unsigned int expected_len;
     unsigned int received = 0;
     unsigned int i;
 
     if ((function_code != MODBUS_READ_HOLDING_REGISTERS && function_code != MODBUS_READ_INPUT_REGISTERS) ||
         slave_addr == 0U || reg_count == 0U || out_regs == NULL || out_reg_capacity < reg_count) {
-        return -1;
+        return RS485_MODBUS_ERR_INVALID;
     }
 
     expected_len = 5U + ((unsigned int)reg_count * 2U);
     if (expected_len > sizeof(response)) {
-        return -1;
+        return RS485_MODBUS_ERR_INVALID;
     }
 
     request[0] = slave_addr;
@@ -326,7 +784,7 @@ int RS485_ModbusReadRegistersWithTimeoutOnChannel(
     request[3] = (uint8_t)(start_reg & 0xFFU);
     request[4] = (uint8_t)(reg_count >> 8);
     request[5] = (uint8_t)(reg_count & 0xFFU);
-    crc = ModbusCrc16(request, 6);
+    crc = Crc_Modbus16(request, 6);
     request[6] = (uint8_t)(crc & 0xFFU);
     request[7] = (uint8_t)(crc >> 8);
 
@@ -346,14 +804,14 @@ int RS485_ModbusReadRegistersWithTimeoutOnChannel(
         if (written != (int)sizeof(request)) {
             printf("[RS485] write failed ch=%u slave=%u reg=0x%04X count=%u written=%d\n",
                    channel, slave_addr, start_reg, reg_count, written);
-            return -1;
+            return RS485_MODBUS_ERR_WRITE;
         }
     }
 
     if (WaitPortTxDone(channel, 50U) != 0) {
         printf("[RS485] tx not completed ch=%u slave=%u reg=0x%04X count=%u\n",
                channel, slave_addr, start_reg, reg_count);
-        return -1;
+        return RS485_MODBUS_ERR_TX_DONE;
     }
 
     memset(response, 0, sizeof(response));
@@ -372,7 +830,9 @@ int RS485_ModbusReadRegistersWithTimeoutOnChannel(
 
         len = ReadPort(channel, response + received, expected_len - received);
         if (len > 0) {
+            rx_crc = Crc_Modbus16Update(rx_crc, response + received, (unsigned int)len);
             received += (unsigned int)len;
+            response_ticks = (uint32_t)LOS_TickCountGet() - start_tick;
             if (received >= 5U &&
                 response[0] == slave_addr &&
                 (response[1] & 0x80U) != 0U) {
@@ -400,25 +860,37 @@ int RS485_ModbusReadRegistersWithTimeoutOnChannel(
         printf("[RS485] timeout/no response ch=%u fc=0x%02X slave=%u reg=0x%04X count=%u bytes=%u\n",
                channel, function_code, slave_addr, start_reg, reg_count, received);
 #endif
-        return -1;
+#if RS485_ADAPTIVE_TIMING
+        RecordResponseFailure(channel, slave_addr, 1);
+#endif
+        return RS485_MODBUS_ERR_TIMEOUT;
     }
 
     if (response[0] != slave_addr) {
         printf("[RS485] unexpected slave addr got=%u expected=%u\n", response[0], slave_addr);
-        return -1;
+#if RS485_ADAPTIVE_TIMING
+        RecordResponseFailure(channel, slave_addr, 0);
+#endif
+        return RS485_MODBUS_ERR_ADDR;
     }
 
-    crc = ModbusCrc16(response, received - 2U);
-    if (response[received - 2U] != (uint8_t)(crc & 0xFFU) ||
-        response[received - 1U] != (uint8_t)(crc >> 8)) {
+    // The CRC was folded as bytes arrived; a frame carrying its own CRC folds to zero.
+    if (rx_crc != 0U) {
         printf("[RS485] CRC mismatch slave=%u bytes=%u\n", slave_addr, received);
-        return -1;
+#if RS485_ADAPTIVE_TIMING
+        RecordResponseFailure(channel, slave_addr, 0);
+#endif
+        return RS485_MODBUS_ERR_CRC;
     }
 
     if ((response[1] & 0x80U) != 0U) {
         printf("[RS485] Modbus exception slave=%u func=0x%02X code=0x%02X\n",
                slave_addr, response[1], response[2]);
-        return -1;
+#if RS485_ADAPTIVE_TIMING
+        // The slave answered in time; an exception is still a valid latency sample.
+        RecordResponseLatency(channel, slave_addr, TicksToMs(response_ticks));
+#endif
+        return RS485_MODBUS_ERR_EXCEPTION;
     }
 
     if (response[1] != function_code ||
@@ -426,15 +898,22 @@ int RS485_ModbusReadRegistersWithTimeoutOnChannel(
         received < expected_len) {
         printf("[RS485] malformed response slave=%u func=0x%02X byte_count=%u bytes=%u\n",
                slave_addr, response[1], response[2], received);
-        return -1;
+#if RS485_ADAPTIVE_TIMING
+        RecordResponseFailure(channel, slave_addr, 0);
+#endif
+        return RS485_MODBUS_ERR_MALFORMED;
     }
 
+#if RS485_ADAPTIVE_TIMING
+    RecordResponseLatency(channel, slave_addr, TicksToMs(response_ticks));
+#endif
+
     for (i = 0; i < reg_count; ++i) {
         unsigned int offset = 3U + (i * 2U);
         out_regs[i] = (uint16_t)(((uint16_t)response[offset] << 8) | response[offset + 1U]);
     }
 
-    return 0;
+    return RS485_MODBUS_OK;
 }
 
 int RS485_ModbusReadHoldingRegistersOnChannel(
@@ -454,7 +933,7 @@ int RS485_ModbusReadHoldingRegistersOnChannel(
         reg_count,
         out_regs,
         out_reg_capacity,
-        RS485_RESPONSE_TIMEOUT_MS);
+        RS485_ModbusGetResponseTimeoutMs(channel, slave_addr));
 }
 
 int RS485_ModbusReadHoldingRegisters(
@@ -542,7 +1021,7 @@ int RS485_ModbusWriteSingleRegisterOnChannelAllowResponseAddrs(
     request[3] = (uint8_t)(reg_addr & 0xFFU);
     request[4] = (uint8_t)(value >> 8);
     request[5] = (uint8_t)(value & 0xFFU);
-    crc = ModbusCrc16(request, 6);
+    crc = Crc_Modbus16(request, 6);
     request[6] = (uint8_t)(crc & 0xFFU);
     request[7] = (uint8_t)(crc >> 8);
 
@@ -624,7 +1103,7 @@ int RS485_ModbusWriteSingleRegisterOnChannelAllowResponseAddrs(
         return RS485_MODBUS_ERR_ADDR;
     }
 
-    crc = ModbusCrc16(response, sizeof(response) - 2U);
+    crc = Crc_Modbus16(response, sizeof(response) - 2U);
     if (response[sizeof(response) - 2U] != (uint8_t)(crc & 0xFFU) ||
         response[sizeof(response) - 1U] != (uint8_t)(crc >> 8)) {
         printf("[RS485] write single CRC mismatch slave=%u bytes=%u\n", slave_addr, received);
@@ -16,8 +16,33 @@ extern "C" {
 #define RS485_MODBUS_ERR_CRC           -6
 #define RS485_MODBUS_ERR_EXCEPTION     -7
 #define RS485_MODBUS_ERR_ECHO          -8
+#define RS485_MODBUS_ERR_MALFORMED     -9
+
+/**
+ * Learned response timing for one (channel, slave address) pair.
+ * Latency is measured from TX-done to the last response byte.
+ */
+typedef struct {
+    uint8_t channel;
+    uint8_t slave_addr;
+    unsigned int samples;
+    unsigned int latency_avg_ms;
+    unsigned int latency_jitter_ms;
+    unsigned int latency_max_ms;        // Decaying peak, see RS485_ADAPTIVE_PEAK_DECAY_SHIFT
+    unsigned int timeout_ms;
+    unsigned int gap_ms;
+    unsigned int timeouts;
+    unsigned int errors;
+    int restored;
+} Rs485SlaveTiming;
 
 int RS485_ModbusInit(void);
+/**
+ * Serialise whole multi-frame exchanges (reconfigure + request + gap) between
+ * tasks sharing the SC16IS752 channels. The mutex is recursive for its owner.
+ */
+void RS485_ModbusLockBus(void);
+void RS485_ModbusUnlockBus(void);
 int RS485_ModbusReadRegistersWithTimeoutOnChannel(
     uint8_t channel,
     uint8_t function_code,
@@ -74,6 +99,12 @@ int RS485_ModbusRawWriteOnChannel(
     unsigned int tx_done_timeout_ms
 );
 const char *RS485_ModbusStatusName(int code);
+unsigned int RS485_ModbusGetResponseTimeoutMs(uint8_t channel, uint8_t slave_addr);
+unsigned int RS485_ModbusGetInterRequestGapMs(uint8_t channel, uint8_t slave_addr);
+unsigned int RS485_ModbusGetSlaveTimingCount(void);
+int RS485_ModbusGetSlaveTiming(unsigned int index, Rs485SlaveTiming *out);
+void RS485_ModbusResetSlaveTiming(void);
+void RS485_ModbusPersistTiming(void);
 uint8_t RS485_ModbusGetLastWriteResponseAddr(void);
 unsigned int RS485_ModbusGetLastWriteResponseBytes(void);
 unsigned int RS485_ModbusGetLastWriteResponse(uint8_t *out, unsigned int out_capacity);
@@ -8,6 +8,7 @@
 #include "los_task.h"
 #include "iot_i2c.h"
 #include "iot_errno.h"
+#include "../../utils/crc.h"
 
 // SHT30 I2C Address (moved from config to avoid dependency)
 #ifndef SHT30_I2C_ADDR
@@ -26,30 +27,6 @@
 #define SHT30_CMD_MEASURE   0x2C06      // High precision measurement
 #define SHT30_CMD_RESET     0x30A2      // Soft reset
 
-static uint8_t SHT30_Crc8(const uint8_t *data, unsigned int len)
-{
-    uint8_t crc = 0xFF;
-    unsigned int i;
-    unsigned int bit;
-
-    if (data == NULL) {
-        return 0;
-    }
-
-    for (i = 0; i < len; ++i) {
-        crc ^= data[i];
-        for (bit = 0; bit < 8; ++bit) {
-            if ((crc & 0x80U) != 0U) {
-                crc = (uint8_t)((crc << 1) ^ 0x31U);
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-
-    return crc;
-}
-
 int SHT30_Init(void)
 {
     printf("[SHT30] Initializing...\n");
@@ -92,8 +69,8 @@ int SHT30_Read(float *temp, float *humi)
         return -2;
     }
 
-    if (SHT30_Crc8(&buffer[0], 2) != buffer[2] ||
-        SHT30_Crc8(&buffer[3], 2) != buffer[5]) {
+    if (Crc_Sensirion8(&buffer[0], 2) != buffer[2] ||
+        Crc_Sensirion8(&buffer[3], 2) != buffer[5]) {
         printf("[WARN] SHT30 CRC mismatch\n");
         return -3;
     }
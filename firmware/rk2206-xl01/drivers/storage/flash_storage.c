@@ -0,0 +1,72 @@
+#include "flash_storage.h"
+
+#include <stdio.h>
+#include "iot_errno.h"
+#include "iot_flash.h"
+#include "../../config/app_config.h"
+
+#ifndef SAMPLE_LOG_FLASH_OFFSET
+#define SAMPLE_LOG_FLASH_OFFSET 0x00300000U
+#endif
+
+#ifndef SAMPLE_LOG_SECTOR_SIZE
+#define SAMPLE_LOG_SECTOR_SIZE 4096U
+#endif
+
+#ifndef SAMPLE_LOG_SECTOR_COUNT
+#define SAMPLE_LOG_SECTOR_COUNT 16U
+#endif
+
+#define FLASH_STORAGE_REGION_BYTES (SAMPLE_LOG_SECTOR_SIZE * SAMPLE_LOG_SECTOR_COUNT)
+
+static int InRegion(uint32_t offset, uint32_t size)
+{
+    return size <= FLASH_STORAGE_REGION_BYTES && offset <= FLASH_STORAGE_REGION_BYTES - size;
+}
+
+static int FlashRead(uint32_t offset, uint8_t *data, uint32_t size)
+{
+    if (!InRegion(offset, size)) {
+        return -1;
+    }
+    return IoTFlashRead(SAMPLE_LOG_FLASH_OFFSET + offset, size, data) == IOT_SUCCESS ? 0 : -1;
+}
+
+static int FlashWrite(uint32_t offset, const uint8_t *data, uint32_t size)
+{
+    if (!InRegion(offset, size)) {
+        return -1;
+    }
+    // doErase=0: the log erases whole sectors itself and only programs erased bytes.
+    return IoTFlashWrite(SAMPLE_LOG_FLASH_OFFSET + offset, size, data, 0) == IOT_SUCCESS ? 0 : -1;
+}
+
+static int FlashErase(uint32_t offset, uint32_t size)
+{
+    if (!InRegion(offset, size) || (offset % SAMPLE_LOG_SECTOR_SIZE) != 0U) {
+        return -1;
+    }
+    return IoTFlashErase(SAMPLE_LOG_FLASH_OFFSET + offset, size) == IOT_SUCCESS ? 0 : -1;
+}
+
+static const FlashLogPort g_flash_storage_port = {
+    FlashRead,
+    FlashWrite,
+    FlashErase,
+    SAMPLE_LOG_SECTOR_SIZE,
+    SAMPLE_LOG_SECTOR_COUNT,
+};
+
+const FlashLogPort *FlashStorage_LogPort(void)
+{
+    static unsigned char initialized = 0;
+
+    if (!initialized) {
+        if (IoTFlashInit() != IOT_SUCCESS) {
+            printf("[FLASH] init failed\n");
+            return NULL;
+        }
+        initialized = 1;
+    }
+    return &g_flash_storage_port;
+}
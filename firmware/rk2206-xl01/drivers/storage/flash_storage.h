@@ -0,0 +1,21 @@
+#ifndef DRIVERS_STORAGE_FLASH_STORAGE_H
+#define DRIVERS_STORAGE_FLASH_STORAGE_H
+
+#include "../../utils/flash_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Flash log backend over the SoC SPI flash, confined to the region
+ * SAMPLE_LOG_FLASH_OFFSET .. + SAMPLE_LOG_SECTOR_SIZE * SAMPLE_LOG_SECTOR_COUNT.
+ * @return NULL if the flash controller cannot be initialized
+ */
+const FlashLogPort *FlashStorage_LogPort(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DRIVERS_STORAGE_FLASH_STORAGE_H
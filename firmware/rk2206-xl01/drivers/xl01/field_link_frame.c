@@ -2,6 +2,7 @@
 
 #include <stdio.h>
 #include <string.h>
+#include "../../utils/crc.h"
 
 static void FieldLink_WriteUint32Be(unsigned char *output, unsigned int value)
 {
@@ -27,30 +28,6 @@ static unsigned int FieldLink_ReadUint32Be(const unsigned char *input)
            (unsigned int)input[3];
 }
 
-static unsigned int FieldLink_Crc32(const unsigned char *data, int len)
-{
-    unsigned int crc = 0xFFFFFFFFU;
-    int index;
-    int bit;
-
-    if (data == NULL || len < 0) {
-        return 0U;
-    }
-
-    for (index = 0; index < len; ++index) {
-        crc ^= (unsigned int)data[index];
-        for (bit = 0; bit < 8; ++bit) {
-            if ((crc & 1U) != 0U) {
-                crc = (crc >> 1) ^ 0xEDB88320U;
-            } else {
-                crc >>= 1;
-            }
-        }
-    }
-
-    return crc ^ 0xFFFFFFFFU;
-}
-
 static int FieldLink_CobsEncode(
     const unsigned char *input,
     int input_len,
@@ -175,7 +152,7 @@ static int FieldLink_DecodeFrame(const unsigned char *frame, int frame_len, Fiel
     }
 
     expected_crc = FieldLink_ReadUint32Be(packet + packet_len - FIELD_LINK_FRAME_CRC_BYTES);
-    actual_crc = FieldLink_Crc32(packet, packet_len - FIELD_LINK_FRAME_CRC_BYTES);
+    actual_crc = Crc_Ieee32(packet, (unsigned int)(packet_len - FIELD_LINK_FRAME_CRC_BYTES));
     if (expected_crc != actual_crc) {
         return -1;
     }
@@ -248,7 +225,7 @@ int FieldLinkFrame_Encode(
     }
 
     packet_len = FIELD_LINK_FRAME_HEADER_BYTES + payload_len;
-    crc = FieldLink_Crc32(packet, packet_len);
+    crc = Crc_Ieee32(packet, (unsigned int)packet_len);
     FieldLink_WriteUint32Be(packet + packet_len, crc);
     packet_len += FIELD_LINK_FRAME_CRC_BYTES;
 
@@ -0,0 +1,478 @@
+/*
+ * Firmware Microbenchmarks
+ * Times the field-link, JSON, FIFO, NMEA and CRC hot paths on the host build.
+ *
+ * Usage: landslide_bench [--filter substr] [--min-time-ms N] [--repeats N]
+ *
+ * Output is JSON lines: one "meta" record, then one record per case with
+ * ns_per_op (median of the repeats), ns_min/ns_max, bytes_per_op, mb_per_s
+ * and stack_bytes. Inputs are fixed (seeded xorshift for the binary ones), so
+ * records from two commits compare directly. stack_bytes is the peak stack of
+ * one call, measured by painting a private thread stack and subtracting an
+ * empty case; it is x86-64 stack, a guide to the target's, not a copy of it.
+ * Firmware log lines go to stderr so stdout stays machine-readable.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "app/command_ack_builder.h"
+#include "app/device_command_parser.h"
+#include "app/sensor_data.h"
+#include "app/telemetry_envelope_builder.h"
+#include "drivers/sensors/gps_driver.h"
+#include "drivers/xl01/field_link_frame.h"
+#include "utils/crc.h"
+#include "utils/fifo.h"
+
+#define BENCH_SEED              0x5EEDF00DU
+#define BENCH_DEFAULT_MIN_MS    200U
+#define BENCH_DEFAULT_REPEATS   5U
+#define BENCH_MAX_REPEATS       31U
+#define BENCH_STACK_BYTES       (256U * 1024U)
+#define BENCH_STACK_PAINT       0xA5U
+#define BENCH_CRC_BLOCK_BYTES   256U
+#define BENCH_FIFO_CHUNK_BYTES  64U
+#define BENCH_NMEA_BYTES        1024U
+
+typedef struct {
+    const char *name;
+    void (*run)(void);          // One operation
+    unsigned int bytes;         // Input bytes per operation, 0 when not meaningful
+} BenchCase;
+
+static volatile unsigned int g_sink = 0U;
+static FILE *g_out = NULL;
+static uint32_t g_rng = BENCH_SEED;
+
+static SensorData g_sensor;
+static char g_telemetry[FIELD_LINK_MAX_PAYLOAD_BYTES + 1];
+static int g_telemetry_len = 0;
+static unsigned char g_frame[FIELD_LINK_FRAME_ENCODED_BYTES];
+static int g_frame_len = 0;
+static FieldLinkFrameDecoder g_decoder;
+static FieldLinkFrameMessage g_message;
+static DeviceCommandMessage g_command;
+static char g_ack[FIELD_LINK_MAX_PAYLOAD_BYTES + 1];
+static Fifo g_fifo;
+static unsigned char g_block[BENCH_CRC_BLOCK_BYTES];
+static unsigned char g_chunk[BENCH_FIFO_CHUNK_BYTES];
+static char g_nmea[BENCH_NMEA_BYTES];
+static unsigned int g_nmea_len = 0U;
+
+// One modbus read request (slave 1, holding 0x0000, 2 registers) without CRC
+static const unsigned char g_modbus_request[6] = {0x01, 0x03, 0x00, 0x00, 0x00, 0x02};
+
+static const char g_command_json[] =
+    "{\"schema_version\":1,\"command_id\":\"2f6b1c8e-8a51-4c55-9f0e-3b7d2e41c9a0\","
+    "\"device_id\":\"00000000-0000-0000-0000-000000000001\",\"command_type\":\"set_config\","
+    "\"issued_ts\":\"2026-07-19T08:30:00.000Z\",\"sent_ts\":\"2026-07-19T08:30:00.120Z\","
+    "\"gateway_sent_ts\":\"2026-07-19T08:30:00.450Z\",\"time_sync\":{\"sent_ts\":\"2026-07-19T08:30:00.450Z\"},"
+    "\"payload\":{\"sampling_s\":5,\"report_interval_s\":60,"
+    "\"sensor_sampling_ms\":{\"soil\":5000,\"tilt\":1000,\"rain\":0}}}";
+
+static const char g_ack_result[] =
+    "{\"applied\":{\"sampling_s\":5,\"report_interval_s\":60},"
+    "\"sensor_sampling_ms\":{\"soil\":5000,\"tilt\":1000,\"rain\":5000}}";
+
+// Fix, recommended minimum and satellites in view from a UM220 at 1 Hz
+static const char *const g_nmea_bodies[] = {
+    "GNGGA,083000.00,2232.1234567,N,11356.7654321,E,1,12,0.8,45.3,M,-3.2,M,,",
+    "GNRMC,083000.00,A,2232.1234567,N,11356.7654321,E,0.02,,190726,,,A",
+    "GPGSV,3,1,11,02,45,123,38,05,67,045,41,12,23,300,35,13,10,210,30",
+    "GNGSA,A,3,02,05,12,13,15,18,20,25,,,,,1.4,0.8,1.1",
+};
+
+static uint32_t NextRandom(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static uint64_t NowNs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+// ==================== Inputs ====================
+
+static void FillSensorData(SensorData *data)
+{
+    unsigned int i;
+
+    memset(data, 0, sizeof(*data));
+    data->seq = 1234U;
+    data->uptime = 86400U;
+    data->soil_temperature = 18.6f;
+    data->soil_moisture = 31.4f;
+    data->soil_ec = 412.0f;
+    data->soil_ec_valid = 1;
+    data->soil_valid = 1;
+    data->latitude = 22.53539;
+    data->longitude = 113.94609;
+    data->gps_valid = 1;
+    data->gps_quality = 1;
+    data->gps_sats = 12;
+    data->gps_hdop = 0.8f;
+    data->gps_age_ms = 420U;
+    data->gps_utc_date = 20260719U;
+    data->gps_utc_ms = 30600000U;
+    data->gps_utc_valid = 1;
+    data->gps_est_valid = 1;
+    data->gps_mean_latitude = 22.535388;
+    data->gps_mean_longitude = 113.946091;
+    data->gps_std_m = 1.7f;
+    data->gps_rate_valid = 1;
+    data->gps_rate_mm_per_day = 0.6f;
+    data->angle_x = 1.25f;
+    data->angle_y = -0.75f;
+    data->tilt_valid = 1;
+    data->battery_level = 87;
+    data->risk_valid = 1;
+    data->risk_level = 1;
+    data->risk_confidence = 0.8f;
+    for (i = 0U; i < SENSOR_WINDOW_SOIL_EC + 1U; ++i) {
+        data->window[i].count = 60U;
+        data->window[i].min = 1.0f + (float)i;
+        data->window[i].max = 2.0f + (float)i;
+        data->window[i].last = 1.5f + (float)i;
+        data->window[i].mean = 1.5f + (float)i;
+        data->window[i].m2 = 0.25f * 60.0f;
+    }
+}
+
+static void AppendNmea(const char *body)
+{
+    uint8_t checksum = 0U;
+    const char *p;
+    int written;
+
+    for (p = body; *p != '\0'; ++p) {
+        checksum ^= (uint8_t)*p;
+    }
+    written = snprintf(&g_nmea[g_nmea_len], sizeof(g_nmea) - g_nmea_len, "$%s*%02X\r\n", body, checksum);
+    if (written > 0 && (unsigned int)written < sizeof(g_nmea) - g_nmea_len) {
+        g_nmea_len += (unsigned int)written;
+    }
+}
+
+static int PrepareInputs(void)
+{
+    unsigned int i;
+
+    for (i = 0U; i < sizeof(g_block); ++i) {
+        g_block[i] = (unsigned char)NextRandom();
+    }
+    for (i = 0U; i < sizeof(g_chunk); ++i) {
+        g_chunk[i] = (unsigned char)NextRandom();
+    }
+    for (i = 0U; i < sizeof(g_nmea_bodies) / sizeof(g_nmea_bodies[0]); ++i) {
+        AppendNmea(g_nmea_bodies[i]);
+    }
+
+    FillSensorData(&g_sensor);
+    g_telemetry_len = BuildTelemetryEnvelopeV1(&g_sensor, "set_config", "2f6b1c8e-8a51-4c55-9f0e-3b7d2e41c9a0",
+                                               86000U, "poll_latest", "2026-07-19T08:30:00.000+08:00",
+                                               "gnss", 0, g_telemetry, sizeof(g_telemetry));
+    g_frame_len = FieldLinkFrame_Encode(FIELD_LINK_FRAME_TYPE_TELEMETRY, 42U, g_telemetry, g_telemetry_len,
+                                        g_frame, sizeof(g_frame));
+    Fifo_Init(&g_fifo);
+    FieldLinkFrameDecoder_Init(&g_decoder);
+    // The decode case must time the success path, not a rejected frame.
+    g_message.payload_len = 0;
+    for (i = 0U; i < (unsigned int)(g_frame_len > 0 ? g_frame_len : 0); ++i) {
+        (void)FieldLinkFrameDecoder_FeedByte(&g_decoder, g_frame[i], &g_message);
+    }
+    if (g_telemetry_len <= 0 || g_frame_len <= 0 || g_message.payload_len != g_telemetry_len ||
+        ParseDeviceCommandV1(g_command_json, &g_command) != 0) {
+        fprintf(stderr, "bench input setup failed (telemetry=%d frame=%d)\n", g_telemetry_len, g_frame_len);
+        return -1;
+    }
+    return 0;
+}
+
+// ==================== Cases ====================
+
+static void RunNoop(void)
+{
+    g_sink++;
+}
+
+static void RunCrc16Request(void)
+{
+    g_sink += Crc_Modbus16(g_modbus_request, sizeof(g_modbus_request));
+}
+
+static void RunCrc16Block(void)
+{
+    g_sink += Crc_Modbus16(g_block, sizeof(g_block));
+}
+
+static void RunCrc16BlockBitwise(void)
+{
+    g_sink += Crc_Modbus16Bitwise(g_block, sizeof(g_block));
+}
+
+static void RunCrc32Block(void)
+{
+    g_sink += Crc_Ieee32(g_block, sizeof(g_block));
+}
+
+static void RunCrc32BlockBitwise(void)
+{
+    g_sink += Crc_Ieee32Bitwise(g_block, sizeof(g_block));
+}
+
+static void RunCrc8Block(void)
+{
+    g_sink += Crc_Sensirion8(g_block, sizeof(g_block));
+}
+
+static void RunCrc8BlockBitwise(void)
+{
+    g_sink += Crc_Sensirion8Bitwise(g_block, sizeof(g_block));
+}
+
+static void RunFrameEncode(void)
+{
+    g_sink += (unsigned int)FieldLinkFrame_Encode(FIELD_LINK_FRAME_TYPE_TELEMETRY, g_sink, g_telemetry,
+                                                  g_telemetry_len, g_frame, sizeof(g_frame));
+}
+
+static void RunFrameDecode(void)
+{
+    int i;
+
+    for (i = 0; i < g_frame_len; ++i) {
+        if (FieldLinkFrameDecoder_FeedByte(&g_decoder, g_frame[i], &g_message) > 0) {
+            g_sink += (unsigned int)g_message.payload_len;
+        }
+    }
+}
+
+static void RunTelemetryBuild(void)
+{
+    g_sink += (unsigned int)BuildTelemetryEnvelopeV1(&g_sensor, "set_config", "2f6b1c8e-8a51-4c55-9f0e-3b7d2e41c9a0",
+                                                     86000U, "poll_latest", "2026-07-19T08:30:00.000+08:00",
+                                                     "gnss", 0, g_telemetry, sizeof(g_telemetry));
+}
+
+static void RunCommandParse(void)
+{
+    g_sink += (unsigned int)ParseDeviceCommandV1(g_command_json, &g_command) + (unsigned int)g_command.sampling_s;
+}
+
+static void RunAckBuild(void)
+{
+    g_sink += (unsigned int)BuildDeviceCommandAckV1(g_command.command_id, "acked", g_ack_result,
+                                                    "2026-07-19T08:30:01.000+08:00", g_ack, sizeof(g_ack));
+}
+
+static void RunFifoWriteRead(void)
+{
+    unsigned char out[BENCH_FIFO_CHUNK_BYTES];
+
+    g_sink += (unsigned int)Fifo_Write(&g_fifo, g_chunk, sizeof(g_chunk));
+    g_sink += (unsigned int)Fifo_Read(&g_fifo, out, sizeof(out));
+}
+
+static void RunNmea(void)
+{
+    GPS_ProcessBytes((const unsigned char *)g_nmea, (int)g_nmea_len);
+}
+
+static BenchCase g_cases[] = {
+    {"crc16_modbus_request", RunCrc16Request, sizeof(g_modbus_request)},
+    {"crc16_modbus_256", RunCrc16Block, BENCH_CRC_BLOCK_BYTES},
+    {"crc16_modbus_256_bitwise", RunCrc16BlockBitwise, BENCH_CRC_BLOCK_BYTES},
+    {"crc32_ieee_256", RunCrc32Block, BENCH_CRC_BLOCK_BYTES},
+    {"crc32_ieee_256_bitwise", RunCrc32BlockBitwise, BENCH_CRC_BLOCK_BYTES},
+    {"crc8_sensirion_256", RunCrc8Block, BENCH_CRC_BLOCK_BYTES},
+    {"crc8_sensirion_256_bitwise", RunCrc8BlockBitwise, BENCH_CRC_BLOCK_BYTES},
+    {"field_link_frame_encode", RunFrameEncode, 0U},
+    {"field_link_frame_decode", RunFrameDecode, 0U},
+    {"telemetry_envelope_build", RunTelemetryBuild, 0U},
+    {"device_command_parse", RunCommandParse, sizeof(g_command_json) - 1U},
+    {"device_command_ack_build", RunAckBuild, 0U},
+    {"fifo_write_read_64", RunFifoWriteRead, BENCH_FIFO_CHUNK_BYTES},
+    {"gps_nmea_process", RunNmea, 0U},
+};
+
+// Sizes known only after PrepareInputs
+static void FillInputSizes(void)
+{
+    unsigned int i;
+
+    for (i = 0U; i < sizeof(g_cases) / sizeof(g_cases[0]); ++i) {
+        if (g_cases[i].run == RunFrameEncode || g_cases[i].run == RunTelemetryBuild) {
+            g_cases[i].bytes = (unsigned int)g_telemetry_len;
+        } else if (g_cases[i].run == RunFrameDecode) {
+            g_cases[i].bytes = (unsigned int)g_frame_len;
+        } else if (g_cases[i].run == RunAckBuild) {
+            g_cases[i].bytes = sizeof(g_ack_result) - 1U;
+        } else if (g_cases[i].run == RunNmea) {
+            g_cases[i].bytes = g_nmea_len;
+        }
+    }
+}
+
+// ==================== Measurement ====================
+
+static uint64_t TimeBatch(void (*run)(void), uint64_t iterations)
+{
+    uint64_t start = NowNs();
+    uint64_t i;
+
+    for (i = 0U; i < iterations; ++i) {
+        run();
+    }
+    return NowNs() - start;
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static void *StackProbe(void *arg)
+{
+    ((void (*)(void))arg)();
+    return NULL;
+}
+
+// Peak stack of one call on a freshly painted thread stack, including the thread start-up frames
+static long MeasureStack(void (*run)(void))
+{
+    pthread_attr_t attr;
+    pthread_t thread;
+    unsigned char *stack = (unsigned char *)malloc(BENCH_STACK_BYTES);
+    unsigned int untouched = 0U;
+
+    if (stack == NULL) {
+        return -1;
+    }
+    memset(stack, BENCH_STACK_PAINT, BENCH_STACK_BYTES);
+    pthread_attr_init(&attr);
+    if (pthread_attr_setstack(&attr, stack, BENCH_STACK_BYTES) != 0 ||
+        pthread_create(&thread, &attr, StackProbe, (void *)run) != 0) {
+        pthread_attr_destroy(&attr);
+        free(stack);
+        return -1;
+    }
+    pthread_join(thread, NULL);
+    pthread_attr_destroy(&attr);
+
+    // The stack grows down from the top of the buffer.
+    while (untouched < BENCH_STACK_BYTES && stack[untouched] == BENCH_STACK_PAINT) {
+        untouched++;
+    }
+    free(stack);
+    return (long)(BENCH_STACK_BYTES - untouched);
+}
+
+static void RunCase(const BenchCase *bench, unsigned int min_ms, unsigned int repeats, long stack_baseline)
+{
+    double ns_per_op[BENCH_MAX_REPEATS];
+    uint64_t target_ns = (uint64_t)min_ms * 1000000ULL / repeats;
+    uint64_t iterations = 1U;
+    uint64_t elapsed;
+    long stack;
+    double median;
+    unsigned int r;
+
+    // Grow the batch until one repeat takes its share of min_ms.
+    for (;;) {
+        elapsed = TimeBatch(bench->run, iterations);
+        if (elapsed >= target_ns || iterations >= (1ULL << 40)) {
+            break;
+        }
+        iterations = elapsed == 0U ? iterations * 16U :
+            (uint64_t)((double)iterations * (double)target_ns * 1.2 / (double)elapsed) + 1U;
+    }
+
+    for (r = 0U; r < repeats; ++r) {
+        ns_per_op[r] = (double)TimeBatch(bench->run, iterations) / (double)iterations;
+    }
+    qsort(ns_per_op, repeats, sizeof(ns_per_op[0]), CompareDouble);
+    median = ns_per_op[repeats / 2U];
+
+    stack = MeasureStack(bench->run);
+    if (stack >= 0 && stack_baseline >= 0) {
+        stack = stack > stack_baseline ? stack - stack_baseline : 0;
+    }
+
+    fprintf(g_out, "{\"case\":\"%s\",\"iterations\":%llu,\"repeats\":%u,\"ns_per_op\":%.1f,"
+           "\"ns_min\":%.1f,\"ns_max\":%.1f,\"bytes_per_op\":%u,\"mb_per_s\":%.2f,\"stack_bytes\":%ld}\n",
+           bench->name,
+           (unsigned long long)iterations,
+           repeats,
+           median,
+           ns_per_op[0],
+           ns_per_op[repeats - 1U],
+           bench->bytes,
+           bench->bytes > 0U && median > 0.0 ? (double)bench->bytes * 1000.0 / median : 0.0,
+           stack);
+}
+
+int main(int argc, char **argv)
+{
+    const char *filter = NULL;
+    unsigned int min_ms = BENCH_DEFAULT_MIN_MS;
+    unsigned int repeats = BENCH_DEFAULT_REPEATS;
+    long stack_baseline;
+    unsigned int i;
+    int a;
+
+    for (a = 1; a < argc; ++a) {
+        if (strcmp(argv[a], "--filter") == 0 && a + 1 < argc) {
+            filter = argv[++a];
+        } else if (strcmp(argv[a], "--min-time-ms") == 0 && a + 1 < argc) {
+            min_ms = (unsigned int)strtoul(argv[++a], NULL, 10);
+        } else if (strcmp(argv[a], "--repeats") == 0 && a + 1 < argc) {
+            repeats = (unsigned int)strtoul(argv[++a], NULL, 10);
+        } else {
+            fprintf(stderr, "usage: %s [--filter substr] [--min-time-ms N] [--repeats N]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (repeats == 0U || repeats > BENCH_MAX_REPEATS) {
+        repeats = BENCH_DEFAULT_REPEATS;
+    }
+    if (min_ms == 0U) {
+        min_ms = 1U;
+    }
+
+    // Results keep the real stdout; firmware printf output is moved to stderr.
+    g_out = fdopen(dup(STDOUT_FILENO), "w");
+    if (g_out == NULL || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        return 1;
+    }
+    setvbuf(g_out, NULL, _IOLBF, 0);
+
+    if (PrepareInputs() != 0) {
+        return 1;
+    }
+    FillInputSizes();
+    stack_baseline = MeasureStack(RunNoop);
+
+    fprintf(g_out, "{\"meta\":\"landslide_bench\",\"seed\":%u,\"min_time_ms\":%u,\"repeats\":%u,"
+           "\"telemetry_bytes\":%d,\"frame_bytes\":%d,\"stack_baseline\":%ld}\n",
+           BENCH_SEED, min_ms, repeats, g_telemetry_len, g_frame_len, stack_baseline);
+    for (i = 0U; i < sizeof(g_cases) / sizeof(g_cases[0]); ++i) {
+        if (filter == NULL || strstr(g_cases[i].name, filter) != NULL) {
+            RunCase(&g_cases[i], min_ms, repeats, stack_baseline);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "flash_sim.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static FILE *g_sim_file = NULL;
+static FlashLogPort g_sim_port;
+static uint32_t *g_sim_erase_counts = NULL;
+static long g_sim_power_budget = -1;
+
+static int SimRegionOk(uint32_t offset, uint32_t size)
+{
+    uint32_t total = g_sim_port.sector_size * g_sim_port.sector_count;
+
+    return g_sim_file != NULL && size <= total && offset <= total - size;
+}
+
+static int SimRead(uint32_t offset, uint8_t *data, uint32_t size)
+{
+    if (!SimRegionOk(offset, size) || fseek(g_sim_file, (long)offset, SEEK_SET) != 0) {
+        return -1;
+    }
+    return fread(data, 1, size, g_sim_file) == size ? 0 : -1;
+}
+
+static int SimWrite(uint32_t offset, const uint8_t *data, uint32_t size)
+{
+    uint8_t cell[256];
+    uint32_t done;
+    uint32_t i;
+    uint32_t limit = size;
+    int cut = 0;
+
+    if (!SimRegionOk(offset, size)) {
+        return -1;
+    }
+    if (g_sim_power_budget >= 0 && (long)size > g_sim_power_budget) {
+        limit = (uint32_t)g_sim_power_budget;
+        cut = 1;
+    }
+
+    // NOR programming only clears bits, so AND the new data into the old.
+    for (done = 0; done < limit; done += (uint32_t)sizeof(cell)) {
+        uint32_t n = limit - done < sizeof(cell) ? limit - done : (uint32_t)sizeof(cell);
+
+        if (SimRead(offset + done, cell, n) != 0) {
+            return -1;
+        }
+        for (i = 0; i < n; ++i) {
+            cell[i] &= data[done + i];
+        }
+        if (fseek(g_sim_file, (long)(offset + done), SEEK_SET) != 0 || fwrite(cell, 1, n, g_sim_file) != n) {
+            return -1;
+        }
+    }
+    fflush(g_sim_file);
+
+    if (g_sim_power_budget >= 0) {
+        g_sim_power_budget -= (long)limit;
+    }
+    return cut ? -1 : 0;
+}
+
+static int SimErase(uint32_t offset, uint32_t size)
+{
+    uint8_t blank[256];
+    uint32_t done;
+
+    if (!SimRegionOk(offset, size) || (offset % g_sim_port.sector_size) != 0U ||
+        (size % g_sim_port.sector_size) != 0U || g_sim_power_budget == 0) {
+        return -1;
+    }
+    memset(blank, 0xFF, sizeof(blank));
+    for (done = 0; done < size; done += (uint32_t)sizeof(blank)) {
+        uint32_t n = size - done < sizeof(blank) ? size - done : (uint32_t)sizeof(blank);
+
+        if (fseek(g_sim_file, (long)(offset + done), SEEK_SET) != 0 || fwrite(blank, 1, n, g_sim_file) != n) {
+            return -1;
+        }
+    }
+    fflush(g_sim_file);
+    for (done = 0; done < size; done += g_sim_port.sector_size) {
+        g_sim_erase_counts[(offset + done) / g_sim_port.sector_size]++;
+    }
+    return 0;
+}
+
+const FlashLogPort *FlashSim_Open(const char *path, uint32_t sector_size, uint32_t sector_count)
+{
+    uint8_t blank[256];
+    long total = (long)sector_size * (long)sector_count;
+    long size;
+
+    FlashSim_Close();
+    if (path == NULL || sector_size == 0U || sector_count == 0U) {
+        return NULL;
+    }
+
+    g_sim_file = fopen(path, "r+b");
+    if (g_sim_file == NULL) {
+        g_sim_file = fopen(path, "w+b");
+    }
+    if (g_sim_file == NULL) {
+        return NULL;
+    }
+
+    // Grow a new or short file with erased bytes.
+    memset(blank, 0xFF, sizeof(blank));
+    if (fseek(g_sim_file, 0, SEEK_END) != 0) {
+        FlashSim_Close();
+        return NULL;
+    }
+    for (size = ftell(g_sim_file); size >= 0 && size < total; ) {
+        long n = total - size < (long)sizeof(blank) ? total - size : (long)sizeof(blank);
+
+        if (fwrite(blank, 1, (size_t)n, g_sim_file) != (size_t)n) {
+            FlashSim_Close();
+            return NULL;
+        }
+        size += n;
+    }
+    fflush(g_sim_file);
+
+    g_sim_erase_counts = (uint32_t *)calloc(sector_count, sizeof(uint32_t));
+    if (g_sim_erase_counts == NULL) {
+        FlashSim_Close();
+        return NULL;
+    }
+    g_sim_power_budget = -1;
+    g_sim_port.read = SimRead;
+    g_sim_port.write = SimWrite;
+    g_sim_port.erase = SimErase;
+    g_sim_port.sector_size = sector_size;
+    g_sim_port.sector_count = sector_count;
+    return &g_sim_port;
+}
+
+void FlashSim_Close(void)
+{
+    if (g_sim_file != NULL) {
+        fclose(g_sim_file);
+        g_sim_file = NULL;
+    }
+    free(g_sim_erase_counts);
+    g_sim_erase_counts = NULL;
+}
+
+void FlashSim_CutPowerAfterBytes(long budget)
+{
+    g_sim_power_budget = budget;
+}
+
+uint32_t FlashSim_EraseCount(uint32_t sector)
+{
+    return g_sim_erase_counts != NULL && sector < g_sim_port.sector_count ? g_sim_erase_counts[sector] : 0U;
+}
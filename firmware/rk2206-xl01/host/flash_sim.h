@@ -0,0 +1,40 @@
+/*
+ * Flash Simulator
+ * File-backed NOR flash behind a FlashLogPort, for host builds and tests
+ */
+
+#ifndef HOST_FLASH_SIM_H
+#define HOST_FLASH_SIM_H
+
+#include <stdint.h>
+#include "../utils/flash_log.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Open (or create, erased) the backing file. Contents persist across opens,
+ * which is how a host test models a reboot. Only one simulator is open at a time.
+ * @return port, or NULL on I/O failure
+ */
+const FlashLogPort *FlashSim_Open(const char *path, uint32_t sector_size, uint32_t sector_count);
+
+void FlashSim_Close(void);
+
+/**
+ * Model power loss: after budget more programmed bytes every write and erase
+ * fails, the write that crosses the budget programmed only partly. -1 disarms.
+ */
+void FlashSim_CutPowerAfterBytes(long budget);
+
+/**
+ * Times the sector has been erased since FlashSim_Open
+ */
+uint32_t FlashSim_EraseCount(uint32_t sector);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_FLASH_SIM_H
@@ -0,0 +1,611 @@
+/*
+ * Host HAL - Kernel
+ * LiteOS-M and CMSIS-RTOS2 tasks, mutexes, semaphores and ticks on pthreads.
+ * Handles index fixed tables, as LOS handles do. LANDSLIDE_HOST_TIME_SCALE=k
+ * (1..100) runs firmware time k times faster than the host clock: ticks
+ * advance k per ms and every sleep or timeout is cut to 1/k. Task stacks are
+ * painted and guarded like the kernel's, so LOS_TaskInfoGet reports real
+ * high-water marks; CPU share comes from the thread CPU clocks.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#include "los_cpup.h"
+#include "los_mux.h"
+#include "los_sem.h"
+#include "los_task.h"
+#include "los_tick.h"
+#include "cmsis_os2.h"
+
+#define HOST_MAX_TASKS  (LOSCFG_BASE_CORE_TSK_LIMIT + 1U)
+#define HOST_NO_TASK    HOST_MAX_TASKS
+#define HOST_TASK_STACK_BYTES (256U * 1024U)  // glibc printf alone needs more than the target stacks
+#define HOST_STACK_FILL 0xA5U
+#define HOST_MAX_MUXES  64U
+#define HOST_MAX_SEMS   32U
+#define HOST_MAX_TIME_SCALE 100U
+
+typedef struct {
+    pthread_t thread;
+    TSK_ENTRY_FUNC entry;       // LOS_TaskCreate
+    UINT32 arg;
+    osThreadFunc_t func;        // osThreadNew
+    void *argument;
+    char name[LOS_TASK_NAMELEN];
+    UINT16 priority;
+    unsigned char *stack;       // Lowest usable byte; a PROT_NONE guard page sits below it
+    uint64_t created_ns;
+    uint64_t cpup_cpu_ns;       // Start of the current LOS_HistoryTaskCpuUsage window
+    uint64_t cpup_wall_ns;
+    unsigned char used;
+} HostTask;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    unsigned char used;
+} HostMux;
+
+typedef struct {
+    sem_t sem;
+    unsigned char binary;
+    unsigned char used;
+} HostSem;
+
+static HostTask g_tasks[HOST_MAX_TASKS];
+static HostMux g_muxes[HOST_MAX_MUXES];
+static HostSem g_sems[HOST_MAX_SEMS];
+static pthread_mutex_t g_table_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread UINT32 t_current_task = HOST_NO_TASK;
+
+TSKSWITCHHOOK g_pfnUsrTskSwitchHook = NULL;
+
+static unsigned int TimeScale(void)
+{
+    static unsigned int scale = 0U;
+
+    if (scale == 0U) {
+        const char *env = getenv("LANDSLIDE_HOST_TIME_SCALE");
+        unsigned long value = env != NULL ? strtoul(env, NULL, 10) : 1UL;
+
+        scale = (value >= 1UL && value <= HOST_MAX_TIME_SCALE) ? (unsigned int)value : 1U;
+    }
+    return scale;
+}
+
+// Firmware milliseconds since the first call
+static uint64_t MonotonicMs(void)
+{
+    static uint64_t start_us = 0U;
+    struct timespec now;
+    uint64_t us;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    us = (uint64_t)now.tv_sec * 1000000U + (uint64_t)now.tv_nsec / 1000U;
+    if (start_us == 0U) {
+        start_us = us;
+    }
+    return (us - start_us) * TimeScale() / 1000U;
+}
+
+// Host nanoseconds on clock, for CPU share; unaffected by the time scale
+static uint64_t ClockNs(clockid_t clock)
+{
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+// Absolute CLOCK_REALTIME deadline, as the timed pthread/sem calls want
+static struct timespec DeadlineAfterMs(UINT32 timeout_ms)
+{
+    struct timespec deadline;
+    uint64_t host_us = (uint64_t)timeout_ms * 1000U / TimeScale();
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t)(host_us / 1000000U);
+    deadline.tv_nsec += (long)(host_us % 1000000U) * 1000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+    return deadline;
+}
+
+static UINT32 TicksToMs(UINT32 ticks)
+{
+    return (UINT32)(((uint64_t)ticks * 1000U) / LOSCFG_BASE_CORE_TICK_PER_SECOND);
+}
+
+// On the board the scheduler runs the hook as the task gives up the CPU;
+// here that is just before it blocks.
+static void NoteSwitchOut(void)
+{
+    TSKSWITCHHOOK hook = g_pfnUsrTskSwitchHook;
+
+    if (hook != NULL) {
+        hook();
+    }
+}
+
+// ==================== Tasks and Time ====================
+
+// Take a free slot. Called with g_table_lock held.
+static HostTask *ClaimTask(const char *name, UINT16 priority)
+{
+    UINT32 i;
+
+    for (i = 0U; i < HOST_MAX_TASKS && g_tasks[i].used; ++i) {
+    }
+    if (i == HOST_MAX_TASKS) {
+        return NULL;
+    }
+    g_tasks[i].used = 1U;
+    g_tasks[i].entry = NULL;
+    g_tasks[i].func = NULL;
+    g_tasks[i].priority = priority;
+    snprintf(g_tasks[i].name, sizeof(g_tasks[i].name), "%s", name != NULL ? name : "");
+    return &g_tasks[i];
+}
+
+static void ReleaseTask(HostTask *task)
+{
+    pthread_mutex_lock(&g_table_lock);
+    task->used = 0U;
+    pthread_mutex_unlock(&g_table_lock);
+}
+
+static void *TaskTrampoline(void *arg)
+{
+    HostTask *task = (HostTask *)arg;
+
+    t_current_task = (UINT32)(task - g_tasks);
+    if (task->entry != NULL) {
+        (void)task->entry(task->arg);
+    } else {
+        task->func(task->argument);
+    }
+    ReleaseTask(task);
+    return NULL;
+}
+
+// Painted stack with a guard page below it, as the kernel lays them out.
+// A slot keeps its stack: a detached thread may still be unwinding on it
+// after freeing the slot, and firmware tasks live for the whole process.
+static unsigned char *MapTaskStack(void)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    unsigned char *base = (unsigned char *)mmap(NULL, HOST_TASK_STACK_BYTES + page, PROT_READ | PROT_WRITE,
+                                                MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+
+    if (base == MAP_FAILED) {
+        return NULL;
+    }
+    (void)mprotect(base, page, PROT_NONE);
+    return base + page;
+}
+
+static int StartTask(HostTask *task)
+{
+    pthread_attr_t attr;
+    int ret;
+
+    if (task->stack == NULL) {
+        task->stack = MapTaskStack();
+    }
+    if (task->stack == NULL) {
+        ReleaseTask(task);
+        return -1;
+    }
+    memset(task->stack, HOST_STACK_FILL, HOST_TASK_STACK_BYTES);
+    task->created_ns = ClockNs(CLOCK_MONOTONIC);
+    task->cpup_cpu_ns = 0U;
+    task->cpup_wall_ns = task->created_ns;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstack(&attr, task->stack, HOST_TASK_STACK_BYTES);
+    ret = pthread_create(&task->thread, &attr, TaskTrampoline, task);
+    pthread_attr_destroy(&attr);
+    if (ret != 0) {
+        ReleaseTask(task);
+        return ret;
+    }
+    if (task->name[0] != '\0') {
+        char short_name[16];
+
+        // Linux limits thread names to 15 characters.
+        snprintf(short_name, sizeof(short_name), "%.15s", task->name);
+        (void)pthread_setname_np(task->thread, short_name);
+    }
+    return 0;
+}
+
+UINT32 LOS_TaskCreate(UINT32 *taskID, TSK_INIT_PARAM_S *initParam)
+{
+    HostTask *task;
+
+    if (taskID == NULL || initParam == NULL || initParam->pfnTaskEntry == NULL) {
+        return LOS_NOK;
+    }
+
+    pthread_mutex_lock(&g_table_lock);
+    task = ClaimTask(initParam->pcName, initParam->usTaskPrio);
+    if (task != NULL) {
+        task->entry = initParam->pfnTaskEntry;
+        task->arg = initParam->uwArg;
+    }
+    pthread_mutex_unlock(&g_table_lock);
+
+    if (task == NULL || StartTask(task) != 0) {
+        return LOS_NOK;
+    }
+    *taskID = (UINT32)(task - g_tasks);
+    return LOS_OK;
+}
+
+UINT32 LOS_TaskInfoGet(UINT32 taskID, TSK_INFO_S *taskInfo)
+{
+    HostTask *task;
+    const unsigned char *p;
+
+    if (taskInfo == NULL || taskID >= HOST_MAX_TASKS) {
+        return LOS_NOK;
+    }
+    task = &g_tasks[taskID];
+
+    pthread_mutex_lock(&g_table_lock);
+    if (!task->used || task->stack == NULL) {
+        pthread_mutex_unlock(&g_table_lock);
+        return LOS_NOK;
+    }
+    memset(taskInfo, 0, sizeof(*taskInfo));
+    snprintf(taskInfo->acName, sizeof(taskInfo->acName), "%s", task->name);
+    taskInfo->uwTaskID = taskID;
+    taskInfo->usTaskPrio = task->priority;
+    taskInfo->uwStackSize = HOST_TASK_STACK_BYTES;
+    // glibc keeps the thread descriptor and TLS at the top, so a few KB count as used from the start.
+    for (p = task->stack; p < task->stack + HOST_TASK_STACK_BYTES && *p == HOST_STACK_FILL; ++p) {
+    }
+    taskInfo->uwPeakUsed = (UINT32)(task->stack + HOST_TASK_STACK_BYTES - p);
+    taskInfo->bOvf = p == task->stack;
+    pthread_mutex_unlock(&g_table_lock);
+    return LOS_OK;
+}
+
+UINT32 LOS_CurTaskIDGet(VOID)
+{
+    return t_current_task;
+}
+
+UINT32 LOS_HistoryTaskCpuUsage(UINT32 taskID, UINT16 mode)
+{
+    HostTask *task;
+    clockid_t clock;
+    uint64_t cpu_ns;
+    uint64_t wall_ns;
+    uint64_t base_cpu;
+    uint64_t base_wall;
+    UINT32 usage;
+
+    if (taskID >= HOST_MAX_TASKS) {
+        return LOS_ERRNO_CPUP_TSK_ID_INVALID;
+    }
+    task = &g_tasks[taskID];
+
+    // A thread frees its slot last, so its clock is valid while the slot is used.
+    pthread_mutex_lock(&g_table_lock);
+    if (!task->used || pthread_getcpuclockid(task->thread, &clock) != 0) {
+        pthread_mutex_unlock(&g_table_lock);
+        return LOS_ERRNO_CPUP_TSK_ID_INVALID;
+    }
+    cpu_ns = ClockNs(clock);
+    wall_ns = ClockNs(CLOCK_MONOTONIC);
+    if (mode == CPUP_ALL_TIME) {
+        base_cpu = 0U;
+        base_wall = task->created_ns;
+    } else {
+        base_cpu = task->cpup_cpu_ns;
+        base_wall = task->cpup_wall_ns;
+        task->cpup_cpu_ns = cpu_ns;
+        task->cpup_wall_ns = wall_ns;
+    }
+    pthread_mutex_unlock(&g_table_lock);
+
+    if (wall_ns <= base_wall || cpu_ns < base_cpu) {
+        return 0U;
+    }
+    usage = (UINT32)(((cpu_ns - base_cpu) * 1000U) / (wall_ns - base_wall));
+    return usage > 1000U ? 1000U : usage;
+}
+
+UINT32 LOS_TaskDelete(UINT32 taskID)
+{
+    if (taskID >= HOST_MAX_TASKS || !g_tasks[taskID].used) {
+        return LOS_NOK;
+    }
+    // LOS tasks only stop at kernel calls; LOS_Msleep is a cancellation point.
+    (void)pthread_cancel(g_tasks[taskID].thread);
+    g_tasks[taskID].used = 0U;
+    return LOS_OK;
+}
+
+VOID LOS_Msleep(UINT32 mSecs)
+{
+    struct timespec delay;
+    uint64_t host_us = (uint64_t)mSecs * 1000U / TimeScale();
+
+    NoteSwitchOut();
+    delay.tv_sec = (time_t)(host_us / 1000000U);
+    delay.tv_nsec = (long)(host_us % 1000000U) * 1000L;
+    while (nanosleep(&delay, &delay) != 0 && errno == EINTR) {
+    }
+}
+
+UINT32 LOS_TaskDelay(UINT32 tick)
+{
+    LOS_Msleep(TicksToMs(tick));
+    return LOS_OK;
+}
+
+UINT64 LOS_TickCountGet(VOID)
+{
+    return MonotonicMs() * LOSCFG_BASE_CORE_TICK_PER_SECOND / 1000U;
+}
+
+UINT32 LOS_MS2Tick(UINT32 millisec)
+{
+    return (UINT32)(((uint64_t)millisec * LOSCFG_BASE_CORE_TICK_PER_SECOND + 999U) / 1000U);
+}
+
+// ==================== Mutexes ====================
+
+static int LockWithTimeout(pthread_mutex_t *mutex, UINT32 timeout_ms)
+{
+    struct timespec deadline;
+    int ret = pthread_mutex_trylock(mutex);
+
+    if (ret != EBUSY || timeout_ms == 0U) {
+        return ret;
+    }
+    NoteSwitchOut();
+    if (timeout_ms == LOS_WAIT_FOREVER) {
+        return pthread_mutex_lock(mutex);
+    }
+    deadline = DeadlineAfterMs(timeout_ms);
+    return pthread_mutex_timedlock(mutex, &deadline);
+}
+
+static int InitRecursiveMutex(pthread_mutex_t *mutex)
+{
+    pthread_mutexattr_t attr;
+    int ret;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    ret = pthread_mutex_init(mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return ret;
+}
+
+UINT32 LOS_MuxCreate(UINT32 *muxHandle)
+{
+    UINT32 i;
+
+    if (muxHandle == NULL) {
+        return LOS_ERRNO_MUX_INVALID;
+    }
+
+    pthread_mutex_lock(&g_table_lock);
+    for (i = 0U; i < HOST_MAX_MUXES && g_muxes[i].used; ++i) {
+    }
+    if (i == HOST_MAX_MUXES || InitRecursiveMutex(&g_muxes[i].mutex) != 0) {
+        pthread_mutex_unlock(&g_table_lock);
+        return LOS_ERRNO_MUX_ALL_BUSY;
+    }
+    g_muxes[i].used = 1U;
+    pthread_mutex_unlock(&g_table_lock);
+
+    *muxHandle = i;
+    return LOS_OK;
+}
+
+UINT32 LOS_MuxDelete(UINT32 muxHandle)
+{
+    if (muxHandle >= HOST_MAX_MUXES || !g_muxes[muxHandle].used) {
+        return LOS_ERRNO_MUX_INVALID;
+    }
+    pthread_mutex_lock(&g_table_lock);
+    (void)pthread_mutex_destroy(&g_muxes[muxHandle].mutex);
+    g_muxes[muxHandle].used = 0U;
+    pthread_mutex_unlock(&g_table_lock);
+    return LOS_OK;
+}
+
+UINT32 LOS_MuxPend(UINT32 muxHandle, UINT32 timeout)
+{
+    if (muxHandle >= HOST_MAX_MUXES || !g_muxes[muxHandle].used) {
+        return LOS_ERRNO_MUX_INVALID;
+    }
+    if (timeout != LOS_WAIT_FOREVER) {
+        timeout = TicksToMs(timeout);
+    }
+    return LockWithTimeout(&g_muxes[muxHandle].mutex, timeout) == 0 ? LOS_OK : LOS_ERRNO_MUX_TIMEOUT;
+}
+
+UINT32 LOS_MuxPost(UINT32 muxHandle)
+{
+    if (muxHandle >= HOST_MAX_MUXES || !g_muxes[muxHandle].used) {
+        return LOS_ERRNO_MUX_INVALID;
+    }
+    return pthread_mutex_unlock(&g_muxes[muxHandle].mutex) == 0 ? LOS_OK : LOS_ERRNO_MUX_INVALID;
+}
+
+// ==================== Semaphores ====================
+
+static UINT32 CreateSem(UINT16 count, UINT32 *semHandle, unsigned char binary)
+{
+    UINT32 i;
+
+    if (semHandle == NULL || (binary && count > 1U)) {
+        return LOS_ERRNO_SEM_INVALID;
+    }
+
+    pthread_mutex_lock(&g_table_lock);
+    for (i = 0U; i < HOST_MAX_SEMS && g_sems[i].used; ++i) {
+    }
+    if (i == HOST_MAX_SEMS || sem_init(&g_sems[i].sem, 0, count) != 0) {
+        pthread_mutex_unlock(&g_table_lock);
+        return LOS_ERRNO_SEM_ALL_BUSY;
+    }
+    g_sems[i].binary = binary;
+    g_sems[i].used = 1U;
+    pthread_mutex_unlock(&g_table_lock);
+
+    *semHandle = i;
+    return LOS_OK;
+}
+
+UINT32 LOS_SemCreate(UINT16 count, UINT32 *semHandle)
+{
+    return CreateSem(count, semHandle, 0U);
+}
+
+UINT32 LOS_BinarySemCreate(UINT16 count, UINT32 *semHandle)
+{
+    return CreateSem(count, semHandle, 1U);
+}
+
+UINT32 LOS_SemDelete(UINT32 semHandle)
+{
+    if (semHandle >= HOST_MAX_SEMS || !g_sems[semHandle].used) {
+        return LOS_ERRNO_SEM_INVALID;
+    }
+    pthread_mutex_lock(&g_table_lock);
+    (void)sem_destroy(&g_sems[semHandle].sem);
+    g_sems[semHandle].used = 0U;
+    pthread_mutex_unlock(&g_table_lock);
+    return LOS_OK;
+}
+
+UINT32 LOS_SemPend(UINT32 semHandle, UINT32 timeout)
+{
+    struct timespec deadline;
+    int ret;
+
+    if (semHandle >= HOST_MAX_SEMS || !g_sems[semHandle].used) {
+        return LOS_ERRNO_SEM_INVALID;
+    }
+
+    ret = sem_trywait(&g_sems[semHandle].sem);
+    if (ret == 0 || timeout == 0U) {
+        return ret == 0 ? LOS_OK : LOS_ERRNO_SEM_TIMEOUT;
+    }
+    NoteSwitchOut();
+    if (timeout == LOS_WAIT_FOREVER) {
+        while ((ret = sem_wait(&g_sems[semHandle].sem)) != 0 && errno == EINTR) {
+        }
+    } else {
+        deadline = DeadlineAfterMs(TicksToMs(timeout));
+        while ((ret = sem_timedwait(&g_sems[semHandle].sem, &deadline)) != 0 && errno == EINTR) {
+        }
+    }
+    return ret == 0 ? LOS_OK : LOS_ERRNO_SEM_TIMEOUT;
+}
+
+UINT32 LOS_SemPost(UINT32 semHandle)
+{
+    int value = 0;
+
+    if (semHandle >= HOST_MAX_SEMS || !g_sems[semHandle].used) {
+        return LOS_ERRNO_SEM_INVALID;
+    }
+    // Check-then-post can race two posters past the cap; callers here post from one ISR.
+    if (g_sems[semHandle].binary && sem_getvalue(&g_sems[semHandle].sem, &value) == 0 && value > 0) {
+        return LOS_OK;
+    }
+    return sem_post(&g_sems[semHandle].sem) == 0 ? LOS_OK : LOS_ERRNO_SEM_INVALID;
+}
+
+// ==================== CMSIS-RTOS2 ====================
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr)
+{
+    HostTask *task;
+
+    if (func == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&g_table_lock);
+    task = ClaimTask(attr != NULL ? attr->name : NULL, attr != NULL ? (UINT16)attr->priority : 0U);
+    if (task != NULL) {
+        task->func = func;
+        task->argument = argument;
+    }
+    pthread_mutex_unlock(&g_table_lock);
+
+    if (task == NULL || StartTask(task) != 0) {
+        return NULL;
+    }
+    return (osThreadId_t)task;
+}
+
+osStatus_t osDelay(uint32_t ticks)
+{
+    LOS_Msleep(TicksToMs(ticks));
+    return osOK;
+}
+
+uint32_t osKernelGetTickCount(void)
+{
+    return (uint32_t)LOS_TickCountGet();
+}
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr)
+{
+    pthread_mutex_t *mutex = (pthread_mutex_t *)malloc(sizeof(*mutex));
+
+    (void)attr;
+    if (mutex == NULL || InitRecursiveMutex(mutex) != 0) {
+        free(mutex);
+        return NULL;
+    }
+    return (osMutexId_t)mutex;
+}
+
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout)
+{
+    if (mutex_id == NULL) {
+        return osErrorParameter;
+    }
+    if (timeout != osWaitForever) {
+        timeout = TicksToMs(timeout);
+    }
+    return LockWithTimeout((pthread_mutex_t *)mutex_id, timeout) == 0 ? osOK : osErrorTimeout;
+}
+
+osStatus_t osMutexRelease(osMutexId_t mutex_id)
+{
+    if (mutex_id == NULL) {
+        return osErrorParameter;
+    }
+    return pthread_mutex_unlock((pthread_mutex_t *)mutex_id) == 0 ? osOK : osErrorResource;
+}
+
+osStatus_t osMutexDelete(osMutexId_t mutex_id)
+{
+    if (mutex_id == NULL) {
+        return osErrorParameter;
+    }
+    (void)pthread_mutex_destroy((pthread_mutex_t *)mutex_id);
+    free(mutex_id);
+    return osOK;
+}
@@ -0,0 +1,538 @@
+/*
+ * Host HAL - Peripherals
+ * UART, I2C, GPIO, flash and KV store stand-ins for a Linux process.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "iot_errno.h"
+#include "iot_flash.h"
+#include "iot_gpio.h"
+#include "iot_i2c.h"
+#include "iot_uart.h"
+#include "kv_store.h"
+
+#define HOST_FLASH_SIZE         0x00400000U     // 4 MB, covers the sample log region
+#define HOST_FLASH_SECTOR_SIZE  4096U
+#define HOST_KV_VALUE_MAX       128U
+
+typedef struct {
+    int fd;                     // Firmware end, -1 until first opened
+    int peer_fd;                // Pipe mode: the simulator end
+    int pty_slave_fd;           // Pty mode: held open so reads see no hangup while nothing is attached
+    char pty_name[64];
+    unsigned char open;         // Between IoTUartInit and IoTUartDeinit
+} HostUart;
+
+typedef struct {
+    unsigned short addr;
+    const HostI2cDevice *device;
+    void *ctx;
+} HostI2cSlot;
+
+typedef struct {
+    GpioIsrCallbackFunc isr;
+    char *arg;
+} HostGpio;
+
+static HostUart g_uarts[HOST_UART_COUNT] = {
+    {-1, -1, -1, {0}, 0U}, {-1, -1, -1, {0}, 0U}, {-1, -1, -1, {0}, 0U},
+    {-1, -1, -1, {0}, 0U}, {-1, -1, -1, {0}, 0U}, {-1, -1, -1, {0}, 0U},
+};
+static HostI2cSlot g_i2c[HOST_I2C_BUS_COUNT][HOST_I2C_MAX_DEVICES];
+static HostGpio g_gpio[HOST_GPIO_COUNT];
+static pthread_mutex_t g_periph_lock = PTHREAD_MUTEX_INITIALIZER;
+static int g_flash_fd = -1;
+
+// ==================== UART ====================
+
+static int SetNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+
+    return flags < 0 ? -1 : fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static int OpenPty(HostUart *uart)
+{
+    struct termios tio;
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0 ||
+        ptsname_r(master, uart->pty_name, sizeof(uart->pty_name)) != 0) {
+        if (master >= 0) {
+            close(master);
+        }
+        return -1;
+    }
+    uart->pty_slave_fd = open(uart->pty_name, O_RDWR | O_NOCTTY);
+    if (uart->pty_slave_fd >= 0 && tcgetattr(uart->pty_slave_fd, &tio) == 0) {
+        cfmakeraw(&tio);
+        (void)tcsetattr(uart->pty_slave_fd, TCSANOW, &tio);
+    }
+    uart->fd = master;
+    return 0;
+}
+
+// First open picks the endpoint; later opens (the drivers re-init on link loss) reuse it.
+static int EnsureUartEndpoint(unsigned int id)
+{
+    HostUart *uart = &g_uarts[id];
+    char env_name[32];
+    const char *path;
+
+    if (uart->fd >= 0) {
+        return 0;
+    }
+
+    snprintf(env_name, sizeof(env_name), "LANDSLIDE_HOST_UART%u", id);
+    path = getenv(env_name);
+    if (path != NULL && strncmp(path, "fd:", 3) == 0) {
+        // Inherited from a parent simulator; dup it so a re-exec after reset still finds the original
+        uart->fd = dup(atoi(path + 3));
+        if (uart->fd < 0) {
+            printf("[HOST] UART%u %s unusable: %s\n", id, path, strerror(errno));
+            return -1;
+        }
+        printf("[HOST] UART%u <-> %s\n", id, path);
+    } else if (path != NULL && path[0] != '\0') {
+        uart->fd = open(path, O_RDWR | O_NOCTTY);
+        if (uart->fd < 0) {
+            printf("[HOST] UART%u open %s failed: %s\n", id, path, strerror(errno));
+            return -1;
+        }
+        printf("[HOST] UART%u <-> %s\n", id, path);
+    } else {
+        if (OpenPty(uart) != 0) {
+            printf("[HOST] UART%u pty failed: %s\n", id, strerror(errno));
+            return -1;
+        }
+        printf("[HOST] UART%u <-> %s\n", id, uart->pty_name);
+    }
+    return SetNonBlocking(uart->fd);
+}
+
+int HostUart_OpenPipe(unsigned int id)
+{
+    int fds[2];
+
+    if (id >= HOST_UART_COUNT) {
+        return -1;
+    }
+
+    pthread_mutex_lock(&g_periph_lock);
+    if (g_uarts[id].peer_fd >= 0) {
+        pthread_mutex_unlock(&g_periph_lock);
+        return g_uarts[id].peer_fd;
+    }
+    if (g_uarts[id].fd >= 0 || socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+        pthread_mutex_unlock(&g_periph_lock);
+        return -1;
+    }
+    (void)SetNonBlocking(fds[0]);
+    g_uarts[id].fd = fds[0];
+    g_uarts[id].peer_fd = fds[1];
+    pthread_mutex_unlock(&g_periph_lock);
+    return fds[1];
+}
+
+const char *HostUart_PtyName(unsigned int id)
+{
+    if (id >= HOST_UART_COUNT || g_uarts[id].pty_slave_fd < 0) {
+        return NULL;
+    }
+    return g_uarts[id].pty_name;
+}
+
+unsigned int IoTUartInit(unsigned int id, const IotUartAttribute *param)
+{
+    int ret;
+
+    if (id >= HOST_UART_COUNT || param == NULL) {
+        return (unsigned int)IOT_FAILURE;
+    }
+
+    pthread_mutex_lock(&g_periph_lock);
+    ret = EnsureUartEndpoint(id);
+    if (ret == 0) {
+        g_uarts[id].open = 1U;
+    }
+    pthread_mutex_unlock(&g_periph_lock);
+    return ret == 0 ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+int IoTUartRead(unsigned int id, unsigned char *data, unsigned int dataLen)
+{
+    ssize_t n;
+
+    if (id >= HOST_UART_COUNT || !g_uarts[id].open || data == NULL) {
+        return IOT_FAILURE;
+    }
+    n = read(g_uarts[id].fd, data, dataLen);
+    if (n < 0) {
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EIO) ? 0 : IOT_FAILURE;
+    }
+    return (int)n;
+}
+
+int IoTUartWrite(unsigned int id, const unsigned char *data, unsigned int dataLen)
+{
+    unsigned int done = 0U;
+
+    if (id >= HOST_UART_COUNT || !g_uarts[id].open || data == NULL) {
+        return IOT_FAILURE;
+    }
+    // The board's TX FIFO drains at line rate; here a full buffer means nobody is reading.
+    while (done < dataLen) {
+        ssize_t n = write(g_uarts[id].fd, data + done, dataLen - done);
+
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return IOT_FAILURE;
+        }
+        done += (unsigned int)n;
+    }
+    return (int)done;
+}
+
+unsigned int IoTUartDeinit(unsigned int id)
+{
+    if (id >= HOST_UART_COUNT) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    g_uarts[id].open = 0U;
+    return IOT_SUCCESS;
+}
+
+unsigned int IoTUartSetFlowCtrl(unsigned int id, IotFlowCtrl flowCtrl)
+{
+    (void)flowCtrl;
+    return id < HOST_UART_COUNT ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int LzUartReadAny(unsigned int id)
+{
+    int pending = 0;
+
+    if (id >= HOST_UART_COUNT || !g_uarts[id].open || ioctl(g_uarts[id].fd, FIONREAD, &pending) != 0) {
+        return 0U;
+    }
+    return (unsigned int)pending;
+}
+
+// ==================== I2C ====================
+
+static HostI2cSlot *FindI2cSlot(unsigned int bus, unsigned short addr)
+{
+    unsigned int i;
+
+    if (bus >= HOST_I2C_BUS_COUNT) {
+        return NULL;
+    }
+    for (i = 0U; i < HOST_I2C_MAX_DEVICES; ++i) {
+        if (g_i2c[bus][i].device != NULL && g_i2c[bus][i].addr == addr) {
+            return &g_i2c[bus][i];
+        }
+    }
+    return NULL;
+}
+
+int HostI2c_Attach(unsigned int bus, unsigned short addr, const HostI2cDevice *device, void *ctx)
+{
+    unsigned int i;
+
+    if (bus >= HOST_I2C_BUS_COUNT || device == NULL || FindI2cSlot(bus, addr) != NULL) {
+        return -1;
+    }
+    for (i = 0U; i < HOST_I2C_MAX_DEVICES; ++i) {
+        if (g_i2c[bus][i].device == NULL) {
+            g_i2c[bus][i].addr = addr;
+            g_i2c[bus][i].ctx = ctx;
+            g_i2c[bus][i].device = device;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+unsigned int IoTI2cInit(unsigned int id, unsigned int baudrate)
+{
+    (void)baudrate;
+    return id < HOST_I2C_BUS_COUNT ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int IoTI2cDeinit(unsigned int id)
+{
+    return id < HOST_I2C_BUS_COUNT ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int IoTI2cWrite(unsigned int id, unsigned short deviceAddr, const unsigned char *data, unsigned int dataLen)
+{
+    HostI2cSlot *slot = FindI2cSlot(id, deviceAddr);
+
+    if (slot == NULL || slot->device->write == NULL || data == NULL) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    return slot->device->write(slot->ctx, data, dataLen) == 0 ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int IoTI2cRead(unsigned int id, unsigned short deviceAddr, unsigned char *data, unsigned int dataLen)
+{
+    HostI2cSlot *slot = FindI2cSlot(id, deviceAddr);
+
+    if (slot == NULL || slot->device->read == NULL || data == NULL) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    return slot->device->read(slot->ctx, data, dataLen) == 0 ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int IoTI2cScan(unsigned int id, unsigned short *slaveAddr, unsigned int slaveAddrLen)
+{
+    unsigned int found = 0U;
+    unsigned int i;
+
+    if (id >= HOST_I2C_BUS_COUNT) {
+        return 0U;
+    }
+    for (i = 0U; i < HOST_I2C_MAX_DEVICES; ++i) {
+        if (g_i2c[id][i].device != NULL) {
+            if (slaveAddr != NULL && found < slaveAddrLen) {
+                slaveAddr[found] = g_i2c[id][i].addr;
+            }
+            found++;
+        }
+    }
+    return found;
+}
+
+// ==================== GPIO ====================
+
+unsigned int IoTGpioInit(unsigned int id)
+{
+    return id < HOST_GPIO_COUNT ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int IoTGpioSetDir(unsigned int id, IotGpioDir dir)
+{
+    (void)dir;
+    return id < HOST_GPIO_COUNT ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int IoTGpioSetOutputVal(unsigned int id, IotGpioValue val)
+{
+    (void)val;
+    return id < HOST_GPIO_COUNT ? IOT_SUCCESS : (unsigned int)IOT_FAILURE;
+}
+
+unsigned int IoTGpioGetInputVal(unsigned int id, IotGpioValue *val)
+{
+    if (id >= HOST_GPIO_COUNT || val == NULL) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    *val = IOT_GPIO_VALUE0;
+    return IOT_SUCCESS;
+}
+
+unsigned int IoTGpioRegisterIsrFunc(unsigned int id, IotGpioIntType intType, IotGpioIntPolarity intPolarity,
+                                    GpioIsrCallbackFunc func, char *arg)
+{
+    (void)intType;
+    (void)intPolarity;
+    if (id >= HOST_GPIO_COUNT || func == NULL) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    g_gpio[id].arg = arg;
+    g_gpio[id].isr = func;
+    return IOT_SUCCESS;
+}
+
+void HostGpio_Trigger(unsigned int gpio)
+{
+    if (gpio < HOST_GPIO_COUNT && g_gpio[gpio].isr != NULL) {
+        g_gpio[gpio].isr(g_gpio[gpio].arg);
+    }
+}
+
+// ==================== Flash ====================
+
+unsigned int IoTFlashInit(void)
+{
+    const char *path = getenv("LANDSLIDE_HOST_FLASH");
+    unsigned char erased[HOST_FLASH_SECTOR_SIZE];
+    struct stat st;
+    off_t size;
+
+    if (g_flash_fd >= 0) {
+        return IOT_SUCCESS;
+    }
+    if (path == NULL || path[0] == '\0') {
+        path = "landslide_flash.img";
+    }
+    g_flash_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (g_flash_fd < 0 || fstat(g_flash_fd, &st) != 0) {
+        printf("[HOST] flash image %s: %s\n", path, strerror(errno));
+        return (unsigned int)IOT_FAILURE;
+    }
+
+    // A new (or short) image starts erased.
+    memset(erased, 0xFF, sizeof(erased));
+    for (size = st.st_size; size < (off_t)HOST_FLASH_SIZE; size += (off_t)sizeof(erased)) {
+        if (pwrite(g_flash_fd, erased, sizeof(erased), size) != (ssize_t)sizeof(erased)) {
+            return (unsigned int)IOT_FAILURE;
+        }
+    }
+    return IOT_SUCCESS;
+}
+
+unsigned int IoTFlashDeinit(void)
+{
+    if (g_flash_fd >= 0) {
+        close(g_flash_fd);
+        g_flash_fd = -1;
+    }
+    return IOT_SUCCESS;
+}
+
+static int FlashRangeOk(unsigned int offset, unsigned int size)
+{
+    return g_flash_fd >= 0 && size <= HOST_FLASH_SIZE && offset <= HOST_FLASH_SIZE - size;
+}
+
+unsigned int IoTFlashRead(unsigned int flashOffset, unsigned int size, unsigned char *ramData)
+{
+    if (!FlashRangeOk(flashOffset, size) || ramData == NULL ||
+        pread(g_flash_fd, ramData, size, flashOffset) != (ssize_t)size) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    return IOT_SUCCESS;
+}
+
+unsigned int IoTFlashErase(unsigned int flashOffset, unsigned int size)
+{
+    unsigned char erased[HOST_FLASH_SECTOR_SIZE];
+    unsigned int done;
+
+    if (!FlashRangeOk(flashOffset, size) || flashOffset % HOST_FLASH_SECTOR_SIZE != 0U) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    memset(erased, 0xFF, sizeof(erased));
+    for (done = 0U; done < size; done += HOST_FLASH_SECTOR_SIZE) {
+        if (pwrite(g_flash_fd, erased, HOST_FLASH_SECTOR_SIZE, flashOffset + done) != (ssize_t)HOST_FLASH_SECTOR_SIZE) {
+            return (unsigned int)IOT_FAILURE;
+        }
+    }
+    return IOT_SUCCESS;
+}
+
+unsigned int IoTFlashWrite(unsigned int flashOffset, unsigned int size, const unsigned char *ramData,
+                           unsigned char doErase)
+{
+    unsigned char cell[256];
+    unsigned int done;
+    unsigned int i;
+
+    if (!FlashRangeOk(flashOffset, size) || ramData == NULL) {
+        return (unsigned int)IOT_FAILURE;
+    }
+    if (doErase) {
+        unsigned int start = flashOffset - flashOffset % HOST_FLASH_SECTOR_SIZE;
+        unsigned int end = flashOffset + size;
+
+        end += (HOST_FLASH_SECTOR_SIZE - end % HOST_FLASH_SECTOR_SIZE) % HOST_FLASH_SECTOR_SIZE;
+        if (IoTFlashErase(start, end - start) != IOT_SUCCESS) {
+            return (unsigned int)IOT_FAILURE;
+        }
+    }
+
+    // NOR programming only clears bits.
+    for (done = 0U; done < size; done += (unsigned int)sizeof(cell)) {
+        unsigned int n = size - done < sizeof(cell) ? size - done : (unsigned int)sizeof(cell);
+
+        if (pread(g_flash_fd, cell, n, flashOffset + done) != (ssize_t)n) {
+            return (unsigned int)IOT_FAILURE;
+        }
+        for (i = 0U; i < n; ++i) {
+            cell[i] &= ramData[done + i];
+        }
+        if (pwrite(g_flash_fd, cell, n, flashOffset + done) != (ssize_t)n) {
+            return (unsigned int)IOT_FAILURE;
+        }
+    }
+    return IOT_SUCCESS;
+}
+
+// ==================== KV Store ====================
+
+static int KvPath(const char *key, char *path, size_t size)
+{
+    const char *dir = getenv("LANDSLIDE_HOST_KV_DIR");
+
+    if (key == NULL || key[0] == '\0' || strchr(key, '/') != NULL) {
+        return -1;
+    }
+    if (dir == NULL || dir[0] == '\0') {
+        dir = "landslide_kv";
+    }
+    (void)mkdir(dir, 0755);
+    return snprintf(path, size, "%s/%s", dir, key) < (int)size ? 0 : -1;
+}
+
+int UtilsGetValue(const char *key, char *value, unsigned int len)
+{
+    char path[256];
+    FILE *file;
+    size_t n;
+
+    if (value == NULL || len == 0U || KvPath(key, path, sizeof(path)) != 0) {
+        return -1;
+    }
+    file = fopen(path, "rb");
+    if (file == NULL) {
+        return -1;
+    }
+    n = fread(value, 1, len, file);
+    fclose(file);
+    if (n < len) {
+        value[n] = '\0';
+    }
+    return (int)n;
+}
+
+int UtilsSetValue(const char *key, const char *value)
+{
+    char path[256];
+    FILE *file;
+    size_t n;
+
+    if (value == NULL || strlen(value) >= HOST_KV_VALUE_MAX || KvPath(key, path, sizeof(path)) != 0) {
+        return -1;
+    }
+    file = fopen(path, "wb");
+    if (file == NULL) {
+        return -1;
+    }
+    n = fwrite(value, 1, strlen(value), file);
+    return (fclose(file) == 0 && n == strlen(value)) ? 0 : -1;
+}
+
+int UtilsDeleteValue(const char *key)
+{
+    char path[256];
+
+    if (KvPath(key, path, sizeof(path)) != 0) {
+        return -1;
+    }
+    return unlink(path) == 0 ? 0 : -1;
+}
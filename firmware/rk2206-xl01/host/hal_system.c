@@ -0,0 +1,111 @@
+/*
+ * Host HAL - System
+ * SYS_RUN entries, process-level reset and the watchdog. A reset re-executes
+ * the binary with its original arguments; the flash image and KV directory
+ * persist across it like the board's flash does.
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "iot_watchdog.h"
+#include "los_task.h"
+
+#define HOST_WATCHDOG_POLL_MS 100U
+
+static HostEntryFunc g_entries[HOST_HAL_MAX_ENTRIES];
+static unsigned int g_entry_count = 0U;
+static char **g_argv = NULL;
+
+static pthread_mutex_t g_watchdog_lock = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int g_watchdog_timeout_ms = 0U;     // 0 = disabled
+static uint64_t g_watchdog_kick_ms = 0U;
+static unsigned char g_watchdog_thread_started = 0U;
+
+static uint64_t NowMs(void)
+{
+    return LOS_TickCountGet() * 1000U / LOSCFG_BASE_CORE_TICK_PER_SECOND;
+}
+
+void HostHal_RegisterEntry(HostEntryFunc entry)
+{
+    if (entry != NULL && g_entry_count < HOST_HAL_MAX_ENTRIES) {
+        g_entries[g_entry_count++] = entry;
+    }
+}
+
+int HostHal_Start(int argc, char **argv)
+{
+    unsigned int i;
+
+    (void)argc;
+    g_argv = argv;
+    for (i = 0U; i < g_entry_count; ++i) {
+        g_entries[i]();
+    }
+    return (int)g_entry_count;
+}
+
+void HostHal_Reset(const char *reason)
+{
+    printf("[HOST] reset: %s\n", reason != NULL ? reason : "unknown");
+    fflush(stdout);
+    if (g_argv != NULL) {
+        execv("/proc/self/exe", g_argv);
+        perror("[HOST] execv");
+    }
+    _exit(3);
+}
+
+// ==================== Watchdog ====================
+
+static void *WatchdogThread(void *arg)
+{
+    (void)arg;
+
+    for (;;) {
+        unsigned int timeout_ms;
+        uint64_t kick_ms;
+
+        LOS_Msleep(HOST_WATCHDOG_POLL_MS);
+        pthread_mutex_lock(&g_watchdog_lock);
+        timeout_ms = g_watchdog_timeout_ms;
+        kick_ms = g_watchdog_kick_ms;
+        pthread_mutex_unlock(&g_watchdog_lock);
+
+        if (timeout_ms != 0U && NowMs() - kick_ms >= timeout_ms) {
+            HostHal_Reset("watchdog expired");
+        }
+    }
+    return NULL;
+}
+
+unsigned int IoTWatchDogEnable(unsigned int timeout)
+{
+    pthread_t thread;
+
+    pthread_mutex_lock(&g_watchdog_lock);
+    g_watchdog_timeout_ms = (timeout > 0U ? timeout : 1U) * 1000U;
+    g_watchdog_kick_ms = NowMs();
+    if (!g_watchdog_thread_started && pthread_create(&thread, NULL, WatchdogThread, NULL) == 0) {
+        pthread_detach(thread);
+        g_watchdog_thread_started = 1U;
+    }
+    pthread_mutex_unlock(&g_watchdog_lock);
+    return 0U;
+}
+
+void IoTWatchDogKick(void)
+{
+    pthread_mutex_lock(&g_watchdog_lock);
+    g_watchdog_kick_ms = NowMs();
+    pthread_mutex_unlock(&g_watchdog_lock);
+}
+
+void IoTWatchDogDisable(void)
+{
+    pthread_mutex_lock(&g_watchdog_lock);
+    g_watchdog_timeout_ms = 0U;
+    pthread_mutex_unlock(&g_watchdog_lock);
+}
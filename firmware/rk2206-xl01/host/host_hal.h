@@ -0,0 +1,77 @@
+/*
+ * Host HAL
+ * Controls for the POSIX stand-ins behind host/include: entry registration,
+ * UART endpoints, simulated I2C devices and GPIO interrupts. Simulators and
+ * harnesses call these; firmware code never does.
+ */
+
+#ifndef HOST_HOST_HAL_H
+#define HOST_HOST_HAL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define HOST_HAL_MAX_ENTRIES     4U
+#define HOST_UART_COUNT          6U      // EUART0_M0 .. EUART2_M1
+#define HOST_I2C_BUS_COUNT       8U      // EI2C0_M0 .. EI2C2_M1
+#define HOST_I2C_MAX_DEVICES     8U
+#define HOST_GPIO_COUNT          64U
+
+typedef void (*HostEntryFunc)(void);
+
+/**
+ * Called from SYS_RUN's constructor; entries run in registration order.
+ */
+void HostHal_RegisterEntry(HostEntryFunc entry);
+
+/**
+ * Remember argv for watchdog resets, then run the registered entries.
+ * @return number of entries run
+ */
+int HostHal_Start(int argc, char **argv);
+
+/**
+ * Re-execute the process, as a watchdog reset would reboot the board.
+ */
+void HostHal_Reset(const char *reason);
+
+/**
+ * Connect UART id to an in-process socket pair instead of a pty. Call before
+ * the firmware opens the UART.
+ * @return the peer end (bytes written to it are received by the firmware,
+ *         bytes the firmware sends can be read from it), or -1 on error
+ */
+int HostUart_OpenPipe(unsigned int id);
+
+/**
+ * Path of the pty slave behind UART id, or NULL if it is not a pty or not open
+ */
+const char *HostUart_PtyName(unsigned int id);
+
+typedef struct {
+    // One I2C write transfer (register pointer plus any data); 0 = ACK
+    int (*write)(void *ctx, const uint8_t *data, uint32_t len);
+    // One I2C read transfer; 0 = ACK
+    int (*read)(void *ctx, uint8_t *data, uint32_t len);
+} HostI2cDevice;
+
+/**
+ * Put a simulated device on bus (EI2C*) at the 7-bit address. Its callbacks
+ * run on the firmware thread doing the transfer.
+ * @return 0 on success, -1 if the bus is full or the address taken
+ */
+int HostI2c_Attach(unsigned int bus, unsigned short addr, const HostI2cDevice *device, void *ctx);
+
+/**
+ * Fire the interrupt registered on gpio, if any, on the calling thread.
+ */
+void HostGpio_Trigger(unsigned int gpio);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_HOST_HAL_H
@@ -0,0 +1,39 @@
+/*
+ * Host Entry
+ * Runs the firmware's SYS_RUN entry as a Linux process.
+ *
+ * Usage: landslide_host [run_seconds]
+ * Without run_seconds the process runs until killed. UART endpoints are
+ * printed as they open; see host/README.md. LANDSLIDE_HOST_DEVICE_ID and
+ * LANDSLIDE_HOST_INSTALL_LABEL replace the compiled-in identity, so one
+ * binary can play several nodes.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "app/device_identity.h"
+
+int main(int argc, char **argv)
+{
+    unsigned long run_s = argc > 1 ? strtoul(argv[1], NULL, 10) : 0UL;
+
+    // Firmware logs are read live through pipes; do not hold them in a block buffer.
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    DeviceIdentity_SetHostOverride(getenv("LANDSLIDE_HOST_DEVICE_ID"), getenv("LANDSLIDE_HOST_INSTALL_LABEL"));
+
+    if (HostHal_Start(argc, argv) == 0) {
+        printf("[HOST] no SYS_RUN entry linked\n");
+        return 1;
+    }
+
+    if (run_s == 0UL) {
+        for (;;) {
+            pause();
+        }
+    }
+    sleep((unsigned int)run_s);
+    printf("[HOST] run time elapsed (%lus)\n", run_s);
+    return 0;
+}
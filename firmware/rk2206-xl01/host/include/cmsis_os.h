@@ -0,0 +1,10 @@
+/*
+ * CMSIS-RTOS Shim
+ */
+
+#ifndef HOST_SHIM_CMSIS_OS_H
+#define HOST_SHIM_CMSIS_OS_H
+
+#include "cmsis_os2.h"
+
+#endif // HOST_SHIM_CMSIS_OS_H
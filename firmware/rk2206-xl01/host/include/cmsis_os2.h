@@ -0,0 +1,77 @@
+/*
+ * CMSIS-RTOS2 Shim
+ * The subset the firmware uses, on pthreads. Priorities are recorded but not
+ * applied: SCHED_OTHER threads all share the same static priority.
+ */
+
+#ifndef HOST_SHIM_CMSIS_OS2_H
+#define HOST_SHIM_CMSIS_OS2_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "los_task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define osWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    osOK = 0,
+    osError = -1,
+    osErrorTimeout = -2,
+    osErrorResource = -3,
+    osErrorParameter = -4,
+    osErrorNoMemory = -5,
+} osStatus_t;
+
+typedef enum {
+    osPriorityNone = 0,
+    osPriorityIdle = 1,
+    osPriorityLow = 8,
+    osPriorityBelowNormal = 16,
+    osPriorityNormal = 24,
+    osPriorityAboveNormal = 32,
+    osPriorityHigh = 40,
+    osPriorityRealtime = 48,
+    osPriorityISR = 56,
+} osPriority_t;
+
+typedef void (*osThreadFunc_t)(void *argument);
+typedef void *osThreadId_t;
+typedef void *osMutexId_t;
+
+typedef struct {
+    const char *name;
+    uint32_t attr_bits;
+    void *cb_mem;
+    uint32_t cb_size;
+    void *stack_mem;
+    uint32_t stack_size;
+    osPriority_t priority;
+    uint32_t tz_module;
+    uint32_t reserved;
+} osThreadAttr_t;
+
+typedef struct {
+    const char *name;
+    uint32_t attr_bits;
+    void *cb_mem;
+    uint32_t cb_size;
+} osMutexAttr_t;
+
+osThreadId_t osThreadNew(osThreadFunc_t func, void *argument, const osThreadAttr_t *attr);
+osStatus_t osDelay(uint32_t ticks);
+uint32_t osKernelGetTickCount(void);
+
+osMutexId_t osMutexNew(const osMutexAttr_t *attr);
+osStatus_t osMutexAcquire(osMutexId_t mutex_id, uint32_t timeout);
+osStatus_t osMutexRelease(osMutexId_t mutex_id);
+osStatus_t osMutexDelete(osMutexId_t mutex_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_CMSIS_OS2_H
@@ -0,0 +1,11 @@
+/*
+ * IoT Peripheral Error Codes Shim
+ */
+
+#ifndef HOST_SHIM_IOT_ERRNO_H
+#define HOST_SHIM_IOT_ERRNO_H
+
+#define IOT_SUCCESS 0
+#define IOT_FAILURE (-1)
+
+#endif // HOST_SHIM_IOT_ERRNO_H
@@ -0,0 +1,25 @@
+/*
+ * IoT Flash Shim
+ * NOR semantics (erase to 0xFF, programming only clears bits) over an image
+ * file, LANDSLIDE_HOST_FLASH or landslide_flash.img, that survives resets.
+ */
+
+#ifndef HOST_SHIM_IOT_FLASH_H
+#define HOST_SHIM_IOT_FLASH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned int IoTFlashInit(void);
+unsigned int IoTFlashDeinit(void);
+unsigned int IoTFlashRead(unsigned int flashOffset, unsigned int size, unsigned char *ramData);
+unsigned int IoTFlashWrite(unsigned int flashOffset, unsigned int size, const unsigned char *ramData,
+                           unsigned char doErase);
+unsigned int IoTFlashErase(unsigned int flashOffset, unsigned int size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_IOT_FLASH_H
@@ -0,0 +1,31 @@
+/*
+ * IoT I2C Shim
+ * Transfers go to devices registered with HostI2c_Attach; an address with no
+ * device NACKs (IOT_FAILURE), like an empty bus.
+ */
+
+#ifndef HOST_SHIM_IOT_I2C_H
+#define HOST_SHIM_IOT_I2C_H
+
+#include "lz_hardware.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+unsigned int IoTI2cInit(unsigned int id, unsigned int baudrate);
+unsigned int IoTI2cDeinit(unsigned int id);
+unsigned int IoTI2cWrite(unsigned int id, unsigned short deviceAddr, const unsigned char *data, unsigned int dataLen);
+unsigned int IoTI2cRead(unsigned int id, unsigned short deviceAddr, unsigned char *data, unsigned int dataLen);
+
+/**
+ * Addresses that acknowledge on the bus
+ * @return number found (may exceed slaveAddrLen; only that many are stored)
+ */
+unsigned int IoTI2cScan(unsigned int id, unsigned short *slaveAddr, unsigned int slaveAddrLen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_IOT_I2C_H
@@ -0,0 +1,67 @@
+/*
+ * IoT UART Shim
+ * Each UART id is a file descriptor: a pseudo-terminal by default, an
+ * in-process socket pair (HostUart_OpenPipe), or a path from
+ * LANDSLIDE_HOST_UART<id>. Baud rate and framing are not applied.
+ */
+
+#ifndef HOST_SHIM_IOT_UART_H
+#define HOST_SHIM_IOT_UART_H
+
+#include "lz_hardware.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    IOT_UART_DATA_BIT_5 = 5,
+    IOT_UART_DATA_BIT_6,
+    IOT_UART_DATA_BIT_7,
+    IOT_UART_DATA_BIT_8,
+} IotUartIdxDataBit;
+
+typedef enum {
+    IOT_UART_STOP_BIT_1 = 1,
+    IOT_UART_STOP_BIT_2,
+} IotUartStopBit;
+
+typedef enum {
+    IOT_UART_PARITY_NONE = 0,
+    IOT_UART_PARITY_ODD,
+    IOT_UART_PARITY_EVEN,
+} IotUartParity;
+
+typedef enum {
+    IOT_UART_BLOCK_STATE_BLOCK = 0,
+    IOT_UART_BLOCK_STATE_NONE_BLOCK,
+} IotUartBlockState;
+
+typedef enum {
+    IOT_FLOW_CTRL_NONE = 0,
+    IOT_FLOW_CTRL_RTS_CTS,
+    IOT_FLOW_CTRL_RTS_ONLY,
+    IOT_FLOW_CTRL_CTS_ONLY,
+} IotFlowCtrl;
+
+typedef struct {
+    unsigned int baudRate;
+    unsigned char dataBits;
+    unsigned char stopBits;
+    unsigned char parity;
+    unsigned char rxBlock;
+    unsigned char txBlock;
+    unsigned char pad;
+} IotUartAttribute;
+
+unsigned int IoTUartInit(unsigned int id, const IotUartAttribute *param);
+int IoTUartRead(unsigned int id, unsigned char *data, unsigned int dataLen);
+int IoTUartWrite(unsigned int id, const unsigned char *data, unsigned int dataLen);
+unsigned int IoTUartDeinit(unsigned int id);
+unsigned int IoTUartSetFlowCtrl(unsigned int id, IotFlowCtrl flowCtrl);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_IOT_UART_H
@@ -0,0 +1,25 @@
+/*
+ * IoT Watchdog Shim
+ * An expired watchdog re-executes the process, so watchdog-driven reboots
+ * (link recovery, reboot commands) behave as on the board.
+ */
+
+#ifndef HOST_SHIM_IOT_WATCHDOG_H
+#define HOST_SHIM_IOT_WATCHDOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @param timeout Seconds without a kick before reset
+ */
+unsigned int IoTWatchDogEnable(unsigned int timeout);
+void IoTWatchDogKick(void);
+void IoTWatchDogDisable(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_IOT_WATCHDOG_H
@@ -0,0 +1,24 @@
+/*
+ * Utils KV Store Shim
+ * One file per key under LANDSLIDE_HOST_KV_DIR (default landslide_kv/).
+ */
+
+#ifndef HOST_SHIM_KV_STORE_H
+#define HOST_SHIM_KV_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @return value length, or negative if the key is missing
+ */
+int UtilsGetValue(const char *key, char *value, unsigned int len);
+int UtilsSetValue(const char *key, const char *value);
+int UtilsDeleteValue(const char *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_KV_STORE_H
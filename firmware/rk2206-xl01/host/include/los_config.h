@@ -0,0 +1,12 @@
+/*
+ * LiteOS-M Kernel Configuration Shim
+ */
+
+#ifndef HOST_SHIM_LOS_CONFIG_H
+#define HOST_SHIM_LOS_CONFIG_H
+
+#define LOSCFG_BASE_CORE_TICK_PER_SECOND 1000UL
+#define LOSCFG_BASE_CORE_TSK_LIMIT       31U     // Task ids 0..31, as the kernel's table plus idle
+#define LOSCFG_BASE_CORE_CPUP            1
+
+#endif // HOST_SHIM_LOS_CONFIG_H
@@ -0,0 +1,33 @@
+/*
+ * LiteOS-M CPUP Shim
+ * Per-task CPU share from each thread's CPU-time clock
+ */
+
+#ifndef HOST_SHIM_LOS_CPUP_H
+#define HOST_SHIM_LOS_CPUP_H
+
+#include "los_typedef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CPUP_LAST_TEN_SECONDS   0U
+#define CPUP_LAST_ONE_SECONDS   1U
+#define CPUP_ALL_TIME           0xFFFFU
+
+#define LOS_ERRNO_CPUP_TSK_ID_INVALID 0x02001E05U
+
+/**
+ * Per mille of one CPU used by the task. CPUP_ALL_TIME covers the task's
+ * life; the windowed modes cover the time since the previous windowed call
+ * for that task, not a fixed window.
+ * @return 0..1000, or LOS_ERRNO_CPUP_TSK_ID_INVALID for an unknown task
+ */
+UINT32 LOS_HistoryTaskCpuUsage(UINT32 taskID, UINT16 mode);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_LOS_CPUP_H
@@ -0,0 +1,26 @@
+/*
+ * LiteOS-M Memory Shim
+ */
+
+#ifndef HOST_SHIM_LOS_MEMORY_H
+#define HOST_SHIM_LOS_MEMORY_H
+
+#include <stdlib.h>
+#include "los_typedef.h"
+
+#define OS_SYS_MEM_ADDR NULL
+
+static inline VOID *LOS_MemAlloc(VOID *pool, UINT32 size)
+{
+    (void)pool;
+    return malloc(size);
+}
+
+static inline UINT32 LOS_MemFree(VOID *pool, VOID *ptr)
+{
+    (void)pool;
+    free(ptr);
+    return LOS_OK;
+}
+
+#endif // HOST_SHIM_LOS_MEMORY_H
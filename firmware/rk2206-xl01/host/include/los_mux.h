@@ -0,0 +1,28 @@
+/*
+ * LiteOS-M Mutex Shim
+ * Recursive pthread mutexes, like LOS mutexes, addressed by handle
+ */
+
+#ifndef HOST_SHIM_LOS_MUX_H
+#define HOST_SHIM_LOS_MUX_H
+
+#include "los_typedef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOS_ERRNO_MUX_INVALID   0x02001d01U
+#define LOS_ERRNO_MUX_ALL_BUSY  0x02001d03U
+#define LOS_ERRNO_MUX_TIMEOUT   0x02001d06U
+
+UINT32 LOS_MuxCreate(UINT32 *muxHandle);
+UINT32 LOS_MuxDelete(UINT32 muxHandle);
+UINT32 LOS_MuxPend(UINT32 muxHandle, UINT32 timeout);
+UINT32 LOS_MuxPost(UINT32 muxHandle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_LOS_MUX_H
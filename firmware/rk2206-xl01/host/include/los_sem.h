@@ -0,0 +1,33 @@
+/*
+ * LiteOS-M Semaphore Shim
+ */
+
+#ifndef HOST_SHIM_LOS_SEM_H
+#define HOST_SHIM_LOS_SEM_H
+
+#include "los_typedef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LOS_ERRNO_SEM_INVALID   0x02000e01U
+#define LOS_ERRNO_SEM_ALL_BUSY  0x02000e03U
+#define LOS_ERRNO_SEM_TIMEOUT   0x02000e07U
+
+UINT32 LOS_SemCreate(UINT16 count, UINT32 *semHandle);
+
+/**
+ * Count never exceeds 1; a post to a full semaphore is dropped
+ */
+UINT32 LOS_BinarySemCreate(UINT16 count, UINT32 *semHandle);
+
+UINT32 LOS_SemDelete(UINT32 semHandle);
+UINT32 LOS_SemPend(UINT32 semHandle, UINT32 timeout);
+UINT32 LOS_SemPost(UINT32 semHandle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_LOS_SEM_H
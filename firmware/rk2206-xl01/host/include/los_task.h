@@ -0,0 +1,70 @@
+/*
+ * LiteOS-M Task Shim
+ * Host (POSIX) stand-in for los_task.h: tasks are detached pthreads on
+ * painted stacks
+ */
+
+#ifndef HOST_SHIM_LOS_TASK_H
+#define HOST_SHIM_LOS_TASK_H
+
+#include "los_typedef.h"
+#include "los_config.h"
+// The LiteOS-M los_task.h reaches these through its own includes; firmware relies on that.
+#include "los_mux.h"
+#include "los_sem.h"
+#include "los_tick.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef VOID *(*TSK_ENTRY_FUNC)(UINT32 arg);
+
+typedef struct {
+    TSK_ENTRY_FUNC pfnTaskEntry;
+    UINT16 usTaskPrio;          // Only reported back; the Linux scheduler decides
+    UINT32 uwArg;
+    UINT32 uwStackSize;         // Ignored; every task gets HOST_TASK_STACK_BYTES
+    CHAR *pcName;
+    UINT32 uwResved;
+} TSK_INIT_PARAM_S;
+
+#define LOS_TASK_NAMELEN 32
+
+// The LiteOS-M fields the firmware reads; the rest of the kernel's struct is left out.
+typedef struct {
+    CHAR acName[LOS_TASK_NAMELEN];
+    UINT32 uwTaskID;
+    UINT16 usTaskStatus;
+    UINT16 usTaskPrio;          // As passed at creation (CMSIS priority for osThreadNew)
+    UINT32 uwStackSize;         // The host stack actually allocated, not the requested size
+    UINT32 uwCurrUsed;          // Not tracked on the host, always 0
+    UINT32 uwPeakUsed;          // From the fill pattern, as the kernel measures it
+    BOOL bOvf;
+} TSK_INFO_S;
+
+typedef VOID (*TSKSWITCHHOOK)(VOID);
+
+/**
+ * Called on the outgoing task's thread each time it blocks in LOS_Msleep or
+ * waits on a semaphore or mutex; preemption by the Linux scheduler is not seen.
+ */
+extern TSKSWITCHHOOK g_pfnUsrTskSwitchHook;
+
+UINT32 LOS_TaskCreate(UINT32 *taskID, TSK_INIT_PARAM_S *initParam);
+UINT32 LOS_TaskInfoGet(UINT32 taskID, TSK_INFO_S *taskInfo);
+
+/**
+ * Id of the calling task, or LOSCFG_BASE_CORE_TSK_LIMIT + 1 on a thread the
+ * kernel shim did not start
+ */
+UINT32 LOS_CurTaskIDGet(VOID);
+UINT32 LOS_TaskDelete(UINT32 taskID);
+UINT32 LOS_TaskDelay(UINT32 tick);
+VOID LOS_Msleep(UINT32 mSecs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_LOS_TASK_H
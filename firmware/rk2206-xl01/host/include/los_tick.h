@@ -0,0 +1,27 @@
+/*
+ * LiteOS-M Tick Shim
+ * Ticks run at LOSCFG_BASE_CORE_TICK_PER_SECOND from CLOCK_MONOTONIC
+ */
+
+#ifndef HOST_SHIM_LOS_TICK_H
+#define HOST_SHIM_LOS_TICK_H
+
+#include "los_typedef.h"
+#include "los_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Ticks since the process started
+ */
+UINT64 LOS_TickCountGet(VOID);
+
+UINT32 LOS_MS2Tick(UINT32 millisec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_LOS_TICK_H
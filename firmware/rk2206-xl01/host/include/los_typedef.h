@@ -0,0 +1,25 @@
+/*
+ * LiteOS-M Base Types Shim
+ */
+
+#ifndef HOST_SHIM_LOS_TYPEDEF_H
+#define HOST_SHIM_LOS_TYPEDEF_H
+
+#include <stdint.h>
+
+typedef uint8_t UINT8;
+typedef uint16_t UINT16;
+typedef uint32_t UINT32;
+typedef uint64_t UINT64;
+typedef int32_t INT32;
+typedef uintptr_t UINTPTR;
+typedef char CHAR;
+typedef void VOID;
+typedef unsigned int BOOL;
+
+#define LOS_OK              0U
+#define LOS_NOK             1U
+#define LOS_WAIT_FOREVER    0xFFFFFFFFU
+#define LOS_NO_WAIT         0U
+
+#endif // HOST_SHIM_LOS_TYPEDEF_H
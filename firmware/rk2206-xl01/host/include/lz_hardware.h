@@ -0,0 +1,45 @@
+/*
+ * RK2206 (Lockzhiner) Hardware Shim
+ * Bus route identifiers as preprocessor constants, so the firmware's
+ * "#if XL01_UART_ID == ..." route selection resolves on the host too.
+ */
+
+#ifndef HOST_SHIM_LZ_HARDWARE_H
+#define HOST_SHIM_LZ_HARDWARE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EUART0_M0       0U
+#define EUART0_M1       1U
+#define EUART1_M0       2U
+#define EUART1_M1       3U
+#define EUART2_M0       4U
+#define EUART2_M1       5U
+#define EUART_MAX       6U
+
+#define EI2C0_M0        0U
+#define EI2C0_M1        1U
+#define EI2C0_M2        2U
+#define EI2C1_M0        3U
+#define EI2C1_M1        4U
+#define EI2C1_M2        5U
+#define EI2C2_M0        6U
+#define EI2C2_M1        7U
+#define EI2C_MAX        8U
+
+#define EI2C_FRE_100K   0U
+#define EI2C_FRE_400K   1U
+#define EI2C_FRE_1000K  2U
+
+/**
+ * Bytes waiting in the UART receive path
+ */
+unsigned int LzUartReadAny(unsigned int id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SHIM_LZ_HARDWARE_H
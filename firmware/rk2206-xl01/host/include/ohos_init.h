@@ -0,0 +1,22 @@
+/*
+ * OpenHarmony Init Shim
+ * SYS_RUN and friends register the entry with the host HAL, which runs it
+ * from main() the way the board's system init task would.
+ */
+
+#ifndef HOST_SHIM_OHOS_INIT_H
+#define HOST_SHIM_OHOS_INIT_H
+
+#include "../host_hal.h"
+
+#define HOST_INIT_ENTRY(func) \
+    static void __attribute__((constructor)) HostRegister_##func(void) \
+    { \
+        HostHal_RegisterEntry(func); \
+    }
+
+#define SYS_RUN(func)           HOST_INIT_ENTRY(func)
+#define APP_FEATURE_INIT(func)  HOST_INIT_ENTRY(func)
+#define SYS_SERVICE_INIT(func)  HOST_INIT_ENTRY(func)
+
+#endif // HOST_SHIM_OHOS_INIT_H
@@ -0,0 +1,1001 @@
+/*
+ * Field Network Simulator
+ * Runs N landslide_host processes as field nodes on one simulated XL01 radio
+ * channel and polls them the way field-gateway's southbound poller does, to
+ * measure how poll-cycle time, command round trip, collisions and airtime
+ * scale with the node count.
+ *
+ * Usage: field_net_sim [--nodes 3,5,10,20,50] [--cycles N] [--air-bps N]
+ *                      [--loss P] [--lbt] [--time-scale K] [--seed N] ...
+ *                      (--help lists every option)
+ *
+ * Channel model: each node's XL01 UART is a socket to this process. Bytes a
+ * radio receives from its UART are sent as one air packet once the UART has
+ * been idle for --packet-gap-ms or --max-packet bytes are waiting; a packet
+ * occupies the channel for (len + --air-overhead-bytes) * 8 / --air-bps.
+ * There is one collision domain: packets that overlap in time are lost at
+ * every receiver, and a radio never hears while it sends. Packets that survive
+ * are dropped per receiver with probability --loss. Without --lbt radios send
+ * blindly (the transparent-mode default); with it they defer while they hear
+ * a packet that started more than --cca-ms ago, plus a random backoff.
+ *
+ * Poller: round robin over the nodes; wait for --prewrite-quiet-ms of silence
+ * (at most --prewrite-max-wait-ms), send poll_latest_telemetry, wait up to
+ * --ack-timeout-ms for the ACK, then up to --session-timeout-ms for that
+ * node's telemetry, and start the next poll on the next --poll-interval-ms
+ * tick. Defaults are field-gateway's.
+ *
+ * Each node also gets a 1 Hz GGA/RMC fix on its GPS UART, a few metres apart,
+ * so every poll has real metrics to report and the nodes run their normal
+ * sample and envelope path.
+ *
+ * Output is JSON lines: one "meta" record, then one record per node count.
+ * Times are firmware milliseconds: with --time-scale K the nodes run K times
+ * faster than the wall clock and so does the channel. Node logs go to
+ * <work-dir>/n<N>/node-XX/node.log.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "drivers/xl01/field_link_frame.h"
+
+#define SIM_MAX_NODES           64U
+#define SIM_GATEWAY             0U      // Radio 0 is the gateway, nodes are 1..N
+#define SIM_MAX_RADIOS          (SIM_MAX_NODES + 1U)
+#define SIM_RADIO_BUFFER_BYTES  8192U
+#define SIM_MAX_PACKET_BYTES    1024U
+#define SIM_MAX_WAIT_MS         100.0   // Longest single sleep, firmware ms
+#define SIM_XL01_UART_ID        5U      // EUART2_M1
+#define SIM_GPS_UART_ID         0U      // EUART0_M0
+#define SIM_GPS_PERIOD_MS       1000.0
+#define SIM_COMMAND_BYTES       512
+
+typedef struct {
+    const char *node_list;
+    const char *host_bin;
+    const char *work_dir;
+    unsigned int cycles;
+    unsigned int air_bps;
+    unsigned int air_overhead_bytes;
+    unsigned int max_packet;
+    double packet_gap_ms;
+    double loss;
+    int lbt;
+    double cca_ms;
+    double lbt_backoff_ms;
+    unsigned int time_scale;
+    unsigned int seed;
+    double boot_ms;
+    double prewrite_quiet_ms;
+    double prewrite_max_wait_ms;
+    double ack_timeout_ms;
+    double session_timeout_ms;
+    double poll_interval_ms;
+} SimOptions;
+
+typedef struct {
+    int fd;                     // Simulator end of the node's XL01 UART; -1 for the gateway
+    int gps_fd;                 // Simulator end of the node's GPS UART
+    pid_t pid;
+    char device_id[40];
+    unsigned char pending[SIM_RADIO_BUFFER_BYTES];
+    unsigned int pending_len;
+    double last_byte_ms;
+    double tx_end_ms;
+    double backoff_until_ms;
+} SimRadio;
+
+typedef struct {
+    unsigned int sender;
+    double start_ms;
+    double end_ms;
+    unsigned char data[SIM_MAX_PACKET_BYTES];
+    unsigned int len;
+    unsigned char collided;
+} SimPacket;
+
+typedef enum {
+    POLL_IDLE = 0,
+    POLL_PREWRITE,
+    POLL_WAIT_ACK,
+    POLL_WAIT_TELEMETRY,
+} PollState;
+
+typedef struct {
+    unsigned long polls;
+    unsigned long acks;
+    unsigned long ack_failed;
+    unsigned long ack_timeouts;
+    unsigned long telemetry;
+    unsigned long telemetry_timeouts;
+    unsigned long unsolicited_telemetry;
+    unsigned long frame_errors;
+    unsigned long packets;
+    unsigned long collided_packets;
+    unsigned long lost_receptions;
+    unsigned long dropped_bytes;
+    unsigned long air_bytes;
+    double busy_ms;
+    double *rtt_ms;
+    double *latency_ms;
+    double *cycle_ms;
+    unsigned long cycles_done;
+} SimStats;
+
+static SimOptions g_opt = {
+    .node_list = "3,5,10,20,50",
+    .host_bin = NULL,
+    .work_dir = "field_net_sim_work",
+    .cycles = 3U,
+    .air_bps = 9600U,
+    .air_overhead_bytes = 12U,
+    .max_packet = 240U,
+    .packet_gap_ms = 5.0,
+    .loss = 0.0,
+    .lbt = 0,
+    .cca_ms = 2.0,
+    .lbt_backoff_ms = 50.0,
+    .time_scale = 1U,
+    .seed = 1U,
+    .boot_ms = 15000.0,
+    .prewrite_quiet_ms = 400.0,
+    .prewrite_max_wait_ms = 4000.0,
+    .ack_timeout_ms = 10000.0,
+    .session_timeout_ms = 6000.0,
+    .poll_interval_ms = 500.0,
+};
+
+static SimRadio g_radios[SIM_MAX_RADIOS];
+static unsigned int g_radio_count = 0U;
+static SimPacket g_air[SIM_MAX_RADIOS];     // At most one packet per radio on air
+static unsigned int g_air_count = 0U;
+static double g_channel_busy_until_ms = 0.0;
+static double g_start_real_ms = 0.0;
+static SimStats g_stats;
+
+static FieldLinkFrameDecoder g_gateway_decoder;
+static FieldLinkFrameMessage g_gateway_message;
+static PollState g_poll_state = POLL_IDLE;
+static unsigned int g_poll_cursor = 0U;     // Node polled last, 1..N
+static unsigned int g_poll_sequence = 0U;
+static char g_poll_command_id[48];
+static double g_poll_started_ms = 0.0;      // Prewrite began
+static double g_poll_sent_ms = 0.0;         // Command handed to the gateway radio
+static double g_poll_deadline_ms = 0.0;
+static double g_next_poll_ms = 0.0;
+static double g_cycle_start_ms = 0.0;
+static double g_next_gps_ms = 0.0;
+static unsigned int g_gps_epoch = 0U;
+
+// ==================== Time ====================
+
+static double RealMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+// Firmware milliseconds since the run started, matching the nodes' LOS ticks
+static double SimNowMs(void)
+{
+    return (RealMs() - g_start_real_ms) * (double)g_opt.time_scale;
+}
+
+static double AirtimeMs(unsigned int len)
+{
+    return (double)(len + g_opt.air_overhead_bytes) * 8000.0 / (double)g_opt.air_bps;
+}
+
+// ==================== Nodes ====================
+
+static int MakeDirs(const char *path)
+{
+    char buffer[512];
+    size_t i;
+
+    snprintf(buffer, sizeof(buffer), "%s", path);
+    for (i = 1U; buffer[i] != '\0'; ++i) {
+        if (buffer[i] == '/') {
+            buffer[i] = '\0';
+            if (mkdir(buffer, 0755) != 0 && errno != EEXIST) {
+                return -1;
+            }
+            buffer[i] = '/';
+        }
+    }
+    return (mkdir(buffer, 0755) != 0 && errno != EEXIST) ? -1 : 0;
+}
+
+static void SetUartEnv(unsigned int uart_id, int fd)
+{
+    char name[32];
+    char value[32];
+
+    snprintf(name, sizeof(name), "LANDSLIDE_HOST_UART%u", uart_id);
+    snprintf(value, sizeof(value), "fd:%d", fd);
+    setenv(name, value, 1);
+}
+
+static void ExecNode(int fd, int gps_fd, const SimRadio *radio, unsigned int node, unsigned int node_count)
+{
+    char dir[512];
+    char value[32];
+    char label[32];
+    int log_fd;
+
+    // Nodes must not outlive the simulator; the flag survives execve.
+    (void)prctl(PR_SET_PDEATHSIG, SIGKILL);
+    snprintf(dir, sizeof(dir), "%s/n%u/node-%02u", g_opt.work_dir, node_count, node);
+    if (MakeDirs(dir) != 0 || chdir(dir) != 0) {
+        _exit(126);
+    }
+    log_fd = open("node.log", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (log_fd >= 0) {
+        (void)dup2(log_fd, STDOUT_FILENO);
+        (void)dup2(log_fd, STDERR_FILENO);
+        close(log_fd);
+    }
+
+    SetUartEnv(SIM_XL01_UART_ID, fd);
+    SetUartEnv(SIM_GPS_UART_ID, gps_fd);
+    snprintf(value, sizeof(value), "%u", g_opt.time_scale);
+    setenv("LANDSLIDE_HOST_TIME_SCALE", value, 1);
+    snprintf(label, sizeof(label), "SIM-NODE-%02u", node);
+    setenv("LANDSLIDE_HOST_DEVICE_ID", radio->device_id, 1);
+    setenv("LANDSLIDE_HOST_INSTALL_LABEL", label, 1);
+    execl(g_opt.host_bin, g_opt.host_bin, (char *)NULL);
+    _exit(127);
+}
+
+static int SpawnNodes(unsigned int node_count)
+{
+    unsigned int i;
+
+    memset(g_radios, 0, sizeof(g_radios));
+    g_radios[SIM_GATEWAY].fd = -1;
+    g_radios[SIM_GATEWAY].gps_fd = -1;
+    g_radio_count = node_count + 1U;
+
+    for (i = 1U; i <= node_count; ++i) {
+        SimRadio *radio = &g_radios[i];
+        int fds[2];
+        int gps[2];
+
+        radio->fd = -1;
+        radio->gps_fd = -1;
+        snprintf(radio->device_id, sizeof(radio->device_id), "00000000-0000-4000-8000-%012x", i);
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            return -1;
+        }
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, gps) != 0) {
+            close(fds[0]);
+            close(fds[1]);
+            return -1;
+        }
+        radio->pid = fork();
+        if (radio->pid < 0) {
+            return -1;
+        }
+        if (radio->pid == 0) {
+            close(fds[0]);
+            close(gps[0]);
+            ExecNode(fds[1], gps[1], radio, i, node_count);
+        }
+        close(fds[1]);
+        close(gps[1]);
+        radio->fd = fds[0];
+        radio->gps_fd = gps[0];
+        (void)fcntl(radio->fd, F_SETFL, fcntl(radio->fd, F_GETFL, 0) | O_NONBLOCK);
+        (void)fcntl(radio->gps_fd, F_SETFL, fcntl(radio->gps_fd, F_GETFL, 0) | O_NONBLOCK);
+    }
+    return 0;
+}
+
+static void StopNodes(void)
+{
+    unsigned int i;
+
+    for (i = 1U; i < g_radio_count; ++i) {
+        if (g_radios[i].pid > 0) {
+            kill(g_radios[i].pid, SIGKILL);
+            (void)waitpid(g_radios[i].pid, NULL, 0);
+        }
+        if (g_radios[i].fd >= 0) {
+            close(g_radios[i].fd);
+        }
+        if (g_radios[i].gps_fd >= 0) {
+            close(g_radios[i].gps_fd);
+        }
+    }
+}
+
+static int AppendNmea(char *out, int size, int len, const char *body)
+{
+    unsigned char checksum = 0U;
+    const char *p;
+    int written;
+
+    for (p = body; *p != '\0'; ++p) {
+        checksum ^= (unsigned char)*p;
+    }
+    written = snprintf(out + len, (size_t)(size - len), "$%s*%02X\r\n", body, checksum);
+    return (written > 0 && written < size - len) ? len + written : len;
+}
+
+// One GGA/RMC epoch per node; node i sits i * 10^-5 min north of the first
+static void FeedGps(void)
+{
+    unsigned int seconds = 8U * 3600U + 30U * 60U + g_gps_epoch++;
+    unsigned int i;
+
+    for (i = 1U; i < g_radio_count; ++i) {
+        char body[128];
+        char nmea[320];
+        char clock[16];
+        char lat[24];
+        int len = 0;
+
+        snprintf(clock, sizeof(clock), "%02u%02u%02u.00",
+                 (seconds / 3600U) % 24U, (seconds / 60U) % 60U, seconds % 60U);
+        snprintf(lat, sizeof(lat), "2232.%07u", 1234567U + i * 1000U);
+        snprintf(body, sizeof(body), "GNGGA,%s,%s,N,11356.7654321,E,1,12,0.8,45.3,M,-3.2,M,,", clock, lat);
+        len = AppendNmea(nmea, (int)sizeof(nmea), len, body);
+        snprintf(body, sizeof(body), "GNRMC,%s,A,%s,N,11356.7654321,E,0.02,,190726,,,A", clock, lat);
+        len = AppendNmea(nmea, (int)sizeof(nmea), len, body);
+        (void)write(g_radios[i].gps_fd, nmea, (size_t)len);
+    }
+}
+
+// ==================== Channel ====================
+
+static void QueueBytes(unsigned int radio_id, const unsigned char *data, unsigned int len, double now)
+{
+    SimRadio *radio = &g_radios[radio_id];
+    unsigned int room = SIM_RADIO_BUFFER_BYTES - radio->pending_len;
+
+    if (len > room) {
+        g_stats.dropped_bytes += len - room;
+        len = room;
+    }
+    memcpy(&radio->pending[radio->pending_len], data, len);
+    radio->pending_len += len;
+    radio->last_byte_ms = now;
+}
+
+static void HandleGatewayFrame(const FieldLinkFrameMessage *message, double now);
+
+static void Deliver(const SimPacket *packet, unsigned int receiver, double now)
+{
+    unsigned int i;
+
+    if (g_opt.loss > 0.0 && drand48() < g_opt.loss) {
+        g_stats.lost_receptions++;
+        return;
+    }
+    if (receiver == SIM_GATEWAY) {
+        for (i = 0U; i < packet->len; ++i) {
+            int ret = FieldLinkFrameDecoder_FeedByte(&g_gateway_decoder, packet->data[i], &g_gateway_message);
+
+            if (ret > 0) {
+                HandleGatewayFrame(&g_gateway_message, now);
+            } else if (ret < 0) {
+                g_stats.frame_errors++;
+            }
+        }
+        return;
+    }
+    if (write(g_radios[receiver].fd, packet->data, packet->len) != (ssize_t)packet->len) {
+        g_stats.dropped_bytes += packet->len;
+    }
+}
+
+static void FinishPackets(double now)
+{
+    unsigned int i = 0U;
+
+    while (i < g_air_count) {
+        SimPacket *packet = &g_air[i];
+        unsigned int r;
+
+        if (packet->end_ms > now) {
+            ++i;
+            continue;
+        }
+        if (packet->collided) {
+            g_stats.collided_packets++;
+        } else {
+            for (r = 0U; r < g_radio_count; ++r) {
+                if (r != packet->sender) {
+                    Deliver(packet, r, now);
+                }
+            }
+        }
+        g_air[i] = g_air[--g_air_count];
+    }
+}
+
+// True if the radio can hear a packet on air long enough to have detected it
+static int CarrierSensed(double now)
+{
+    unsigned int i;
+
+    for (i = 0U; i < g_air_count; ++i) {
+        if (g_air[i].start_ms + g_opt.cca_ms <= now) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void StartPacket(unsigned int radio_id, double now)
+{
+    SimRadio *radio = &g_radios[radio_id];
+    SimPacket *packet = &g_air[g_air_count++];
+    unsigned int len = radio->pending_len < g_opt.max_packet ? radio->pending_len : g_opt.max_packet;
+    unsigned int i;
+
+    packet->sender = radio_id;
+    packet->start_ms = now;
+    packet->end_ms = now + AirtimeMs(len);
+    packet->len = len;
+    packet->collided = 0U;
+    memcpy(packet->data, radio->pending, len);
+    memmove(radio->pending, &radio->pending[len], radio->pending_len - len);
+    radio->pending_len -= len;
+    radio->tx_end_ms = packet->end_ms;
+
+    for (i = 0U; i + 1U < g_air_count; ++i) {
+        g_air[i].collided = 1U;
+        packet->collided = 1U;
+    }
+
+    g_stats.packets++;
+    g_stats.air_bytes += len;
+    g_stats.busy_ms += packet->end_ms - (now > g_channel_busy_until_ms ? now : g_channel_busy_until_ms);
+    if (packet->end_ms > g_channel_busy_until_ms) {
+        g_channel_busy_until_ms = packet->end_ms;
+    }
+}
+
+static void ServiceRadios(double now)
+{
+    unsigned int r;
+
+    FinishPackets(now);
+    for (r = 0U; r < g_radio_count; ++r) {
+        SimRadio *radio = &g_radios[r];
+
+        if (radio->pending_len == 0U || radio->tx_end_ms > now || radio->backoff_until_ms > now) {
+            continue;
+        }
+        if (radio->pending_len < g_opt.max_packet && now - radio->last_byte_ms < g_opt.packet_gap_ms) {
+            continue;
+        }
+        if (g_opt.lbt && CarrierSensed(now)) {
+            radio->backoff_until_ms = g_channel_busy_until_ms + drand48() * g_opt.lbt_backoff_ms;
+            continue;
+        }
+        StartPacket(r, now);
+    }
+}
+
+// Earliest time a packet ends or a queued radio may start
+static double NextChannelEventMs(double now)
+{
+    double next = now + SIM_MAX_WAIT_MS;
+    unsigned int i;
+
+    for (i = 0U; i < g_air_count; ++i) {
+        if (g_air[i].end_ms < next) {
+            next = g_air[i].end_ms;
+        }
+    }
+    for (i = 0U; i < g_radio_count; ++i) {
+        const SimRadio *radio = &g_radios[i];
+        double ready;
+
+        if (radio->pending_len == 0U) {
+            continue;
+        }
+        ready = radio->last_byte_ms + g_opt.packet_gap_ms;
+        if (radio->tx_end_ms > ready) {
+            ready = radio->tx_end_ms;
+        }
+        if (radio->backoff_until_ms > ready) {
+            ready = radio->backoff_until_ms;
+        }
+        if (ready < next) {
+            next = ready;
+        }
+    }
+    return next;
+}
+
+// ==================== Gateway Poller ====================
+
+// Copy the string value of "key" out of a flat JSON payload
+static int JsonString(const char *json, const char *key, char *out, size_t out_size)
+{
+    char pattern[40];
+    const char *start;
+    const char *end;
+
+    snprintf(pattern, sizeof(pattern), "\"%s\":\"", key);
+    start = strstr(json, pattern);
+    if (start == NULL) {
+        return -1;
+    }
+    start += strlen(pattern);
+    end = strchr(start, '"');
+    if (end == NULL || (size_t)(end - start) >= out_size) {
+        return -1;
+    }
+    memcpy(out, start, (size_t)(end - start));
+    out[end - start] = '\0';
+    return 0;
+}
+
+static void ClosePoll(double now)
+{
+    g_poll_state = POLL_IDLE;
+    // field-gateway picks the next node on its next scheduler tick
+    g_next_poll_ms = (double)((unsigned long)(now / g_opt.poll_interval_ms) + 1UL) * g_opt.poll_interval_ms;
+    if (g_poll_cursor == g_radio_count - 1U) {
+        g_stats.cycle_ms[g_stats.cycles_done++] = now - g_cycle_start_ms;
+    }
+}
+
+static void SendPoll(double now)
+{
+    char payload[SIM_COMMAND_BYTES];
+    unsigned char frame[FIELD_LINK_FRAME_ENCODED_BYTES];
+    int payload_len;
+    int frame_len;
+
+    snprintf(g_poll_command_id, sizeof(g_poll_command_id), "5e1f0000-0000-4000-8000-%012x", ++g_poll_sequence);
+    payload_len = snprintf(
+        payload,
+        sizeof(payload),
+        "{\"schema_version\":1,\"command_id\":\"%s\",\"device_id\":\"%s\","
+        "\"command_type\":\"poll_latest_telemetry\","
+        "\"payload\":{\"source\":\"field-net-sim\",\"scheduler\":true},"
+        "\"issued_ts\":\"2026-01-01T00:00:00.000Z\"}",
+        g_poll_command_id,
+        g_radios[g_poll_cursor].device_id
+    );
+    frame_len = FieldLinkFrame_Encode(
+        FIELD_LINK_FRAME_TYPE_COMMAND,
+        g_poll_sequence,
+        payload,
+        payload_len,
+        frame,
+        (int)sizeof(frame)
+    );
+    if (frame_len > 0) {
+        QueueBytes(SIM_GATEWAY, frame, (unsigned int)frame_len, now);
+    }
+    g_stats.polls++;
+    g_poll_sent_ms = now;
+    g_poll_deadline_ms = now + g_opt.ack_timeout_ms;
+    g_poll_state = POLL_WAIT_ACK;
+}
+
+static void HandleGatewayFrame(const FieldLinkFrameMessage *message, double now)
+{
+    char value[64];
+
+    if (message->type == FIELD_LINK_FRAME_TYPE_ACK) {
+        if (g_poll_state != POLL_WAIT_ACK ||
+            JsonString(message->payload, "command_id", value, sizeof(value)) != 0 ||
+            strcmp(value, g_poll_command_id) != 0) {
+            return;
+        }
+        g_stats.rtt_ms[g_stats.acks + g_stats.ack_failed] = now - g_poll_sent_ms;
+        if (JsonString(message->payload, "status", value, sizeof(value)) == 0 && strcmp(value, "acked") == 0) {
+            g_stats.acks++;
+            g_poll_state = POLL_WAIT_TELEMETRY;
+            g_poll_deadline_ms = now + g_opt.session_timeout_ms;
+        } else {
+            g_stats.ack_failed++;
+            ClosePoll(now);
+        }
+        return;
+    }
+
+    if (message->type == FIELD_LINK_FRAME_TYPE_TELEMETRY) {
+        if (g_poll_state == POLL_WAIT_TELEMETRY &&
+            JsonString(message->payload, "device_id", value, sizeof(value)) == 0 &&
+            strcmp(value, g_radios[g_poll_cursor].device_id) == 0) {
+            g_stats.latency_ms[g_stats.telemetry++] = now - g_poll_sent_ms;
+            ClosePoll(now);
+        } else {
+            g_stats.unsolicited_telemetry++;
+        }
+    }
+}
+
+static void ServicePoller(double now)
+{
+    switch (g_poll_state) {
+        case POLL_IDLE:
+            if (now < g_next_poll_ms) {
+                break;
+            }
+            g_poll_cursor = g_poll_cursor % (g_radio_count - 1U) + 1U;
+            if (g_poll_cursor == 1U) {
+                g_cycle_start_ms = now;
+            }
+            g_poll_started_ms = now;
+            g_poll_state = POLL_PREWRITE;
+            // fall through
+        case POLL_PREWRITE:
+            if ((g_air_count == 0U && now - g_channel_busy_until_ms >= g_opt.prewrite_quiet_ms) ||
+                now - g_poll_started_ms >= g_opt.prewrite_max_wait_ms) {
+                SendPoll(now);
+            }
+            break;
+        case POLL_WAIT_ACK:
+            if (now >= g_poll_deadline_ms) {
+                g_stats.ack_timeouts++;
+                ClosePoll(now);
+            }
+            break;
+        case POLL_WAIT_TELEMETRY:
+            if (now >= g_poll_deadline_ms) {
+                g_stats.telemetry_timeouts++;
+                ClosePoll(now);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static double NextPollerEventMs(void)
+{
+    switch (g_poll_state) {
+        case POLL_IDLE:
+            return g_next_poll_ms;
+        case POLL_PREWRITE: {
+            double quiet = g_channel_busy_until_ms + g_opt.prewrite_quiet_ms;
+            double limit = g_poll_started_ms + g_opt.prewrite_max_wait_ms;
+
+            return quiet < limit ? quiet : limit;
+        }
+        default:
+            return g_poll_deadline_ms;
+    }
+}
+
+// ==================== Runs ====================
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double Percentile(double *values, unsigned long count, double fraction)
+{
+    unsigned long index;
+
+    if (count == 0UL) {
+        return 0.0;
+    }
+    qsort(values, count, sizeof(values[0]), CompareDouble);
+    index = (unsigned long)(fraction * (double)(count - 1UL) + 0.5);
+    return values[index];
+}
+
+static double Mean(const double *values, unsigned long count)
+{
+    double sum = 0.0;
+    unsigned long i;
+
+    for (i = 0UL; i < count; ++i) {
+        sum += values[i];
+    }
+    return count > 0UL ? sum / (double)count : 0.0;
+}
+
+// fds holds the XL01 ends, then the GPS ends; GPS receiver commands are discarded.
+static void ReadNodes(struct pollfd *fds, unsigned int node_count)
+{
+    unsigned char buffer[1024];
+    unsigned int i;
+
+    for (i = 0U; i < node_count * 2U; ++i) {
+        ssize_t n;
+
+        if ((fds[i].revents & POLLIN) == 0) {
+            continue;
+        }
+        while ((n = read(fds[i].fd, buffer, sizeof(buffer))) > 0) {
+            if (i < node_count) {
+                QueueBytes(i + 1U, buffer, (unsigned int)n, SimNowMs());
+            }
+        }
+    }
+}
+
+static void ResetRun(void)
+{
+    free(g_stats.rtt_ms);
+    free(g_stats.latency_ms);
+    free(g_stats.cycle_ms);
+    memset(&g_stats, 0, sizeof(g_stats));
+    memset(g_air, 0, sizeof(g_air));
+    g_air_count = 0U;
+    g_channel_busy_until_ms = 0.0;
+    FieldLinkFrameDecoder_Init(&g_gateway_decoder);
+    g_poll_state = POLL_IDLE;
+    g_poll_cursor = 0U;
+    g_poll_sequence = 0U;
+    g_poll_command_id[0] = '\0';
+}
+
+static int RunNetwork(unsigned int node_count, double *elapsed_ms)
+{
+    struct pollfd fds[SIM_MAX_NODES * 2U];
+    unsigned long max_polls = (unsigned long)g_opt.cycles * node_count;
+    double poll_budget_ms = g_opt.prewrite_max_wait_ms + g_opt.ack_timeout_ms +
+                            g_opt.session_timeout_ms + g_opt.poll_interval_ms;
+    double end_ms;
+    double now;
+    unsigned int i;
+
+    ResetRun();
+    g_stats.rtt_ms = calloc(max_polls, sizeof(double));
+    g_stats.latency_ms = calloc(max_polls, sizeof(double));
+    g_stats.cycle_ms = calloc(g_opt.cycles, sizeof(double));
+    if (g_stats.rtt_ms == NULL || g_stats.latency_ms == NULL || g_stats.cycle_ms == NULL) {
+        return -1;
+    }
+
+    g_start_real_ms = RealMs();
+    if (SpawnNodes(node_count) != 0) {
+        fprintf(stderr, "[SIM] spawning %u nodes failed: %s\n", node_count, strerror(errno));
+        StopNodes();
+        return -1;
+    }
+    for (i = 0U; i < node_count; ++i) {
+        fds[i].fd = g_radios[i + 1U].fd;
+        fds[i].events = POLLIN;
+        fds[node_count + i].fd = g_radios[i + 1U].gps_fd;
+        fds[node_count + i].events = POLLIN;
+    }
+
+    // Every poll finishes within its budget, so a stuck run still ends.
+    g_next_poll_ms = g_opt.boot_ms;
+    g_next_gps_ms = 0.0;
+    g_gps_epoch = 0U;
+    end_ms = g_opt.boot_ms + (double)max_polls * poll_budget_ms;
+    now = SimNowMs();
+    while (g_stats.cycles_done < g_opt.cycles && now < end_ms) {
+        double next;
+        double wait_real_ms;
+        struct timespec timeout;
+
+        if (now >= g_next_gps_ms) {
+            FeedGps();
+            g_next_gps_ms += SIM_GPS_PERIOD_MS;
+        }
+        ServiceRadios(now);
+        ServicePoller(now);
+        ServiceRadios(now);
+
+        next = NextChannelEventMs(now);
+        if (NextPollerEventMs() < next) {
+            next = NextPollerEventMs();
+        }
+        if (g_next_gps_ms < next) {
+            next = g_next_gps_ms;
+        }
+        wait_real_ms = next > now ? (next - now) / (double)g_opt.time_scale : 0.0;
+        timeout.tv_sec = (time_t)(wait_real_ms / 1000.0);
+        timeout.tv_nsec = (long)((wait_real_ms - (double)timeout.tv_sec * 1000.0) * 1000000.0);
+        for (i = 0U; i < node_count * 2U; ++i) {
+            fds[i].revents = 0;
+        }
+        if (ppoll(fds, node_count * 2U, &timeout, NULL) > 0) {
+            ReadNodes(fds, node_count);
+        }
+        now = SimNowMs();
+    }
+    *elapsed_ms = now;
+    StopNodes();
+    return 0;
+}
+
+static void Report(unsigned int node_count, double elapsed_ms)
+{
+    unsigned long answered = g_stats.acks + g_stats.ack_failed;
+
+    printf("{\"nodes\":%u,\"cycles\":%lu,\"polls\":%lu,\"acks\":%lu,\"ack_failed\":%lu,\"ack_timeouts\":%lu,"
+           "\"telemetry\":%lu,\"telemetry_timeouts\":%lu,\"unsolicited_telemetry\":%lu,"
+           "\"poll_cycle_ms_mean\":%.1f,\"poll_cycle_ms_max\":%.1f,"
+           "\"cmd_rtt_ms_p50\":%.1f,\"cmd_rtt_ms_p95\":%.1f,\"cmd_rtt_ms_max\":%.1f,"
+           "\"poll_latency_ms_p50\":%.1f,\"poll_latency_ms_p95\":%.1f,"
+           "\"packets\":%lu,\"collided_packets\":%lu,\"collision_rate\":%.4f,\"lost_receptions\":%lu,"
+           "\"frame_errors\":%lu,\"dropped_bytes\":%lu,\"air_bytes\":%lu,\"airtime_utilisation\":%.4f,"
+           "\"elapsed_ms\":%.0f}\n",
+           node_count,
+           g_stats.cycles_done,
+           g_stats.polls,
+           g_stats.acks,
+           g_stats.ack_failed,
+           g_stats.ack_timeouts,
+           g_stats.telemetry,
+           g_stats.telemetry_timeouts,
+           g_stats.unsolicited_telemetry,
+           Mean(g_stats.cycle_ms, g_stats.cycles_done),
+           Percentile(g_stats.cycle_ms, g_stats.cycles_done, 1.0),
+           Percentile(g_stats.rtt_ms, answered, 0.50),
+           Percentile(g_stats.rtt_ms, answered, 0.95),
+           Percentile(g_stats.rtt_ms, answered, 1.0),
+           Percentile(g_stats.latency_ms, g_stats.telemetry, 0.50),
+           Percentile(g_stats.latency_ms, g_stats.telemetry, 0.95),
+           g_stats.packets,
+           g_stats.collided_packets,
+           g_stats.packets > 0UL ? (double)g_stats.collided_packets / (double)g_stats.packets : 0.0,
+           g_stats.lost_receptions,
+           g_stats.frame_errors,
+           g_stats.dropped_bytes,
+           g_stats.air_bytes,
+           elapsed_ms > 0.0 ? g_stats.busy_ms / elapsed_ms : 0.0,
+           elapsed_ms);
+}
+
+// ==================== Main ====================
+
+static void Usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [--nodes 3,5,10,20,50] [--cycles N] [--host-bin PATH] [--work-dir DIR]\n"
+            "          [--air-bps N] [--air-overhead-bytes N] [--max-packet N] [--packet-gap-ms MS]\n"
+            "          [--loss P] [--lbt] [--cca-ms MS] [--lbt-backoff-ms MS]\n"
+            "          [--time-scale K] [--seed N] [--boot-ms MS] [--prewrite-quiet-ms MS]\n"
+            "          [--prewrite-max-wait-ms MS] [--ack-timeout-ms MS] [--session-timeout-ms MS]\n"
+            "          [--poll-interval-ms MS]\n",
+            name);
+}
+
+static int ParseOptions(int argc, char **argv)
+{
+    int a;
+
+    for (a = 1; a < argc; ++a) {
+        const char *arg = argv[a];
+        const char *value = a + 1 < argc ? argv[a + 1] : NULL;
+
+        if (strcmp(arg, "--lbt") == 0) {
+            g_opt.lbt = 1;
+            continue;
+        }
+        if (value == NULL) {
+            return -1;
+        }
+        ++a;
+        if (strcmp(arg, "--nodes") == 0) {
+            g_opt.node_list = value;
+        } else if (strcmp(arg, "--cycles") == 0) {
+            g_opt.cycles = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--host-bin") == 0) {
+            g_opt.host_bin = value;
+        } else if (strcmp(arg, "--work-dir") == 0) {
+            g_opt.work_dir = value;
+        } else if (strcmp(arg, "--air-bps") == 0) {
+            g_opt.air_bps = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--air-overhead-bytes") == 0) {
+            g_opt.air_overhead_bytes = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--max-packet") == 0) {
+            g_opt.max_packet = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--packet-gap-ms") == 0) {
+            g_opt.packet_gap_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--loss") == 0) {
+            g_opt.loss = strtod(value, NULL);
+        } else if (strcmp(arg, "--cca-ms") == 0) {
+            g_opt.cca_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--lbt-backoff-ms") == 0) {
+            g_opt.lbt_backoff_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--time-scale") == 0) {
+            g_opt.time_scale = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--seed") == 0) {
+            g_opt.seed = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--boot-ms") == 0) {
+            g_opt.boot_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--prewrite-quiet-ms") == 0) {
+            g_opt.prewrite_quiet_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--prewrite-max-wait-ms") == 0) {
+            g_opt.prewrite_max_wait_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--ack-timeout-ms") == 0) {
+            g_opt.ack_timeout_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--session-timeout-ms") == 0) {
+            g_opt.session_timeout_ms = strtod(value, NULL);
+        } else if (strcmp(arg, "--poll-interval-ms") == 0) {
+            g_opt.poll_interval_ms = strtod(value, NULL);
+        } else {
+            return -1;
+        }
+    }
+
+    if (g_opt.cycles == 0U || g_opt.air_bps == 0U || g_opt.poll_interval_ms <= 0.0 ||
+        g_opt.loss < 0.0 || g_opt.loss >= 1.0 || g_opt.time_scale == 0U || g_opt.time_scale > 100U) {
+        return -1;
+    }
+    if (g_opt.max_packet == 0U || g_opt.max_packet > SIM_MAX_PACKET_BYTES) {
+        g_opt.max_packet = SIM_MAX_PACKET_BYTES;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static char default_bin[512];
+    const char *cursor;
+
+    if (ParseOptions(argc, argv) != 0) {
+        Usage(argv[0]);
+        return 2;
+    }
+    // landslide_host is built next to this binary.
+    if (g_opt.host_bin == NULL) {
+        ssize_t n = readlink("/proc/self/exe", default_bin, sizeof(default_bin) - 1U);
+        char *slash;
+
+        if (n <= 0) {
+            return 1;
+        }
+        default_bin[n] = '\0';
+        slash = strrchr(default_bin, '/');
+        snprintf(slash + 1, sizeof(default_bin) - (size_t)(slash + 1 - default_bin), "landslide_host");
+        g_opt.host_bin = default_bin;
+    }
+    if (access(g_opt.host_bin, X_OK) != 0) {
+        fprintf(stderr, "[SIM] %s not executable\n", g_opt.host_bin);
+        return 1;
+    }
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    signal(SIGPIPE, SIG_IGN);
+    srand48((long)g_opt.seed);
+
+    printf("{\"meta\":\"field_net_sim\",\"air_bps\":%u,\"air_overhead_bytes\":%u,\"max_packet\":%u,"
+           "\"packet_gap_ms\":%.1f,\"loss\":%.4f,\"lbt\":%d,\"time_scale\":%u,\"seed\":%u,\"cycles\":%u,"
+           "\"boot_ms\":%.0f,\"poll_interval_ms\":%.0f,\"ack_timeout_ms\":%.0f,\"session_timeout_ms\":%.0f}\n",
+           g_opt.air_bps, g_opt.air_overhead_bytes, g_opt.max_packet, g_opt.packet_gap_ms, g_opt.loss,
+           g_opt.lbt, g_opt.time_scale, g_opt.seed, g_opt.cycles, g_opt.boot_ms, g_opt.poll_interval_ms,
+           g_opt.ack_timeout_ms, g_opt.session_timeout_ms);
+
+    for (cursor = g_opt.node_list; *cursor != '\0';) {
+        char *end;
+        unsigned long nodes = strtoul(cursor, &end, 10);
+        double elapsed_ms = 0.0;
+
+        if (end == cursor || nodes == 0UL || nodes > SIM_MAX_NODES) {
+            fprintf(stderr, "[SIM] node counts must be 1..%u\n", SIM_MAX_NODES);
+            return 2;
+        }
+        fprintf(stderr, "[SIM] %lu nodes\n", nodes);
+        if (RunNetwork((unsigned int)nodes, &elapsed_ms) != 0) {
+            return 1;
+        }
+        Report((unsigned int)nodes, elapsed_ms);
+        cursor = *end == ',' ? end + 1 : end;
+    }
+    return 0;
+}
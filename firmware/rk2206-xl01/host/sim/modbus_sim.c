@@ -0,0 +1,614 @@
+/*
+ * Modbus Slave Farm Implementation
+ *
+ * The chip is modelled lazily: every I2C transfer first advances both
+ * channels to the current monotonic time, so nothing runs between transfers.
+ * Each UART sends 8N1 characters back to back at xtal / (16 * divisor). A
+ * request is complete once its segment has been quiet for 3.5 characters;
+ * the slaves then schedule their reply from the end of the request, and
+ * reply bytes enter the 64-byte RX FIFO one character time apart. The
+ * segments have auto-direction transceivers, so the firmware never hears its
+ * own request. Times are host microseconds, so run with time scale 1.
+ */
+
+#include "modbus_sim.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include "host_hal.h"
+#include "config/app_config.h"
+#include "utils/crc.h"
+
+#ifndef SC16IS752_XTAL_HZ
+#define SC16IS752_XTAL_HZ 14745600UL
+#endif
+
+#define SIM_REG_RHR_THR 0x00U
+#define SIM_REG_IER     0x01U
+#define SIM_REG_FCR_IIR 0x02U
+#define SIM_REG_LCR     0x03U
+#define SIM_REG_MCR     0x04U
+#define SIM_REG_LSR     0x05U
+#define SIM_REG_SPR     0x07U
+#define SIM_REG_TXLVL   0x08U
+#define SIM_REG_RXLVL   0x09U
+#define SIM_REG_IOCTRL  0x0EU
+
+#define SIM_LSR_DATA_READY 0x01U
+#define SIM_LSR_OVERRUN    0x02U
+#define SIM_LSR_THR_EMPTY  0x20U
+#define SIM_LSR_TX_EMPTY   0x40U
+#define SIM_LCR_DLAB       0x80U
+#define SIM_LCR_RESET      0x1DU
+#define SIM_FCR_RX_RESET   0x02U
+#define SIM_FCR_TX_RESET   0x04U
+#define SIM_MCR_LOOPBACK   0x10U
+#define SIM_IOCTRL_RESET   0x08U
+
+#define SIM_FIFO_BYTES     64U
+#define SIM_LINE_BYTES     256U
+#define SIM_FRAME_BYTES    256U
+#define SIM_BITS_PER_CHAR  10U      // 8N1
+#define SIM_BAUD_TOLERANCE 3U       // Percent a UART accepts before it sees garbage
+#define SIM_I2C_SLEEP_US   1000U    // Bus time is slept off once this much is owed
+
+#define MODBUS_FC_READ_HOLDING   0x03U
+#define MODBUS_FC_READ_INPUT     0x04U
+#define MODBUS_FC_WRITE_SINGLE   0x06U
+#define MODBUS_EX_ILLEGAL_FUNC   0x01U
+#define MODBUS_EX_ILLEGAL_ADDR   0x02U
+#define MODBUS_EX_ILLEGAL_VALUE  0x03U
+#define MODBUS_EX_BUSY           0x06U
+
+typedef struct {
+    uint8_t byte;
+    unsigned int baudrate;          // Speed it was sent at
+    uint64_t at_us;                 // Fully received by the UART
+} SimLineByte;
+
+typedef struct {
+    uint8_t ier;
+    uint8_t lcr;
+    uint8_t mcr;
+    uint8_t spr;
+    uint8_t dll;
+    uint8_t dlh;
+
+    uint64_t tx_busy_until_us;      // Last queued character leaves the shift register
+
+    uint8_t request[SIM_FRAME_BYTES];
+    unsigned int request_len;
+    unsigned int request_baudrate;
+    uint64_t request_end_us;
+
+    SimLineByte line[SIM_LINE_BYTES];   // Sent by slaves, not yet in the FIFO
+    unsigned int line_pos;
+    unsigned int line_len;
+
+    uint8_t rx[SIM_FIFO_BYTES];
+    unsigned int rx_head;
+    unsigned int rx_count;
+    unsigned char overrun;
+} SimChannel;
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static ModbusSimConfig g_config;
+static unsigned char g_attached = 0U;
+static SimChannel g_channels[MODBUS_SIM_CHANNELS];
+static ModbusSimSlave g_slaves[MODBUS_SIM_MAX_SLAVES];
+static unsigned int g_slave_count = 0U;
+static ModbusSimStats g_stats;
+static uint32_t g_rng = 1U;
+static uint8_t g_pointer = 0U;      // Sub-address of the last write, used by reads
+static uint64_t g_i2c_free_us = 0U;
+
+static uint64_t NowUs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000U + (uint64_t)now.tv_nsec / 1000U;
+}
+
+static uint32_t Random(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static int Chance(unsigned int permille)
+{
+    return permille > 0U && (Random() % 1000U) < permille;
+}
+
+static unsigned int ChannelBaudrate(const SimChannel *channel)
+{
+    unsigned int divisor = ((unsigned int)channel->dlh << 8) | channel->dll;
+
+    return divisor > 0U ? (unsigned int)(g_config.xtal_hz / (16UL * divisor)) : 0U;
+}
+
+static uint64_t CharUs(unsigned int baudrate)
+{
+    return ((uint64_t)SIM_BITS_PER_CHAR * 1000000U + baudrate - 1U) / baudrate;
+}
+
+static int BaudMatches(unsigned int a, unsigned int b)
+{
+    unsigned int diff = a > b ? a - b : b - a;
+
+    return a > 0U && b > 0U && diff * 100U <= b * SIM_BAUD_TOLERANCE;
+}
+
+static void ResetChannel(SimChannel *channel)
+{
+    memset(channel, 0, sizeof(*channel));
+    channel->lcr = SIM_LCR_RESET;
+}
+
+// ==================== Slaves ====================
+
+static void PutLine(SimChannel *channel, uint8_t byte, unsigned int baudrate, uint64_t at_us)
+{
+    if (channel->line_pos == channel->line_len) {
+        channel->line_pos = 0U;
+        channel->line_len = 0U;
+    }
+    if (channel->line_len < SIM_LINE_BYTES) {
+        channel->line[channel->line_len].byte = byte;
+        channel->line[channel->line_len].baudrate = baudrate;
+        channel->line[channel->line_len].at_us = at_us;
+        channel->line_len++;
+    }
+}
+
+static unsigned int AppendCrc(uint8_t *frame, unsigned int len)
+{
+    uint16_t crc = Crc_Modbus16(frame, len);
+
+    frame[len] = (uint8_t)(crc & 0xFFU);
+    frame[len + 1U] = (uint8_t)(crc >> 8);
+    return len + 2U;
+}
+
+static unsigned int BuildException(uint8_t *reply, uint8_t addr, uint8_t function, uint8_t code)
+{
+    reply[0] = addr;
+    reply[1] = (uint8_t)(function | 0x80U);
+    reply[2] = code;
+    g_stats.exceptions++;
+    return AppendCrc(reply, 3U);
+}
+
+// Answer for one slave, or 0 when it stays quiet
+static unsigned int BuildReply(ModbusSimSlave *slave, const uint8_t *request, uint8_t *reply)
+{
+    uint8_t function = request[1];
+    uint16_t start = (uint16_t)(((uint16_t)request[2] << 8) | request[3]);
+    uint16_t value = (uint16_t)(((uint16_t)request[4] << 8) | request[5]);
+    unsigned int i;
+
+    if (Chance(slave->drop_permille)) {
+        g_stats.dropped++;
+        return 0U;
+    }
+    if (Chance(slave->exception_permille)) {
+        return BuildException(reply, slave->addr, function,
+                              slave->exception_code != 0U ? slave->exception_code : MODBUS_EX_BUSY);
+    }
+
+    if (function == MODBUS_FC_READ_HOLDING || function == MODBUS_FC_READ_INPUT) {
+        if (value == 0U || value > 125U) {
+            return BuildException(reply, slave->addr, function, MODBUS_EX_ILLEGAL_VALUE);
+        }
+        if (start < slave->reg_start || (unsigned int)start + value > (unsigned int)slave->reg_start + slave->reg_count) {
+            return BuildException(reply, slave->addr, function, MODBUS_EX_ILLEGAL_ADDR);
+        }
+        reply[0] = slave->addr;
+        reply[1] = function;
+        reply[2] = (uint8_t)(value * 2U);
+        for (i = 0U; i < value; ++i) {
+            uint16_t reg = slave->regs[start - slave->reg_start + i];
+
+            reply[3U + i * 2U] = (uint8_t)(reg >> 8);
+            reply[4U + i * 2U] = (uint8_t)(reg & 0xFFU);
+        }
+        return AppendCrc(reply, 3U + (unsigned int)value * 2U);
+    }
+
+    if (function == MODBUS_FC_WRITE_SINGLE && slave->writable) {
+        if (start >= slave->reg_start && start < (unsigned int)slave->reg_start + slave->reg_count) {
+            slave->regs[start - slave->reg_start] = value;
+        }
+        memcpy(reply, request, 6U);
+        reply[0] = slave->addr;
+        return AppendCrc(reply, 6U);
+    }
+
+    return BuildException(reply, slave->addr, function, MODBUS_EX_ILLEGAL_FUNC);
+}
+
+static void Dispatch(unsigned int index)
+{
+    SimChannel *channel = &g_channels[index];
+    const uint8_t *request = channel->request;
+    uint8_t reply[SIM_FRAME_BYTES];
+    unsigned int reply_len = 0U;
+    unsigned int reply_baudrate = 0U;
+    unsigned int answering = 0U;
+    unsigned int latency_us = 0U;
+    unsigned int addressed = 0U;
+    uint64_t start_us;
+    unsigned int i;
+
+    g_stats.requests++;
+    if (channel->request_len != 8U || Crc_Modbus16(request, channel->request_len) != 0U) {
+        g_stats.bad_requests++;
+        channel->request_len = 0U;
+        return;
+    }
+
+    for (i = 0U; i < g_slave_count; ++i) {
+        ModbusSimSlave *slave = &g_slaves[i];
+        uint8_t own[SIM_FRAME_BYTES];
+        unsigned int own_len;
+        unsigned int j;
+
+        if (slave->channel != index || slave->silent ||
+            (request[0] != slave->addr && request[0] != 0U)) {
+            continue;
+        }
+        addressed++;
+        if (!BaudMatches(channel->request_baudrate, slave->baudrate)) {
+            g_stats.baud_mismatch++;
+            continue;
+        }
+        if (request[0] == 0U) {
+            // Broadcast writes are applied but never answered.
+            if (request[1] == MODBUS_FC_WRITE_SINGLE && slave->writable) {
+                (void)BuildReply(slave, request, own);
+            }
+            continue;
+        }
+        own_len = BuildReply(slave, request, own);
+        if (own_len == 0U) {
+            continue;
+        }
+        if (Chance(slave->crc_permille)) {
+            own[Random() % own_len] ^= (uint8_t)(1U << (Random() % 8U));
+            g_stats.crc_corrupted++;
+        }
+        if (answering == 0U) {
+            memcpy(reply, own, own_len);
+            reply_len = own_len;
+            reply_baudrate = slave->baudrate;
+            latency_us = slave->latency_ms * 1000U +
+                         (slave->jitter_ms > 0U ? Random() % (slave->jitter_ms * 1000U + 1U) : 0U);
+        } else {
+            // Two drivers on one pair: the receiver sees neither frame intact.
+            for (j = 0U; j < own_len && j < reply_len; ++j) {
+                reply[j] ^= (uint8_t)(own[j] | Random());
+            }
+            g_stats.collisions++;
+        }
+        answering++;
+    }
+    if (addressed == 0U && request[0] != 0U) {
+        g_stats.unanswered++;
+    }
+    channel->request_len = 0U;
+    if (reply_len == 0U) {
+        return;
+    }
+
+    g_stats.responses++;
+    start_us = channel->request_end_us;
+    if (latency_us < (unsigned int)(CharUs(reply_baudrate) * 7U / 2U)) {
+        latency_us = (unsigned int)(CharUs(reply_baudrate) * 7U / 2U);
+    }
+    start_us += latency_us;
+    for (i = 0U; i < reply_len; ++i) {
+        PutLine(channel, reply[i], reply_baudrate, start_us + CharUs(reply_baudrate) * (i + 1U));
+    }
+}
+
+// ==================== Chip ====================
+
+static void Advance(unsigned int index, uint64_t now)
+{
+    SimChannel *channel = &g_channels[index];
+    unsigned int baudrate = ChannelBaudrate(channel);
+
+    if (channel->request_len > 0U &&
+        now >= channel->request_end_us + CharUs(channel->request_baudrate) * 7U / 2U) {
+        Dispatch(index);
+    }
+
+    while (channel->line_pos < channel->line_len && channel->line[channel->line_pos].at_us <= now) {
+        const SimLineByte *in = &channel->line[channel->line_pos++];
+
+        if (channel->rx_count >= SIM_FIFO_BYTES) {
+            channel->overrun = 1U;
+            g_stats.rx_overruns++;
+            continue;
+        }
+        channel->rx[(channel->rx_head + channel->rx_count) % SIM_FIFO_BYTES] =
+            BaudMatches(baudrate, in->baudrate) ? in->byte : (uint8_t)Random();
+        channel->rx_count++;
+    }
+}
+
+static unsigned int TxPending(const SimChannel *channel, uint64_t now)
+{
+    unsigned int baudrate = ChannelBaudrate(channel);
+    uint64_t char_us;
+
+    if (baudrate == 0U || channel->tx_busy_until_us <= now) {
+        return 0U;
+    }
+    char_us = CharUs(baudrate);
+    return (unsigned int)((channel->tx_busy_until_us - now + char_us - 1U) / char_us);
+}
+
+static void Transmit(unsigned int index, uint8_t byte, uint64_t now)
+{
+    SimChannel *channel = &g_channels[index];
+    unsigned int baudrate = ChannelBaudrate(channel);
+    uint64_t start_us;
+
+    if (baudrate == 0U || TxPending(channel, now) >= SIM_FIFO_BYTES) {
+        return;
+    }
+    start_us = channel->tx_busy_until_us > now ? channel->tx_busy_until_us : now;
+    channel->tx_busy_until_us = start_us + CharUs(baudrate);
+
+    if ((channel->mcr & SIM_MCR_LOOPBACK) != 0U) {
+        PutLine(channel, byte, baudrate, channel->tx_busy_until_us);
+        return;
+    }
+    if (channel->request_len == 0U) {
+        channel->request_baudrate = baudrate;
+    }
+    if (channel->request_len < SIM_FRAME_BYTES) {
+        channel->request[channel->request_len++] = byte;
+    }
+    channel->request_end_us = channel->tx_busy_until_us;
+}
+
+static void WriteRegister(unsigned int index, uint8_t reg, uint8_t value, uint64_t now)
+{
+    SimChannel *channel = &g_channels[index];
+    int dlab = (channel->lcr & SIM_LCR_DLAB) != 0U;
+
+    switch (reg) {
+        case SIM_REG_RHR_THR:
+            if (dlab) {
+                channel->dll = value;
+            } else {
+                Transmit(index, value, now);
+            }
+            break;
+        case SIM_REG_IER:
+            if (dlab) {
+                channel->dlh = value;
+            } else {
+                channel->ier = value;
+            }
+            break;
+        case SIM_REG_FCR_IIR:
+            if ((value & SIM_FCR_RX_RESET) != 0U) {
+                channel->rx_count = 0U;
+                channel->overrun = 0U;
+            }
+            if ((value & SIM_FCR_TX_RESET) != 0U && channel->tx_busy_until_us > now) {
+                channel->tx_busy_until_us = now;
+            }
+            break;
+        case SIM_REG_LCR:
+            channel->lcr = value;
+            break;
+        case SIM_REG_MCR:
+            channel->mcr = value;
+            break;
+        case SIM_REG_SPR:
+            channel->spr = value;
+            break;
+        case SIM_REG_IOCTRL:
+            if ((value & SIM_IOCTRL_RESET) != 0U) {
+                unsigned int i;
+
+                for (i = 0U; i < MODBUS_SIM_CHANNELS; ++i) {
+                    ResetChannel(&g_channels[i]);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static uint8_t ReadRegister(unsigned int index, uint8_t reg, uint64_t now)
+{
+    SimChannel *channel = &g_channels[index];
+    int dlab = (channel->lcr & SIM_LCR_DLAB) != 0U;
+    unsigned int pending;
+    uint8_t value;
+
+    switch (reg) {
+        case SIM_REG_RHR_THR:
+            if (dlab) {
+                return channel->dll;
+            }
+            if (channel->rx_count == 0U) {
+                return 0U;
+            }
+            value = channel->rx[channel->rx_head];
+            channel->rx_head = (channel->rx_head + 1U) % SIM_FIFO_BYTES;
+            channel->rx_count--;
+            return value;
+        case SIM_REG_IER:
+            return dlab ? channel->dlh : channel->ier;
+        case SIM_REG_FCR_IIR:
+            return 0x01U;           // No interrupt pending
+        case SIM_REG_LCR:
+            return channel->lcr;
+        case SIM_REG_MCR:
+            return channel->mcr;
+        case SIM_REG_LSR:
+            pending = TxPending(channel, now);
+            value = (uint8_t)((channel->rx_count > 0U ? SIM_LSR_DATA_READY : 0U) |
+                              (channel->overrun ? SIM_LSR_OVERRUN : 0U) |
+                              (pending <= 1U ? SIM_LSR_THR_EMPTY : 0U) |
+                              (pending == 0U ? SIM_LSR_TX_EMPTY : 0U));
+            channel->overrun = 0U;
+            return value;
+        case SIM_REG_SPR:
+            return channel->spr;
+        case SIM_REG_TXLVL:
+            pending = TxPending(channel, now);
+            return (uint8_t)(pending >= SIM_FIFO_BYTES ? 0U : SIM_FIFO_BYTES - pending);
+        case SIM_REG_RXLVL:
+            return (uint8_t)channel->rx_count;
+        default:
+            return 0U;
+    }
+}
+
+// Charge the transfer's bus time and return the time it completes. The
+// caller is held back once that runs SIM_I2C_SLEEP_US ahead of the clock:
+// fewer, longer sleeps keep host wake-up slop from splitting requests.
+static uint64_t ChargeI2c(uint32_t len)
+{
+    uint64_t now = NowUs();
+    uint64_t done_us;
+    struct timespec until;
+
+    g_stats.i2c_transfers++;
+    if (g_config.i2c_khz == 0U) {
+        return now;
+    }
+    // Address plus data bytes of 9 clocks each, and start/stop
+    done_us = (g_i2c_free_us > now ? g_i2c_free_us : now) +
+              ((uint64_t)(len + 1U) * 9U + 2U) * 1000U / g_config.i2c_khz;
+    g_stats.i2c_busy_us += done_us - (g_i2c_free_us > now ? g_i2c_free_us : now);
+    g_i2c_free_us = done_us;
+    if (done_us > now + SIM_I2C_SLEEP_US) {
+        until.tv_sec = (time_t)(done_us / 1000000U);
+        until.tv_nsec = (long)(done_us % 1000000U) * 1000L;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) != 0) {
+        }
+    }
+    return done_us;
+}
+
+static void AdvanceAll(uint64_t now)
+{
+    unsigned int i;
+
+    for (i = 0U; i < MODBUS_SIM_CHANNELS; ++i) {
+        Advance(i, now);
+    }
+}
+
+static int ChipWrite(void *ctx, const uint8_t *data, uint32_t len)
+{
+    uint64_t now;
+    uint32_t i;
+
+    (void)ctx;
+    if (len == 0U) {
+        return -1;
+    }
+    now = ChargeI2c(len);
+    pthread_mutex_lock(&g_lock);
+    AdvanceAll(now);
+    g_pointer = data[0];
+    for (i = 1U; i < len; ++i) {
+        WriteRegister((g_pointer >> 1) & 0x01U, (uint8_t)((g_pointer >> 3) & 0x0FU), data[i], now);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return 0;
+}
+
+static int ChipRead(void *ctx, uint8_t *data, uint32_t len)
+{
+    uint64_t now;
+    uint32_t i;
+
+    (void)ctx;
+    now = ChargeI2c(len);
+    pthread_mutex_lock(&g_lock);
+    AdvanceAll(now);
+    for (i = 0U; i < len; ++i) {
+        data[i] = ReadRegister((g_pointer >> 1) & 0x01U, (uint8_t)((g_pointer >> 3) & 0x0FU), now);
+    }
+    pthread_mutex_unlock(&g_lock);
+    return 0;
+}
+
+static const HostI2cDevice kChip = {
+    .write = ChipWrite,
+    .read = ChipRead,
+};
+
+int ModbusSim_Attach(unsigned int bus, unsigned short addr, const ModbusSimConfig *config)
+{
+    unsigned int i;
+
+    if (g_attached) {
+        return -1;
+    }
+    memset(&g_config, 0, sizeof(g_config));
+    if (config != NULL) {
+        g_config = *config;
+    }
+    if (g_config.xtal_hz == 0UL) {
+        g_config.xtal_hz = SC16IS752_XTAL_HZ;
+    }
+    g_rng = g_config.seed != 0U ? g_config.seed : 1U;
+    for (i = 0U; i < MODBUS_SIM_CHANNELS; ++i) {
+        ResetChannel(&g_channels[i]);
+    }
+    if (HostI2c_Attach(bus, addr, &kChip, NULL) != 0) {
+        return -1;
+    }
+    g_attached = 1U;
+    return 0;
+}
+
+ModbusSimSlave *ModbusSim_AddSlave(const ModbusSimSlave *slave)
+{
+    ModbusSimSlave *added = NULL;
+
+    if (slave == NULL || slave->channel >= MODBUS_SIM_CHANNELS || slave->reg_count > MODBUS_SIM_MAX_REGS) {
+        return NULL;
+    }
+    pthread_mutex_lock(&g_lock);
+    if (g_slave_count < MODBUS_SIM_MAX_SLAVES) {
+        added = &g_slaves[g_slave_count++];
+        *added = *slave;
+    }
+    pthread_mutex_unlock(&g_lock);
+    return added;
+}
+
+void ModbusSim_GetStats(ModbusSimStats *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&g_lock);
+    *out = g_stats;
+    pthread_mutex_unlock(&g_lock);
+}
+
+void ModbusSim_ResetStats(void)
+{
+    pthread_mutex_lock(&g_lock);
+    memset(&g_stats, 0, sizeof(g_stats));
+    pthread_mutex_unlock(&g_lock);
+}
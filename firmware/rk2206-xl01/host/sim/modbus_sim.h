@@ -0,0 +1,82 @@
+/*
+ * Modbus Slave Farm
+ * A virtual SC16IS752 on a host I2C bus with Modbus RTU slaves behind its
+ * two UARTs, for driving the RS485 stack without hardware. Slaves have a
+ * register map, a baud rate, a response latency with jitter and per-mille
+ * rates of dropped replies, corrupted CRCs and injected exceptions.
+ */
+
+#ifndef HOST_SIM_MODBUS_SIM_H
+#define HOST_SIM_MODBUS_SIM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MODBUS_SIM_CHANNELS     2U      // SC16IS752 UART A and B, one RS485 segment each
+#define MODBUS_SIM_MAX_SLAVES   8U
+#define MODBUS_SIM_MAX_REGS     16U
+
+typedef struct {
+    uint8_t channel;                // 0 = UART A, 1 = UART B
+    uint8_t addr;
+    unsigned int baudrate;          // Requests at another speed are not understood
+    uint16_t reg_start;             // FC 03/04 serve [reg_start, reg_start + reg_count)
+    uint16_t reg_count;
+    uint16_t regs[MODBUS_SIM_MAX_REGS];
+    unsigned char writable;         // FC 06 accepted at any address, stored when in the map
+    unsigned int latency_ms;        // From the end of the request to the first reply byte
+    unsigned int jitter_ms;         // Uniform extra 0..jitter_ms
+    unsigned int drop_permille;     // Reply never sent
+    unsigned int crc_permille;      // One bit of the reply flipped after its CRC is computed
+    unsigned int exception_permille;
+    uint8_t exception_code;         // Injected exception, 0x06 (busy) when 0
+    unsigned char silent;           // Powered off or disconnected; may be toggled between cycles
+} ModbusSimSlave;
+
+typedef struct {
+    unsigned long xtal_hz;          // Crystal actually fitted; 0 = SC16IS752_XTAL_HZ
+    unsigned int i2c_khz;           // Each transfer takes its bus time at this clock; 0 = free
+    uint32_t seed;
+} ModbusSimConfig;
+
+typedef struct {
+    unsigned int requests;          // Frames the firmware put on either segment
+    unsigned int bad_requests;      // Wrong length (a pause of 3.5 characters splits a frame) or CRC
+    unsigned int baud_mismatch;     // Addressed slave listens at another speed
+    unsigned int unanswered;        // No slave at that address on the segment
+    unsigned int responses;
+    unsigned int dropped;
+    unsigned int crc_corrupted;
+    unsigned int exceptions;        // Injected, plus bad range or function
+    unsigned int collisions;        // More than one slave answered the same request
+    unsigned int rx_overruns;       // Bytes lost to a full 64-byte RX FIFO
+    unsigned int i2c_transfers;
+    uint64_t i2c_busy_us;
+} ModbusSimStats;
+
+/**
+ * Put the virtual SC16IS752 on bus (EI2C*) at the 7-bit address. One chip per
+ * process; config may be NULL for the defaults.
+ * @return 0 on success, -1 if already attached or the address is taken
+ */
+int ModbusSim_Attach(unsigned int bus, unsigned short addr, const ModbusSimConfig *config);
+
+/**
+ * Add a slave behind the chip.
+ * @return the farm's copy, which the caller may change between bus
+ *         transactions (silent, fault rates, register values), or NULL if full
+ */
+ModbusSimSlave *ModbusSim_AddSlave(const ModbusSimSlave *slave);
+
+void ModbusSim_GetStats(ModbusSimStats *out);
+
+void ModbusSim_ResetStats(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_SIM_MODBUS_SIM_H
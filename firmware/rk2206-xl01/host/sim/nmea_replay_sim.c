@@ -0,0 +1,758 @@
+/*
+ * NMEA Replay Harness
+ * Replays UM220 NMEA captures into the GPS UART at a chosen line rate and
+ * lets the firmware's own path (10 ms UART poll task -> 1 KB FIFO ->
+ * GPS_Poll -> ProcessGPSData) take them in, to check that the FIFO and the
+ * poll cadence keep up with the receiver at 9600..115200 baud.
+ *
+ * Usage: nmea_replay_sim [--capture substr] [--file PATH] [--baud N[,N...]]
+ *                        [--seconds N] [--rate-hz N] [--poll-ms N]
+ *                        [--uart-rx-bytes N] [--noise-permille N]
+ *                        [--fix-after-ms N] [--seed N] [--list]
+ *
+ * Built-in captures are synthetic UM220 output before receiver
+ * configuration: a GPS-only stream, a multi-GNSS one with the GSV storm of
+ * three constellations, and the GPS-only stream on a noisy line (bit flips
+ * and bursts of line garbage). --file adds a recorded capture (raw NMEA, one
+ * sentence per line); it is cut into epochs where its first sentence type
+ * repeats and looped for --seconds. Each epoch is sent back to back at the
+ * line rate, starting on its output tick or when the line frees up.
+ *
+ * Every capture and baud rate runs in a forked child with fresh driver
+ * state. GPS_Poll is called every --poll-ms, 1000 by default like the
+ * sampling loop. --uart-rx-bytes bounds what may sit between the line and
+ * IoTUartRead (the UART's own FIFO and driver buffer); 0 leaves it
+ * unbounded and only reports the backlog the poll task let build up.
+ *
+ * Output is JSON lines: one "meta" record, then one record per capture and
+ * baud rate with the sentence counts and rate, FIFO high-watermark, bytes
+ * dropped by the FIFO and the UART model, resync events, time to first fix
+ * and GPS_Poll cost. Firmware log lines go to stderr.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "host_hal.h"
+#include "lz_hardware.h"
+#include "config/app_config.h"
+#include "drivers/sensors/gps_driver.h"
+#include "utils/fifo.h"
+
+#define REPLAY_MAX_BAUDS        8U
+#define REPLAY_MAX_STREAM       (1024U * 1024U)
+#define REPLAY_MAX_EPOCHS       4096U
+#define REPLAY_MAX_POLLS        20000U
+#define REPLAY_SENTENCE_BYTES   128U
+#define REPLAY_FEED_SLICE_MS    1.0
+
+typedef enum {
+    CAPTURE_GPS_ONLY = 0,
+    CAPTURE_MULTI_GNSS,
+    CAPTURE_FILE
+} CaptureKind;
+
+typedef struct {
+    const char *name;
+    const char *summary;
+    CaptureKind kind;
+    unsigned char noisy;            // Apply --noise-permille to the line
+} ReplayCapture;
+
+static const ReplayCapture kCaptures[] = {
+    {"gps_only", "GP talker: GGA GSA 3xGSV RMC VTG", CAPTURE_GPS_ONLY, 0U},
+    {"multi_gnss", "GPS+BDS+GLONASS: GGA GLL 3xGSA 11xGSV RMC VTG ZDA", CAPTURE_MULTI_GNSS, 0U},
+    {"noisy", "gps_only with bit flips and line garbage", CAPTURE_GPS_ONLY, 1U},
+};
+
+static const ReplayCapture kFileCapture = {"file", "recorded capture", CAPTURE_FILE, 0U};
+
+typedef struct {
+    const char *filter;
+    const char *file;
+    unsigned int bauds[REPLAY_MAX_BAUDS];
+    unsigned int baud_count;
+    unsigned int seconds;
+    unsigned int rate_hz;
+    unsigned int poll_ms;
+    unsigned int uart_rx_bytes;
+    unsigned int noise_permille;
+    unsigned int fix_after_ms;
+    unsigned int seed;
+} ReplayOptions;
+
+static ReplayOptions g_opt = {
+    .filter = NULL,
+    .file = NULL,
+    .bauds = {9600U, 38400U, 115200U},
+    .baud_count = 3U,
+    .seconds = 8U,
+    .rate_hz = 1U,
+    .poll_ms = 1000U,
+    .uart_rx_bytes = 0U,
+    .noise_permille = 10U,
+    .fix_after_ms = 3000U,
+    .seed = 1U,
+};
+
+// One capture laid out for the line: bytes plus where each epoch starts
+typedef struct {
+    unsigned char *bytes;
+    unsigned int len;
+    unsigned int epoch_offset[REPLAY_MAX_EPOCHS + 1U];
+    unsigned int epochs;
+    unsigned int sentences;
+    unsigned int useful;            // GGA/RMC sentences sent
+    unsigned int useful_intact;     // ... that the noise left alone
+    unsigned int noise_events;
+} ReplayStream;
+
+// Feeder state, shared between the line thread and the poll loop
+typedef struct {
+    const ReplayStream *stream;
+    int fd;
+    unsigned int baudrate;
+    double start_ms;
+    volatile int done;
+    volatile unsigned int sent;
+    unsigned int overrun_bytes;     // Lost to a full --uart-rx-bytes buffer
+    unsigned int backlog_max;       // Line bytes not yet taken by IoTUartRead
+    unsigned int tx_bytes;          // Receiver commands the firmware sent
+    double lag_ms;                  // How far the line fell behind the epoch ticks
+} ReplayFeeder;
+
+static FILE *g_out = NULL;
+static uint32_t g_rng = 1U;
+static char **g_file_lines = NULL;
+static unsigned int g_file_line_count = 0U;
+static double g_poll_us[REPLAY_MAX_POLLS];
+
+static double NowMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+static void SleepUntilMs(double deadline_ms)
+{
+    double wait_ms = deadline_ms - NowMs();
+    struct timespec ts;
+
+    if (wait_ms <= 0.0) {
+        return;
+    }
+    ts.tv_sec = (time_t)(wait_ms / 1000.0);
+    ts.tv_nsec = (long)((wait_ms - (double)ts.tv_sec * 1000.0) * 1000000.0);
+    nanosleep(&ts, NULL);
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double Percentile(double *values, unsigned int count, double fraction)
+{
+    unsigned int index;
+
+    if (count == 0U) {
+        return 0.0;
+    }
+    qsort(values, count, sizeof(values[0]), CompareDouble);
+    index = (unsigned int)(fraction * (double)(count - 1U) + 0.5);
+    return values[index];
+}
+
+static double Mean(const double *values, unsigned int count)
+{
+    double sum = 0.0;
+    unsigned int i;
+
+    for (i = 0U; i < count; ++i) {
+        sum += values[i];
+    }
+    return count > 0U ? sum / (double)count : 0.0;
+}
+
+static uint32_t NextRandom(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+// ==================== Captures ====================
+
+static int IsUsefulSentence(const char *sentence)
+{
+    return strlen(sentence) > 6U && (strncmp(sentence + 3, "GGA", 3) == 0 || strncmp(sentence + 3, "RMC", 3) == 0);
+}
+
+/*
+ * Put one sentence ("$...*hh\r\n" or its body) on the stream. On a noisy line
+ * each byte but the final LF may be hit: a flipped bit, or a burst of 1..8
+ * garbage bytes in front of it. Either loses the sentence.
+ */
+static int AppendSentence(ReplayStream *stream, const char *sentence, unsigned int noise_permille)
+{
+    char framed[REPLAY_SENTENCE_BYTES];
+    const char *text = sentence;
+    unsigned int len;
+    unsigned int i;
+    int touched = 0;
+
+    if (sentence[0] != '$') {
+        unsigned char checksum = 0U;
+        const char *p;
+
+        for (p = sentence; *p != '\0'; ++p) {
+            checksum ^= (unsigned char)*p;
+        }
+        if (snprintf(framed, sizeof(framed), "$%s*%02X\r\n", sentence, checksum) >= (int)sizeof(framed)) {
+            return -1;
+        }
+        text = framed;
+    }
+    len = (unsigned int)strlen(text);
+    if (stream->len + len + 8U * len > REPLAY_MAX_STREAM) {
+        return -1;
+    }
+
+    for (i = 0U; i < len; ++i) {
+        unsigned char c = (unsigned char)text[i];
+
+        if (noise_permille > 0U && i + 1U < len && NextRandom() % 1000U < noise_permille) {
+            touched = 1;
+            stream->noise_events++;
+            if ((NextRandom() & 1U) != 0U) {
+                c ^= (unsigned char)(1U << (NextRandom() % 8U));
+            } else {
+                unsigned int burst = 1U + NextRandom() % 8U;
+
+                while (burst-- > 0U) {
+                    stream->bytes[stream->len++] = (unsigned char)(0x80U | NextRandom());
+                }
+            }
+        }
+        stream->bytes[stream->len++] = c;
+    }
+
+    stream->sentences++;
+    if (IsUsefulSentence(text)) {
+        stream->useful++;
+        stream->useful_intact += (unsigned int)!touched;
+    }
+    return 0;
+}
+
+static void FormatUtc(char *out, size_t size, unsigned int ms)
+{
+    unsigned int s = 8U * 3600U + 30U * 60U + ms / 1000U;
+
+    snprintf(out, size, "%02u%02u%02u.%02u", (s / 3600U) % 24U, (s / 60U) % 60U, s % 60U, (ms % 1000U) / 10U);
+}
+
+// One GSV group: count satellites over ceil(count / 4) sentences
+static int AppendGsv(ReplayStream *stream, const char *talker, unsigned int count, unsigned int first_prn,
+                     unsigned int epoch, unsigned int noise_permille)
+{
+    unsigned int messages = (count + 3U) / 4U;
+    unsigned int m;
+
+    for (m = 0U; m < messages; ++m) {
+        char body[REPLAY_SENTENCE_BYTES];
+        int len = snprintf(body, sizeof(body), "%sGSV,%u,%u,%02u", talker, messages, m + 1U, count);
+        unsigned int s;
+
+        for (s = m * 4U; s < count && s < m * 4U + 4U; ++s) {
+            unsigned int prn = first_prn + s * 3U;
+
+            len += snprintf(body + len, sizeof(body) - (size_t)len, ",%02u,%02u,%03u,%02u", prn,
+                            (prn * 7U + epoch / 60U) % 85U + 5U, (prn * 37U + epoch / 30U) % 360U,
+                            25U + (prn + epoch) % 20U);
+        }
+        if (AppendSentence(stream, body, noise_permille) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static int AppendSyntheticEpoch(ReplayStream *stream, CaptureKind kind, unsigned int epoch, unsigned int noise_permille)
+{
+    unsigned int ms = epoch * 1000U / g_opt.rate_hz;
+    int fixed = ms >= g_opt.fix_after_ms;
+    const char *gn = kind == CAPTURE_MULTI_GNSS ? "GN" : "GP";
+    char utc[16];
+    char body[REPLAY_SENTENCE_BYTES];
+    int rc = 0;
+
+    FormatUtc(utc, sizeof(utc), ms);
+    if (fixed) {
+        snprintf(body, sizeof(body), "%sGGA,%s,2234.56789,N,11356.76543,E,1,%u,0.8,45.3,M,-3.2,M,,", gn, utc,
+                 kind == CAPTURE_MULTI_GNSS ? 24U : 9U);
+    } else {
+        snprintf(body, sizeof(body), "%sGGA,%s,,,,,0,%u,,,M,,M,,", gn, utc, 2U + ms / 1000U);
+    }
+    rc |= AppendSentence(stream, body, noise_permille);
+
+    if (kind == CAPTURE_MULTI_GNSS) {
+        snprintf(body, sizeof(body), "GNGLL,%s,%s,%s,%s,%s,%s", fixed ? "2234.56789" : "", fixed ? "N" : "",
+                 fixed ? "11356.76543" : "", fixed ? "E" : "", utc, fixed ? "A,A" : "V,N");
+        rc |= AppendSentence(stream, body, noise_permille);
+        rc |= AppendSentence(stream, fixed ? "GNGSA,A,3,01,04,07,10,13,16,19,22,,,,,1.4,0.8,1.1,1"
+                                           : "GNGSA,A,1,,,,,,,,,,,,,99.9,99.9,99.9,1", noise_permille);
+        rc |= AppendSentence(stream, fixed ? "GNGSA,A,3,02,05,08,11,14,17,20,,,,,,1.4,0.8,1.1,4"
+                                           : "GNGSA,A,1,,,,,,,,,,,,,99.9,99.9,99.9,4", noise_permille);
+        rc |= AppendSentence(stream, fixed ? "GNGSA,A,3,66,67,75,76,82,83,,,,,,,1.4,0.8,1.1,2"
+                                           : "GNGSA,A,1,,,,,,,,,,,,,99.9,99.9,99.9,2", noise_permille);
+        rc |= AppendGsv(stream, "GP", 14U, 1U, epoch, noise_permille);
+        rc |= AppendGsv(stream, "BD", 16U, 1U, epoch, noise_permille);
+        rc |= AppendGsv(stream, "GL", 10U, 65U, epoch, noise_permille);
+    } else {
+        rc |= AppendSentence(stream, fixed ? "GPGSA,A,3,01,04,07,10,13,16,19,22,25,,,,1.4,0.8,1.1"
+                                           : "GPGSA,A,1,,,,,,,,,,,,,99.9,99.9,99.9", noise_permille);
+        rc |= AppendGsv(stream, "GP", 11U, 1U, epoch, noise_permille);
+    }
+
+    if (fixed) {
+        snprintf(body, sizeof(body), "%sRMC,%s,A,2234.56789,N,11356.76543,E,0.02,,180926,,,A", gn, utc);
+    } else {
+        snprintf(body, sizeof(body), "%sRMC,%s,V,,,,,,,180926,,,N", gn, utc);
+    }
+    rc |= AppendSentence(stream, body, noise_permille);
+    rc |= AppendSentence(stream, fixed ? (kind == CAPTURE_MULTI_GNSS ? "GNVTG,,T,,M,0.02,N,0.04,K,A"
+                                                                     : "GPVTG,,T,,M,0.02,N,0.04,K,A")
+                                       : (kind == CAPTURE_MULTI_GNSS ? "GNVTG,,,,,,,,,N" : "GPVTG,,,,,,,,,N"),
+                         noise_permille);
+    if (kind == CAPTURE_MULTI_GNSS) {
+        snprintf(body, sizeof(body), "GNZDA,%s,18,09,2026,,", utc);
+        rc |= AppendSentence(stream, body, noise_permille);
+    }
+    return rc;
+}
+
+static int LoadCaptureFile(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[256];
+    unsigned int capacity = 0U;
+
+    if (file == NULL) {
+        fprintf(stderr, "[REPLAY] cannot open %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        size_t len = strcspn(line, "\r\n");
+
+        if (line[0] != '$' || len < 7U || len + 3U > REPLAY_SENTENCE_BYTES) {
+            continue;
+        }
+        if (g_file_line_count == capacity) {
+            char **grown;
+
+            capacity = capacity > 0U ? capacity * 2U : 256U;
+            grown = realloc(g_file_lines, capacity * sizeof(*grown));
+            if (grown == NULL) {
+                fclose(file);
+                return -1;
+            }
+            g_file_lines = grown;
+        }
+        line[len] = '\0';
+        strcat(line, "\r\n");
+        g_file_lines[g_file_line_count] = strdup(line);
+        if (g_file_lines[g_file_line_count] == NULL) {
+            fclose(file);
+            return -1;
+        }
+        g_file_line_count++;
+    }
+    fclose(file);
+    if (g_file_line_count == 0U) {
+        fprintf(stderr, "[REPLAY] %s holds no NMEA sentences\n", path);
+        return -1;
+    }
+    return 0;
+}
+
+// A new epoch starts where the file's first sentence type comes round again.
+static int AppendFileEpoch(ReplayStream *stream, unsigned int *cursor, unsigned int noise_permille)
+{
+    const char *first = g_file_lines[0];
+    unsigned int taken = 0U;
+
+    do {
+        if (AppendSentence(stream, g_file_lines[*cursor], noise_permille) != 0) {
+            return -1;
+        }
+        *cursor = (*cursor + 1U) % g_file_line_count;
+        taken++;
+    } while (taken < g_file_line_count && strncmp(g_file_lines[*cursor], first, 6) != 0);
+    return 0;
+}
+
+static int BuildStream(ReplayStream *stream, const ReplayCapture *capture)
+{
+    unsigned int noise = capture->noisy ? g_opt.noise_permille : 0U;
+    unsigned int epochs = g_opt.seconds * g_opt.rate_hz;
+    unsigned int cursor = 0U;
+    unsigned int e;
+
+    memset(stream, 0, sizeof(*stream));
+    stream->bytes = malloc(REPLAY_MAX_STREAM);
+    if (stream->bytes == NULL || epochs > REPLAY_MAX_EPOCHS) {
+        return -1;
+    }
+    for (e = 0U; e < epochs; ++e) {
+        stream->epoch_offset[e] = stream->len;
+        if ((capture->kind == CAPTURE_FILE ? AppendFileEpoch(stream, &cursor, noise)
+                                           : AppendSyntheticEpoch(stream, capture->kind, e, noise)) != 0) {
+            fprintf(stderr, "[REPLAY] capture %s does not fit in %u bytes\n", capture->name, REPLAY_MAX_STREAM);
+            return -1;
+        }
+    }
+    stream->epochs = epochs;
+    stream->epoch_offset[epochs] = stream->len;
+    return 0;
+}
+
+// ==================== Line ====================
+
+/*
+ * Sends the capture at the line rate in REPLAY_FEED_SLICE_MS steps and
+ * keeps the firmware's receiver commands from filling the socket.
+ */
+static void *FeederThread(void *arg)
+{
+    ReplayFeeder *feeder = (ReplayFeeder *)arg;
+    const ReplayStream *stream = feeder->stream;
+    double byte_ms = 10000.0 / (double)feeder->baudrate;
+    double epoch_ms = 1000.0 / (double)g_opt.rate_hz;
+    double line_ms = 0.0;           // Due time of the next byte, from start_ms
+    unsigned int epoch = 0U;
+    unsigned int pos = 0U;
+    unsigned char chunk[4096];
+
+    while (pos < stream->len) {
+        double now = NowMs() - feeder->start_ms;
+        unsigned int count = 0U;
+        unsigned char sink[256];
+        GpsStats stats;
+        unsigned int backlog;
+
+        while (pos < stream->len && count < sizeof(chunk)) {
+            if (pos == stream->epoch_offset[epoch]) {
+                double tick = (double)epoch * epoch_ms;
+
+                if (line_ms > tick && line_ms - tick > feeder->lag_ms) {
+                    feeder->lag_ms = line_ms - tick;
+                }
+                if (line_ms < tick) {
+                    line_ms = tick;
+                }
+                epoch++;
+            }
+            if (line_ms > now) {
+                break;
+            }
+            chunk[count++] = stream->bytes[pos++];
+            line_ms += byte_ms;
+        }
+
+        (void)GPS_GetStats(&stats);
+        backlog = feeder->sent - stats.rx_bytes_total;
+        if (count > 0U) {
+            unsigned int accept = count;
+            unsigned int done = 0U;
+
+            if (g_opt.uart_rx_bytes > 0U) {
+                unsigned int room = backlog < g_opt.uart_rx_bytes ? g_opt.uart_rx_bytes - backlog : 0U;
+
+                if (accept > room) {
+                    feeder->overrun_bytes += accept - room;
+                    accept = room;
+                }
+            }
+            while (done < accept) {
+                ssize_t n = write(feeder->fd, chunk + done, accept - done);
+
+                if (n <= 0) {
+                    break;
+                }
+                done += (unsigned int)n;
+            }
+            feeder->sent += done;
+            backlog += done;
+        }
+        if (backlog > feeder->backlog_max) {
+            feeder->backlog_max = backlog;
+        }
+        for (;;) {
+            ssize_t n = recv(feeder->fd, sink, sizeof(sink), MSG_DONTWAIT);
+
+            if (n <= 0) {
+                break;
+            }
+            feeder->tx_bytes += (unsigned int)n;
+        }
+        SleepUntilMs(NowMs() + REPLAY_FEED_SLICE_MS);
+    }
+    feeder->done = 1;
+    return NULL;
+}
+
+// ==================== Replay ====================
+
+static int RunReplay(const ReplayCapture *capture, unsigned int baudrate)
+{
+    ReplayStream stream;
+    ReplayFeeder feeder;
+    pthread_t thread;
+    GpsStats stats;
+    GpsFix fix;
+    double ttff_ms = -1.0;
+    double elapsed_ms;
+    double next_poll_ms;
+    double parse_ms;
+    unsigned int polls = 0U;
+    unsigned int seen;
+    int fd;
+
+    g_rng = g_opt.seed != 0U ? g_opt.seed : 1U;
+    if (BuildStream(&stream, capture) != 0) {
+        return -1;
+    }
+    fd = HostUart_OpenPipe(GPS_UART_ID);
+    if (fd < 0 || GPS_Init() != 0) {
+        fprintf(stderr, "[REPLAY] GPS init failed\n");
+        return -1;
+    }
+
+    memset(&feeder, 0, sizeof(feeder));
+    feeder.stream = &stream;
+    feeder.fd = fd;
+    feeder.baudrate = baudrate;
+    feeder.start_ms = NowMs();
+    if (pthread_create(&thread, NULL, FeederThread, &feeder) != 0) {
+        return -1;
+    }
+
+    // The sampling loop's cadence; one more poll once the line and UART are empty.
+    next_poll_ms = feeder.start_ms;
+    for (;;) {
+        double poll_start_ms;
+        int drained;
+
+        next_poll_ms += (double)g_opt.poll_ms;
+        SleepUntilMs(next_poll_ms);
+        (void)GPS_GetStats(&stats);
+        drained = feeder.done && stats.rx_bytes_total == feeder.sent;
+
+        poll_start_ms = NowMs();
+        GPS_Poll();
+        if (polls < REPLAY_MAX_POLLS) {
+            g_poll_us[polls++] = (NowMs() - poll_start_ms) * 1000.0;
+        }
+        if (ttff_ms < 0.0 && GPS_ReadFix(&fix) == 0) {
+            ttff_ms = NowMs() - feeder.start_ms;
+        }
+        if (drained) {
+            break;
+        }
+    }
+    elapsed_ms = NowMs() - feeder.start_ms;
+    pthread_join(thread, NULL);
+    (void)GPS_GetStats(&stats);
+
+    // Parser cost alone: the whole capture straight through ProcessGPSData.
+    parse_ms = NowMs();
+    GPS_ProcessBytes(stream.bytes, (int)stream.len);
+    parse_ms = NowMs() - parse_ms;
+
+    seen = stats.nmea_parsed + stats.nmea_skipped + stats.nmea_checksum_errors;
+    fprintf(g_out, "{\"capture\":\"%s\",\"summary\":\"%s\",\"baudrate\":%u,\"rate_hz\":%u,\"epochs\":%u,"
+            "\"epoch_bytes\":%u,\"line_load\":%.2f,\"line_lag_ms\":%.0f,\"elapsed_ms\":%.0f,"
+            "\"bytes_sent\":%u,\"sentences_sent\":%u,\"useful_sent\":%u,\"useful_intact\":%u,\"noise_events\":%u,"
+            "\"parsed\":%u,\"skipped\":%u,\"checksum_errors\":%u,\"useful_lost\":%d,\"sentences_per_s\":%.1f,",
+            capture->name, capture->summary, baudrate, g_opt.rate_hz, stream.epochs,
+            stream.epochs > 0U ? stream.len / stream.epochs : 0U,
+            (double)stream.len * 10.0 / ((double)baudrate * (double)g_opt.seconds), feeder.lag_ms, elapsed_ms,
+            feeder.sent, stream.sentences, stream.useful, stream.useful_intact, stream.noise_events,
+            stats.nmea_parsed, stats.nmea_skipped, stats.nmea_checksum_errors,
+            (int)stream.useful_intact - (int)stats.nmea_parsed,
+            elapsed_ms > 0.0 ? (double)seen * 1000.0 / elapsed_ms : 0.0);
+    fprintf(g_out, "\"fifo_size\":%u,\"fifo_high_watermark\":%u,\"fifo_dropped_bytes\":%u,\"resync_events\":%u,"
+            "\"uart_backlog_max\":%u,\"uart_overrun_bytes\":%u,\"ttff_ms\":%.0f,\"fix_after_ms\":%u,"
+            "\"poll_ms\":%u,\"polls\":%u,\"poll_us_mean\":%.1f,\"poll_us_p95\":%.1f,\"poll_us_max\":%.1f,"
+            "\"parser_sentences_per_cpu_s\":%.0f,\"receiver_config\":\"%s\",\"receiver_tx_bytes\":%u}\n",
+            (unsigned int)FIFO_SIZE, stats.fifo_high_watermark, stats.fifo_dropped_bytes, stats.resync_events,
+            feeder.backlog_max, feeder.overrun_bytes, ttff_ms, g_opt.fix_after_ms,
+            g_opt.poll_ms, polls, Mean(g_poll_us, polls), Percentile(g_poll_us, polls, 0.95),
+            Percentile(g_poll_us, polls, 1.0),
+            parse_ms > 0.0 ? (double)stream.sentences * 1000.0 / parse_ms : 0.0,
+            GPS_ReceiverConfigStateName(stats.receiver_config_state), feeder.tx_bytes);
+    fflush(g_out);
+    return 0;
+}
+
+// ==================== Main ====================
+
+static void Usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [--capture substr] [--file PATH] [--baud N[,N...]] [--seconds N] [--rate-hz N]\n"
+            "          [--poll-ms N] [--uart-rx-bytes N] [--noise-permille N] [--fix-after-ms N] [--seed N]\n"
+            "          [--list]\n",
+            name);
+}
+
+static int ParseBauds(const char *value)
+{
+    const char *p = value;
+
+    g_opt.baud_count = 0U;
+    while (*p != '\0' && g_opt.baud_count < REPLAY_MAX_BAUDS) {
+        char *end;
+        unsigned long baud = strtoul(p, &end, 10);
+
+        if (end == p || baud < 1200UL) {
+            return -1;
+        }
+        g_opt.bauds[g_opt.baud_count++] = (unsigned int)baud;
+        p = *end == ',' ? end + 1 : end;
+    }
+    return (*p == '\0' && g_opt.baud_count > 0U) ? 0 : -1;
+}
+
+static int ParseOptions(int argc, char **argv, int *list)
+{
+    int a;
+
+    for (a = 1; a < argc; ++a) {
+        const char *arg = argv[a];
+        const char *value = a + 1 < argc ? argv[a + 1] : NULL;
+
+        if (strcmp(arg, "--list") == 0) {
+            *list = 1;
+            continue;
+        }
+        if (value == NULL) {
+            return -1;
+        }
+        ++a;
+        if (strcmp(arg, "--capture") == 0) {
+            g_opt.filter = value;
+        } else if (strcmp(arg, "--file") == 0) {
+            g_opt.file = value;
+        } else if (strcmp(arg, "--baud") == 0) {
+            if (ParseBauds(value) != 0) {
+                return -1;
+            }
+        } else if (strcmp(arg, "--seconds") == 0) {
+            g_opt.seconds = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--rate-hz") == 0) {
+            g_opt.rate_hz = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--poll-ms") == 0) {
+            g_opt.poll_ms = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--uart-rx-bytes") == 0) {
+            g_opt.uart_rx_bytes = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--noise-permille") == 0) {
+            g_opt.noise_permille = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--fix-after-ms") == 0) {
+            g_opt.fix_after_ms = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--seed") == 0) {
+            g_opt.seed = (unsigned int)strtoul(value, NULL, 10);
+        } else {
+            return -1;
+        }
+    }
+    if (g_opt.seconds == 0U || g_opt.rate_hz == 0U || g_opt.rate_hz > 20U || g_opt.poll_ms == 0U ||
+        g_opt.seconds * g_opt.rate_hz > REPLAY_MAX_EPOCHS || g_opt.noise_permille > 1000U) {
+        return -1;
+    }
+    return 0;
+}
+
+static int RunCapture(const ReplayCapture *capture, unsigned int baudrate)
+{
+    pid_t pid;
+    int status = 0;
+
+    fprintf(stderr, "[REPLAY] %s @ %u\n", capture->name, baudrate);
+    pid = fork();
+    if (pid < 0) {
+        return -1;
+    }
+    if (pid == 0) {
+        _exit(RunReplay(capture, baudrate) == 0 ? 0 : 1);
+    }
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        fprintf(stderr, "[REPLAY] %s @ %u failed (status 0x%x)\n", capture->name, baudrate, (unsigned int)status);
+        return -1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int failures = 0U;
+    unsigned int i;
+    unsigned int b;
+    int list = 0;
+
+    if (ParseOptions(argc, argv, &list) != 0) {
+        Usage(argv[0]);
+        return 2;
+    }
+    if (list) {
+        for (i = 0U; i < sizeof(kCaptures) / sizeof(kCaptures[0]); ++i) {
+            printf("%-12s %s\n", kCaptures[i].name, kCaptures[i].summary);
+        }
+        return 0;
+    }
+    if (g_opt.file != NULL && LoadCaptureFile(g_opt.file) != 0) {
+        return 2;
+    }
+
+    // Results keep the real stdout; firmware printf output is moved to stderr.
+    g_out = fdopen(dup(STDOUT_FILENO), "w");
+    if (g_out == NULL || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        return 1;
+    }
+    // The line is paced by the host clock, so firmware time must not be scaled.
+    unsetenv("LANDSLIDE_HOST_TIME_SCALE");
+
+    fprintf(g_out, "{\"meta\":\"nmea_replay_sim\",\"seconds\":%u,\"rate_hz\":%u,\"poll_ms\":%u,"
+            "\"uart_rx_bytes\":%u,\"noise_permille\":%u,\"fix_after_ms\":%u,\"seed\":%u,\"file\":\"%s\","
+            "\"fifo_size\":%u,\"receiver_configure\":%d,\"nmea_output_period_s\":%u}\n",
+            g_opt.seconds, g_opt.rate_hz, g_opt.poll_ms, g_opt.uart_rx_bytes, g_opt.noise_permille,
+            g_opt.fix_after_ms, g_opt.seed, g_opt.file != NULL ? g_opt.file : "",
+            (unsigned int)FIFO_SIZE, GPS_RECEIVER_CONFIGURE, (unsigned int)GPS_NMEA_OUTPUT_PERIOD_S);
+    fflush(g_out);
+
+    for (b = 0U; b < g_opt.baud_count; ++b) {
+        for (i = 0U; i < sizeof(kCaptures) / sizeof(kCaptures[0]); ++i) {
+            if (g_opt.filter != NULL && strstr(kCaptures[i].name, g_opt.filter) == NULL) {
+                continue;
+            }
+            failures += (unsigned int)(RunCapture(&kCaptures[i], g_opt.bauds[b]) != 0);
+        }
+        if (g_opt.file != NULL && (g_opt.filter == NULL || strstr(kFileCapture.name, g_opt.filter) != NULL)) {
+            failures += (unsigned int)(RunCapture(&kFileCapture, g_opt.bauds[b]) != 0);
+        }
+    }
+    return failures > 0U ? 1 : 0;
+}
@@ -0,0 +1,537 @@
+/*
+ * RS485 Slave Farm Load Test
+ * Runs the firmware's RS485 stack (SC16IS752 driver, Modbus RTU master,
+ * field sensor read plans, YX75R alarm writes) against the virtual slave farm
+ * in modbus_sim.c, to measure sampling-cycle time and what faults cost under
+ * realistic and pathological bus conditions.
+ *
+ * Usage: rs485_farm_sim [--scenario substr] [--cycles N] [--seed N]
+ *                       [--i2c-khz N] [--xtal-hz N] [--work-dir DIR] [--list]
+ *
+ * The farm holds an RS-ECTH soil probe (or an RS-WS one without EC) on
+ * channel 1 and an RS-DIP tilt sensor on channel 2 at the configured
+ * addresses and baud rate, plus a YX75R alarm at its own speed on the alarm
+ * channel. Each scenario runs in a forked child, so every one starts from
+ * fresh driver state (read plans, learned timing), and calls FieldRs485_Read
+ * --cycles times back to back. Register values move every cycle and the
+ * decoded readings are checked against them.
+ *
+ * Output is JSON lines: one "meta" record, then one record per scenario with
+ * the cycle time distribution, per-device success, the failure cost (mean
+ * cycle time with a device missing minus a complete cycle), recovery after
+ * an outage ends, what the farm saw on the wire and the adaptive timing the
+ * master learned per slave. Firmware log lines go to stderr.
+ *
+ * With ENABLE_RS485_ALARM = 0 FieldAlarmRs485_* returns at once, so the alarm
+ * scenario replays its light and audio writes through the Modbus master; with
+ * RS485_TILT_AUTO_PROBE = 0 the tilt probe is compiled out and a tilt at the
+ * wrong speed stays lost, as it would on a production build.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "lz_hardware.h"
+#include "los_task.h"
+#include "config/app_config.h"
+#include "drivers/sensors/field_alarm_rs485.h"
+#include "drivers/sensors/field_sensors_rs485.h"
+#include "drivers/sensors/rs485_modbus.h"
+#include "drivers/sensors/sc16is752_driver.h"
+#include "modbus_sim.h"
+
+#define FARM_MAX_CYCLES     2000U
+#define FARM_PATH_BYTES     512U
+
+#ifndef RS485_ALARM_RESPONSE_TIMEOUT_MS
+#define RS485_ALARM_RESPONSE_TIMEOUT_MS 800
+#endif
+
+// YX75R registers, as field_alarm_rs485.c drives them
+#define YX75R_LIGHT_REG         0x00C2U
+#define YX75R_LIGHT_FLASH       0x0003U
+#define YX75R_LIGHT_OFF         0x0006U
+#define YX75R_PLAY_FILE_REG     0x300FU
+#define YX75R_PLAY_FILE_VALUE   0x0101U
+#define YX75R_STOP_REG          0x0016U
+#define YX75R_STOP_VALUE        0x0001U
+
+typedef struct {
+    const char *name;
+    const char *summary;
+    unsigned char soil_has_ec;      // RS-ECTH (moisture, temperature, EC) or RS-WS (no EC)
+    unsigned int latency_ms;
+    unsigned int jitter_ms;
+    unsigned int drop_permille;
+    unsigned int crc_permille;
+    unsigned int exception_permille;
+    unsigned int tilt_baudrate;     // 0 = RS485_BAUDRATE
+    unsigned char tilt_clone;       // A second slave at the tilt address on the same segment
+    unsigned char tilt_outage;      // Tilt unpowered for the second quarter of the run
+    unsigned char alarm;            // Toggle the alarm after every read
+} FarmScenario;
+
+static const FarmScenario kScenarios[] = {
+    {"nominal", "RS-ECTH + RS-DIP, 15+-10 ms turnaround", 1U, 15U, 10U, 0U, 0U, 0U, 0U, 0U, 0U, 0U},
+    {"rs_ws", "soil without EC: wide read rejected, split plan", 0U, 15U, 10U, 0U, 0U, 0U, 0U, 0U, 0U, 0U},
+    {"slow", "250+-200 ms turnaround, adaptive timeout near its ceiling", 1U, 250U, 200U, 0U, 0U, 0U, 0U, 0U, 0U, 0U},
+    {"noisy", "3% corrupted and 3% lost replies", 1U, 15U, 10U, 30U, 30U, 0U, 0U, 0U, 0U, 0U},
+    {"busy", "8% slave-busy exceptions", 1U, 15U, 10U, 0U, 0U, 80U, 0U, 0U, 0U, 0U},
+    {"tilt_outage", "tilt unpowered for cycles N/4..N/2", 1U, 15U, 10U, 0U, 0U, 0U, 0U, 0U, 1U, 0U},
+    {"tilt_wrong_baud", "tilt left at 9600 baud", 1U, 15U, 10U, 0U, 0U, 0U, 9600U, 0U, 0U, 0U},
+    {"addr_clash", "two tilt sensors at one address", 1U, 15U, 10U, 0U, 0U, 0U, 0U, 1U, 0U, 0U},
+    {"alarm", "YX75R toggled on the soil segment between reads", 1U, 15U, 10U, 0U, 0U, 0U, 0U, 0U, 0U, 1U},
+};
+
+typedef struct {
+    const char *filter;
+    const char *work_dir;
+    unsigned int cycles;
+    unsigned int seed;
+    unsigned int i2c_khz;
+    unsigned long xtal_hz;
+} FarmOptions;
+
+static FarmOptions g_opt = {
+    .filter = NULL,
+    .work_dir = "rs485_farm_work",
+    .cycles = 30U,
+    .seed = 1U,
+    .i2c_khz = 100U,
+    .xtal_hz = 0UL,
+};
+
+static FILE *g_out = NULL;
+static double g_cycle_ms[FARM_MAX_CYCLES];
+static double g_complete_ms[FARM_MAX_CYCLES];
+static double g_degraded_ms[FARM_MAX_CYCLES];
+static double g_alarm_ms[FARM_MAX_CYCLES];
+
+static double NowMs(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+static int CompareDouble(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+
+    return (x > y) - (x < y);
+}
+
+static double Percentile(double *values, unsigned int count, double fraction)
+{
+    unsigned int index;
+
+    if (count == 0U) {
+        return 0.0;
+    }
+    qsort(values, count, sizeof(values[0]), CompareDouble);
+    index = (unsigned int)(fraction * (double)(count - 1U) + 0.5);
+    return values[index];
+}
+
+static double Mean(const double *values, unsigned int count)
+{
+    double sum = 0.0;
+    unsigned int i;
+
+    for (i = 0U; i < count; ++i) {
+        sum += values[i];
+    }
+    return count > 0U ? sum / (double)count : 0.0;
+}
+
+static int MakeDirs(const char *path)
+{
+    char buffer[FARM_PATH_BYTES];
+    char *p;
+
+    if (snprintf(buffer, sizeof(buffer), "%s", path) >= (int)sizeof(buffer)) {
+        return -1;
+    }
+    for (p = buffer + 1; *p != '\0'; ++p) {
+        if (*p == '/') {
+            *p = '\0';
+            if (mkdir(buffer, 0755) != 0 && errno != EEXIST) {
+                return -1;
+            }
+            *p = '/';
+        }
+    }
+    return (mkdir(buffer, 0755) != 0 && errno != EEXIST) ? -1 : 0;
+}
+
+// ==================== Farm ====================
+
+static ModbusSimSlave *AddSlave(uint8_t channel, uint8_t addr, unsigned int baudrate, uint16_t reg_count,
+                                const FarmScenario *scenario)
+{
+    ModbusSimSlave slave;
+
+    memset(&slave, 0, sizeof(slave));
+    slave.channel = channel;
+    slave.addr = addr;
+    slave.baudrate = baudrate;
+    slave.reg_count = reg_count;
+    slave.latency_ms = scenario->latency_ms;
+    slave.jitter_ms = scenario->jitter_ms;
+    slave.drop_permille = scenario->drop_permille;
+    slave.crc_permille = scenario->crc_permille;
+    slave.exception_permille = scenario->exception_permille;
+    return ModbusSim_AddSlave(&slave);
+}
+
+static int16_t TiltCounts(unsigned int cycle, int base)
+{
+    return (int16_t)(base + (int)(cycle % 40U) - 20);
+}
+
+static void UpdateRegisters(ModbusSimSlave *soil, ModbusSimSlave *tilt, unsigned int cycle)
+{
+    soil->regs[0] = (uint16_t)(250U + (cycle * 7U) % 200U);         // Moisture, 0.1 %
+    soil->regs[1] = (uint16_t)(int16_t)(-35 + (int)(cycle % 90U));  // Temperature, 0.1 C, crosses zero
+    if (soil->reg_count > 2U) {
+        soil->regs[2] = (uint16_t)(800U + cycle);                   // EC, uS/cm
+    }
+    tilt->regs[0] = (uint16_t)TiltCounts(cycle, 120);               // 0.01 deg
+    tilt->regs[1] = (uint16_t)TiltCounts(cycle, -310);
+    tilt->regs[2] = (uint16_t)TiltCounts(cycle, 9000);
+}
+
+static int Differs(float got, uint16_t raw, float scale, int is_signed)
+{
+    float want = (is_signed ? (float)(int16_t)raw : (float)raw) * scale;
+
+    return fabsf(got - want) > scale * 0.5f;
+}
+
+static unsigned int CheckValues(const FieldRs485Readings *readings, const ModbusSimSlave *soil,
+                                const ModbusSimSlave *tilt)
+{
+    unsigned int errors = 0U;
+
+    if (readings->soil_valid) {
+        errors += (unsigned int)Differs(readings->soil_moisture_pct, soil->regs[0], RS485_SOIL_MOISTURE_SCALE, 0);
+        errors += (unsigned int)Differs(readings->soil_temperature_c, soil->regs[1], RS485_SOIL_TEMPERATURE_SCALE, 1);
+    }
+    if (readings->soil_ec_valid) {
+        errors += (unsigned int)Differs(readings->soil_ec_us_cm, soil->regs[2], RS485_SOIL_EC_SCALE, 0);
+    }
+    if (readings->tilt_valid) {
+        errors += (unsigned int)Differs(readings->tilt_x_deg, tilt->regs[0], RS485_TILT_SCALE, 1);
+        errors += (unsigned int)Differs(readings->tilt_y_deg, tilt->regs[1], RS485_TILT_SCALE, 1);
+        errors += (unsigned int)Differs(readings->tilt_z_deg, tilt->regs[2], RS485_TILT_SCALE, 1);
+    }
+    return errors;
+}
+
+static int SetAlarm(int enabled)
+{
+#if ENABLE_RS485_ALARM
+    return FieldAlarmRs485_SetEnabled(enabled);
+#else
+    int first_ret;
+    int second_ret;
+
+    // FieldAlarmRs485_SetEnabled is compiled out; send the same two writes.
+    RS485_ModbusLockBus();
+    SC16IS752_SetClockHz(SC16IS752_XTAL_HZ);
+    (void)SC16IS752_UartInit((Sc16is752Channel)RS485_ALARM_CHANNEL, RS485_ALARM_BAUDRATE);
+    first_ret = RS485_ModbusWriteSingleRegisterOnChannel(
+        RS485_ALARM_CHANNEL, RS485_ALARM_ADDR, YX75R_LIGHT_REG,
+        enabled ? YX75R_LIGHT_FLASH : YX75R_LIGHT_OFF, RS485_ALARM_RESPONSE_TIMEOUT_MS);
+    LOS_Msleep(RS485_ModbusGetInterRequestGapMs(RS485_ALARM_CHANNEL, RS485_ALARM_ADDR));
+    second_ret = RS485_ModbusWriteSingleRegisterOnChannel(
+        RS485_ALARM_CHANNEL, RS485_ALARM_ADDR,
+        enabled ? YX75R_PLAY_FILE_REG : YX75R_STOP_REG,
+        enabled ? YX75R_PLAY_FILE_VALUE : YX75R_STOP_VALUE, RS485_ALARM_RESPONSE_TIMEOUT_MS);
+    RS485_ModbusUnlockBus();
+    return second_ret != 0 ? second_ret : first_ret;
+#endif
+}
+
+// ==================== Scenario ====================
+
+static void ReportTiming(void)
+{
+    unsigned int count = RS485_ModbusGetSlaveTimingCount();
+    unsigned int i;
+
+    fprintf(g_out, "\"timing\":[");
+    for (i = 0U; i < count; ++i) {
+        Rs485SlaveTiming timing;
+
+        if (RS485_ModbusGetSlaveTiming(i, &timing) != 0) {
+            continue;
+        }
+        fprintf(g_out, "%s{\"ch\":%u,\"addr\":%u,\"samples\":%u,\"latency_avg_ms\":%u,\"latency_jitter_ms\":%u,"
+                "\"latency_max_ms\":%u,\"timeout_ms\":%u,\"gap_ms\":%u,\"timeouts\":%u,\"errors\":%u}",
+                i > 0U ? "," : "", timing.channel, timing.slave_addr, timing.samples, timing.latency_avg_ms,
+                timing.latency_jitter_ms, timing.latency_max_ms, timing.timeout_ms, timing.gap_ms,
+                timing.timeouts, timing.errors);
+    }
+    fprintf(g_out, "]");
+}
+
+static int RunScenario(const FarmScenario *scenario)
+{
+    ModbusSimConfig config = {
+        .xtal_hz = g_opt.xtal_hz,
+        .i2c_khz = g_opt.i2c_khz,
+        .seed = g_opt.seed,
+    };
+    char kv_dir[FARM_PATH_BYTES];
+    ModbusSimSlave *soil;
+    ModbusSimSlave *tilt;
+    ModbusSimSlave *clone = NULL;
+    ModbusSimStats bus;
+    unsigned int outage_start = g_opt.cycles / 4U;
+    unsigned int outage_end = g_opt.cycles / 2U;
+    unsigned int soil_ok = 0U;
+    unsigned int soil_ec_ok = 0U;
+    unsigned int tilt_ok = 0U;
+    unsigned int complete = 0U;
+    unsigned int degraded = 0U;
+    unsigned int value_errors = 0U;
+    unsigned int alarm_calls = 0U;
+    unsigned int alarm_ok = 0U;
+    int recovery_cycles = -1;
+    double recovery_ms = -1.0;
+    double revived_at_ms = 0.0;
+    double started_ms;
+    double elapsed_ms;
+    unsigned int cycle;
+
+    // Learned timing persists through kv_store; keep it per scenario.
+    snprintf(kv_dir, sizeof(kv_dir), "%s/%s", g_opt.work_dir, scenario->name);
+    if (MakeDirs(kv_dir) != 0) {
+        fprintf(stderr, "[FARM] cannot create %s\n", kv_dir);
+        return -1;
+    }
+    setenv("LANDSLIDE_HOST_KV_DIR", kv_dir, 1);
+
+    if (ModbusSim_Attach(I2C_IDX, SC16IS752_I2C_ADDR, &config) != 0) {
+        return -1;
+    }
+    soil = AddSlave(RS485_SOIL_CHANNEL, RS485_SOIL_ADDR, RS485_BAUDRATE, scenario->soil_has_ec ? 3U : 2U, scenario);
+    tilt = AddSlave(RS485_TILT_CHANNEL, RS485_TILT_ADDR,
+                    scenario->tilt_baudrate != 0U ? scenario->tilt_baudrate : RS485_BAUDRATE,
+                    RS485_TILT_REG_COUNT, scenario);
+    if (scenario->tilt_clone) {
+        clone = AddSlave(RS485_TILT_CHANNEL, RS485_TILT_ADDR, RS485_BAUDRATE, RS485_TILT_REG_COUNT, scenario);
+    }
+    if (scenario->alarm) {
+        ModbusSimSlave *alarm = AddSlave(RS485_ALARM_CHANNEL, RS485_ALARM_ADDR, RS485_ALARM_BAUDRATE, 0U, scenario);
+
+        if (alarm != NULL) {
+            alarm->writable = 1U;
+        }
+    }
+    if (soil == NULL || tilt == NULL || (scenario->tilt_clone && clone == NULL)) {
+        return -1;
+    }
+
+    if (FieldRs485_Init() != 0) {
+        fprintf(stderr, "[FARM] RS485 init failed\n");
+        return -1;
+    }
+    RS485_ModbusResetSlaveTiming();
+    ModbusSim_ResetStats();
+
+    started_ms = NowMs();
+    for (cycle = 0U; cycle < g_opt.cycles; ++cycle) {
+        FieldRs485Readings readings;
+        double cycle_start_ms;
+        double cycle_ms;
+        int tilt_expected;
+
+        if (scenario->tilt_outage) {
+            tilt->silent = (unsigned char)(cycle >= outage_start && cycle < outage_end);
+        }
+        UpdateRegisters(soil, tilt, cycle);
+        if (clone != NULL) {
+            memcpy(clone->regs, tilt->regs, sizeof(clone->regs));
+        }
+
+        cycle_start_ms = NowMs();
+        if (scenario->tilt_outage && cycle == outage_end) {
+            revived_at_ms = cycle_start_ms;
+        }
+        (void)FieldRs485_Read(&readings);
+        cycle_ms = NowMs() - cycle_start_ms;
+        g_cycle_ms[cycle] = cycle_ms;
+
+        soil_ok += (unsigned int)(readings.soil_valid != 0);
+        soil_ec_ok += (unsigned int)(readings.soil_ec_valid != 0);
+        tilt_ok += (unsigned int)(readings.tilt_valid != 0);
+        value_errors += CheckValues(&readings, soil, tilt);
+        tilt_expected = scenario->tilt_baudrate == 0U || scenario->tilt_baudrate == RS485_BAUDRATE;
+        if (readings.soil_valid && (readings.tilt_valid || !tilt_expected)) {
+            g_complete_ms[complete++] = cycle_ms;
+        } else {
+            g_degraded_ms[degraded++] = cycle_ms;
+        }
+        if (scenario->tilt_outage && cycle >= outage_end && recovery_cycles < 0 && readings.tilt_valid) {
+            recovery_cycles = (int)(cycle - outage_end);
+            recovery_ms = NowMs() - revived_at_ms;
+        }
+
+        if (scenario->alarm) {
+            double alarm_start_ms = NowMs();
+
+            alarm_ok += (unsigned int)(SetAlarm((cycle & 1U) == 0U) == 0);
+            g_alarm_ms[alarm_calls++] = NowMs() - alarm_start_ms;
+        }
+    }
+    elapsed_ms = NowMs() - started_ms;
+    ModbusSim_GetStats(&bus);
+
+    fprintf(g_out, "{\"scenario\":\"%s\",\"summary\":\"%s\",\"cycles\":%u,\"elapsed_ms\":%.0f,"
+            "\"cycle_ms_mean\":%.1f,\"cycle_ms_p50\":%.1f,\"cycle_ms_p95\":%.1f,\"cycle_ms_max\":%.1f,"
+            "\"soil_ok\":%u,\"soil_ec_ok\":%u,\"tilt_ok\":%u,\"value_errors\":%u,"
+            "\"complete_cycles\":%u,\"complete_ms_mean\":%.1f,\"degraded_cycles\":%u,\"degraded_ms_mean\":%.1f,"
+            "\"failure_cost_ms\":%.1f,",
+            scenario->name, scenario->summary, g_opt.cycles, elapsed_ms,
+            Mean(g_cycle_ms, g_opt.cycles),
+            Percentile(g_cycle_ms, g_opt.cycles, 0.50),
+            Percentile(g_cycle_ms, g_opt.cycles, 0.95),
+            Percentile(g_cycle_ms, g_opt.cycles, 1.0),
+            soil_ok, soil_ec_ok, tilt_ok, value_errors,
+            complete, Mean(g_complete_ms, complete), degraded, Mean(g_degraded_ms, degraded),
+            (complete > 0U && degraded > 0U) ? Mean(g_degraded_ms, degraded) - Mean(g_complete_ms, complete) : 0.0);
+    if (scenario->tilt_outage) {
+        fprintf(g_out, "\"outage_cycles\":%u,\"recovery_cycles\":%d,\"recovery_ms\":%.1f,",
+                outage_end - outage_start, recovery_cycles, recovery_ms);
+    }
+    if (scenario->alarm) {
+        fprintf(g_out, "\"alarm_path\":\"%s\",\"alarm_calls\":%u,\"alarm_ok\":%u,\"alarm_ms_mean\":%.1f,"
+                "\"alarm_ms_max\":%.1f,",
+                ENABLE_RS485_ALARM ? "field_alarm" : "modbus_replay", alarm_calls, alarm_ok,
+                Mean(g_alarm_ms, alarm_calls), Percentile(g_alarm_ms, alarm_calls, 1.0));
+    }
+    fprintf(g_out, "\"bus\":{\"requests\":%u,\"responses\":%u,\"bad_requests\":%u,\"unanswered\":%u,"
+            "\"baud_mismatch\":%u,\"dropped\":%u,\"crc_corrupted\":%u,\"exceptions\":%u,\"collisions\":%u,"
+            "\"rx_overruns\":%u,\"i2c_transfers\":%u,\"i2c_busy_ms\":%.1f},",
+            bus.requests, bus.responses, bus.bad_requests, bus.unanswered, bus.baud_mismatch, bus.dropped,
+            bus.crc_corrupted, bus.exceptions, bus.collisions, bus.rx_overruns, bus.i2c_transfers,
+            (double)bus.i2c_busy_us / 1000.0);
+    ReportTiming();
+    fprintf(g_out, "}\n");
+    fflush(g_out);
+    return 0;
+}
+
+// ==================== Main ====================
+
+static void Usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [--scenario substr] [--cycles N] [--seed N] [--i2c-khz N] [--xtal-hz N]\n"
+            "          [--work-dir DIR] [--list]\n",
+            name);
+}
+
+static int ParseOptions(int argc, char **argv, int *list)
+{
+    int a;
+
+    for (a = 1; a < argc; ++a) {
+        const char *arg = argv[a];
+        const char *value = a + 1 < argc ? argv[a + 1] : NULL;
+
+        if (strcmp(arg, "--list") == 0) {
+            *list = 1;
+            continue;
+        }
+        if (value == NULL) {
+            return -1;
+        }
+        ++a;
+        if (strcmp(arg, "--scenario") == 0) {
+            g_opt.filter = value;
+        } else if (strcmp(arg, "--cycles") == 0) {
+            g_opt.cycles = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--seed") == 0) {
+            g_opt.seed = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--i2c-khz") == 0) {
+            g_opt.i2c_khz = (unsigned int)strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--xtal-hz") == 0) {
+            g_opt.xtal_hz = strtoul(value, NULL, 10);
+        } else if (strcmp(arg, "--work-dir") == 0) {
+            g_opt.work_dir = value;
+        } else {
+            return -1;
+        }
+    }
+    return (g_opt.cycles == 0U || g_opt.cycles > FARM_MAX_CYCLES) ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int failures = 0U;
+    unsigned int i;
+    int list = 0;
+
+    if (ParseOptions(argc, argv, &list) != 0) {
+        Usage(argv[0]);
+        return 2;
+    }
+    if (list) {
+        for (i = 0U; i < sizeof(kScenarios) / sizeof(kScenarios[0]); ++i) {
+            printf("%-16s %s\n", kScenarios[i].name, kScenarios[i].summary);
+        }
+        return 0;
+    }
+
+    // Results keep the real stdout; firmware printf output is moved to stderr.
+    g_out = fdopen(dup(STDOUT_FILENO), "w");
+    if (g_out == NULL || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        return 1;
+    }
+    // The farm's clock is the host clock, so firmware time must not be scaled.
+    unsetenv("LANDSLIDE_HOST_TIME_SCALE");
+
+    fprintf(g_out, "{\"meta\":\"rs485_farm_sim\",\"cycles\":%u,\"seed\":%u,\"i2c_khz\":%u,\"xtal_hz\":%lu,"
+            "\"baudrate\":%u,\"alarm_baudrate\":%u,\"response_timeout_ms\":%u,\"adaptive_timing\":%d,"
+            "\"soil_coalesce\":%d,\"tilt_auto_probe\":%d,\"alarm_enabled\":%d}\n",
+            g_opt.cycles, g_opt.seed, g_opt.i2c_khz,
+            g_opt.xtal_hz != 0UL ? g_opt.xtal_hz : (unsigned long)SC16IS752_XTAL_HZ,
+            (unsigned int)RS485_BAUDRATE, (unsigned int)RS485_ALARM_BAUDRATE,
+            (unsigned int)RS485_RESPONSE_TIMEOUT_MS, RS485_ADAPTIVE_TIMING, RS485_SOIL_COALESCE_READS,
+            RS485_TILT_AUTO_PROBE, ENABLE_RS485_ALARM);
+    fflush(g_out);
+
+    for (i = 0U; i < sizeof(kScenarios) / sizeof(kScenarios[0]); ++i) {
+        const FarmScenario *scenario = &kScenarios[i];
+        pid_t pid;
+        int status = 0;
+
+        if (g_opt.filter != NULL && strstr(scenario->name, g_opt.filter) == NULL) {
+            continue;
+        }
+        fprintf(stderr, "[FARM] %s\n", scenario->name);
+        pid = fork();
+        if (pid < 0) {
+            return 1;
+        }
+        if (pid == 0) {
+            _exit(RunScenario(scenario) == 0 ? 0 : 1);
+        }
+        if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            fprintf(stderr, "[FARM] scenario %s failed (status 0x%x)\n", scenario->name, (unsigned int)status);
+            failures++;
+        }
+    }
+    return failures > 0U ? 1 : 0;
+}
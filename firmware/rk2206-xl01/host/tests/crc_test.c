@@ -0,0 +1,127 @@
+/*
+ * CRC Tests
+ * Checks the table-driven CRC16/Modbus, CRC8/Sensirion and CRC32/IEEE against
+ * the published check values and against the bitwise references, over
+ * seeded random buffers at every length up to a few table rows and split at
+ * arbitrary points through the Update entry points.
+ *
+ * Usage: crc_test; exit status 0 when every check passes.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "utils/crc.h"
+
+#define CRC_TEST_SEED       0xC0FFEE11U
+#define CRC_TEST_MAX_BYTES  600U
+#define CRC_TEST_ROUNDS     8U
+
+static unsigned int g_checks = 0U;
+static unsigned int g_failures = 0U;
+static uint32_t g_rng = CRC_TEST_SEED;
+
+static uint32_t NextRandom(void)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return g_rng;
+}
+
+static void Expect(int ok, const char *what, unsigned long got, unsigned long want, unsigned int len)
+{
+    g_checks++;
+    if (!ok) {
+        g_failures++;
+        printf("[FAIL] %s len=%u: got 0x%lX want 0x%lX\n", what, len, got, want);
+    }
+}
+
+static void TestCheckValues(void)
+{
+    static const uint8_t check[] = "123456789";
+    static const uint8_t sht30_word[] = {0xBEU, 0xEFU};  // Sensirion datasheet example
+    unsigned int len = (unsigned int)strlen((const char *)check);
+
+    Expect(Crc_Modbus16(check, len) == 0x4B37U, "crc16 check", Crc_Modbus16(check, len), 0x4B37U, len);
+    Expect(Crc_Modbus16Bitwise(check, len) == 0x4B37U, "crc16 bitwise check",
+           Crc_Modbus16Bitwise(check, len), 0x4B37U, len);
+    Expect(Crc_Sensirion8(check, len) == 0xF7U, "crc8 check", Crc_Sensirion8(check, len), 0xF7U, len);
+    Expect(Crc_Sensirion8Bitwise(check, len) == 0xF7U, "crc8 bitwise check",
+           Crc_Sensirion8Bitwise(check, len), 0xF7U, len);
+    Expect(Crc_Sensirion8(sht30_word, 2U) == 0x92U, "crc8 sht30 word", Crc_Sensirion8(sht30_word, 2U), 0x92U, 2U);
+    Expect(Crc_Ieee32(check, len) == 0xCBF43926UL, "crc32 check", Crc_Ieee32(check, len), 0xCBF43926UL, len);
+    Expect(Crc_Ieee32Bitwise(check, len) == 0xCBF43926UL, "crc32 bitwise check",
+           Crc_Ieee32Bitwise(check, len), 0xCBF43926UL, len);
+
+    // Empty input returns the init value (after the final XOR for CRC32).
+    Expect(Crc_Modbus16(check, 0U) == CRC16_MODBUS_INIT, "crc16 empty", Crc_Modbus16(check, 0U), CRC16_MODBUS_INIT, 0U);
+    Expect(Crc_Sensirion8(check, 0U) == CRC8_SENSIRION_INIT, "crc8 empty",
+           Crc_Sensirion8(check, 0U), CRC8_SENSIRION_INIT, 0U);
+    Expect(Crc_Ieee32(check, 0U) == 0UL, "crc32 empty", Crc_Ieee32(check, 0U), 0UL, 0U);
+}
+
+static void TestAgainstReference(void)
+{
+    static uint8_t buffer[CRC_TEST_MAX_BYTES + 3U];
+    unsigned int round;
+
+    for (round = 0U; round < CRC_TEST_ROUNDS; ++round) {
+        // Odd offsets catch any word-at-a-time shortcut that assumes alignment.
+        uint8_t *data = buffer + (round % 4U);
+        unsigned int len;
+        unsigned int i;
+
+        for (i = 0U; i < CRC_TEST_MAX_BYTES; ++i) {
+            data[i] = (uint8_t)NextRandom();
+        }
+        for (len = 0U; len <= CRC_TEST_MAX_BYTES; ++len) {
+            uint16_t crc16 = Crc_Modbus16(data, len);
+            uint8_t crc8 = Crc_Sensirion8(data, len);
+            uint32_t crc32 = Crc_Ieee32(data, len);
+            unsigned int split = len > 0U ? NextRandom() % len : 0U;
+
+            Expect(crc16 == Crc_Modbus16Bitwise(data, len), "crc16 vs bitwise", crc16, Crc_Modbus16Bitwise(data, len), len);
+            Expect(crc8 == Crc_Sensirion8Bitwise(data, len), "crc8 vs bitwise", crc8, Crc_Sensirion8Bitwise(data, len), len);
+            Expect(crc32 == Crc_Ieee32Bitwise(data, len), "crc32 vs bitwise", crc32, Crc_Ieee32Bitwise(data, len), len);
+
+            // Streaming in two pieces gives the one-shot value.
+            Expect(Crc_Modbus16Update(Crc_Modbus16Update(CRC16_MODBUS_INIT, data, split), data + split, len - split) ==
+                   crc16, "crc16 split", split, crc16, len);
+            Expect(Crc_Sensirion8Update(Crc_Sensirion8Update(CRC8_SENSIRION_INIT, data, split), data + split,
+                                        len - split) == crc8, "crc8 split", split, crc8, len);
+            Expect(Crc_Ieee32Final(Crc_Ieee32Update(Crc_Ieee32Update(CRC32_IEEE_INIT, data, split), data + split,
+                                                    len - split)) == crc32, "crc32 split", split, crc32, len);
+        }
+    }
+}
+
+static void TestModbusResidue(void)
+{
+    uint8_t frame[64];
+    unsigned int len;
+
+    // A frame followed by its own little-endian CRC folds to 0.
+    for (len = 1U; len <= sizeof(frame) - 2U; ++len) {
+        unsigned int i;
+        uint16_t crc;
+
+        for (i = 0U; i < len; ++i) {
+            frame[i] = (uint8_t)NextRandom();
+        }
+        crc = Crc_Modbus16(frame, len);
+        frame[len] = (uint8_t)(crc & 0xFFU);
+        frame[len + 1U] = (uint8_t)(crc >> 8);
+        Expect(Crc_Modbus16(frame, len + 2U) == 0U, "crc16 residue", Crc_Modbus16(frame, len + 2U), 0U, len);
+    }
+}
+
+int main(void)
+{
+    TestCheckValues();
+    TestAgainstReference();
+    TestModbusResidue();
+
+    printf("[CRC] %u checks, %u failed\n", g_checks, g_failures);
+    return g_failures == 0U ? 0 : 1;
+}
@@ -0,0 +1,319 @@
+/*
+ * Flash Log Tests
+ * Drives utils/flash_log through flash_sim: mount on blank and foreign
+ * regions, wrap with iterator loss accounting, power cut at every byte of an
+ * append followed by a remount, and a damaged sector header.
+ *
+ * Usage: flash_log_test [image path]; exit status 0 when every check passes.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "flash_sim.h"
+#include "utils/flash_log.h"
+
+#define TEST_SECTOR_BYTES   512U
+#define TEST_SECTORS        4U
+#define TEST_PAYLOAD_BYTES  40U     // 52 bytes per record, 9 records per sector
+#define TEST_DEFAULT_IMAGE  "flash_log_test.img"
+
+static const char *g_image = TEST_DEFAULT_IMAGE;
+static unsigned int g_checks = 0U;
+static unsigned int g_failures = 0U;
+
+#define EXPECT(cond) Expect((cond), #cond, __func__, __LINE__)
+
+static int Expect(int ok, const char *what, const char *test, int line)
+{
+    g_checks++;
+    if (!ok) {
+        g_failures++;
+        printf("[FAIL] %s:%d %s\n", test, line, what);
+    }
+    return ok;
+}
+
+// Payload derived from the seq, so a read can be checked without a copy.
+static void FillPayload(uint8_t *data, uint32_t seq)
+{
+    unsigned int i;
+
+    for (i = 0U; i < TEST_PAYLOAD_BYTES; ++i) {
+        data[i] = (uint8_t)(seq * 31U + i);
+    }
+}
+
+static const FlashLogPort *OpenBlank(void)
+{
+    (void)remove(g_image);
+    return FlashSim_Open(g_image, TEST_SECTOR_BYTES, TEST_SECTORS);
+}
+
+// Reopen the image as a reboot does and mount it.
+static const FlashLogPort *Reboot(FlashLog *log)
+{
+    const FlashLogPort *port;
+
+    FlashSim_Close();
+    port = FlashSim_Open(g_image, TEST_SECTOR_BYTES, TEST_SECTORS);
+    if (!EXPECT(port != NULL) || !EXPECT(FlashLog_Mount(log, port) == 0)) {
+        return NULL;
+    }
+    return port;
+}
+
+static int AppendRecords(FlashLog *log, unsigned int count)
+{
+    uint8_t data[TEST_PAYLOAD_BYTES];
+    unsigned int i;
+
+    for (i = 0U; i < count; ++i) {
+        uint32_t seq = 0U;
+
+        FillPayload(data, FlashLog_NextSeq(log));
+        if (FlashLog_Append(log, data, TEST_PAYLOAD_BYTES, &seq) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Read from the iterator to the end. Every record must carry the payload of
+ * its seq and seqs must rise by one, except across it->lost.
+ * @return records read, -1 on a bad record
+ */
+static int DrainAndCheck(const FlashLog *log, FlashLogIterator *it, uint32_t expect_first)
+{
+    uint8_t data[TEST_PAYLOAD_BYTES];
+    uint8_t want[TEST_PAYLOAD_BYTES];
+    uint32_t expect = expect_first;
+    uint32_t lost_before = it->lost;
+    int count = 0;
+    int ret;
+
+    for (;;) {
+        uint16_t size = 0U;
+        uint32_t seq = 0U;
+
+        ret = FlashLog_Next(log, it, data, sizeof(data), &size, &seq);
+        if (ret != 1) {
+            break;
+        }
+        FillPayload(want, seq);
+        expect += it->lost - lost_before;
+        lost_before = it->lost;
+        if (!EXPECT(seq == expect) || !EXPECT(size == TEST_PAYLOAD_BYTES) ||
+            !EXPECT(memcmp(data, want, TEST_PAYLOAD_BYTES) == 0)) {
+            return -1;
+        }
+        expect = seq + 1U;
+        count++;
+    }
+    return EXPECT(ret == 0) ? count : -1;
+}
+
+static void TestBlankRegion(void)
+{
+    FlashLog log;
+    FlashLogIterator it;
+    const FlashLogPort *port = OpenBlank();
+    uint8_t data[TEST_PAYLOAD_BYTES];
+
+    if (!EXPECT(port != NULL)) {
+        return;
+    }
+    EXPECT(FlashLog_Mount(&log, port) == 0);
+    EXPECT(FlashLog_OldestSeq(&log) == FlashLog_NextSeq(&log));
+    FlashLog_Seek(&log, &it, 0U);
+    EXPECT(FlashLog_Next(&log, &it, data, sizeof(data), NULL, NULL) == 0);
+
+    // Formatted once, so a second mount finds the same empty log.
+    EXPECT(AppendRecords(&log, 3U) == 0);
+    if (Reboot(&log) == NULL) {
+        return;
+    }
+    EXPECT(FlashLog_NextSeq(&log) == 3U);
+    FlashLog_Seek(&log, &it, 0U);
+    EXPECT(DrainAndCheck(&log, &it, 0U) == 3);
+    FlashSim_Close();
+}
+
+static void TestForeignRegion(void)
+{
+    FlashLog log;
+    FlashLogIterator it;
+    const FlashLogPort *port = OpenBlank();
+    uint8_t junk[TEST_SECTOR_BYTES];
+    uint32_t sector;
+    unsigned int i;
+
+    if (!EXPECT(port != NULL)) {
+        return;
+    }
+    // Leftovers of another layout: bits cleared at random everywhere.
+    for (sector = 0U; sector < TEST_SECTORS; ++sector) {
+        for (i = 0U; i < sizeof(junk); ++i) {
+            junk[i] = (uint8_t)((sector + 1U) * 0x9DU ^ i * 0x3BU);
+        }
+        EXPECT(port->write(sector * TEST_SECTOR_BYTES, junk, sizeof(junk)) == 0);
+    }
+    EXPECT(FlashLog_Mount(&log, port) == 0);
+    EXPECT(FlashLog_OldestSeq(&log) == FlashLog_NextSeq(&log));
+    EXPECT(AppendRecords(&log, 5U) == 0);
+    if (Reboot(&log) == NULL) {
+        return;
+    }
+    FlashLog_Seek(&log, &it, 0U);
+    EXPECT(DrainAndCheck(&log, &it, 0U) == 5);
+    FlashSim_Close();
+}
+
+static void TestWrapAndLost(void)
+{
+    FlashLog log;
+    FlashLogIterator it;
+    const FlashLogPort *port = OpenBlank();
+    uint8_t data[TEST_PAYLOAD_BYTES];
+    uint32_t oldest;
+    uint32_t seq = 0U;
+    uint32_t sector;
+    int read;
+
+    if (!EXPECT(port != NULL) || !EXPECT(FlashLog_Mount(&log, port) == 0)) {
+        return;
+    }
+    // Several trips round the ring.
+    EXPECT(AppendRecords(&log, 100U) == 0);
+    oldest = FlashLog_OldestSeq(&log);
+    EXPECT(FlashLog_NextSeq(&log) == 100U);
+    EXPECT(oldest > 0U && oldest < 100U);
+    for (sector = 0U; sector < TEST_SECTORS; ++sector) {
+        EXPECT(FlashSim_EraseCount(sector) >= 2U);
+    }
+
+    // A cursor behind the tail counts what was recycled.
+    FlashLog_Seek(&log, &it, 0U);
+    EXPECT(it.lost == oldest);
+    read = DrainAndCheck(&log, &it, oldest);
+    EXPECT(read == (int)(100U - oldest));
+
+    // The ring recycles the sector under a reader part way through it.
+    FlashLog_Seek(&log, &it, oldest);
+    EXPECT(it.lost == 0U);
+    EXPECT(FlashLog_Next(&log, &it, data, sizeof(data), NULL, &seq) == 1 && seq == oldest);
+    EXPECT(AppendRecords(&log, 20U) == 0);
+    read = DrainAndCheck(&log, &it, oldest + 1U);
+    EXPECT(it.lost == FlashLog_OldestSeq(&log) - (oldest + 1U));
+    EXPECT(read == (int)(FlashLog_NextSeq(&log) - FlashLog_OldestSeq(&log)));
+
+    // Same geometry after a reboot.
+    if (Reboot(&log) == NULL) {
+        return;
+    }
+    EXPECT(FlashLog_NextSeq(&log) == 120U);
+    FlashLog_Seek(&log, &it, FlashLog_OldestSeq(&log));
+    EXPECT(DrainAndCheck(&log, &it, FlashLog_OldestSeq(&log)) == (int)(120U - FlashLog_OldestSeq(&log)));
+    FlashSim_Close();
+}
+
+static void TestTornRecord(void)
+{
+    const long record_bytes = FLASH_LOG_RECORD_OVERHEAD_BYTES + TEST_PAYLOAD_BYTES;
+    long budget;
+
+    // Cut power after every possible number of programmed bytes.
+    for (budget = 0; budget < record_bytes; ++budget) {
+        FlashLog log;
+        FlashLogIterator it;
+        const FlashLogPort *port = OpenBlank();
+        uint8_t data[TEST_PAYLOAD_BYTES];
+        uint32_t committed;
+
+        if (!EXPECT(port != NULL) || !EXPECT(FlashLog_Mount(&log, port) == 0)) {
+            return;
+        }
+        EXPECT(AppendRecords(&log, 4U) == 0);
+        FlashSim_CutPowerAfterBytes(budget);
+        FillPayload(data, 4U);
+        EXPECT(FlashLog_Append(&log, data, TEST_PAYLOAD_BYTES, NULL) == -2);
+
+        if (Reboot(&log) == NULL) {
+            return;
+        }
+        // A torn append never takes its seq. Only a cut in the length word's
+        // last byte, already 0xFF for this size, leaves the record whole.
+        committed = FlashLog_NextSeq(&log) - 4U;
+        EXPECT(committed == (budget == record_bytes - 1 ? 1U : 0U));
+        FlashLog_Seek(&log, &it, 0U);
+        EXPECT(DrainAndCheck(&log, &it, 0U) == (int)(4U + committed));
+
+        // Appends resume past the damage and survive another reboot.
+        EXPECT(AppendRecords(&log, 12U) == 0);
+        if (Reboot(&log) == NULL) {
+            return;
+        }
+        EXPECT(FlashLog_NextSeq(&log) == 16U + committed);
+        FlashLog_Seek(&log, &it, 0U);
+        EXPECT(DrainAndCheck(&log, &it, 0U) == (int)(16U + committed));
+        EXPECT(it.lost == 0U);
+        FlashSim_Close();
+    }
+}
+
+static void TestCorruptSectorHeader(void)
+{
+    FlashLog log;
+    FlashLogIterator it;
+    const FlashLogPort *port = OpenBlank();
+    const uint8_t zeros[4] = {0U, 0U, 0U, 0U};
+    uint32_t next;
+    int read;
+
+    if (!EXPECT(port != NULL) || !EXPECT(FlashLog_Mount(&log, port) == 0)) {
+        return;
+    }
+    // Sectors 0..2 full, sector 3 part filled.
+    EXPECT(AppendRecords(&log, 30U) == 0);
+    next = FlashLog_NextSeq(&log);
+
+    // Clear bits in the CRC of sector 1's header.
+    EXPECT(port->write(1U * TEST_SECTOR_BYTES + 12U, zeros, sizeof(zeros)) == 0);
+    if ((port = Reboot(&log)) == NULL) {
+        return;
+    }
+    EXPECT(FlashLog_NextSeq(&log) == next);
+
+    // Reading skips the sector, counts its records as lost and goes on to the head.
+    FlashLog_Seek(&log, &it, 0U);
+    read = DrainAndCheck(&log, &it, 0U);
+    EXPECT(it.lost == 9U);
+    EXPECT(read == (int)next - 9);
+
+    // Appending wraps over the damaged sector without getting stuck.
+    EXPECT(AppendRecords(&log, 40U) == 0);
+    EXPECT(FlashLog_NextSeq(&log) == next + 40U);
+    FlashLog_Seek(&log, &it, FlashLog_OldestSeq(&log));
+    EXPECT(DrainAndCheck(&log, &it, FlashLog_OldestSeq(&log)) ==
+           (int)(FlashLog_NextSeq(&log) - FlashLog_OldestSeq(&log)));
+    EXPECT(it.lost == 0U);
+    FlashSim_Close();
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1) {
+        g_image = argv[1];
+    }
+
+    TestBlankRegion();
+    TestForeignRegion();
+    TestWrapAndLost();
+    TestTornRecord();
+    TestCorruptSectorHeader();
+
+    FlashSim_Close();
+    (void)remove(g_image);
+    printf("[FLASH LOG] %u checks, %u failed\n", g_checks, g_failures);
+    return g_failures == 0U ? 0 : 1;
+}
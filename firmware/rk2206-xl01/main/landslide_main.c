@@ -11,6 +11,7 @@
 
 #include <stdio.h>
 #include <math.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdbool.h>
 #include <time.h>
@@ -33,6 +34,10 @@
 #define EDGE_UPLINK_MODE_POLLED 1
 #endif
 
+#ifndef EDGE_UPLINK_MODE_HYBRID
+#define EDGE_UPLINK_MODE_HYBRID 2
+#endif
+
 #ifndef EDGE_UPLINK_MODE
 #define EDGE_UPLINK_MODE EDGE_UPLINK_MODE_POLLED
 #endif
@@ -45,8 +50,15 @@
 #define BOOT_SERIAL_DIAG_MODE 0
 #endif
 
+#ifndef ENABLE_IMU_FIFO_CAPTURE
+#define ENABLE_IMU_FIFO_CAPTURE 0
+#endif
+
 // Utilities
+#include "../utils/crc.h"
 #include "../utils/fifo.h"
+#include "../utils/runtime_stats.h"
+#include "../utils/time_discipline.h"
 #include "../utils/watchdog_mgr.h"
 
 // Drivers
@@ -63,10 +75,20 @@
 #if ENABLE_RS485_BUS
 #include "../drivers/sensors/field_sensors_rs485.h"
 #include "../drivers/sensors/field_alarm_rs485.h"
+#include "../drivers/sensors/rs485_modbus.h"
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG
+#include "../drivers/storage/flash_storage.h"
+#endif
 #endif
 
 // Application
 #include "../app/sensor_data.h"
+#include "../app/sensor_window.h"
+#include "../app/sample_history.h"
+#include "../app/sample_log.h"
+#include "../app/motion_features.h"
+#include "../app/risk_engine.h"
+#include "../app/uplink_policy.h"
 #include "../app/device_command_parser.h"
 #include "../app/command_ack_builder.h"
 #include "../app/device_identity.h"
@@ -104,12 +126,27 @@ static int g_system_ready = 0;
 static int g_i2c_ready = 0;
 static int g_sht30_ready = 0;
 static int g_mpu6050_ready = 0;
+static volatile unsigned int g_mpu6050_generation = 0;  // Bumped on every (re)init; MPU6050_Init clears the FIFO setup
 static int g_rs485_ready = 0;
 static unsigned int g_runtime_sampling_interval_ms = 1000;
 static unsigned int g_runtime_report_interval_ms = UPLOAD_INTERVAL_MS;
 static int g_platform_uplink_enabled = 1;
 static volatile int g_platform_manual_collect_requested = 0;
 static volatile int g_platform_poll_latest_requested = 0;
+#if ENABLE_SAMPLE_HISTORY
+// fetch_history hand-off: the command handler prepares a cursor, DataUploadTask streams it.
+#define HISTORY_FRAME_OVERHEAD_BYTES 288
+static SampleHistoryCursor g_history_pending_cursor;
+static char g_history_pending_command_id[64] = "";
+static volatile int g_history_fetch_requested = 0;
+#endif
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG
+// fetch_log hand-off, same shape as fetch_history.
+#define SAMPLE_LOG_FRAME_OVERHEAD_BYTES 352
+static SampleLogCursor g_log_pending_cursor;
+static char g_log_pending_command_id[64] = "";
+static volatile int g_log_fetch_requested = 0;
+#endif
 static volatile unsigned int g_platform_uplink_quiet_remaining_ms = 0;
 static char g_last_platform_command_type[32] = "";
 static char g_last_platform_command_id[64] = "";
@@ -135,6 +172,8 @@ int g_cloud_rgb_blue = 0;
 #define ACK_TS_MIN_VALID_UNIX_SECONDS ((time_t)1704067200)
 #define COMMAND_INTERVAL_MIN_SECONDS 1
 #define COMMAND_INTERVAL_MAX_SECONDS 3600
+#define COMMAND_SENSOR_SAMPLING_MIN_MS 200
+#define COMMAND_SENSOR_SAMPLING_MAX_MS (3600 * 1000)
 #define COMMAND_REBOOT_DELAY_MS 1000U
 #define SENSOR_I2C_SETTLE_MS 50U
 #define MPU6050_INIT_RETRY_COUNT 3
@@ -176,8 +215,10 @@ static void SensorData_StoreSnapshot(const SensorData *snapshot)
 
     SensorData_Lock();
     seq = g_sensor_data.seq;
-    memcpy(&g_sensor_data, snapshot, sizeof(g_sensor_data));
+    // window is the last member and belongs to g_sensor_data; fold the sample in instead.
+    memcpy(&g_sensor_data, snapshot, offsetof(SensorData, window));
     g_sensor_data.seq = seq;
+    SensorWindow_AddSample(g_sensor_data.window, snapshot);
     SensorData_Unlock();
 }
 
@@ -192,6 +233,33 @@ static void SensorData_TakeUploadSnapshot(SensorData *snapshot)
     memcpy(snapshot, &g_sensor_data, sizeof(*snapshot));
     snapshot->seq = g_sensor_data.seq + 1;
     g_sensor_data.seq = snapshot->seq;
+    SensorWindow_Reset(g_sensor_data.window);
+    SensorData_Unlock();
+}
+
+// Alerts carry no window stats, so the window keeps accumulating for the next full upload.
+static void SensorData_TakeAlertSnapshot(SensorData *snapshot)
+{
+    if (snapshot == NULL) {
+        return;
+    }
+
+    SensorData_Lock();
+    memcpy(snapshot, &g_sensor_data, sizeof(*snapshot));
+    snapshot->seq = g_sensor_data.seq + 1;
+    g_sensor_data.seq = snapshot->seq;
+    SensorData_Unlock();
+}
+
+// An upload that did not go out hands its window back, so the next one still covers it.
+static void SensorData_RestoreUploadWindow(const SensorData *snapshot)
+{
+    if (snapshot == NULL) {
+        return;
+    }
+
+    SensorData_Lock();
+    SensorWindow_Merge(g_sensor_data.window, snapshot->window);
     SensorData_Unlock();
 }
 
@@ -205,6 +273,7 @@ static unsigned int SensorData_GetUptimeSnapshot(void)
     return uptime;
 }
 
+#if ENABLE_MPU6050
 static int TryInitMpu6050WithRetry(const char *phase_tag)
 {
     int attempt;
@@ -228,6 +297,7 @@ static int TryInitMpu6050WithRetry(const char *phase_tag)
 
     return -1;
 }
+#endif
 
 static int FormatUnixTimeAsBeijingIso8601(time_t unix_seconds, char *output, int output_size)
 {
@@ -306,11 +376,20 @@ static int BuildAckTimestamp(
     time_t now;
     static int g_ack_ts_clock_warned = 0;
     const char *trusted_ts;
+    int64_t utc_ms;
 
     if (output == NULL || output_size <= 0) {
         return 0;
     }
 
+    if (TimeDiscipline_NowUtcMs(&utc_ms) == 0 &&
+        TimeDiscipline_FormatRfc3339(utc_ms, output, output_size) > 0) {
+        if (time_source != NULL) {
+            *time_source = TimeDiscipline_SourceName();
+        }
+        return 1;
+    }
+
     trusted_ts = GetCommandTrustedTimeTs(cmd);
     if (trusted_ts != NULL && trusted_ts[0] != '\0') {
         strncpy(output, trusted_ts, (size_t)output_size - 1);
@@ -420,9 +499,23 @@ static void RecordAcceptedPlatformCommand(const DeviceCommandMessage *cmd)
         g_last_trusted_time_ts[sizeof(g_last_trusted_time_ts) - 1] = '\0';
         strncpy(g_last_trusted_time_source, GetCommandTrustedTimeSource(cmd), sizeof(g_last_trusted_time_source) - 1);
         g_last_trusted_time_source[sizeof(g_last_trusted_time_source) - 1] = '\0';
+        // Steers the clock only while no GNSS time has been seen recently.
+        (void)TimeDiscipline_ObserveRfc3339(trusted_ts, LOS_TickCountGet());
     }
 }
 
+/*
+ * Hand every partly filled history block to the flash log before a planned
+ * reboot; without this up to one block per channel would be lost.
+ */
+static void PersistSampleHistoryForReboot(void)
+{
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG
+    SampleHistory_CloseOpenBlocks();
+    SampleLog_Service();
+#endif
+}
+
 static void* FieldLinkHealthTask(const char* arg)
 {
     (void)arg;
@@ -434,7 +527,8 @@ static void* FieldLinkHealthTask(const char* arg)
     );
 
     while (1) {
-#if ENABLE_FIELD_LINK_AUTO_RECOVERY && EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_POLLED
+#if ENABLE_FIELD_LINK_AUTO_RECOVERY && \
+    (EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_POLLED || EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_HYBRID)
         uint32_t now_tick = (uint32_t)LOS_TickCountGet();
         uint32_t last_command_tick = g_last_platform_command_tick;
         uint32_t stale_ticks = LOS_MS2Tick(FIELD_LINK_STALE_REBOOT_MS);
@@ -449,8 +543,17 @@ static void* FieldLinkHealthTask(const char* arg)
                 (unsigned int)FIELD_LINK_STALE_REBOOT_MS,
                 (unsigned int)FIELD_LINK_RECOVERY_REBOOT_DELAY_MS
             );
+            PersistSampleHistoryForReboot();
             Watchdog_RequestReboot(FIELD_LINK_RECOVERY_REBOOT_DELAY_MS);
         }
+#endif
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG
+        // Flash programming and sector erases happen here, away from the
+        // sensor and uplink tasks.
+        SampleLog_Service();
+#endif
+#if ENABLE_RUNTIME_STATS
+        RuntimeStats_Service();
 #endif
         LOS_Msleep(FIELD_LINK_RECOVERY_CHECK_MS);
     }
@@ -584,6 +687,7 @@ static int SendPlatformCommandAckWithGuard(
 static int BuildRuntimeConfigResultJson(
     int include_sampling_s,
     int include_report_interval_s,
+    int include_sensor_sampling_ms,
     char *output,
     int output_size
 )
@@ -623,12 +727,25 @@ static int BuildRuntimeConfigResultJson(
         if (len < 0 || len >= output_size) {
             return -1;
         }
+        first = 0;
+    }
+
+    if (include_sensor_sampling_ms) {
+        len += snprintf(
+            output + len,
+            (size_t)(output_size - len),
+            "%s\"sensor_sampling_ms\"",
+            first ? "" : ","
+        );
+        if (len < 0 || len >= output_size) {
+            return -1;
+        }
     }
 
     len += snprintf(
         output + len,
         (size_t)(output_size - len),
-        "],\"effective\":{\"sampling_s\":%u,\"report_interval_s\":%u},\"runtime_config\":{\"sampling_s\":%u,\"report_interval_s\":%u}}",
+        "],\"effective\":{\"sampling_s\":%u,\"report_interval_s\":%u},\"runtime_config\":{\"sampling_s\":%u,\"report_interval_s\":%u}",
         g_runtime_sampling_interval_ms / 1000,
         g_runtime_report_interval_ms / 1000,
         g_runtime_sampling_interval_ms / 1000,
@@ -638,14 +755,198 @@ static int BuildRuntimeConfigResultJson(
         return -1;
     }
 
+#if ENABLE_RS485_BUS
+    if (include_sensor_sampling_ms) {
+        len += snprintf(
+            output + len,
+            (size_t)(output_size - len),
+            ",\"sensor_sampling_ms\":{\"soil\":%u,\"tilt\":%u,\"rain\":%u}",
+            FieldRs485_GetDevicePeriodMs(FIELD_RS485_DEVICE_SOIL),
+            FieldRs485_GetDevicePeriodMs(FIELD_RS485_DEVICE_TILT),
+            FieldRs485_GetDevicePeriodMs(FIELD_RS485_DEVICE_RAIN)
+        );
+        if (len < 0 || len >= output_size) {
+            return -1;
+        }
+    }
+#endif
+
+    len += snprintf(output + len, (size_t)(output_size - len), "}");
+    if (len < 0 || len >= output_size) {
+        return -1;
+    }
+
+    return len;
+}
+
+#if ENABLE_GPS
+static int BuildGpsStatsResultJson(char *output, int output_size)
+{
+    GpsStats stats;
+    int len;
+
+    if (output == NULL || output_size <= 0 || GPS_GetStats(&stats) != 0) {
+        return -1;
+    }
+
+    len = snprintf(
+        output,
+        (size_t)output_size,
+        "{\"rx_bps\":%u,\"rx_bps_baseline\":%u,\"rx_total\":%u,\"parsed\":%u,\"skipped\":%u,"
+        "\"cksum_err\":%u,\"bin\":%u,\"bin_err\":%u,\"protocol\":\"%s\",\"receiver_config\":\"%s\",\"config_attempts\":%u}",
+        (unsigned int)stats.rx_bytes_per_sec,
+        (unsigned int)stats.rx_bytes_per_sec_baseline,
+        (unsigned int)stats.rx_bytes_total,
+        (unsigned int)stats.nmea_parsed,
+        (unsigned int)stats.nmea_skipped,
+        (unsigned int)stats.nmea_checksum_errors,
+        (unsigned int)stats.binary_frames,
+        (unsigned int)stats.binary_errors,
+        stats.binary_active ? "binary" : "nmea",
+        GPS_ReceiverConfigStateName(stats.receiver_config_state),
+        (unsigned int)stats.receiver_config_attempts
+    );
+    if (len < 0 || len >= output_size) {
+        return -1;
+    }
+    return len;
+}
+#endif
+
+#if ENABLE_RS485_BUS
+// Compact keys keep three slaves inside the 256-byte result and 320-byte ACK budget.
+static int BuildRs485TimingResultJson(char *output, int output_size)
+{
+    unsigned int count = RS485_ModbusGetSlaveTimingCount();
+    unsigned int index;
+    int len;
+
+    if (output == NULL || output_size <= 0) {
+        return -1;
+    }
+
+    len = snprintf(output, (size_t)output_size, "{\"slaves\":[");
+    if (len < 0 || len >= output_size) {
+        return -1;
+    }
+
+    for (index = 0; index < count; ++index) {
+        Rs485SlaveTiming timing;
+        int written;
+
+        if (RS485_ModbusGetSlaveTiming(index, &timing) != 0) {
+            break;
+        }
+        written = snprintf(
+            output + len,
+            (size_t)(output_size - len),
+            "%s{\"ch\":%u,\"a\":%u,\"n\":%u,\"avg\":%u,\"jit\":%u,\"max\":%u,\"to\":%u,\"gap\":%u,\"tmo\":%u,\"err\":%u}",
+            index > 0U ? "," : "",
+            timing.channel,
+            timing.slave_addr,
+            timing.samples,
+            timing.latency_avg_ms,
+            timing.latency_jitter_ms,
+            timing.latency_max_ms,
+            timing.timeout_ms,
+            timing.gap_ms,
+            timing.timeouts,
+            timing.errors
+        );
+        // Leave room for the closing "],"omitted":N}" suffix.
+        if (written < 0 || len + written >= output_size - 16) {
+            break;
+        }
+        len += written;
+    }
+
+    {
+        int written = snprintf(
+            output + len,
+            (size_t)(output_size - len),
+            "],\"omitted\":%u}",
+            count - index
+        );
+        if (written < 0 || len + written >= output_size) {
+            return -1;
+        }
+        len += written;
+    }
+
     return len;
 }
+#endif
 
 static int IsRuntimeIntervalValid(int seconds)
 {
     return seconds >= COMMAND_INTERVAL_MIN_SECONDS && seconds <= COMMAND_INTERVAL_MAX_SECONDS;
 }
 
+// 0 is accepted and hands the sensor back to the global sampling_s rate.
+static int IsSensorSamplingValid(int period_ms)
+{
+    return period_ms == 0 ||
+           (period_ms >= COMMAND_SENSOR_SAMPLING_MIN_MS && period_ms <= COMMAND_SENSOR_SAMPLING_MAX_MS);
+}
+
+static int IsSensorScheduled(unsigned int device)
+{
+#if ENABLE_RS485_BUS
+    return FieldRs485_GetDevicePeriodMs(device) > 0U;
+#else
+    (void)device;
+    return 0;
+#endif
+}
+
+static int HasSensorSamplingKeys(const DeviceCommandMessage *cmd)
+{
+    return cmd->has_soil_sampling_ms || cmd->has_tilt_sampling_ms || cmd->has_rain_sampling_ms;
+}
+
+/*
+ * Validates every requested sensor rate before applying any of them.
+ * On failure fills resultJson with the error and returns -1.
+ */
+static int ApplySensorSamplingRates(const DeviceCommandMessage *cmd, char *resultJson, int resultSize)
+{
+    static const char *names[] = {"soil", "tilt", "rain"};
+    const int has[] = {cmd->has_soil_sampling_ms, cmd->has_tilt_sampling_ms, cmd->has_rain_sampling_ms};
+    const int values[] = {cmd->soil_sampling_ms, cmd->tilt_sampling_ms, cmd->rain_sampling_ms};
+    unsigned int i;
+
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        if (!has[i]) {
+            continue;
+        }
+        if (!IsSensorSamplingValid(values[i])) {
+            snprintf(
+                resultJson,
+                (size_t)resultSize,
+                "{\"error\":\"invalid_sensor_sampling_ms\",\"sensor\":\"%s\",\"min\":%d,\"max\":%d,\"received\":%d}",
+                names[i],
+                COMMAND_SENSOR_SAMPLING_MIN_MS,
+                COMMAND_SENSOR_SAMPLING_MAX_MS,
+                values[i]
+            );
+            return -1;
+        }
+        if (!IsSensorScheduled(i)) {
+            snprintf(resultJson, (size_t)resultSize, "{\"error\":\"sensor_not_enabled\",\"sensor\":\"%s\"}", names[i]);
+            return -1;
+        }
+    }
+
+#if ENABLE_RS485_BUS
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); ++i) {
+        if (has[i]) {
+            (void)FieldRs485_SetDevicePeriodMs(i, (unsigned int)values[i]);
+        }
+    }
+#endif
+    return 0;
+}
+
 static void HandlePlatformCommand(const char *commandJson)
 {
     DeviceCommandMessage cmd;
@@ -687,7 +988,7 @@ static void HandlePlatformCommand(const char *commandJson)
     }
 
     if (strcmp(cmd.command_type, "set_config") == 0) {
-        if (!cmd.has_sampling_s && !cmd.has_report_interval_s) {
+        if (!cmd.has_sampling_s && !cmd.has_report_interval_s && !HasSensorSamplingKeys(&cmd)) {
             SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"no_supported_keys\"}", 0, 0);
             return;
         }
@@ -718,8 +1019,17 @@ static void HandlePlatformCommand(const char *commandJson)
             return;
         }
 
+        if (HasSensorSamplingKeys(&cmd) &&
+            ApplySensorSamplingRates(&cmd, resultJson, sizeof(resultJson)) != 0) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", resultJson, 0, 0);
+            return;
+        }
+
         if (cmd.has_sampling_s) {
             g_runtime_sampling_interval_ms = (unsigned int)cmd.sampling_s * 1000;
+#if ENABLE_RS485_BUS
+            FieldRs485_SetDefaultPeriodMs(g_runtime_sampling_interval_ms);
+#endif
         }
         if (cmd.has_report_interval_s) {
             g_runtime_report_interval_ms = (unsigned int)cmd.report_interval_s * 1000;
@@ -735,6 +1045,7 @@ static void HandlePlatformCommand(const char *commandJson)
         if (BuildRuntimeConfigResultJson(
                 cmd.has_sampling_s,
                 cmd.has_report_interval_s,
+                HasSensorSamplingKeys(&cmd),
                 resultJson,
                 sizeof(resultJson)
             ) <= 0) {
@@ -760,6 +1071,7 @@ static void HandlePlatformCommand(const char *commandJson)
         );
         sendRet = SendPlatformCommandAckWithGuard(&cmd, "acked", resultJson, 0, 0);
         if (sendRet > 0) {
+            PersistSampleHistoryForReboot();
             Watchdog_RequestReboot(COMMAND_REBOOT_DELAY_MS);
         }
         return;
@@ -779,6 +1091,7 @@ static void HandlePlatformCommand(const char *commandJson)
         );
         sendRet = SendPlatformCommandAckWithGuard(&cmd, "acked", resultJson, 0, 0);
         if (sendRet > 0) {
+            PersistSampleHistoryForReboot();
             Watchdog_RequestReboot(COMMAND_REBOOT_DELAY_MS);
         }
         return;
@@ -787,7 +1100,10 @@ static void HandlePlatformCommand(const char *commandJson)
     if (strcmp(cmd.command_type, "set_sampling_interval") == 0) {
         if (cmd.has_interval_seconds && IsRuntimeIntervalValid(cmd.interval_seconds)) {
             g_runtime_sampling_interval_ms = (unsigned int)cmd.interval_seconds * 1000;
-            if (BuildRuntimeConfigResultJson(1, 0, resultJson, sizeof(resultJson)) <= 0) {
+#if ENABLE_RS485_BUS
+            FieldRs485_SetDefaultPeriodMs(g_runtime_sampling_interval_ms);
+#endif
+            if (BuildRuntimeConfigResultJson(1, 0, 0, resultJson, sizeof(resultJson)) <= 0) {
                 snprintf(
                     resultJson,
                     sizeof(resultJson),
@@ -812,6 +1128,164 @@ static void HandlePlatformCommand(const char *commandJson)
         return;
     }
 
+    if (strcmp(cmd.command_type, "get_gps_stats") == 0) {
+#if ENABLE_GPS
+        if (BuildGpsStatsResultJson(resultJson, sizeof(resultJson)) <= 0) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"result_too_large\"}", 0, 0);
+            return;
+        }
+        SendPlatformCommandAckWithGuard(&cmd, "acked", resultJson, 0, 0);
+#else
+        SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"gps_disabled\"}", 0, 0);
+#endif
+        return;
+    }
+
+    if (strcmp(cmd.command_type, "get_runtime_stats") == 0) {
+#if ENABLE_RUNTIME_STATS
+        unsigned int first = 0U;
+
+        if (cmd.has_log_cursor) {
+            if (cmd.log_cursor < 0) {
+                SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"invalid_cursor\"}", 0, 0);
+                return;
+            }
+            first = (unsigned int)cmd.log_cursor;
+        }
+        if (RuntimeStats_BuildResultJson(first, resultJson, sizeof(resultJson)) <= 0) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"result_too_large\"}", 0, 0);
+            return;
+        }
+        SendPlatformCommandAckWithGuard(&cmd, "acked", resultJson, 0, 0);
+#else
+        SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"runtime_stats_disabled\"}", 0, 0);
+#endif
+        return;
+    }
+
+    if (strcmp(cmd.command_type, "get_rs485_timing") == 0) {
+#if ENABLE_RS485_BUS
+        if (BuildRs485TimingResultJson(resultJson, sizeof(resultJson)) <= 0) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"result_too_large\"}", 0, 0);
+            return;
+        }
+        SendPlatformCommandAckWithGuard(&cmd, "acked", resultJson, 0, 0);
+#else
+        SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"rs485_bus_disabled\"}", 0, 0);
+#endif
+        return;
+    }
+
+    if (strcmp(cmd.command_type, "reset_rs485_timing") == 0) {
+#if ENABLE_RS485_BUS
+        RS485_ModbusResetSlaveTiming();
+        SendPlatformCommandAckWithGuard(&cmd, "acked", "{\"reset\":true}", 0, 0);
+#else
+        SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"rs485_bus_disabled\"}", 0, 0);
+#endif
+        return;
+    }
+
+    if (strcmp(cmd.command_type, "fetch_history") == 0) {
+#if ENABLE_SAMPLE_HISTORY && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+        const char *sensor = cmd.has_history_sensor ? cmd.history_sensor : "all";
+        uint32_t mask = 0U;
+        uint32_t now_ms = (uint32_t)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U));
+        uint32_t since_ms = now_ms - 0x7FFFFFFFU;
+        uint32_t blocks = 0U;
+        uint32_t samples = 0U;
+        SampleHistoryCursor cursor;
+
+        if (DOWNLINK_ONLY_MODE || !g_platform_uplink_enabled) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"uplink_disabled\"}", 0, 0);
+            return;
+        }
+        if (strcmp(sensor, "tilt") == 0) {
+            mask = SAMPLE_HISTORY_MASK_TILT;
+        } else if (strcmp(sensor, "soil") == 0) {
+            mask = SAMPLE_HISTORY_MASK_SOIL;
+        } else if (strcmp(sensor, "all") == 0) {
+            mask = SAMPLE_HISTORY_MASK_ALL;
+        }
+        if (mask == 0U) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"invalid_history_sensor\"}", 0, 0);
+            return;
+        }
+        if (cmd.has_since_s) {
+            if (cmd.since_s <= 0 || cmd.since_s > 2000000) {
+                SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"invalid_since_s\"}", 0, 0);
+                return;
+            }
+            since_ms = now_ms - (uint32_t)cmd.since_s * 1000U;
+        }
+
+        (void)SampleHistory_BeginFetch(&cursor, mask, since_ms, &blocks, &samples);
+        snprintf(
+            resultJson,
+            sizeof(resultJson),
+            "{\"history\":{\"sensor\":\"%s\",\"blocks\":%u,\"samples\":%u}}",
+            sensor,
+            (unsigned int)blocks,
+            (unsigned int)samples
+        );
+        sendRet = SendPlatformCommandAckWithGuard(&cmd, "acked", resultJson, 0, 0);
+        if (sendRet > 0 && blocks > 0U) {
+            g_history_pending_cursor = cursor;
+            strncpy(g_history_pending_command_id, cmd.command_id, sizeof(g_history_pending_command_id) - 1);
+            g_history_pending_command_id[sizeof(g_history_pending_command_id) - 1] = '\0';
+            g_history_fetch_requested = 1;
+        }
+#else
+        SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"history_unavailable\"}", 0, 0);
+#endif
+        return;
+    }
+
+    if (strcmp(cmd.command_type, "fetch_log") == 0) {
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+        uint32_t from_seq = 0U;
+        uint32_t oldest = 0U;
+        uint32_t next = 0U;
+        SampleLogCursor cursor;
+
+        if (DOWNLINK_ONLY_MODE || !g_platform_uplink_enabled) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"uplink_disabled\"}", 0, 0);
+            return;
+        }
+        if (cmd.has_log_cursor) {
+            if (cmd.log_cursor < 0) {
+                SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"invalid_cursor\"}", 0, 0);
+                return;
+            }
+            from_seq = (uint32_t)cmd.log_cursor;
+        }
+        if (SampleLog_BeginFetch(&cursor, from_seq, SAMPLE_LOG_FRAMES_PER_FETCH, &oldest, &next) != 0) {
+            SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"log_unavailable\"}", 0, 0);
+            return;
+        }
+        snprintf(
+            resultJson,
+            sizeof(resultJson),
+            "{\"log\":{\"cursor\":%u,\"oldest\":%u,\"next\":%u,\"boot\":%u,\"dropped\":%u}}",
+            (unsigned int)cursor.it.cursor,
+            (unsigned int)oldest,
+            (unsigned int)next,
+            (unsigned int)SampleLog_Boot(),
+            (unsigned int)SampleLog_DroppedBlocks()
+        );
+        sendRet = SendPlatformCommandAckWithGuard(&cmd, "acked", resultJson, 0, 0);
+        if (sendRet > 0 && !cursor.done) {
+            g_log_pending_cursor = cursor;
+            strncpy(g_log_pending_command_id, cmd.command_id, sizeof(g_log_pending_command_id) - 1);
+            g_log_pending_command_id[sizeof(g_log_pending_command_id) - 1] = '\0';
+            g_log_fetch_requested = 1;
+        }
+#else
+        SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"log_unavailable\"}", 0, 0);
+#endif
+        return;
+    }
+
     if (strcmp(cmd.command_type, "manual_collect") == 0) {
         if (DOWNLINK_ONLY_MODE) {
             SendPlatformCommandAckWithGuard(&cmd, "failed", "{\"error\":\"downlink_only_mode\"}", 0, 0);
@@ -1093,9 +1567,10 @@ static void VirtualSensor_Read(SensorData *data)
     data->temp_valid = 1;
     
     // GPS: Fixed location (example)
-    data->latitude = 22.5430f + data->seq * 0.00001f;
-    data->longitude = 114.0579f + data->seq * 0.00001f;
+    data->latitude = 22.5430 + data->seq * 0.00001;
+    data->longitude = 114.0579 + data->seq * 0.00001;
     data->gps_valid = 1;
+    data->gps_quality = 1;
     
     // Accelerometer: Simulate tilt
     angle_base += 0.05f;
@@ -1118,6 +1593,65 @@ static void VirtualSensor_Read(SensorData *data)
 }
 #endif
 
+#if ENABLE_MPU6050 && ENABLE_IMU_FIFO_CAPTURE
+#define IMU_OVERFLOW_LOG_INTERVAL_MS 10000U
+
+// Keep the drain buffer off the 2 KB task stack.
+static int16_t g_imu_fifo_block[IMU_FIFO_DRAIN_MAX_SAMPLES][3];
+
+static void* ImuCaptureTask(const char* arg)
+{
+    (void)arg;
+    unsigned int started_generation = 0;
+    unsigned int overflows = 0;
+    uint32_t last_overflow_log_ms = 0U;
+
+    printf("[Task] IMU FIFO capture started\n");
+
+    while (1) {
+        uint32_t now_ms;
+        MotionFeatures motion;
+        int count;
+
+        if (!g_i2c_ready || !g_mpu6050_ready) {
+            LOS_Msleep(IMU_FIFO_DRAIN_MS);
+            continue;
+        }
+        if (started_generation != g_mpu6050_generation) {
+            started_generation = g_mpu6050_generation;
+            if (MPU6050_StartFifoCapture(IMU_FIFO_RATE_HZ, IMU_FIFO_INT_GPIO, IMU_FIFO_WATERMARK_SAMPLES) != 0) {
+                // SensorTask's read-failure path re-inits the chip and bumps the generation.
+                LOS_Msleep(SENSOR_REINIT_RETRY_MS);
+                continue;
+            }
+        }
+
+        (void)MPU6050_WaitFifo(IMU_FIFO_DRAIN_MS);
+        count = MPU6050_ReadFifoAccel(g_imu_fifo_block, IMU_FIFO_DRAIN_MAX_SAMPLES);
+        now_ms = (uint32_t)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U));
+        if (count == MPU6050_ERR_FIFO_OVERFLOW) {
+            overflows++;
+            if (now_ms - last_overflow_log_ms >= IMU_OVERFLOW_LOG_INTERVAL_MS) {
+                last_overflow_log_ms = now_ms;
+                printf("[WARN] MPU6050 FIFO overflow count=%u; drain faster or lower IMU_FIFO_RATE_HZ\n", overflows);
+            }
+            continue;
+        }
+        if (count <= 0) {
+            continue;
+        }
+
+        if (MotionFeatures_PushAccelRaw((const int16_t (*)[3])g_imu_fifo_block, (uint32_t)count, now_ms, &motion) == 0) {
+#if ENABLE_RISK_ENGINE
+            RiskEngine_ObserveMotion(&motion, now_ms);
+#endif
+        }
+    }
+
+    return NULL;
+}
+#endif
+
 // ==================== Task 1: Sensor Collection ====================
 
 static void* SensorCollectionTask(const char* arg)
@@ -1149,9 +1683,22 @@ static void* SensorCollectionTask(const char* arg)
         next_sample.soil_ec = 0.0f;
         next_sample.soil_ec_valid = 0;
         next_sample.soil_valid = 0;
-        next_sample.latitude = 0.0f;
-        next_sample.longitude = 0.0f;
+        next_sample.latitude = 0.0;
+        next_sample.longitude = 0.0;
         next_sample.gps_valid = 0;
+        next_sample.gps_quality = 0;
+        next_sample.gps_sats = 0;
+        next_sample.gps_hdop = 0.0f;
+        next_sample.gps_age_ms = 0;
+        next_sample.gps_utc_date = 0;
+        next_sample.gps_utc_ms = 0;
+        next_sample.gps_utc_valid = 0;
+        next_sample.gps_est_valid = 0;
+        next_sample.gps_mean_latitude = 0.0;
+        next_sample.gps_mean_longitude = 0.0;
+        next_sample.gps_std_m = 0.0f;
+        next_sample.gps_rate_valid = 0;
+        next_sample.gps_rate_mm_per_day = 0.0f;
         next_sample.accel_x = 0.0f;
         next_sample.accel_y = 0.0f;
         next_sample.accel_z = 0.0f;
@@ -1182,6 +1729,7 @@ static void* SensorCollectionTask(const char* arg)
             if (last_mpu_reinit_tick == 0U || (now_tick - last_mpu_reinit_tick) >= retry_ticks) {
                 last_mpu_reinit_tick = now_tick;
                 if (TryInitMpu6050WithRetry("runtime") == 0) {
+                    g_mpu6050_generation++;
                     g_mpu6050_ready = 1;
                     mpu_read_fail_streak = 0;
                     printf("[OK] MPU6050 recovered during runtime\n");
@@ -1191,23 +1739,46 @@ static void* SensorCollectionTask(const char* arg)
             }
         }
 
-        float ax, ay, az, gx, gy, gz;
+        int16_t accel_raw[1][3];
+        int16_t gyro_raw[3];
         if (g_i2c_ready && g_mpu6050_ready) {
-            if (MPU6050_Read(&ax, &ay, &az, &gx, &gy, &gz) == 0) {
+            if (MPU6050_ReadRaw(accel_raw[0], gyro_raw) == 0) {
+                uint32_t now_ms = (uint32_t)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U));
+#if !ENABLE_IMU_FIFO_CAPTURE
+                MotionFeatures motion;
+#endif
+
                 mpu_read_fail_streak = 0;
-                next_sample.accel_x = ax;
-                next_sample.accel_y = ay;
-                next_sample.accel_z = az;
-                next_sample.gyro_x = gx;
-                next_sample.gyro_y = gy;
-                next_sample.gyro_z = gz;
-
-                // Calculate tilt angles
-                next_sample.angle_x = atan2(ay, sqrt(ax*ax + az*az)) * 180.0f / 3.14159f;
-                next_sample.angle_y = atan2(-ax, sqrt(ay*ay + az*az)) * 180.0f / 3.14159f;
+                next_sample.accel_x = accel_raw[0][0] / MPU6050_ACCEL_LSB_PER_G;
+                next_sample.accel_y = accel_raw[0][1] / MPU6050_ACCEL_LSB_PER_G;
+                next_sample.accel_z = accel_raw[0][2] / MPU6050_ACCEL_LSB_PER_G;
+                next_sample.gyro_x = gyro_raw[0] / MPU6050_GYRO_LSB_PER_DPS;
+                next_sample.gyro_y = gyro_raw[1] / MPU6050_GYRO_LSB_PER_DPS;
+                next_sample.gyro_z = gyro_raw[2] / MPU6050_GYRO_LSB_PER_DPS;
+
+                // Tilt angles in fixed point from the raw counts; with FIFO capture
+                // on, ImuCaptureTask feeds the vibration features at full rate.
+                MotionFeatures_TiltFromRaw(accel_raw[0], &next_sample.angle_x, &next_sample.angle_y);
+#if !ENABLE_IMU_FIFO_CAPTURE
+                (void)MotionFeatures_PushAccelRaw((const int16_t (*)[3])accel_raw, 1U, now_ms, &motion);
+#endif
                 next_sample.angle_z = 0.0f;
 
                 next_sample.imu_valid = 1;
+                // One tilt source per trend and history channel: the two sensors are
+                // mounted and zeroed differently, so the RS485 inclinometer wins when built.
+#if ENABLE_SAMPLE_HISTORY && !ENABLE_RS485_TILT_SENSOR
+                SampleHistory_Append(SAMPLE_HISTORY_TILT_X, next_sample.angle_x, now_ms);
+                SampleHistory_Append(SAMPLE_HISTORY_TILT_Y, next_sample.angle_y, now_ms);
+#endif
+#if ENABLE_RISK_ENGINE
+#if !ENABLE_RS485_TILT_SENSOR
+                RiskEngine_ObserveTilt(next_sample.angle_x, next_sample.angle_y, now_ms);
+#endif
+#if !ENABLE_IMU_FIFO_CAPTURE
+                RiskEngine_ObserveMotion(&motion, now_ms);
+#endif
+#endif
             } else {
                 mpu_read_fail_streak++;
                 if (mpu_read_fail_streak >= 3U) {
@@ -1221,7 +1792,8 @@ static void* SensorCollectionTask(const char* arg)
 #endif
 
 #if ENABLE_RS485_BUS
-        if (g_rs485_ready && FieldRs485_Read(&rs485_readings) == 0) {
+        // Rs485BusTask owns the bus; this is an O(1) copy of its latest-value cache.
+        if (g_rs485_ready && FieldRs485_GetLatest(&rs485_readings) == 0) {
             if (rs485_readings.soil_valid) {
                 next_sample.soil_temperature = rs485_readings.soil_temperature_c;
                 next_sample.soil_moisture = rs485_readings.soil_moisture_pct;
@@ -1254,11 +1826,48 @@ static void* SensorCollectionTask(const char* arg)
         // GPS使用中断接收，这里只需要处理缓冲区数据
         GPS_Poll();  // 处理中断接收到的数据
         
-        // 读取最新的GPS坐标（无论fix状态如何，都更新坐标）
-        int gps_ret = GPS_Read(&next_sample.latitude, &next_sample.longitude);
-        
-        // 只有当GPS返回成功时，才标记为有效
-        next_sample.gps_valid = (gps_ret == 0) ? 1 : 0;
+        // 读取最新的GPS定位（无论fix状态如何，都更新坐标）
+        {
+            GpsFix fix;
+            int gps_ret = GPS_ReadFix(&fix);
+
+            if (gps_ret == 0 || fix.fix_tick != 0U) {
+                next_sample.latitude = (double)fix.lat_e7 / 10000000.0;
+                next_sample.longitude = (double)fix.lon_e7 / 10000000.0;
+                next_sample.gps_quality = fix.quality;
+                next_sample.gps_sats = fix.sats;
+                next_sample.gps_hdop = (float)fix.hdop_x100 / 100.0f;
+                next_sample.gps_age_ms = fix.age_ms;
+                next_sample.gps_utc_valid = fix.utc_time_valid;
+                next_sample.gps_utc_ms = fix.utc_ms_of_day;
+                next_sample.gps_utc_date = fix.utc_date_valid
+                    ? (unsigned int)fix.utc_year * 10000U + (unsigned int)fix.utc_month * 100U + fix.utc_day
+                    : 0U;
+            }
+
+            // 只有当GPS返回成功时，才标记为有效
+            next_sample.gps_valid = (gps_ret == 0) ? 1 : 0;
+        }
+        {
+            GpsEstimate estimate;
+
+            if (GPS_GetEstimate(&estimate) == 0) {
+                next_sample.gps_est_valid = 1;
+                next_sample.gps_mean_latitude = estimate.mean_lat_deg;
+                next_sample.gps_mean_longitude = estimate.mean_lon_deg;
+                next_sample.gps_std_m = estimate.std_m;
+                next_sample.gps_rate_valid = estimate.rate_valid;
+                next_sample.gps_rate_mm_per_day = estimate.rate_mm_per_day;
+#if ENABLE_RISK_ENGINE
+                if (estimate.rate_valid) {
+                    RiskEngine_ObserveGpsRate(
+                        estimate.rate_mm_per_day,
+                        (uint32_t)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U))
+                    );
+                }
+#endif
+            }
+        }
 #endif
 
         // Check warnings
@@ -1270,15 +1879,35 @@ static void* SensorCollectionTask(const char* arg)
                 next_sample.warning = 1;
             }
         }
+#endif
+#if ENABLE_RISK_ENGINE
+        // The engine already ran on each sample as it arrived; just publish it.
+        {
+            RiskAssessment risk;
+
+            next_sample.risk_valid = GetLatestRiskAssessment(&risk) == 0 ? 1 : 0;
+            next_sample.risk_level = next_sample.risk_valid ? (int)risk.level : 0;
+            next_sample.risk_confidence = next_sample.risk_valid ? risk.confidence : 0.0f;
+        }
 #endif
         SensorData_StoreSnapshot(&next_sample);
         
         // Feed watchdog
         Watchdog_Feed();
         
-        // Update every 1 second
-        LOS_Msleep(g_runtime_sampling_interval_ms);
-        g_stats.uptime_sec += (g_runtime_sampling_interval_ms / 1000) > 0 ? (g_runtime_sampling_interval_ms / 1000) : 1;
+        // Wake at the fastest per-sensor rate so a sub-second tilt period reaches the
+        // warning check; uptime comes from the tick counter, not the loop count.
+        {
+            unsigned int loop_ms = g_runtime_sampling_interval_ms;
+#if ENABLE_RS485_BUS
+            unsigned int fastest_ms = FieldRs485_GetFastestPeriodMs();
+            if (fastest_ms > 0U && fastest_ms < loop_ms) {
+                loop_ms = fastest_ms;
+            }
+#endif
+            LOS_Msleep(loop_ms);
+        }
+        g_stats.uptime_sec = (unsigned int)(LOS_TickCountGet() / LOS_MS2Tick(1000U));
         SensorData_Lock();
         g_sensor_data.uptime = g_stats.uptime_sec;
         SensorData_Unlock();
@@ -1287,6 +1916,29 @@ static void* SensorCollectionTask(const char* arg)
     return NULL;
 }
 
+#if ENABLE_RS485_BUS
+// ==================== Task 1b: RS485 Bus Owner ====================
+
+static void* Rs485BusTask(const char* arg)
+{
+    (void)arg;
+
+    LOS_Msleep(1000);
+    printf("[Task] RS485 bus owner started\n");
+
+    while (1) {
+        unsigned int wait_ms = g_rs485_ready ? FieldRs485_ServiceBus() : 1000U;
+        if (wait_ms > 0U) {
+            // Idle slot: flush learned timing to kv_store without holding the bus.
+            RS485_ModbusPersistTiming();
+            LOS_Msleep(wait_ms);
+        }
+    }
+
+    return NULL;
+}
+#endif
+
 // ==================== Task 2: UART RX ====================
 
 static void* UartRxTask(const char* arg)
@@ -1341,15 +1993,148 @@ static void* DataProcessTask(const char* arg)
     return NULL;
 }
 
+#if ENABLE_SAMPLE_HISTORY && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+/*
+ * One fetch_history frame: a DeviceCommandAck v1 for the fetch command whose
+ * result carries whole history blocks. Receivers order frames by "part" and
+ * stop at "last"; sample times are now_ms-relative to the frame's ack_ts.
+ * Returns 1 while more frames remain, 0 when the stream is finished.
+ */
+static int SendNextHistoryFrame(SampleHistoryCursor *cursor, const char *command_id)
+{
+    static char blocks_json[FIELD_LINK_MAX_PAYLOAD_BYTES - HISTORY_FRAME_OVERHEAD_BYTES];
+    static char result_json[FIELD_LINK_MAX_PAYLOAD_BYTES - HISTORY_FRAME_OVERHEAD_BYTES + 128];
+    static char frame[FIELD_LINK_MAX_PAYLOAD_BYTES + 1];
+    char ack_ts[32];
+    const char *time_source = NULL;
+    int blocks_len;
+    int result_len;
+    int frame_len;
+    int last;
+
+    blocks_len = SampleHistory_EncodeNext(cursor, blocks_json, sizeof(blocks_json));
+    if (blocks_len < 0) {
+        printf("[HISTORY] block does not fit a frame; stream aborted id=%s\n", command_id);
+        return 0;
+    }
+    last = cursor->done ? 1 : 0;
+
+    result_len = snprintf(
+        result_json,
+        sizeof(result_json),
+        "{\"history\":{\"part\":%u,\"last\":%s,\"now_ms\":%u,\"lost\":%u,\"blocks\":[%s]}}",
+        (unsigned int)cursor->part,
+        last ? "true" : "false",
+        (unsigned int)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U)),
+        (unsigned int)cursor->lost_blocks,
+        blocks_json
+    );
+    if (result_len <= 0 || result_len >= (int)sizeof(result_json)) {
+        return 0;
+    }
+
+    BuildAckTimestamp(NULL, ack_ts, sizeof(ack_ts), &time_source);
+    frame_len = BuildDeviceCommandAckV1(command_id, "acked", result_json, ack_ts, frame, sizeof(frame));
+    if (frame_len <= 0 || frame_len >= (int)sizeof(frame)) {
+        printf("[HISTORY] frame build failed id=%s part=%u\n", command_id, (unsigned int)cursor->part);
+        return 0;
+    }
+    if (XL01_SendPlatformCommandAck(frame, frame_len) != frame_len) {
+        printf("[HISTORY] frame TX failed id=%s part=%u\n", command_id, (unsigned int)cursor->part);
+    }
+    return last ? 0 : 1;
+}
+#endif
+
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+/*
+ * One fetch_log frame, framed like fetch_history. "next_cursor" is where a
+ * later fetch_log resumes; "more" on the last frame means records were left
+ * for that follow-up fetch.
+ * Returns 1 while more frames remain, 0 when the stream is finished.
+ */
+static int SendNextLogFrame(SampleLogCursor *cursor, const char *command_id)
+{
+    static char records_json[FIELD_LINK_MAX_PAYLOAD_BYTES - SAMPLE_LOG_FRAME_OVERHEAD_BYTES];
+    static char result_json[FIELD_LINK_MAX_PAYLOAD_BYTES - SAMPLE_LOG_FRAME_OVERHEAD_BYTES + 160];
+    static char frame[FIELD_LINK_MAX_PAYLOAD_BYTES + 1];
+    char ack_ts[32];
+    const char *time_source = NULL;
+    int records_len;
+    int result_len;
+    int frame_len;
+    int last;
+
+    records_len = SampleLog_EncodeNext(cursor, records_json, sizeof(records_json));
+    if (records_len < 0) {
+        printf("[SAMPLE LOG] record does not fit a frame; stream aborted id=%s\n", command_id);
+        return 0;
+    }
+    last = cursor->done ? 1 : 0;
+
+    result_len = snprintf(
+        result_json,
+        sizeof(result_json),
+        "{\"log\":{\"part\":%u,\"last\":%s,\"more\":%s,\"next_cursor\":%u,\"lost\":%u,"
+        "\"boot\":%u,\"now_ms\":%u,\"records\":[%s]}}",
+        (unsigned int)cursor->part,
+        last ? "true" : "false",
+        cursor->more ? "true" : "false",
+        (unsigned int)cursor->it.cursor,
+        (unsigned int)cursor->it.lost,
+        (unsigned int)SampleLog_Boot(),
+        (unsigned int)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U)),
+        records_json
+    );
+    if (result_len <= 0 || result_len >= (int)sizeof(result_json)) {
+        return 0;
+    }
+
+    BuildAckTimestamp(NULL, ack_ts, sizeof(ack_ts), &time_source);
+    frame_len = BuildDeviceCommandAckV1(command_id, "acked", result_json, ack_ts, frame, sizeof(frame));
+    if (frame_len <= 0 || frame_len >= (int)sizeof(frame)) {
+        printf("[SAMPLE LOG] frame build failed id=%s part=%u\n", command_id, (unsigned int)cursor->part);
+        return 0;
+    }
+    if (XL01_SendPlatformCommandAck(frame, frame_len) != frame_len) {
+        printf("[SAMPLE LOG] frame TX failed id=%s part=%u\n", command_id, (unsigned int)cursor->part);
+    }
+    return last ? 0 : 1;
+}
+#endif
+
 // ==================== Task 4: Data Upload ====================
 
+static uint32_t UplinkNowMs(void)
+{
+    return (uint32_t)(((uint64_t)LOS_TickCountGet() * 1000U) / LOS_MS2Tick(1000U));
+}
+
 static void* DataUploadTask(const char* arg)
 {
     (void)arg;
     char json[FIELD_LINK_MAX_PAYLOAD_BYTES + 1];
     SensorData telemetry_snapshot;
+#if ENABLE_SAMPLE_HISTORY && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+    SampleHistoryCursor history_cursor;
+    char history_command_id[sizeof(g_history_pending_command_id)];
+    int history_streaming = 0;
+#endif
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+    SampleLogCursor log_cursor;
+    char log_command_id[sizeof(g_log_pending_command_id)];
+    int log_streaming = 0;
+#endif
+    char event_ts[sizeof(g_last_trusted_time_ts)];
+    const char *event_time_source;
+    int64_t event_utc_ms;
     int len;
     unsigned int elapsed_since_upload_ms = UPLOAD_INTERVAL_MS;
+#if EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_HYBRID
+    uint32_t seen_command_tick = g_last_platform_command_tick;
+#endif
+    RiskAssessment risk;
+    int reported_risk_level = RISK_LEVEL_SAFE;
     
     LOS_Msleep(3000);
     printf("[Task] Data Upload started\n\n");
@@ -1358,8 +2143,8 @@ static void* DataUploadTask(const char* arg)
     printf("========================================\n");
     printf("  Configuration Summary\n");
     printf("========================================\n");
-    printf("  Device ID: %s\n", DEVICE_ID);
-    printf("  Install Label: %s\n", INSTALL_LABEL);
+    printf("  Device ID: %s\n", DeviceIdentity_Get()->device_id);
+    printf("  Install Label: %s\n", DeviceIdentity_Get()->install_label);
     printf("  Sample Version: %s\n", FIRMWARE_SAMPLE_VERSION);
     printf("  XL01 UART: %s\n", XL01_UART_ROUTE_NAME);
 #if ENABLE_RS485_BUS
@@ -1374,7 +2159,9 @@ static void* DataUploadTask(const char* arg)
     printf("  UART TX Chunk Delay: %d ms\n", XL01_UART_TX_CHUNK_DELAY_MS);
     printf("  Post ACK Quiet: %d ms\n", PLATFORM_POST_ACK_QUIET_MS);
     printf("  Manual Collect Delay: %d ms\n", PLATFORM_MANUAL_COLLECT_DELAY_MS);
-    printf("  Edge Uplink Mode: %s\n", EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_POLLED ? "Polled" : "Periodic");
+    printf("  Edge Uplink Mode: %s\n",
+           EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_HYBRID ? "Hybrid" :
+           EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_POLLED ? "Polled" : "Periodic");
     printf("  Max Retries: %d\n", MAX_RETRY_COUNT);
     printf("  ACK Check: %s\n", ENABLE_ACK_CHECK ? "Enabled" : "Disabled");
     printf("  ACK Timeout: %d ms\n", ACK_TIMEOUT_MS);
@@ -1413,6 +2200,9 @@ static void* DataUploadTask(const char* arg)
     while (1) {
         int manual_collect_requested = 0;
         int poll_latest_requested = 0;
+        UplinkPushKind push_kind = UPLINK_PUSH_NONE;
+        int send_ok = 1;
+        int32_t reported_jump_ms = 0;
         const char *upload_trigger = "periodic";
         unsigned int sleep_ms = 200;
 
@@ -1445,14 +2235,74 @@ static void* DataUploadTask(const char* arg)
             g_platform_poll_latest_requested = 0;
         }
 
+        if (GetLatestRiskAssessment(&risk) != 0) {
+            memset(&risk, 0, sizeof(risk));
+            risk.level = RISK_LEVEL_SAFE;
+        }
+#if EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_HYBRID
+        if (seen_command_tick != g_last_platform_command_tick) {
+            seen_command_tick = g_last_platform_command_tick;
+            UplinkPolicy_OnGatewayContact();
+        }
+        // Unsolicited pushes only while nothing the gateway asked for is pending.
+        if (!manual_collect_requested && !poll_latest_requested && g_platform_uplink_enabled && !DOWNLINK_ONLY_MODE) {
+            push_kind = UplinkPolicy_Decide(risk.level, UplinkNowMs());
+            if (push_kind != UPLINK_PUSH_NONE) {
+                printf("[UPLINK PUSH] %s level=%d reported=%d backoff_shift=%u %s\n",
+                       push_kind == UPLINK_PUSH_ALERT ? "alert" : "report",
+                       (int)risk.level,
+                       reported_risk_level,
+                       (unsigned int)UplinkPolicy_BackoffShift(),
+                       risk.description);
+            }
+        }
+#endif
+
+#if ENABLE_SAMPLE_HISTORY && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+        if (g_history_fetch_requested) {
+            // A newer fetch_history replaces any stream still in progress.
+            g_history_fetch_requested = 0;
+            history_cursor = g_history_pending_cursor;
+            memcpy(history_command_id, g_history_pending_command_id, sizeof(history_command_id));
+            history_streaming = 1;
+        }
+        // Polls and manual collects go first; history fills the gaps between them.
+        if (history_streaming && !manual_collect_requested && !poll_latest_requested &&
+            push_kind == UPLINK_PUSH_NONE) {
+            history_streaming = SendNextHistoryFrame(&history_cursor, history_command_id);
+            LOS_Msleep(SAMPLE_HISTORY_FRAME_GAP_MS);
+            elapsed_since_upload_ms += SAMPLE_HISTORY_FRAME_GAP_MS;
+            continue;
+        }
+#endif
+#if ENABLE_SAMPLE_HISTORY && ENABLE_SAMPLE_FLASH_LOG && !ENABLE_SHARED_PORT_SOURCE_CONTROL
+        if (g_log_fetch_requested) {
+            g_log_fetch_requested = 0;
+            log_cursor = g_log_pending_cursor;
+            memcpy(log_command_id, g_log_pending_command_id, sizeof(log_command_id));
+            log_streaming = 1;
+        }
+        if (log_streaming && !manual_collect_requested && !poll_latest_requested &&
+            push_kind == UPLINK_PUSH_NONE) {
+            log_streaming = SendNextLogFrame(&log_cursor, log_command_id);
+            LOS_Msleep(SAMPLE_HISTORY_FRAME_GAP_MS);
+            elapsed_since_upload_ms += SAMPLE_HISTORY_FRAME_GAP_MS;
+            continue;
+        }
+#endif
+
         if (manual_collect_requested) {
             upload_trigger = "manual_collect";
         } else if (poll_latest_requested) {
             upload_trigger = "scheduler_poll";
+        } else if (push_kind == UPLINK_PUSH_ALERT) {
+            upload_trigger = "risk_alert";
+        } else if (push_kind == UPLINK_PUSH_REPORT) {
+            upload_trigger = "risk_report";
         }
 
-#if EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_POLLED
-        if (!manual_collect_requested && !poll_latest_requested) {
+#if EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_POLLED || EDGE_UPLINK_MODE == EDGE_UPLINK_MODE_HYBRID
+        if (!manual_collect_requested && !poll_latest_requested && push_kind == UPLINK_PUSH_NONE) {
             LOS_Msleep(sleep_ms);
             continue;
         }
@@ -1511,20 +2361,49 @@ static void* DataUploadTask(const char* arg)
             continue;
         }
 
-        SensorData_TakeUploadSnapshot(&telemetry_snapshot);
+        if (push_kind == UPLINK_PUSH_ALERT) {
+            SensorData_TakeAlertSnapshot(&telemetry_snapshot);
+        } else {
+            SensorData_TakeUploadSnapshot(&telemetry_snapshot);
+        }
         memset(json, 0, sizeof(json));
-        
-        len = BuildTelemetryEnvelopeV1(
-            &telemetry_snapshot,
-            g_last_platform_command_type,
-            g_last_platform_command_id,
-            g_last_platform_command_uptime_s,
-            upload_trigger,
-            g_last_trusted_time_ts,
-            g_last_trusted_time_source,
-            json,
-            sizeof(json)
-        );
+
+        // Disciplined UTC when synced; otherwise the last gateway timestamp as before.
+        if (TimeDiscipline_NowUtcMs(&event_utc_ms) == 0 &&
+            TimeDiscipline_FormatRfc3339(event_utc_ms, event_ts, sizeof(event_ts)) > 0) {
+            event_time_source = TimeDiscipline_SourceName();
+        } else {
+            strncpy(event_ts, g_last_trusted_time_ts, sizeof(event_ts) - 1);
+            event_ts[sizeof(event_ts) - 1] = '\0';
+            event_time_source = g_last_trusted_time_source;
+        }
+
+        if (push_kind == UPLINK_PUSH_ALERT) {
+            len = BuildTelemetryAlertV1(
+                &telemetry_snapshot,
+                &risk,
+                reported_risk_level,
+                event_ts,
+                event_time_source,
+                json,
+                sizeof(json)
+            );
+        } else {
+            // Only peeked: a skipped or failed upload reports the step next time.
+            reported_jump_ms = TimeDiscipline_PeekJumpMs();
+            len = BuildTelemetryEnvelopeV1(
+                &telemetry_snapshot,
+                g_last_platform_command_type,
+                g_last_platform_command_id,
+                g_last_platform_command_uptime_s,
+                upload_trigger,
+                event_ts,
+                event_time_source,
+                (int)reported_jump_ms,
+                json,
+                sizeof(json)
+            );
+        }
         if (len == TELEMETRY_ENVELOPE_ERR_EMPTY_METRICS) {
 #if PLATFORM_COMMAND_RX_LOG_MODE
             printf("[UPLOAD SKIP] no valid metrics for seq=%u trigger=%s\n",
@@ -1532,6 +2411,10 @@ static void* DataUploadTask(const char* arg)
                    upload_trigger);
 #endif
             PrintSparseMetricsDiagnostic(&telemetry_snapshot, upload_trigger);
+            if (push_kind != UPLINK_PUSH_ALERT) {
+                SensorData_RestoreUploadWindow(&telemetry_snapshot);
+            }
+            UplinkPolicy_OnSent(push_kind, risk.level, 0, UplinkNowMs());
             elapsed_since_upload_ms = 0;
             LOS_Msleep(200);
             elapsed_since_upload_ms += 200;
@@ -1539,6 +2422,10 @@ static void* DataUploadTask(const char* arg)
         }
         if (len <= 0 || len >= (int)sizeof(json)) {
             printf("[ERROR] Failed to build telemetry envelope\n");
+            if (push_kind != UPLINK_PUSH_ALERT) {
+                SensorData_RestoreUploadWindow(&telemetry_snapshot);
+            }
+            UplinkPolicy_OnSent(push_kind, risk.level, 0, UplinkNowMs());
             LOS_Msleep(UPLOAD_INTERVAL_MS);
             continue;
         }
@@ -1553,6 +2440,7 @@ static void* DataUploadTask(const char* arg)
                 len
             ) <= 0) {
             printf("[SRC CTRL QUEUE FAIL] seq=%u device=%s\n", telemetry_snapshot.seq, DeviceIdentity_Get()->device_id);
+            send_ok = 0;
         } else {
             printf("[SRC CTRL STAGE] seq=%u device=%s trigger=%s\n",
                    telemetry_snapshot.seq,
@@ -1564,6 +2452,7 @@ static void* DataUploadTask(const char* arg)
             int ret = XL01_SendWithRetry(json, len, &g_stats);
             g_stats.total_sent++;
             g_stats.total_bytes += len;
+            send_ok = ret == 0;
 
             printf("[SEND #%u] %d bytes device=%s", telemetry_snapshot.seq, len, DeviceIdentity_Get()->device_id);
             if (ret == 0) {
@@ -1581,6 +2470,14 @@ static void* DataUploadTask(const char* arg)
             printf("\n");
         }
 #endif
+
+        UplinkPolicy_OnSent(push_kind, risk.level, send_ok, UplinkNowMs());
+        if (send_ok) {
+            reported_risk_level = (int)risk.level;
+            TimeDiscipline_AckJumpMs(reported_jump_ms);
+        } else if (push_kind != UPLINK_PUSH_ALERT) {
+            SensorData_RestoreUploadWindow(&telemetry_snapshot);
+        }
         
         // 显示GPS坐标而不只是状态（删除电池显示）
         {
@@ -1648,16 +2545,19 @@ static void* DataUploadTask(const char* arg)
             }
 
             if (telemetry_snapshot.gps_valid &&
-                (telemetry_snapshot.latitude != 0.0f || telemetry_snapshot.longitude != 0.0f)) {
+                (telemetry_snapshot.latitude != 0.0 || telemetry_snapshot.longitude != 0.0)) {
                 printf(
-                    "  Temp:%s Humi:%s Soil:%s Tilt:%s Rain:%s GPS:(%.6f,%.6f)\n",
+                    "  Temp:%s Humi:%s Soil:%s Tilt:%s Rain:%s GPS:(%.7f,%.7f) q=%d sats=%d hdop=%.2f\n",
                     temp_buf,
                     humi_buf,
                     soil_buf,
                     tilt_buf,
                     rain_buf,
                     telemetry_snapshot.latitude,
-                    telemetry_snapshot.longitude
+                    telemetry_snapshot.longitude,
+                    telemetry_snapshot.gps_quality,
+                    telemetry_snapshot.gps_sats,
+                    telemetry_snapshot.gps_hdop
                 );
             } else {
                 printf("  Temp:%s Humi:%s Soil:%s Tilt:%s Rain:%s GPS:NO\n",
@@ -1764,7 +2664,30 @@ static void App_SystemInit(void)
     
     // Initialize watchdog
     Watchdog_Init();
+#if ENABLE_RUNTIME_STATS
+    // Before any task starts, so every switch is counted
+    RuntimeStats_Init();
+#endif
     
+    // Clock discipline must exist before GPS and command RX can feed it
+    TimeDiscipline_Init();
+    MotionFeatures_Init();
+#if ENABLE_RISK_ENGINE
+    RiskEngine_Init();
+#endif
+    // The device id seeds the push jitter so nodes that escalate together spread out.
+    UplinkPolicy_Init(Crc_Ieee32(
+        (const uint8_t *)DeviceIdentity_Get()->device_id,
+        (unsigned int)strlen(DeviceIdentity_Get()->device_id)
+    ));
+#if ENABLE_SAMPLE_HISTORY
+    SampleHistory_Init();
+#if ENABLE_SAMPLE_FLASH_LOG
+    // Recover the boot counter and write position before any block closes.
+    (void)SampleLog_Init(FlashStorage_LogPort());
+#endif
+#endif
+
     // Initialize XL01 driver
     XL01_Init();
     g_last_platform_command_tick = (uint32_t)LOS_TickCountGet();
@@ -1816,6 +2739,7 @@ static void App_SystemInit(void)
 
 #if ENABLE_MPU6050
     if (g_i2c_ready && TryInitMpu6050WithRetry("boot") == 0) {
+        g_mpu6050_generation++;
         g_mpu6050_ready = 1;
     } else if (g_i2c_ready) {
         printf("[WARN] MPU6050 init failed; IMU metrics will be omitted until runtime reinit succeeds\n");
@@ -1871,6 +2795,27 @@ static void MainEntry(void)
         printf("[ERROR] Failed to create SensorTask\n");
     }
 
+#if ENABLE_RS485_BUS
+    // Slow or absent slaves block only this task, not GPS draining or the snapshot loop.
+    attr.name = "Rs485BusTask";
+    attr.stack_size = 4096;
+    attr.priority = osPriorityNormal;
+    thread_id = osThreadNew((osThreadFunc_t)Rs485BusTask, NULL, &attr);
+    if (thread_id == NULL) {
+        printf("[ERROR] Failed to create Rs485BusTask\n");
+    }
+#endif
+
+#if ENABLE_MPU6050 && ENABLE_IMU_FIFO_CAPTURE
+    attr.name = "ImuCaptureTask";
+    attr.stack_size = 2048;
+    attr.priority = osPriorityNormal;
+    thread_id = osThreadNew((osThreadFunc_t)ImuCaptureTask, NULL, &attr);
+    if (thread_id == NULL) {
+        printf("[ERROR] Failed to create ImuCaptureTask\n");
+    }
+#endif
+
     attr.name = "UartRxTask";
     attr.stack_size = 4096;
     // LiteOS-M maps CMSIS priorities around osPriorityNormal.
@@ -1882,7 +2827,9 @@ static void MainEntry(void)
     }
 
     attr.name = "FieldLinkHealth";
-    attr.stack_size = 2048;
+    // Also flushes the flash sample log and prints the runtime stats summary;
+    // on the host build its peak sits with UploadTask's, well past 2KB.
+    attr.stack_size = 4096;
     attr.priority = osPriorityBelowNormal;
     thread_id = osThreadNew((osThreadFunc_t)FieldLinkHealthTask, NULL, &attr);
     if (thread_id == NULL) {
@@ -0,0 +1,74 @@
+/*
+ * CRC Utilities
+ * Table-driven CRC16/Modbus, CRC8/Sensirion and CRC32/IEEE shared by the
+ * RS485, SHT30 and field-link code paths.
+ */
+
+#ifndef UTILS_CRC_H
+#define UTILS_CRC_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CRC16_MODBUS_INIT     0xFFFFU
+#define CRC8_SENSIRION_INIT   0xFFU
+#define CRC32_IEEE_INIT       0xFFFFFFFFUL
+
+/**
+ * Fold len bytes into a running CRC16/Modbus (poly 0xA001 reflected).
+ * Start from CRC16_MODBUS_INIT; a frame that includes its own little-endian
+ * CRC folds to 0, so a receiver can check the CRC as bytes arrive.
+ */
+uint16_t Crc_Modbus16Update(uint16_t crc, const uint8_t *data, unsigned int len);
+
+/**
+ * One-shot CRC16/Modbus over a buffer.
+ */
+uint16_t Crc_Modbus16(const uint8_t *data, unsigned int len);
+
+/**
+ * Fold len bytes into a running CRC8/Sensirion (poly 0x31, no reflection).
+ * Start from CRC8_SENSIRION_INIT.
+ */
+uint8_t Crc_Sensirion8Update(uint8_t crc, const uint8_t *data, unsigned int len);
+
+/**
+ * One-shot CRC8/Sensirion over a buffer.
+ */
+uint8_t Crc_Sensirion8(const uint8_t *data, unsigned int len);
+
+/**
+ * Fold len bytes into a running CRC32/IEEE register (poly 0xEDB88320
+ * reflected). Start from CRC32_IEEE_INIT and pass the result to
+ * Crc_Ieee32Final once the last byte has been folded.
+ */
+uint32_t Crc_Ieee32Update(uint32_t crc, const uint8_t *data, unsigned int len);
+
+/**
+ * Apply the final XOR to a running CRC32 register.
+ */
+uint32_t Crc_Ieee32Final(uint32_t crc);
+
+/**
+ * One-shot CRC32/IEEE over a buffer (same value as zlib crc32).
+ */
+uint32_t Crc_Ieee32(const uint8_t *data, unsigned int len);
+
+#if CRC_ENABLE_BITWISE_REFERENCE
+/**
+ * Bitwise reference implementations, kept for host test vectors and
+ * benchmarks only. Firmware builds leave CRC_ENABLE_BITWISE_REFERENCE unset.
+ */
+uint16_t Crc_Modbus16Bitwise(const uint8_t *data, unsigned int len);
+uint8_t Crc_Sensirion8Bitwise(const uint8_t *data, unsigned int len);
+uint32_t Crc_Ieee32Bitwise(const uint8_t *data, unsigned int len);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UTILS_CRC_H
@@ -0,0 +1,211 @@
+/*
+ * Fixed-Point DSP Kernels Implementation
+ */
+
+#include "fixed_dsp.h"
+#include <stddef.h>
+#include "../config/app_config.h"
+
+#ifndef FIXED_DSP_USE_CMSIS
+#define FIXED_DSP_USE_CMSIS 0
+#endif
+
+#if FIXED_DSP_USE_CMSIS
+#include "arm_math.h"
+#endif
+
+#define CORDIC_ITERATIONS 20
+#define CORDIC_HALF_TURN  (1L << 30)    // Internal angle unit: 2^30 = 180 deg
+#define CORDIC_INPUT_BITS 29            // Headroom for the 1.647 CORDIC gain
+
+// atan(2^-i) in CORDIC_HALF_TURN units
+static const int32_t g_cordic_atan[CORDIC_ITERATIONS] = {
+    268435456, 158466703, 83729454, 42502378, 21333666,
+    10677233, 5339919, 2670123, 1335082, 667543,
+    333772, 166886, 83443, 41722, 20861,
+    10430, 5215, 2608, 1304, 652,
+};
+
+int16_t FixedDsp_SatQ15(int32_t value)
+{
+    if (value > 32767) {
+        return 32767;
+    }
+    if (value < -32768) {
+        return -32768;
+    }
+    return (int16_t)value;
+}
+
+uint32_t FixedDsp_SqrtU32(uint32_t value)
+{
+    uint32_t root = 0U;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0U) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+int16_t FixedDsp_Atan2Q15(int32_t y, int32_t x)
+{
+    int32_t angle = 0;
+    int32_t magnitude;
+    int shift = 0;
+    int i;
+
+    if (x == 0 && y == 0) {
+        return 0;
+    }
+
+    // Fold the left half-plane onto the right one; CORDIC converges for |angle| < 99 deg.
+    if (x < 0) {
+        angle = y >= 0 ? CORDIC_HALF_TURN : -CORDIC_HALF_TURN;
+        x = -x;
+        y = -y;
+    }
+
+    // Scale up (or down) so the larger input sits just below 2^CORDIC_INPUT_BITS.
+    magnitude = x > (y < 0 ? -y : y) ? x : (y < 0 ? -y : y);
+    while (magnitude < (1L << (CORDIC_INPUT_BITS - 1)) && shift < 31) {
+        magnitude <<= 1;
+        shift++;
+    }
+    while (magnitude >= (1L << CORDIC_INPUT_BITS)) {
+        magnitude >>= 1;
+        shift--;
+    }
+    if (shift >= 0) {
+        x <<= shift;
+        y <<= shift;
+    } else {
+        x >>= -shift;
+        y >>= -shift;
+    }
+
+    // Vectoring mode: rotate (x, y) onto the x axis and sum the rotations.
+    for (i = 0; i < CORDIC_ITERATIONS; ++i) {
+        int32_t dx = y >> i;
+        int32_t dy = x >> i;
+
+        if (y > 0) {
+            x += dx;
+            y -= dy;
+            angle += g_cordic_atan[i];
+        } else {
+            x -= dx;
+            y += dy;
+            angle -= g_cordic_atan[i];
+        }
+    }
+
+    // 2^30 -> 2^15 per half turn, rounded
+    return FixedDsp_SatQ15((angle + (1L << 14)) >> 15);
+}
+
+void FixedDsp_DiffQ15(const int16_t *in, int16_t *out, uint32_t count, int16_t prev)
+{
+    if (in == NULL || out == NULL || count == 0U) {
+        return;
+    }
+
+    out[0] = FixedDsp_SatQ15((int32_t)in[0] - prev);
+#if FIXED_DSP_USE_CMSIS
+    if (count > 1U) {
+        arm_sub_q15((const q15_t *)&in[1], (const q15_t *)&in[0], (q15_t *)&out[1], count - 1U);
+    }
+#else
+    {
+        uint32_t i;
+
+        for (i = 1U; i < count; ++i) {
+            out[i] = FixedDsp_SatQ15((int32_t)in[i] - in[i - 1U]);
+        }
+    }
+#endif
+}
+
+uint32_t FixedDsp_MeanSquareQ15(const int16_t *in, uint32_t count)
+{
+    if (in == NULL || count == 0U) {
+        return 0U;
+    }
+
+#if FIXED_DSP_USE_CMSIS
+    {
+        q63_t power = 0;
+
+        // 34.30 sum of squares
+        arm_power_q15((const q15_t *)in, count, &power);
+        return (uint32_t)((uint64_t)power / count);
+    }
+#else
+    {
+        uint64_t sum = 0U;
+        uint32_t i;
+
+        for (i = 0U; i < count; ++i) {
+            sum += (uint64_t)((int32_t)in[i] * in[i]);
+        }
+        return (uint32_t)(sum / count);
+    }
+#endif
+}
+
+int16_t FixedDsp_RmsQ15(const int16_t *in, uint32_t count)
+{
+    if (in == NULL || count == 0U) {
+        return 0;
+    }
+
+#if FIXED_DSP_USE_CMSIS
+    {
+        q15_t rms = 0;
+
+        arm_rms_q15((const q15_t *)in, count, &rms);
+        return rms;
+    }
+#else
+    return FixedDsp_SatQ15((int32_t)FixedDsp_SqrtU32(FixedDsp_MeanSquareQ15(in, count)));
+#endif
+}
+
+uint32_t FixedDsp_ZeroCrossingsQ15(const int16_t *in, uint32_t count, int16_t hysteresis, int8_t *side)
+{
+    uint32_t crossings = 0U;
+    int8_t current;
+    uint32_t i;
+
+    if (in == NULL || side == NULL) {
+        return 0U;
+    }
+
+    current = *side;
+    for (i = 0U; i < count; ++i) {
+        int8_t next;
+
+        if (in[i] > hysteresis) {
+            next = 1;
+        } else if (in[i] < -hysteresis) {
+            next = -1;
+        } else {
+            continue;
+        }
+        if (current != 0 && next != current) {
+            crossings++;
+        }
+        current = next;
+    }
+    *side = current;
+    return crossings;
+}
@@ -0,0 +1,63 @@
+/*
+ * Fixed-Point DSP Kernels
+ * Q15/Q31 first difference, mean square / RMS, zero crossings, integer square
+ * root and CORDIC atan2 for per-sample feature extraction without the FPU.
+ * Define FIXED_DSP_USE_CMSIS=1 to route the block kernels through CMSIS-DSP.
+ */
+
+#ifndef UTILS_FIXED_DSP_H
+#define UTILS_FIXED_DSP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIXED_DSP_Q15_ONE 32768
+
+/**
+ * Saturate a 32-bit intermediate to Q15.
+ */
+int16_t FixedDsp_SatQ15(int32_t value);
+
+/**
+ * floor(sqrt(value)), bit by bit: 16 iterations, no multiply or divide.
+ */
+uint32_t FixedDsp_SqrtU32(uint32_t value);
+
+/**
+ * atan2(y, x) as a Q15 fraction of a half turn (16384 = 90 deg, saturating at
+ * +/-32767). Any input scale works; 20 CORDIC steps land within half an
+ * output LSB (0.003 deg).
+ */
+int16_t FixedDsp_Atan2Q15(int32_t y, int32_t x);
+
+/**
+ * First difference: out[0] = in[0] - prev, out[i] = in[i] - in[i-1],
+ * saturated to Q15. Pass the last sample of the previous block as prev.
+ */
+void FixedDsp_DiffQ15(const int16_t *in, int16_t *out, uint32_t count, int16_t prev);
+
+/**
+ * Mean of in[i]^2 in Q30 (Q15 x Q15).
+ */
+uint32_t FixedDsp_MeanSquareQ15(const int16_t *in, uint32_t count);
+
+/**
+ * Root mean square in Q15.
+ */
+int16_t FixedDsp_RmsQ15(const int16_t *in, uint32_t count);
+
+/**
+ * Sign changes of a zero-mean signal, ignoring excursions inside
+ * +/-hysteresis. side carries the last confirmed sign (-1, 0 or +1) across
+ * blocks; start it at 0.
+ */
+uint32_t FixedDsp_ZeroCrossingsQ15(const int16_t *in, uint32_t count, int16_t hysteresis, int8_t *side);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // UTILS_FIXED_DSP_H
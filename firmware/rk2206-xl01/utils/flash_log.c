@@ -0,0 +1,435 @@
+#include "flash_log.h"
+#include <stddef.h>
+#include <string.h>
+#include "crc.h"
+
+#define FLASH_LOG_MAGIC 0x474F4C53U  // "SLOG"
+#define FLASH_LOG_BLANK_WORD 0xFFFFFFFFU
+#define FLASH_LOG_SCAN_CHUNK 64U
+
+typedef struct {
+    uint32_t sector_seq;
+    uint32_t first_record_seq;
+} FlashLogSectorHeader;
+
+typedef enum {
+    RECORD_VALID = 0,
+    RECORD_END,         // Erased space follows
+    RECORD_CORRUPT,     // CRC mismatch, length is still trustworthy
+    RECORD_TORN         // Nothing after this point in the sector can be trusted
+} RecordState;
+
+static void PutLe32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v & 0xFFU);
+    p[1] = (uint8_t)((v >> 8) & 0xFFU);
+    p[2] = (uint8_t)((v >> 16) & 0xFFU);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t GetLe32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint32_t Align4(uint32_t v)
+{
+    return (v + 3U) & ~3U;
+}
+
+static uint32_t RecordBytes(uint16_t size)
+{
+    return FLASH_LOG_RECORD_OVERHEAD_BYTES + Align4(size);
+}
+
+static uint32_t SectorBase(const FlashLog *log, uint32_t sector)
+{
+    return sector * log->port->sector_size;
+}
+
+static uint32_t NextSector(const FlashLog *log, uint32_t sector)
+{
+    return (sector + 1U) % log->port->sector_count;
+}
+
+/* @return 1 valid, 0 erased or damaged, -2 port failure */
+static int ReadSectorHeader(const FlashLog *log, uint32_t sector, FlashLogSectorHeader *header)
+{
+    uint8_t raw[FLASH_LOG_SECTOR_HEADER_BYTES];
+
+    if (log->port->read(SectorBase(log, sector), raw, sizeof(raw)) != 0) {
+        return -2;
+    }
+    if (GetLe32(raw) != FLASH_LOG_MAGIC || GetLe32(raw + 12) != Crc_Ieee32(raw, 12)) {
+        return 0;
+    }
+    header->sector_seq = GetLe32(raw + 4);
+    header->first_record_seq = GetLe32(raw + 8);
+    return 1;
+}
+
+static int StartSector(FlashLog *log, uint32_t sector, uint32_t sector_seq)
+{
+    uint8_t raw[FLASH_LOG_SECTOR_HEADER_BYTES];
+
+    if (log->port->erase(SectorBase(log, sector), log->port->sector_size) != 0) {
+        return -2;
+    }
+    log->erase_count++;
+
+    PutLe32(raw, FLASH_LOG_MAGIC);
+    PutLe32(raw + 4, sector_seq);
+    PutLe32(raw + 8, log->next_record_seq);
+    PutLe32(raw + 12, Crc_Ieee32(raw, 12));
+    if (log->port->write(SectorBase(log, sector), raw, sizeof(raw)) != 0) {
+        return -2;
+    }
+
+    log->head_sector = sector;
+    log->head_sector_seq = sector_seq;
+    log->head_offset = FLASH_LOG_SECTOR_HEADER_BYTES;
+    return 0;
+}
+
+/*
+ * Classify the record at offset in sector. For RECORD_VALID and
+ * RECORD_CORRUPT, *out_size holds its payload length. When data is non-NULL
+ * and large enough the payload is copied there while the CRC is checked.
+ */
+static int ReadRecord(
+    const FlashLog *log,
+    uint32_t sector,
+    uint32_t offset,
+    uint8_t *data,
+    uint16_t data_size,
+    uint16_t *out_size,
+    uint32_t *out_seq
+)
+{
+    const uint32_t base = SectorBase(log, sector) + offset;
+    uint8_t word[8];
+    uint8_t chunk[FLASH_LOG_SCAN_CHUNK];
+    uint32_t length_word;
+    uint32_t crc;
+    uint16_t size;
+    uint32_t done;
+
+    if (offset + FLASH_LOG_RECORD_OVERHEAD_BYTES > log->port->sector_size) {
+        return RECORD_TORN;
+    }
+    if (log->port->read(base, word, sizeof(word)) != 0) {
+        return -2;
+    }
+
+    length_word = GetLe32(word);
+    if (length_word == FLASH_LOG_BLANK_WORD) {
+        // The body is written before the length word, so a written body
+        // behind a blank length word is an append cut short by power loss.
+        return GetLe32(word + 4) == FLASH_LOG_BLANK_WORD ? RECORD_END : RECORD_TORN;
+    }
+    size = (uint16_t)(length_word & 0xFFFFU);
+    if ((uint16_t)(length_word >> 16) != (uint16_t)~size ||
+        size == 0U ||
+        offset + RecordBytes(size) > log->port->sector_size) {
+        return RECORD_TORN;
+    }
+
+    *out_size = size;
+    *out_seq = GetLe32(word + 4);
+    crc = Crc_Ieee32Update(0xFFFFFFFFU, word + 4, 4);
+    if (data != NULL && size <= data_size) {
+        if (log->port->read(base + 8U, data, size) != 0) {
+            return -2;
+        }
+        crc = Crc_Ieee32Update(crc, data, size);
+    } else {
+        for (done = 0; done < size; done += FLASH_LOG_SCAN_CHUNK) {
+            uint32_t n = size - done < FLASH_LOG_SCAN_CHUNK ? size - done : FLASH_LOG_SCAN_CHUNK;
+
+            if (log->port->read(base + 8U + done, chunk, n) != 0) {
+                return -2;
+            }
+            crc = Crc_Ieee32Update(crc, chunk, n);
+        }
+    }
+    if (log->port->read(base + 8U + Align4(size), word, 4) != 0) {
+        return -2;
+    }
+    return Crc_Ieee32Final(crc) == GetLe32(word) ? RECORD_VALID : RECORD_CORRUPT;
+}
+
+int FlashLog_Mount(FlashLog *log, const FlashLogPort *port)
+{
+    FlashLogSectorHeader header;
+    FlashLogSectorHeader head_header;
+    uint32_t tail_seq = 0;
+    uint32_t sector;
+    int found = 0;
+    int ret;
+
+    if (log == NULL || port == NULL || port->read == NULL || port->write == NULL || port->erase == NULL ||
+        port->sector_count < 2U ||
+        port->sector_size < FLASH_LOG_SECTOR_HEADER_BYTES + FLASH_LOG_RECORD_OVERHEAD_BYTES + 4U) {
+        return -1;
+    }
+
+    memset(log, 0, sizeof(*log));
+    log->port = port;
+    memset(&head_header, 0, sizeof(head_header));
+
+    for (sector = 0; sector < port->sector_count; ++sector) {
+        ret = ReadSectorHeader(log, sector, &header);
+        if (ret < 0) {
+            return ret;
+        }
+        if (ret == 0) {
+            continue;
+        }
+        if (!found || header.sector_seq > head_header.sector_seq) {
+            log->head_sector = sector;
+            head_header = header;
+        }
+        if (!found || header.sector_seq < tail_seq) {
+            log->tail_sector = sector;
+            tail_seq = header.sector_seq;
+        }
+        found = 1;
+    }
+
+    if (!found) {
+        log->tail_sector = 0;
+        return StartSector(log, 0, 1U);
+    }
+
+    log->head_sector_seq = head_header.sector_seq;
+    log->next_record_seq = head_header.first_record_seq;
+    log->head_offset = FLASH_LOG_SECTOR_HEADER_BYTES;
+    for (;;) {
+        uint16_t size = 0;
+        uint32_t seq = 0;
+
+        ret = ReadRecord(log, log->head_sector, log->head_offset, NULL, 0, &size, &seq);
+        if (ret < 0) {
+            return ret;
+        }
+        if (ret == RECORD_END) {
+            break;
+        }
+        if (ret == RECORD_TORN) {
+            // Never write over partially programmed cells; resume in the next sector.
+            log->head_offset = port->sector_size;
+            break;
+        }
+        if (ret == RECORD_VALID && seq >= log->next_record_seq) {
+            log->next_record_seq = seq + 1U;
+        }
+        log->head_offset += RecordBytes(size);
+    }
+    return 0;
+}
+
+static int Rotate(FlashLog *log)
+{
+    FlashLogSectorHeader header;
+    uint32_t next = NextSector(log, log->head_sector);
+
+    if (next == log->tail_sector) {
+        // Ring is full: recycle the oldest sector. Skip anything not holding
+        // a valid header so the tail always names a readable sector.
+        do {
+            log->tail_sector = NextSector(log, log->tail_sector);
+        } while (log->tail_sector != log->head_sector && ReadSectorHeader(log, log->tail_sector, &header) != 1);
+    }
+    return StartSector(log, next, log->head_sector_seq + 1U);
+}
+
+int FlashLog_Append(FlashLog *log, const uint8_t *data, uint16_t size, uint32_t *out_seq)
+{
+    uint8_t word[4];
+    uint32_t base;
+    uint32_t crc;
+    uint32_t seq;
+
+    if (log == NULL || log->port == NULL || data == NULL || size == 0U || size == 0xFFFFU ||
+        RecordBytes(size) > log->port->sector_size - FLASH_LOG_SECTOR_HEADER_BYTES) {
+        return -1;
+    }
+
+    if (log->head_offset + RecordBytes(size) > log->port->sector_size && Rotate(log) != 0) {
+        return -2;
+    }
+
+    seq = log->next_record_seq;
+    base = SectorBase(log, log->head_sector) + log->head_offset;
+
+    // Body first, length word last: a record only exists once fully programmed.
+    PutLe32(word, seq);
+    crc = Crc_Ieee32Update(0xFFFFFFFFU, word, 4);
+    crc = Crc_Ieee32Final(Crc_Ieee32Update(crc, data, size));
+    if (log->port->write(base + 4U, word, 4) != 0 ||
+        log->port->write(base + 8U, data, size) != 0) {
+        log->head_offset = log->port->sector_size;
+        return -2;
+    }
+    PutLe32(word, crc);
+    if (log->port->write(base + 8U + Align4(size), word, 4) != 0) {
+        log->head_offset = log->port->sector_size;
+        return -2;
+    }
+    PutLe32(word, (uint32_t)size | ((uint32_t)(uint16_t)~size << 16));
+    if (log->port->write(base, word, 4) != 0) {
+        log->head_offset = log->port->sector_size;
+        return -2;
+    }
+
+    log->head_offset += RecordBytes(size);
+    log->next_record_seq = seq + 1U;
+    if (out_seq != NULL) {
+        *out_seq = seq;
+    }
+    return 0;
+}
+
+uint32_t FlashLog_OldestSeq(const FlashLog *log)
+{
+    FlashLogSectorHeader header;
+
+    if (log == NULL || log->port == NULL) {
+        return 0;
+    }
+    if (ReadSectorHeader(log, log->tail_sector, &header) != 1) {
+        return log->next_record_seq;
+    }
+    return header.first_record_seq;
+}
+
+uint32_t FlashLog_NextSeq(const FlashLog *log)
+{
+    return log != NULL ? log->next_record_seq : 0U;
+}
+
+static void SeekFrom(const FlashLog *log, FlashLogIterator *it, uint32_t cursor)
+{
+    FlashLogSectorHeader header;
+    uint32_t sector;
+    uint32_t oldest;
+    uint32_t i;
+    int found = 0;
+
+    it->cursor = cursor;
+    it->sector = log->tail_sector;
+    it->offset = FLASH_LOG_SECTOR_HEADER_BYTES;
+    it->sector_seq = 0;
+
+    oldest = FlashLog_OldestSeq(log);
+    if ((int32_t)(cursor - oldest) < 0) {
+        it->lost += oldest - cursor;
+        it->cursor = oldest;
+    }
+
+    // Sector headers record where they start, so the scan only touches one
+    // header per sector plus the records of the sector holding the cursor.
+    sector = log->tail_sector;
+    for (i = 0; i < log->port->sector_count; ++i) {
+        if (ReadSectorHeader(log, sector, &header) == 1 &&
+            (int32_t)(header.first_record_seq - it->cursor) <= 0) {
+            it->sector = sector;
+            it->sector_seq = header.sector_seq;
+            found = 1;
+        }
+        if (sector == log->head_sector) {
+            break;
+        }
+        sector = NextSector(log, sector);
+    }
+    if (!found) {
+        it->sector = log->head_sector;
+        it->sector_seq = log->head_sector_seq;
+    }
+}
+
+void FlashLog_Seek(const FlashLog *log, FlashLogIterator *it, uint32_t cursor)
+{
+    if (log == NULL || log->port == NULL || it == NULL) {
+        return;
+    }
+    it->lost = 0;
+    SeekFrom(log, it, cursor);
+}
+
+int FlashLog_Next(
+    const FlashLog *log,
+    FlashLogIterator *it,
+    uint8_t *data,
+    uint16_t data_size,
+    uint16_t *out_size,
+    uint32_t *out_seq
+)
+{
+    FlashLogSectorHeader header;
+    uint32_t guard;
+    int ret;
+
+    if (log == NULL || log->port == NULL || it == NULL || data == NULL) {
+        return -2;
+    }
+
+    for (guard = 0; guard < log->port->sector_count * 2U + 2U; ) {
+        uint16_t size = 0;
+        uint32_t seq = 0;
+
+        ret = ReadSectorHeader(log, it->sector, &header);
+        if (ret < 0) {
+            return ret;
+        }
+        if (ret == 0 && it->sector != log->head_sector) {
+            // Damaged header: its records are unreadable, step over the sector.
+            it->sector = NextSector(log, it->sector);
+            it->sector_seq++;
+            it->offset = FLASH_LOG_SECTOR_HEADER_BYTES;
+            guard++;
+            continue;
+        }
+        if (ret == 0 || header.sector_seq != it->sector_seq) {
+            // Recycled since the last call; start over from the cursor.
+            SeekFrom(log, it, it->cursor);
+            guard++;
+            continue;
+        }
+
+        ret = ReadRecord(log, it->sector, it->offset, data, data_size, &size, &seq);
+        if (ret < 0) {
+            return ret;
+        }
+        if (ret == RECORD_END || ret == RECORD_TORN) {
+            if (it->sector == log->head_sector) {
+                return 0;
+            }
+            it->sector = NextSector(log, it->sector);
+            it->sector_seq++;
+            it->offset = FLASH_LOG_SECTOR_HEADER_BYTES;
+            guard++;
+            continue;
+        }
+
+        if ((int32_t)(seq - it->cursor) < 0 || ret == RECORD_CORRUPT) {
+            it->offset += RecordBytes(size);
+            continue;
+        }
+        if (size > data_size) {
+            return -1;
+        }
+        // Records between the cursor and this one sat in a damaged record or sector.
+        it->lost += seq - it->cursor;
+        it->offset += RecordBytes(size);
+        it->cursor = seq + 1U;
+        if (out_size != NULL) {
+            *out_size = size;
+        }
+        if (out_seq != NULL) {
+            *out_seq = seq;
+        }
+        return 1;
+    }
+    return 0;
+}
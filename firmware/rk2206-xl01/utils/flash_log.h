@@ -0,0 +1,86 @@
+/*
+ * Flash Log Utility
+ * Append-only, CRC-protected record log over a ring of erasable flash sectors
+ */
+
+#ifndef UTILS_FLASH_LOG_H
+#define UTILS_FLASH_LOG_H
+
+#include <stdint.h>
+
+#define FLASH_LOG_SECTOR_HEADER_BYTES 16U
+#define FLASH_LOG_RECORD_OVERHEAD_BYTES 12U  // length word + record seq + CRC32
+
+/*
+ * Storage backend. Offsets are relative to the start of the log region,
+ * which spans sector_size * sector_count bytes. Erased bytes read 0xFF and
+ * writes only clear bits, as on NOR flash. All calls return 0 on success.
+ */
+typedef struct {
+    int (*read)(uint32_t offset, uint8_t *data, uint32_t size);
+    int (*write)(uint32_t offset, const uint8_t *data, uint32_t size);
+    int (*erase)(uint32_t offset, uint32_t size);   // whole sectors only
+    uint32_t sector_size;
+    uint32_t sector_count;
+} FlashLogPort;
+
+typedef struct {
+    const FlashLogPort *port;
+    uint32_t head_sector;       // Sector receiving appends
+    uint32_t head_offset;       // Next free byte in head_sector
+    uint32_t head_sector_seq;
+    uint32_t tail_sector;       // Oldest sector still holding records
+    uint32_t next_record_seq;
+    uint32_t erase_count;       // Sector erases since mount
+} FlashLog;
+
+typedef struct {
+    uint32_t sector;
+    uint32_t offset;
+    uint32_t sector_seq;        // Detects the sector being recycled under us
+    uint32_t cursor;            // Next record seq wanted
+    uint32_t lost;              // Records the cursor skipped: recycled, or in a damaged record or sector
+} FlashLogIterator;
+
+/**
+ * Scan the region and resume after the newest intact record. A blank or
+ * unrecognisable region is formatted. A record torn by power loss is
+ * skipped and appends continue in a fresh sector.
+ * @return 0 on success, negative on port failure or bad geometry
+ */
+int FlashLog_Mount(FlashLog *log, const FlashLogPort *port);
+
+/**
+ * Append one record. When the head sector is full the next sector in the
+ * ring is erased, dropping its records, so every sector wears at the same rate.
+ * @return 0 on success, -1 bad arguments / too large, -2 port failure
+ */
+int FlashLog_Append(FlashLog *log, const uint8_t *data, uint16_t size, uint32_t *out_seq);
+
+/**
+ * Sequence number of the oldest record still stored, and of the next record
+ * to be appended. Equal when the log is empty.
+ */
+uint32_t FlashLog_OldestSeq(const FlashLog *log);
+uint32_t FlashLog_NextSeq(const FlashLog *log);
+
+/**
+ * Position an iterator at the first stored record with seq >= cursor
+ */
+void FlashLog_Seek(const FlashLog *log, FlashLogIterator *it, uint32_t cursor);
+
+/**
+ * Read the record under the iterator and advance it.
+ * @return 1 if a record was read, 0 at the end of the log, -1 if the record
+ *         does not fit in data (iterator not advanced), -2 on port failure
+ */
+int FlashLog_Next(
+    const FlashLog *log,
+    FlashLogIterator *it,
+    uint8_t *data,
+    uint16_t data_size,
+    uint16_t *out_size,
+    uint32_t *out_seq
+);
+
+#endif // UTILS_FLASH_LOG_H
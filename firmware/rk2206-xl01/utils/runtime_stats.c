@@ -0,0 +1,292 @@
+/*
+ * Runtime Stats Utility Implementation
+ *
+ * Stack figures come from LOS_TaskInfoGet: the kernel fills each stack with
+ * a pattern at creation and reports how far it has been overwritten, so
+ * stack_peak is the deepest use since the task started, not the current
+ * depth. CPU share comes from CPUP when the kernel is built with it. The
+ * kernel keeps no switch counts, so the user task switch hook counts, per
+ * task, how often it was switched out.
+ */
+
+#include "runtime_stats.h"
+#include <stdio.h>
+#include <string.h>
+#include "los_task.h"
+#include "los_mux.h"
+#include "los_config.h"
+#include "../config/app_config.h"
+
+#if defined(LOSCFG_BASE_CORE_CPUP) && LOSCFG_BASE_CORE_CPUP
+#include "los_cpup.h"
+#define RUNTIME_STATS_HAS_CPUP 1
+#else
+#define RUNTIME_STATS_HAS_CPUP 0
+#endif
+
+#ifndef RUNTIME_STATS_SWITCH_HOOK
+#define RUNTIME_STATS_SWITCH_HOOK 1     // needs g_pfnUsrTskSwitchHook in the kernel
+#endif
+
+#ifndef RUNTIME_STATS_LOG_INTERVAL_MS
+#define RUNTIME_STATS_LOG_INTERVAL_MS 300000U
+#endif
+
+#ifndef RUNTIME_STATS_STACK_WARN_PCT
+#define RUNTIME_STATS_STACK_WARN_PCT 85U
+#endif
+
+#define RUNTIME_STATS_TASK_IDS          (LOSCFG_BASE_CORE_TSK_LIMIT + 1U)  // + idle task
+#define RUNTIME_STATS_JSON_NAME_CHARS   10U
+#define RUNTIME_STATS_JSON_SUFFIX_BYTES 36  // "],"next_cursor":NN,"more":false}" and NUL
+
+#if RUNTIME_STATS_SWITCH_HOOK
+static volatile uint32_t g_switch_out[RUNTIME_STATS_TASK_IDS];
+static volatile uint32_t g_switch_total = 0;
+#endif
+
+static RuntimeStatsSnapshot g_snapshot;     // shared by BuildResultJson and Service
+static UINT32 g_stats_mux = 0;
+static int g_stats_ready = 0;
+static uint32_t g_last_log_tick = 0;
+
+#if RUNTIME_STATS_SWITCH_HOOK
+// Runs in the scheduler with interrupts off, while the outgoing task is still current.
+static VOID CountTaskSwitch(VOID)
+{
+    UINT32 task_id = LOS_CurTaskIDGet();
+
+    if (task_id < RUNTIME_STATS_TASK_IDS) {
+        g_switch_out[task_id]++;
+    }
+    g_switch_total++;
+}
+#endif
+
+void RuntimeStats_Init(void)
+{
+    if (g_stats_ready) {
+        return;
+    }
+    if (LOS_MuxCreate(&g_stats_mux) != LOS_OK) {
+        printf("[RT] ERROR: mutex create failed\n");
+        return;
+    }
+#if RUNTIME_STATS_SWITCH_HOOK
+    memset((void *)g_switch_out, 0, sizeof(g_switch_out));
+    g_switch_total = 0U;
+    g_pfnUsrTskSwitchHook = CountTaskSwitch;
+#endif
+    g_last_log_tick = (uint32_t)LOS_TickCountGet();
+    g_stats_ready = 1;
+    printf("[OK] Runtime stats ready (cpup=%d switch_hook=%d)\n", RUNTIME_STATS_HAS_CPUP, RUNTIME_STATS_SWITCH_HOOK);
+}
+
+// Use per mille of the stack, for ordering rows tightest first
+static uint32_t StackUsePermille(const RuntimeTaskStats *task)
+{
+    if (task->stack_size == 0U) {
+        return 0U;
+    }
+    return (uint32_t)(((uint64_t)task->stack_peak * 1000U) / task->stack_size);
+}
+
+int RuntimeStats_Sample(RuntimeStatsSnapshot *snapshot)
+{
+    UINT32 task_id;
+
+    if (snapshot == NULL) {
+        return -1;
+    }
+    memset(snapshot, 0, sizeof(*snapshot));
+    snapshot->tick = (uint32_t)LOS_TickCountGet();
+    snapshot->cpu_available = RUNTIME_STATS_HAS_CPUP;
+    snapshot->switches_available = RUNTIME_STATS_SWITCH_HOOK && g_stats_ready;
+#if RUNTIME_STATS_SWITCH_HOOK
+    snapshot->switches_total = g_switch_total;
+#endif
+
+    for (task_id = 0U; task_id < RUNTIME_STATS_TASK_IDS; ++task_id) {
+        TSK_INFO_S info;
+        RuntimeTaskStats *task;
+        unsigned int i;
+
+        if (LOS_TaskInfoGet(task_id, &info) != LOS_OK) {
+            continue;
+        }
+        if (snapshot->task_count >= RUNTIME_STATS_MAX_TASKS) {
+            snapshot->tasks_dropped++;
+            continue;
+        }
+
+        task = &snapshot->tasks[snapshot->task_count];
+        snprintf(task->name, sizeof(task->name), "%s", info.acName);
+        task->task_id = (uint16_t)task_id;
+        task->priority = info.usTaskPrio;
+        task->stack_size = info.uwStackSize;
+        task->overflow = info.bOvf ? 1U : 0U;
+        task->stack_peak = task->overflow ? info.uwStackSize : info.uwPeakUsed;
+        snapshot->overflows += task->overflow;
+#if RUNTIME_STATS_HAS_CPUP
+        {
+            UINT32 usage = LOS_HistoryTaskCpuUsage(task_id, CPUP_LAST_TEN_SECONDS);
+
+            task->cpu_permille = usage <= 1000U ? (uint16_t)usage : RUNTIME_STATS_CPU_NONE;
+        }
+#else
+        task->cpu_permille = RUNTIME_STATS_CPU_NONE;
+#endif
+#if RUNTIME_STATS_SWITCH_HOOK
+        task->switches = g_switch_out[task_id];
+#endif
+
+        // Insertion sort, tightest headroom first
+        for (i = snapshot->task_count; i > 0U &&
+             StackUsePermille(&snapshot->tasks[i - 1U]) < StackUsePermille(task); --i) {
+        }
+        if (i != snapshot->task_count) {
+            RuntimeTaskStats moved = *task;
+
+            memmove(&snapshot->tasks[i + 1U], &snapshot->tasks[i],
+                    (snapshot->task_count - i) * sizeof(snapshot->tasks[0]));
+            snapshot->tasks[i] = moved;
+        }
+        snapshot->task_count++;
+    }
+    return 0;
+}
+
+static int AppendRow(const RuntimeStatsSnapshot *snapshot, const RuntimeTaskStats *task, int first,
+                     char *output, int output_size)
+{
+    char name[RUNTIME_STATS_JSON_NAME_CHARS + 1U];
+    unsigned int i;
+
+    // Task names are identifiers; anything else would need JSON escaping.
+    for (i = 0U; i < RUNTIME_STATS_JSON_NAME_CHARS && task->name[i] != '\0'; ++i) {
+        char c = task->name[i];
+
+        name[i] = ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-')
+            ? c : '_';
+    }
+    name[i] = '\0';
+
+    return snprintf(
+        output,
+        (size_t)output_size,
+        "%s[\"%s\",%u,%u,%u,%d,%ld]",
+        first ? "" : ",",
+        name,
+        (unsigned int)task->priority,
+        (unsigned int)task->stack_peak,
+        (unsigned int)task->stack_size,
+        task->cpu_permille == RUNTIME_STATS_CPU_NONE ? -1 : (int)task->cpu_permille,
+        snapshot->switches_available ? (long)task->switches : -1L
+    );
+}
+
+int RuntimeStats_BuildResultJson(unsigned int cursor, char *output, int output_size)
+{
+    unsigned int index;
+    int len;
+    int written;
+
+    if (output == NULL || output_size <= RUNTIME_STATS_JSON_SUFFIX_BYTES || !g_stats_ready) {
+        return -1;
+    }
+    if (LOS_MuxPend(g_stats_mux, LOS_WAIT_FOREVER) != LOS_OK) {
+        return -1;
+    }
+    (void)RuntimeStats_Sample(&g_snapshot);
+
+    len = snprintf(
+        output,
+        (size_t)output_size,
+        "{\"n\":%u,\"ovf\":%u,\"sw\":%ld,\"t\":[",
+        (unsigned int)g_snapshot.task_count,
+        (unsigned int)g_snapshot.overflows,
+        g_snapshot.switches_available ? (long)g_snapshot.switches_total : -1L
+    );
+    if (len < 0 || len >= output_size) {
+        (void)LOS_MuxPost(g_stats_mux);
+        return -1;
+    }
+
+    for (index = cursor; index < g_snapshot.task_count; ++index) {
+        written = AppendRow(&g_snapshot, &g_snapshot.tasks[index], index == cursor,
+                            output + len, output_size - len);
+        // Leave room for the closing "],"next_cursor":N,"more":B}" suffix.
+        if (written < 0 || len + written >= output_size - RUNTIME_STATS_JSON_SUFFIX_BYTES) {
+            break;
+        }
+        len += written;
+    }
+    if (index == cursor && cursor < g_snapshot.task_count) {
+        (void)LOS_MuxPost(g_stats_mux);
+        return -1;
+    }
+
+    written = snprintf(
+        output + len,
+        (size_t)(output_size - len),
+        "],\"next_cursor\":%u,\"more\":%s}",
+        index < g_snapshot.task_count ? index : 0U,
+        index < g_snapshot.task_count ? "true" : "false"
+    );
+    (void)LOS_MuxPost(g_stats_mux);
+    if (written < 0 || len + written >= output_size) {
+        return -1;
+    }
+    return len + written;
+}
+
+void RuntimeStats_Service(void)
+{
+    uint32_t now = (uint32_t)LOS_TickCountGet();
+    const RuntimeTaskStats *busiest = NULL;
+    unsigned int warned = 0U;
+    unsigned int i;
+
+    if (!g_stats_ready || RUNTIME_STATS_LOG_INTERVAL_MS == 0U ||
+        (uint32_t)(now - g_last_log_tick) < LOS_MS2Tick(RUNTIME_STATS_LOG_INTERVAL_MS)) {
+        return;
+    }
+    if (LOS_MuxPend(g_stats_mux, LOS_WAIT_FOREVER) != LOS_OK) {
+        return;
+    }
+    g_last_log_tick = now;
+    (void)RuntimeStats_Sample(&g_snapshot);
+
+    for (i = 0U; i < g_snapshot.task_count; ++i) {
+        const RuntimeTaskStats *task = &g_snapshot.tasks[i];
+
+        if (task->overflow || StackUsePermille(task) >= RUNTIME_STATS_STACK_WARN_PCT * 10U) {
+            printf("[RT] WARN %s stack %s %u/%u bytes (prio %u)\n",
+                   task->name, task->overflow ? "overflowed" : "peak",
+                   (unsigned int)task->stack_peak, (unsigned int)task->stack_size, (unsigned int)task->priority);
+            warned++;
+        }
+        if (task->cpu_permille != RUNTIME_STATS_CPU_NONE &&
+            (busiest == NULL || task->cpu_permille > busiest->cpu_permille)) {
+            busiest = task;
+        }
+    }
+    if (g_snapshot.task_count > 0U) {
+        const RuntimeTaskStats *tightest = &g_snapshot.tasks[0];
+        char line[160];
+        int len = snprintf(line, sizeof(line), "[RT] %u tasks, %u near full; tightest %s %u/%u bytes",
+                           (unsigned int)g_snapshot.task_count, warned, tightest->name,
+                           (unsigned int)tightest->stack_peak, (unsigned int)tightest->stack_size);
+
+        if (busiest != NULL && len > 0 && len < (int)sizeof(line)) {
+            len += snprintf(line + len, sizeof(line) - (size_t)len, "; busiest %s %u.%u%% cpu", busiest->name,
+                            (unsigned int)busiest->cpu_permille / 10U, (unsigned int)busiest->cpu_permille % 10U);
+        }
+        if (g_snapshot.switches_available && len > 0 && len < (int)sizeof(line)) {
+            (void)snprintf(line + len, sizeof(line) - (size_t)len, "; %u switches",
+                           (unsigned int)g_snapshot.switches_total);
+        }
+        printf("%s\n", line);
+    }
+    (void)LOS_MuxPost(g_stats_mux);
+}
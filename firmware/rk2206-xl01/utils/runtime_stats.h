@@ -0,0 +1,68 @@
+/*
+ * Runtime Stats Utility
+ * Per-task stack high-water marks, CPU share and task switches sampled from
+ * the LiteOS-M kernel, for sizing stacks and priorities from field data
+ */
+
+#ifndef UTILS_RUNTIME_STATS_H
+#define UTILS_RUNTIME_STATS_H
+
+#include <stdint.h>
+
+#define RUNTIME_STATS_MAX_TASKS     24U
+#define RUNTIME_STATS_NAME_BYTES    32U      // LOS_TASK_NAMELEN, so kernel task names copy whole
+#define RUNTIME_STATS_CPU_NONE      0xFFFFU  // kernel built without LOSCFG_BASE_CORE_CPUP
+
+typedef struct {
+    char name[RUNTIME_STATS_NAME_BYTES];
+    uint16_t task_id;
+    uint16_t priority;          // LOS priority, 0 highest
+    uint32_t stack_size;
+    uint32_t stack_peak;        // deepest use since the task started; stack_size after an overflow
+    uint16_t cpu_permille;      // share over the last ten seconds, or RUNTIME_STATS_CPU_NONE
+    uint8_t overflow;           // stack guard word overwritten
+    uint32_t switches;          // times switched out since RuntimeStats_Init, 0 without the hook
+} RuntimeTaskStats;
+
+typedef struct {
+    uint32_t tick;
+    uint16_t task_count;        // tasks[] entries, tightest stack headroom first
+    uint16_t tasks_dropped;     // live tasks beyond RUNTIME_STATS_MAX_TASKS
+    uint16_t overflows;
+    uint8_t cpu_available;
+    uint8_t switches_available;
+    uint32_t switches_total;
+    RuntimeTaskStats tasks[RUNTIME_STATS_MAX_TASKS];
+} RuntimeStatsSnapshot;
+
+/**
+ * Create the lock and install the task switch counter. Call before the
+ * application tasks start so their switches are counted from the first.
+ */
+void RuntimeStats_Init(void);
+
+/**
+ * Walk the kernel's task table. Reading the high-water marks scans each
+ * task's stack, so keep this off tight loops.
+ * @return 0 on success, -1 if snapshot is NULL
+ */
+int RuntimeStats_Sample(RuntimeStatsSnapshot *snapshot);
+
+/**
+ * Sample and format one page for get_runtime_stats:
+ * {"n":N,"ovf":N,"sw":N,"t":[[name,prio,peak,size,cpu_permille,switches],...],
+ *  "next_cursor":N,"more":true|false}, paged like fetch_log. Rows from
+ * cursor on, tightest first, as many as fit; cpu_permille is -1 without CPUP
+ * and switches -1 without the hook.
+ * @return length written, -1 on error or if not even one row fits
+ */
+int RuntimeStats_BuildResultJson(unsigned int cursor, char *output, int output_size);
+
+/**
+ * Log tasks whose stack use reached RUNTIME_STATS_STACK_WARN_PCT, at most once
+ * per RUNTIME_STATS_LOG_INTERVAL_MS. Call from a periodic task; the snapshot
+ * lives in static storage, so the stack cost is one TSK_INFO_S and printf.
+ */
+void RuntimeStats_Service(void);
+
+#endif // UTILS_RUNTIME_STATS_H
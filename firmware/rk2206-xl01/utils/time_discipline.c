@@ -0,0 +1,497 @@
+/*
+ * Time Discipline Utility Implementation
+ *
+ * utc(mono) = base_offset + mono + drift * (mono - base_mono)
+ *
+ * Observations arrive late by an unknown, non-negative amount (NMEA waits in
+ * the GPS FIFO until the next GPS_Poll; gateway timestamps include link
+ * latency), so utc - mono underestimates the true offset. Each window keeps
+ * the largest sample, i.e. the least-delayed one, before steering:
+ * - first window or |error| > step threshold: step and record time_jump_ms
+ * - otherwise: slew half the phase error; frequency is the offset slope
+ *   against an anchor window one to two hours old
+ */
+
+#include "time_discipline.h"
+#include <stddef.h>
+#include <stdint.h>
+#include "los_mux.h"
+#include "los_tick.h"    // For LOS_TickCountGet
+#include "los_config.h"  // For LOSCFG_BASE_CORE_TICK_PER_SECOND
+
+#ifndef LOSCFG_BASE_CORE_TICK_PER_SECOND
+#define LOSCFG_BASE_CORE_TICK_PER_SECOND 1000UL
+#endif
+
+#ifndef TIME_DISCIPLINE_GNSS_WINDOW
+#define TIME_DISCIPLINE_GNSS_WINDOW 16U          // observations per steering step
+#endif
+
+#ifndef TIME_DISCIPLINE_GATEWAY_WINDOW
+#define TIME_DISCIPLINE_GATEWAY_WINDOW 4U
+#endif
+
+#ifndef TIME_DISCIPLINE_GNSS_STEP_MS
+#define TIME_DISCIPLINE_GNSS_STEP_MS 1000
+#endif
+
+#ifndef TIME_DISCIPLINE_GATEWAY_STEP_MS
+#define TIME_DISCIPLINE_GATEWAY_STEP_MS 3000
+#endif
+
+#ifndef TIME_DISCIPLINE_GNSS_HOLDOVER_MS
+#define TIME_DISCIPLINE_GNSS_HOLDOVER_MS 300000U // gateway time is ignored this long after GNSS
+#endif
+
+#ifndef TIME_DISCIPLINE_FREQ_BASELINE_MS
+#define TIME_DISCIPLINE_FREQ_BASELINE_MS 3600000U  // frequency anchors are 1-2 h old
+#endif
+
+#define TIME_DISCIPLINE_FREQ_MIN_SPAN_MS 600000  // no frequency estimate before 10 min
+#define TIME_DISCIPLINE_MAX_DRIFT_PPB 500000     // +-500 ppm, far beyond any crystal
+#define TIME_DISCIPLINE_MIN_UNIX_MS 1577836800000LL  // 2020-01-01, rejects receiver cold-start dates
+
+typedef struct {
+    int synced;
+    TimeSource source;
+    int64_t base_offset_ms;
+    uint64_t base_mono_ms;
+    int32_t drift_ppb;
+    int64_t last_output_ms;
+    int32_t pending_jump_ms;
+    uint64_t last_gnss_mono_ms;
+    int has_gnss;
+
+    TimeSource window_source;
+    unsigned int window_count;
+    int64_t window_best_offset_ms;
+
+    int64_t anchor_offset_ms;
+    uint64_t anchor_mono_ms;
+    int64_t next_anchor_offset_ms;
+    uint64_t next_anchor_mono_ms;
+} TimeDisciplineState;
+
+static TimeDisciplineState g_time;
+static uint32_t g_time_mutex;
+static unsigned char g_time_mutex_ready = 0;
+
+static void Lock(void)
+{
+    if (g_time_mutex_ready) {
+        (void)LOS_MuxPend(g_time_mutex, LOS_WAIT_FOREVER);
+    }
+}
+
+static void Unlock(void)
+{
+    if (g_time_mutex_ready) {
+        (void)LOS_MuxPost(g_time_mutex);
+    }
+}
+
+static uint64_t TickToMonoMs(uint64_t tick)
+{
+    return (tick * 1000ULL) / (uint64_t)LOSCFG_BASE_CORE_TICK_PER_SECOND;
+}
+
+// Days since 1970-01-01 for a proleptic Gregorian date (H. Hinnant).
+static int64_t DaysFromCivil(int32_t y, uint32_t m, uint32_t d)
+{
+    int32_t era;
+    uint32_t yoe;
+    uint32_t doy;
+    uint32_t doe;
+
+    y -= (m <= 2U) ? 1 : 0;
+    era = (y >= 0 ? y : y - 399) / 400;
+    yoe = (uint32_t)(y - era * 400);
+    doy = (153U * (m > 2U ? m - 3U : m + 9U) + 2U) / 5U + d - 1U;
+    doe = yoe * 365U + yoe / 4U - yoe / 100U + doy;
+    return (int64_t)era * 146097 + (int64_t)doe - 719468;
+}
+
+static void CivilFromDays(int64_t z, int32_t *y, uint32_t *m, uint32_t *d)
+{
+    int64_t era;
+    uint32_t doe;
+    uint32_t yoe;
+    uint32_t doy;
+    uint32_t mp;
+
+    z += 719468;
+    era = (z >= 0 ? z : z - 146096) / 146097;
+    doe = (uint32_t)(z - era * 146097);
+    yoe = (doe - doe / 1460U + doe / 36524U - doe / 146096U) / 365U;
+    doy = doe - (365U * yoe + yoe / 4U - yoe / 100U);
+    mp = (5U * doy + 2U) / 153U;
+    *d = doy - (153U * mp + 2U) / 5U + 1U;
+    *m = mp < 10U ? mp + 3U : mp - 9U;
+    *y = (int32_t)(yoe + era * 400) + (*m <= 2U ? 1 : 0);
+}
+
+static int64_t OffsetAt(uint64_t mono_ms)
+{
+    int64_t since_base = (int64_t)(mono_ms - g_time.base_mono_ms);
+    return g_time.base_offset_ms + (since_base * g_time.drift_ppb) / 1000000000LL;
+}
+
+static void ResetFrequencyAnchors(int64_t offset_ms, uint64_t mono_ms)
+{
+    g_time.anchor_offset_ms = offset_ms;
+    g_time.anchor_mono_ms = mono_ms;
+    g_time.next_anchor_offset_ms = offset_ms;
+    g_time.next_anchor_mono_ms = mono_ms;
+}
+
+// Saturate rather than wrap: a step past +-24.8 days is reported as the limit.
+static void AddJumpLocked(int64_t error_ms)
+{
+    int64_t total = (int64_t)g_time.pending_jump_ms + error_ms;
+
+    if (total > INT32_MAX) {
+        total = INT32_MAX;
+    } else if (total < INT32_MIN) {
+        total = INT32_MIN;
+    }
+    g_time.pending_jump_ms = (int32_t)total;
+}
+
+static void SteerLocked(TimeSource source, int64_t offset_ms, uint64_t mono_ms, int32_t step_threshold_ms)
+{
+    int64_t error_ms;
+    int64_t span_ms;
+
+    if (!g_time.synced || source != g_time.source) {
+        // First sync or source change: adopt the new source as-is.
+        if (g_time.synced) {
+            error_ms = offset_ms - OffsetAt(mono_ms);
+            if (error_ms > step_threshold_ms || error_ms < -step_threshold_ms) {
+                AddJumpLocked(error_ms);
+                g_time.last_output_ms = 0;
+            }
+        }
+        g_time.synced = 1;
+        g_time.source = source;
+        g_time.base_offset_ms = offset_ms;
+        g_time.base_mono_ms = mono_ms;
+        ResetFrequencyAnchors(offset_ms, mono_ms);
+        return;
+    }
+
+    error_ms = offset_ms - OffsetAt(mono_ms);
+    if (error_ms > step_threshold_ms || error_ms < -step_threshold_ms) {
+        // Too far off to slew (receiver reset, gateway clock fixed, ...).
+        AddJumpLocked(error_ms);
+        g_time.last_output_ms = 0;
+        g_time.base_offset_ms = offset_ms;
+        g_time.base_mono_ms = mono_ms;
+        g_time.drift_ppb = 0;
+        ResetFrequencyAnchors(offset_ms, mono_ms);
+        return;
+    }
+
+    // Phase: take half of the error each window to average out jitter.
+    g_time.base_offset_ms = OffsetAt(mono_ms) + error_ms / 2;
+    g_time.base_mono_ms = mono_ms;
+
+    // Frequency: slope of the offset since an anchor one to two baselines
+    // old, so window jitter is divided by a long span yet temperature
+    // changes are still followed.
+    span_ms = (int64_t)(mono_ms - g_time.anchor_mono_ms);
+    if (span_ms >= TIME_DISCIPLINE_FREQ_MIN_SPAN_MS) {
+        int64_t drift = (offset_ms - g_time.anchor_offset_ms) * 1000000000LL / span_ms;
+
+        if (drift > TIME_DISCIPLINE_MAX_DRIFT_PPB) {
+            drift = TIME_DISCIPLINE_MAX_DRIFT_PPB;
+        } else if (drift < -TIME_DISCIPLINE_MAX_DRIFT_PPB) {
+            drift = -TIME_DISCIPLINE_MAX_DRIFT_PPB;
+        }
+        g_time.drift_ppb = (int32_t)drift;
+    }
+    if ((mono_ms - g_time.next_anchor_mono_ms) >= TIME_DISCIPLINE_FREQ_BASELINE_MS) {
+        g_time.anchor_offset_ms = g_time.next_anchor_offset_ms;
+        g_time.anchor_mono_ms = g_time.next_anchor_mono_ms;
+        g_time.next_anchor_offset_ms = offset_ms;
+        g_time.next_anchor_mono_ms = mono_ms;
+    }
+}
+
+static void ObserveLocked(TimeSource source, int64_t utc_ms, uint64_t tick)
+{
+    uint64_t mono_ms = TickToMonoMs(tick);
+    int64_t offset_ms = utc_ms - (int64_t)mono_ms;
+    unsigned int window = (source == TIME_SOURCE_GNSS) ? TIME_DISCIPLINE_GNSS_WINDOW : TIME_DISCIPLINE_GATEWAY_WINDOW;
+
+    if (source == TIME_SOURCE_GNSS) {
+        g_time.has_gnss = 1;
+        g_time.last_gnss_mono_ms = mono_ms;
+    }
+
+    if (g_time.window_source != source || g_time.window_count == 0U) {
+        g_time.window_source = source;
+        g_time.window_count = 0;
+        g_time.window_best_offset_ms = offset_ms;
+    } else if (offset_ms > g_time.window_best_offset_ms) {
+        g_time.window_best_offset_ms = offset_ms;
+    }
+    g_time.window_count++;
+
+    // Sync (or switch source) on the first observation; later, steer once
+    // per full window.
+    if (g_time.synced && g_time.source == source && g_time.window_count < window) {
+        return;
+    }
+    SteerLocked(
+        source,
+        g_time.window_best_offset_ms,
+        mono_ms,
+        source == TIME_SOURCE_GNSS ? TIME_DISCIPLINE_GNSS_STEP_MS : TIME_DISCIPLINE_GATEWAY_STEP_MS
+    );
+    g_time.window_count = 0;
+}
+
+void TimeDiscipline_Init(void)
+{
+    g_time.synced = 0;
+    g_time.source = TIME_SOURCE_NONE;
+    g_time.base_offset_ms = 0;
+    g_time.base_mono_ms = 0;
+    g_time.drift_ppb = 0;
+    g_time.last_output_ms = 0;
+    g_time.pending_jump_ms = 0;
+    g_time.last_gnss_mono_ms = 0;
+    g_time.has_gnss = 0;
+    g_time.window_source = TIME_SOURCE_NONE;
+    g_time.window_count = 0;
+    g_time.window_best_offset_ms = 0;
+    ResetFrequencyAnchors(0, 0);
+    if (!g_time_mutex_ready) {
+        g_time_mutex_ready = LOS_MuxCreate(&g_time_mutex) == LOS_OK ? 1U : 0U;
+    }
+}
+
+int TimeDiscipline_ObserveGnss(uint16_t year, uint8_t month, uint8_t day, uint32_t ms_of_day, uint64_t tick)
+{
+    int64_t utc_ms;
+
+    if (month < 1U || month > 12U || day < 1U || day > 31U || ms_of_day >= 86401000U) {
+        return -1;
+    }
+    utc_ms = DaysFromCivil((int32_t)year, month, day) * 86400000LL + (int64_t)ms_of_day;
+    if (utc_ms < TIME_DISCIPLINE_MIN_UNIX_MS) {
+        return -1;
+    }
+
+    Lock();
+    ObserveLocked(TIME_SOURCE_GNSS, utc_ms, tick);
+    Unlock();
+    return 0;
+}
+
+static int ParseDigits(const char **p, int count, uint32_t *out)
+{
+    uint32_t value = 0;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        char c = (*p)[i];
+        if (c < '0' || c > '9') {
+            return -1;
+        }
+        value = value * 10U + (uint32_t)(c - '0');
+    }
+    *p += count;
+    *out = value;
+    return 0;
+}
+
+// "YYYY-MM-DDThh:mm:ss[.fff...](Z|+hh:mm|-hh:mm)" -> UTC ms
+static int ParseRfc3339(const char *s, int64_t *utc_ms)
+{
+    uint32_t year;
+    uint32_t month;
+    uint32_t day;
+    uint32_t hour;
+    uint32_t minute;
+    uint32_t second;
+    uint32_t ms = 0;
+    uint32_t scale = 100;
+    int32_t zone_s = 0;
+
+    if (ParseDigits(&s, 4, &year) != 0 || *s++ != '-' ||
+        ParseDigits(&s, 2, &month) != 0 || *s++ != '-' ||
+        ParseDigits(&s, 2, &day) != 0 || (*s != 'T' && *s != 't' && *s != ' ') ||
+        (++s, ParseDigits(&s, 2, &hour)) != 0 || *s++ != ':' ||
+        ParseDigits(&s, 2, &minute) != 0 || *s++ != ':' ||
+        ParseDigits(&s, 2, &second) != 0) {
+        return -1;
+    }
+    if (month < 1U || month > 12U || day < 1U || day > 31U || hour > 23U || minute > 59U || second > 60U) {
+        return -1;
+    }
+    if (*s == '.') {
+        s++;
+        while (*s >= '0' && *s <= '9') {
+            ms += (uint32_t)(*s - '0') * scale;
+            scale /= 10U;
+            s++;
+        }
+    }
+    if (*s == 'Z' || *s == 'z') {
+        s++;
+    } else if (*s == '+' || *s == '-') {
+        int sign = (*s == '-') ? -1 : 1;
+        uint32_t zone_h;
+        uint32_t zone_m;
+
+        s++;
+        if (ParseDigits(&s, 2, &zone_h) != 0 || *s++ != ':' || ParseDigits(&s, 2, &zone_m) != 0) {
+            return -1;
+        }
+        zone_s = sign * (int32_t)(zone_h * 3600U + zone_m * 60U);
+    } else {
+        return -1;
+    }
+    if (*s != '\0') {
+        return -1;
+    }
+
+    *utc_ms = (DaysFromCivil((int32_t)year, month, day) * 86400LL +
+               (int64_t)(hour * 3600U + minute * 60U + second) - zone_s) * 1000LL + (int64_t)ms;
+    return 0;
+}
+
+int TimeDiscipline_ObserveRfc3339(const char *timestamp, uint64_t tick)
+{
+    int64_t utc_ms;
+    int ret = 0;
+
+    if (timestamp == NULL || ParseRfc3339(timestamp, &utc_ms) != 0 || utc_ms < TIME_DISCIPLINE_MIN_UNIX_MS) {
+        return -1;
+    }
+
+    Lock();
+    if (g_time.has_gnss &&
+        TickToMonoMs(tick) - g_time.last_gnss_mono_ms < TIME_DISCIPLINE_GNSS_HOLDOVER_MS) {
+        ret = -2;
+    } else {
+        ObserveLocked(TIME_SOURCE_GATEWAY, utc_ms, tick);
+    }
+    Unlock();
+    return ret;
+}
+
+int TimeDiscipline_NowUtcMs(int64_t *utc_ms)
+{
+    uint64_t mono_ms;
+    int64_t now;
+
+    if (utc_ms == NULL) {
+        return -1;
+    }
+
+    Lock();
+    if (!g_time.synced) {
+        Unlock();
+        return -1;
+    }
+    mono_ms = TickToMonoMs((uint64_t)LOS_TickCountGet());
+    now = (int64_t)mono_ms + OffsetAt(mono_ms);
+    // A negative slew holds the clock rather than running it backwards.
+    if (now < g_time.last_output_ms) {
+        now = g_time.last_output_ms;
+    }
+    g_time.last_output_ms = now;
+    Unlock();
+
+    *utc_ms = now;
+    return 0;
+}
+
+int TimeDiscipline_FormatRfc3339(int64_t utc_ms, char *output, int output_size)
+{
+    int64_t days;
+    int64_t ms_of_day;
+    int32_t year;
+    uint32_t month;
+    uint32_t day;
+    uint32_t seconds;
+
+    if (output == NULL || output_size < TIME_DISCIPLINE_RFC3339_BYTES || utc_ms < 0) {
+        return -1;
+    }
+
+    days = utc_ms / 86400000LL;
+    ms_of_day = utc_ms % 86400000LL;
+    CivilFromDays(days, &year, &month, &day);
+    seconds = (uint32_t)(ms_of_day / 1000LL);
+
+    // Fixed-width digits written directly; no printf on the hot path.
+    {
+        char *p = output;
+        uint32_t ms = (uint32_t)(ms_of_day % 1000LL);
+        uint32_t y = (uint32_t)year;
+
+        *p++ = (char)('0' + (y / 1000U) % 10U);
+        *p++ = (char)('0' + (y / 100U) % 10U);
+        *p++ = (char)('0' + (y / 10U) % 10U);
+        *p++ = (char)('0' + y % 10U);
+        *p++ = '-';
+        *p++ = (char)('0' + month / 10U);
+        *p++ = (char)('0' + month % 10U);
+        *p++ = '-';
+        *p++ = (char)('0' + day / 10U);
+        *p++ = (char)('0' + day % 10U);
+        *p++ = 'T';
+        *p++ = (char)('0' + (seconds / 3600U) / 10U);
+        *p++ = (char)('0' + (seconds / 3600U) % 10U);
+        *p++ = ':';
+        *p++ = (char)('0' + ((seconds / 60U) % 60U) / 10U);
+        *p++ = (char)('0' + ((seconds / 60U) % 60U) % 10U);
+        *p++ = ':';
+        *p++ = (char)('0' + (seconds % 60U) / 10U);
+        *p++ = (char)('0' + (seconds % 60U) % 10U);
+        *p++ = '.';
+        *p++ = (char)('0' + ms / 100U);
+        *p++ = (char)('0' + (ms / 10U) % 10U);
+        *p++ = (char)('0' + ms % 10U);
+        *p++ = 'Z';
+        *p = '\0';
+        return (int)(p - output);
+    }
+}
+
+int32_t TimeDiscipline_PeekJumpMs(void)
+{
+    int32_t jump;
+
+    Lock();
+    jump = g_time.pending_jump_ms;
+    Unlock();
+    return jump;
+}
+
+void TimeDiscipline_AckJumpMs(int32_t reported_ms)
+{
+    Lock();
+    g_time.pending_jump_ms -= reported_ms;
+    Unlock();
+}
+
+const char *TimeDiscipline_SourceName(void)
+{
+    switch (g_time.synced ? g_time.source : TIME_SOURCE_NONE) {
+        case TIME_SOURCE_GNSS:
+            return "gnss_disciplined";
+        case TIME_SOURCE_GATEWAY:
+            return "gateway_disciplined";
+        default:
+            return "";
+    }
+}
+
+int32_t TimeDiscipline_DriftPpb(void)
+{
+    return g_time.drift_ppb;
+}
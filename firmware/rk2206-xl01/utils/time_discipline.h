@@ -0,0 +1,71 @@
+/*
+ * Time Discipline Utility
+ * UTC clock steered from GNSS or gateway timestamps over the LOS tick counter
+ */
+
+#ifndef UTILS_TIME_DISCIPLINE_H
+#define UTILS_TIME_DISCIPLINE_H
+
+#include <stdint.h>
+
+#define TIME_DISCIPLINE_RFC3339_BYTES 25  // "2026-10-18T02:36:34.250Z" + NUL
+
+typedef enum {
+    TIME_SOURCE_NONE = 0,
+    TIME_SOURCE_GNSS,       // receiver UTC (RMC / NAV-PVT)
+    TIME_SOURCE_GATEWAY     // gateway sent_ts / time_sync.sent_ts
+} TimeSource;
+
+/**
+ * Initialize clock state and lock
+ */
+void TimeDiscipline_Init(void);
+
+/**
+ * Feed a receiver UTC solution captured at tick
+ * @return 0 if accepted, negative if invalid or not used
+ */
+int TimeDiscipline_ObserveGnss(uint16_t year, uint8_t month, uint8_t day, uint32_t ms_of_day, uint64_t tick);
+
+/**
+ * Feed a gateway RFC3339 timestamp received at tick; ignored while GNSS
+ * time is fresh. The string is parsed once here.
+ * @return 0 if accepted, negative if unparsable or not used
+ */
+int TimeDiscipline_ObserveRfc3339(const char *timestamp, uint64_t tick);
+
+/**
+ * Current disciplined UTC in ms since the Unix epoch (never goes backwards
+ * except through a reported step)
+ * @return 0 when synchronized, -1 if no source has been seen yet
+ */
+int TimeDiscipline_NowUtcMs(int64_t *utc_ms);
+
+/**
+ * Format UTC ms as "YYYY-MM-DDThh:mm:ss.sssZ"
+ * @return length written, -1 if output is too small
+ */
+int TimeDiscipline_FormatRfc3339(int64_t utc_ms, char *output, int output_size);
+
+/**
+ * Sum of step corrections not yet acknowledged; the value stays pending
+ */
+int32_t TimeDiscipline_PeekJumpMs(void);
+
+/**
+ * Acknowledge a peeked jump once it reached the platform. Steps taken after
+ * the peek stay pending for the next report.
+ */
+void TimeDiscipline_AckJumpMs(int32_t reported_ms);
+
+/**
+ * Name of the source currently steering the clock, "" when unsynchronized
+ */
+const char *TimeDiscipline_SourceName(void);
+
+/**
+ * Estimated oscillator error of the tick counter in parts per billion
+ */
+int32_t TimeDiscipline_DriftPpb(void);
+
+#endif // UTILS_TIME_DISCIPLINE_H